@@ -9,13 +9,19 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <thread>
 
 #include <gmock/gmock.h>
 
+#include "common/sock_dev_ring.h"
+
 #include "autotest.h"
 #include "common.h"
 
@@ -80,6 +86,26 @@ eResult tAutotest::init(const std::string& binaryPath,
 	return eResult::success;
 }
 
+static int connectSocket(const std::string& pci)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (fd < 0)
+	{
+		YANET_LOG_ERROR("error: could not create socket: %s\n", strerror(errno));
+		return -1;
+	}
+	struct sockaddr_un sockaddr;
+	sockaddr.sun_family = AF_UNIX;
+	strncpy(sockaddr.sun_path, pci.data() + strlen(SOCK_DEV_PREFIX), sizeof(sockaddr.sun_path));
+	if (connect(fd, (struct sockaddr*)&sockaddr, sizeof(sockaddr)) < 0)
+	{
+		YANET_LOG_ERROR("error: could not connect: %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
 eResult tAutotest::initSockets()
 {
 	dataPlaneConfig = dataPlane.getConfig();
@@ -95,18 +121,9 @@ eResult tAutotest::initSockets()
 			return eResult::errorSocket;
 		}
 
-		int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+		int fd = connectSocket(pci);
 		if (fd < 0)
 		{
-			YANET_LOG_ERROR("error: could not create socket: %s\n", strerror(errno));
-			return eResult::errorSocket;
-		}
-		struct sockaddr_un sockaddr;
-		sockaddr.sun_family = AF_UNIX;
-		strncpy(sockaddr.sun_path, pci.data() + strlen(SOCK_DEV_PREFIX), sizeof(sockaddr.sun_path));
-		if (connect(fd, (struct sockaddr*)&sockaddr, sizeof(sockaddr)) < 0)
-		{
-			YANET_LOG_ERROR("error: could not connect: %s\n", strerror(errno));
 			return eResult::errorSocket;
 		}
 		pcaps[interfaceName] = fd;
@@ -1435,6 +1452,12 @@ void tAutotest::mainThread()
 
 					result = step_dumpPackets(yamlStep["dumpPackets"], configFilePath);
 				}
+				else if (yamlStep["benchmark"])
+				{
+					YANET_LOG_DEBUG("step: benchmark\n");
+
+					result = step_benchmark(yamlStep["benchmark"], configFilePath);
+				}
 				else
 				{
 					YANET_LOG_ERROR("unknown step\n");
@@ -1958,6 +1981,315 @@ bool tAutotest::step_dumpPackets(const YAML::Node& yamlStep,
 	return true;
 }
 
+static uint64_t dropPackets(const common::worker::stats::common& stats)
+{
+	return stats.brokenPackets +
+	       stats.dropPackets +
+	       stats.ring_highPriority_drops +
+	       stats.ring_normalPriority_drops +
+	       stats.ring_lowPriority_drops +
+	       stats.interface_lookupMisses +
+	       stats.acl_ingress_dropPackets +
+	       stats.acl_egress_dropPackets +
+	       stats.logs_drops;
+}
+
+bool tAutotest::step_benchmark(const YAML::Node& yamlStep,
+                               const std::string& path)
+{
+	const std::string interfaceName = yamlStep["port"].as<std::string>();
+	const std::string sendFilePath = path + "/" + yamlStep["send"].as<std::string>();
+	const double duration = yamlStep["duration"] ? yamlStep["duration"].as<double>() : 5.0;
+	const std::string baselineFilePath = path + "/" + (yamlStep["baseline"] ? yamlStep["baseline"].as<std::string>() : "benchmark.yaml");
+
+	if (!pcaps.count(interfaceName))
+	{
+		YANET_LOG_ERROR("benchmark: error: unknown port '%s'\n", interfaceName.data());
+		throw "";
+	}
+
+	/// frames are loaded in memory, so replay doesn't depend on speed of disk
+	std::vector<std::vector<uint8_t>> frames;
+	{
+		char pcap_errbuf[PCAP_ERRBUF_SIZE];
+		pcap_t* pcap = pcap_open_offline(sendFilePath.data(), pcap_errbuf);
+		if (!pcap)
+		{
+			YANET_LOG_ERROR("benchmark: error: pcap_open_offline(): %s\n", pcap_errbuf);
+			throw "";
+		}
+
+		pcap_pkthdr* header;
+		const u_char* data;
+		while (pcap_next_ex(pcap, &header, &data) >= 0)
+		{
+			if (header->len > common::sock_dev_ring::slot_size_default)
+			{
+				YANET_LOG_WARNING("benchmark: skip packet of %u bytes\n", header->len);
+				continue;
+			}
+
+			/// same as sendThread: truncated packets are padded by zeros
+			auto& frame = frames.emplace_back(header->len, 0);
+			memcpy(frame.data(), data, std::min(header->caplen, header->len));
+		}
+
+		pcap_close(pcap);
+	}
+
+	if (frames.empty())
+	{
+		YANET_LOG_ERROR("benchmark: error: no packets in '%s'\n", sendFilePath.data());
+		throw "";
+	}
+
+	/// switch all ports from stream sockets to shared memory rings
+	std::map<std::string, std::unique_ptr<common::sock_dev_ring::client_t>> clients;
+	for (const auto& port : std::get<0>(dataPlaneConfig))
+	{
+		const auto& portInterfaceName = std::get<0>(port.second);
+		const auto& pci = std::get<3>(port.second);
+
+		close(pcaps[portInterfaceName]);
+		pcaps[portInterfaceName] = -1;
+
+		auto client = std::make_unique<common::sock_dev_ring::client_t>();
+		if (!client->connect(pci.substr(strlen(SOCK_DEV_PREFIX))))
+		{
+			YANET_LOG_ERROR("benchmark: error: could not connect ring of port '%s'\n", portInterfaceName.data());
+			throw "";
+		}
+
+		clients[portInterfaceName] = std::move(client);
+	}
+
+	const auto otherStatsBefore = std::get<0>(dataPlane.getOtherStats());
+	const auto workerStatsBefore = dataPlane.getWorkerStats({});
+
+	std::atomic<bool> stop = false;
+	std::atomic<uint64_t> receivedPackets = 0;
+	std::thread receiveThread([&]() {
+		while (!stop)
+		{
+			uint32_t received = 0;
+			for (const auto& [portInterfaceName, client] : clients)
+			{
+				(void)portInterfaceName;
+
+				const auto& ring = client->from_dataplane();
+				uint32_t count = ring.ready(YANET_CONFIG_BURST_SIZE);
+				ring.release(count);
+				received += count;
+			}
+
+			if (received)
+			{
+				receivedPackets += received;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint64_t sentPackets = 0;
+	const auto& ring = clients[interfaceName]->to_dataplane();
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto stopTime = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(duration));
+	size_t frame_i = 0;
+	while (std::chrono::steady_clock::now() < stopTime)
+	{
+		uint32_t count = ring.reserve(YANET_CONFIG_BURST_SIZE);
+		if (!count)
+		{
+			/// ring is full: dataplane doesn't keep up
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (uint32_t i = 0;
+		     i < count;
+		     i++)
+		{
+			const auto& frame = frames[frame_i];
+			memcpy(ring.reserved_data(i), frame.data(), frame.size());
+			ring.set_reserved_length(i, frame.size());
+
+			if (++frame_i == frames.size())
+			{
+				frame_i = 0;
+			}
+		}
+
+		ring.commit(count);
+		sentPackets += count;
+	}
+	const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	/// wait for packets in flight
+	{
+		const auto drainStopTime = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+		uint64_t lastReceivedPackets = receivedPackets;
+		while (std::chrono::steady_clock::now() < drainStopTime)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			if (receivedPackets == lastReceivedPackets)
+			{
+				break;
+			}
+			lastReceivedPackets = receivedPackets;
+		}
+	}
+
+	const auto otherStatsAfter = std::get<0>(dataPlane.getOtherStats());
+	const auto workerStatsAfter = dataPlane.getWorkerStats({});
+
+	stop = true;
+	receiveThread.join();
+
+	/// switch ports back to stream sockets for next steps
+	clients.clear();
+	for (const auto& port : std::get<0>(dataPlaneConfig))
+	{
+		const auto& portInterfaceName = std::get<0>(port.second);
+		const auto& pci = std::get<3>(port.second);
+
+		int fd = connectSocket(pci);
+		if (fd < 0)
+		{
+			throw "";
+		}
+		pcaps[portInterfaceName] = fd;
+	}
+
+	const double sentPps = sentPackets / elapsed;
+	const double receivedPps = receivedPackets / elapsed;
+
+	printf("benchmark: %s: sent %lu packets (%.0f pps), received %lu packets (%.0f pps) in %.2f seconds\n",
+	       interfaceName.data(),
+	       sentPackets,
+	       sentPps,
+	       receivedPackets.load(),
+	       receivedPps,
+	       elapsed);
+
+	uint64_t totalDrops = 0;
+	for (const auto& [coreId, otherStats] : otherStatsAfter)
+	{
+		const auto& bursts = std::get<0>(otherStats);
+
+		auto it = otherStatsBefore.find(coreId);
+		if (it == otherStatsBefore.end())
+		{
+			continue;
+		}
+		const auto& burstsBefore = std::get<0>(it->second);
+
+		uint64_t iterations = 0;
+		uint64_t packets = 0;
+		std::string distribution;
+		for (size_t burst_i = 0;
+		     burst_i < bursts.size();
+		     burst_i++)
+		{
+			const uint64_t count = bursts[burst_i] - burstsBefore[burst_i];
+			if (!count)
+			{
+				continue;
+			}
+
+			iterations += count;
+			packets += count * burst_i;
+			distribution += " " + std::to_string(burst_i) + ":" + std::to_string(count);
+		}
+
+		uint64_t drops = 0;
+		if (workerStatsBefore.count(coreId) && workerStatsAfter.count(coreId))
+		{
+			drops = dropPackets(std::get<1>(workerStatsAfter.find(coreId)->second)) -
+			        dropPackets(std::get<1>(workerStatsBefore.find(coreId)->second));
+
+			for (const auto& [portId, portStats] : std::get<2>(workerStatsAfter.find(coreId)->second))
+			{
+				const auto& portsStatsBefore = std::get<2>(workerStatsBefore.find(coreId)->second);
+				if (auto port_it = portsStatsBefore.find(portId); port_it != portsStatsBefore.end())
+				{
+					drops += portStats.physicalPort_egress_drops - port_it->second.physicalPort_egress_drops;
+				}
+			}
+		}
+
+		printf("benchmark: core %u: packets %lu, mean burst %.2f, drops %lu, bursts:%s\n",
+		       coreId,
+		       packets,
+		       iterations ? (double)packets / iterations : 0.0,
+		       drops,
+		       distribution.data());
+
+		totalDrops += drops;
+	}
+	fflush(stdout);
+
+	/// throughput with drops is not comparable with baseline
+	if (totalDrops)
+	{
+		YANET_LOG_ERROR("benchmark: error: %lu packets dropped\n", totalDrops);
+		return false;
+	}
+
+	if (std::getenv("YANET_AUTOTEST_BENCHMARK_UPDATE"))
+	{
+		/// tolerance of existing baseline is kept
+		std::optional<double> tolerance;
+		if (std::filesystem::exists(baselineFilePath))
+		{
+			YAML::Node yamlBaseline = YAML::LoadFile(baselineFilePath);
+			if (yamlBaseline["tolerance"])
+			{
+				tolerance = yamlBaseline["tolerance"].as<double>();
+			}
+		}
+
+		std::ofstream baselineFile(baselineFilePath);
+		baselineFile << "pps: " << (uint64_t)receivedPps << std::endl;
+		if (tolerance)
+		{
+			baselineFile << "tolerance: " << *tolerance << std::endl;
+		}
+		if (!baselineFile)
+		{
+			YANET_LOG_ERROR("benchmark: error: could not write '%s'\n", baselineFilePath.data());
+			throw "";
+		}
+
+		YANET_LOG_INFO("benchmark: baseline '%s' updated\n", baselineFilePath.data());
+		return true;
+	}
+
+	if (!std::filesystem::exists(baselineFilePath))
+	{
+		YANET_LOG_INFO("benchmark: no baseline '%s', skip check\n", baselineFilePath.data());
+		return true;
+	}
+
+	YAML::Node yamlBaseline = YAML::LoadFile(baselineFilePath);
+	const double baselinePps = yamlBaseline["pps"].as<double>();
+	const double tolerance = yamlBaseline["tolerance"] ? yamlBaseline["tolerance"].as<double>() : 0.1;
+
+	/// received rate: packets sent but lost in dataplane rings are not counted as processed
+	if (receivedPps < baselinePps * (1.0 - tolerance))
+	{
+		YANET_LOG_ERROR("benchmark: error: %.0f pps is below baseline %.0f pps (tolerance %.2f)\n",
+		                receivedPps,
+		                baselinePps,
+		                tolerance);
+		return false;
+	}
+
+	return true;
+}
+
 void tAutotest::fflushSharedMemory()
 {
 	size_t size = std::get<0>(rawShmInfo);
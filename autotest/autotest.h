@@ -62,6 +62,7 @@ protected:
 	bool step_reload_async(const YAML::Node& yamlStep);
 	bool step_echo(const YAML::Node& yamlStep);
 	bool step_dumpPackets(const YAML::Node& yamlStep, const std::string& path);
+	bool step_benchmark(const YAML::Node& yamlStep, const std::string& path);
 
 	eResult initSockets();
 	eResult initSharedMemory();
@@ -12,10 +12,11 @@ import atexit
 import optparse
 
 class Autotest:
-    def __init__(self, debug, keep, prefix):
+    def __init__(self, debug, keep, prefix, bench):
         self.debug = debug
         self.keep = keep
         self.prefix = prefix
+        self.bench = bench
 
         self.p_dataplane = None
         self.p_controlplane = None
@@ -23,7 +24,7 @@ class Autotest:
 
     def export_path(self):
         if self.prefix:
-            applications = ["dataplane", "controlplane", "cli", "autotest"]
+            applications = ["dataplane", "controlplane", "cli", "autotest", "bench"]
             for application in applications:
                 os.environ["PATH"] += f":{self.prefix}/{application}"
 
@@ -65,7 +66,10 @@ class Autotest:
         self.wait_application("controlplane")
 
     def run_autotest(self, units):
-        command = "yanet-autotest " + " ".join(units)
+        command = "yanet-autotest "
+        if self.bench:
+            command = "yanet-bench "
+        command += " ".join(units)
 
         self.p_autotest = subprocess.Popen(command, shell=True)
 
@@ -104,13 +108,14 @@ def main():
     parser.add_option("-d", "--debug", action="store_true", default=False, dest="debug", help="enable debug mode")
     parser.add_option("-k", "--keep", action="store_true", default=False, dest="keep", help="keep processes running after autotest")
     parser.add_option("--prefix", default="", dest="prefix", help="add prefix for bin path")
+    parser.add_option("--bench", action="store_true", default=False, dest="bench", help="run yanet-bench units instead of autotest")
     opt, args = parser.parse_args()
 
     if len(args) < 1:
         parser.print_help()
         return 1
 
-    autotest = Autotest(opt.debug, opt.keep, opt.prefix)
+    autotest = Autotest(opt.debug, opt.keep, opt.prefix, opt.bench)
 
     atexit.register(autotest.kill_processes)
 
@@ -0,0 +1,674 @@
+#include <arpa/inet.h>
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "common/define.h"
+
+#include "bench.h"
+
+#define SOCK_DEV_PREFIX "sock_dev:"
+
+using namespace bench;
+
+namespace
+{
+
+constexpr uint16_t ether_type_ipv4 = 0x0800;
+constexpr uint16_t ether_type_ipv6 = 0x86DD;
+constexpr uint16_t ether_type_vlan = 0x8100;
+
+enum class packet_type_e : uint32_t
+{
+	ipv4_tcp,
+	ipv4_udp,
+	ipv6_tcp,
+	ipv6_udp,
+	size
+};
+
+struct flow_t
+{
+	packet_type_e type;
+	std::array<uint8_t, 16> source;
+	std::array<uint8_t, 16> destination;
+	uint16_t source_port;
+	uint16_t destination_port;
+};
+
+uint64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool has_suffix(const std::string& string,
+                const std::string& suffix)
+{
+	return string.size() >= suffix.size() &&
+	       string.compare(string.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+uint32_t checksum_add(uint32_t sum,
+                      const void* data,
+                      const uint32_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (uint32_t i = 0;
+	     i + 1 < length;
+	     i += 2)
+	{
+		sum += (bytes[i] << 8) | bytes[i + 1];
+	}
+
+	if (length & 1)
+	{
+		sum += bytes[length - 1] << 8;
+	}
+
+	return sum;
+}
+
+uint16_t checksum_fold(uint32_t sum)
+{
+	while (sum >> 16)
+	{
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	}
+
+	return htons(~sum & 0xFFFF);
+}
+
+/// random address inside prefix, network byte order
+template<typename TGenerator>
+std::array<uint8_t, 16> random_address(const common::ipv4_prefix_t& prefix,
+                                       TGenerator& generator)
+{
+	const uint32_t mask = prefix.mask() ? (0xFFFFFFFFu << (32 - prefix.mask())) : 0;
+	const uint32_t address = htonl((prefix.address() & mask) | (generator() & ~mask));
+
+	std::array<uint8_t, 16> result{};
+	memcpy(result.data(), &address, 4);
+	return result;
+}
+
+template<typename TGenerator>
+std::array<uint8_t, 16> random_address(const common::ipv6_prefix_t& prefix,
+                                       TGenerator& generator)
+{
+	std::array<uint8_t, 16> result = prefix.address();
+	for (unsigned int byte_i = 0;
+	     byte_i < 16;
+	     byte_i++)
+	{
+		const unsigned int bits = byte_i * 8;
+		if (bits + 8 <= prefix.mask())
+		{
+			continue;
+		}
+
+		const uint8_t keep = bits >= prefix.mask() ? 0 : (uint8_t)(0xFF << (8 - (prefix.mask() - bits)));
+		result[byte_i] = (result[byte_i] & keep) | (generator() & ~keep);
+	}
+	return result;
+}
+
+}
+
+bench_t::bench_t() :
+        flag_stop(false),
+        received_packets(0),
+        last_receive_ns(0)
+{
+}
+
+bench_t::~bench_t()
+{
+}
+
+eResult bench_t::init(const std::vector<std::string>& unit_paths)
+{
+	this->unit_paths = unit_paths;
+	return init_clients();
+}
+
+eResult bench_t::init_clients()
+{
+	const auto dataplane_config = dataPlane.getConfig();
+
+	for (const auto& [port_id, port] : std::get<0>(dataplane_config))
+	{
+		(void)port_id;
+
+		const auto& interface_name = std::get<0>(port);
+		const auto& pci = std::get<3>(port);
+
+		if (strncmp(pci.data(), SOCK_DEV_PREFIX, strlen(SOCK_DEV_PREFIX)) != 0)
+		{
+			YANET_LOG_ERROR("error: only sockdev is supported\n");
+			return eResult::errorSocket;
+		}
+
+		auto client = std::make_unique<common::sock_dev_ring::client_t>();
+		if (!client->connect(pci.data() + strlen(SOCK_DEV_PREFIX), {common::sock_dev_ring::slots_count_max, common::sock_dev_ring::slot_size_default}))
+		{
+			YANET_LOG_ERROR("error: could not connect to '%s': %s\n", pci.data(), strerror(errno));
+			return eResult::errorSocket;
+		}
+
+		clients[interface_name] = std::move(client);
+	}
+
+	return eResult::success;
+}
+
+bool bench_t::run()
+{
+	bool result = true;
+
+	for (const auto& unit_path : unit_paths)
+	{
+		YANET_LOG_PRINT("\nbench '%s'\n", unit_path.data());
+
+		try
+		{
+			if (!run_unit(unit_path))
+			{
+				YANET_LOG_ERROR("bench '%s' failed\n", unit_path.data());
+				result = false;
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			YANET_LOG_ERROR("bench '%s' failed: %s\n", unit_path.data(), exception.what());
+			result = false;
+		}
+		catch (const std::string& string)
+		{
+			YANET_LOG_ERROR("bench '%s' failed: %s\n", unit_path.data(), string.data());
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+bool bench_t::run_unit(const std::string& unit_path)
+{
+	const YAML::Node yaml_root = YAML::LoadFile(unit_path + "/bench.yaml");
+
+	traffic_t traffic;
+	if (!parse_traffic(yaml_root, traffic))
+	{
+		return false;
+	}
+
+	if (!load_config(unit_path))
+	{
+		return false;
+	}
+
+	if (!load_routes(yaml_root["routes"]))
+	{
+		return false;
+	}
+
+	/// generate before measure
+	const auto stream = generate(traffic);
+
+	const auto& send_ring = clients[traffic.port]->to_dataplane();
+
+	flag_stop = false;
+	received_packets = 0;
+	last_receive_ns = 0;
+
+	std::vector<std::thread> threads;
+	for (const auto& receive_port : traffic.receive_ports)
+	{
+		threads.emplace_back([this, client = clients[receive_port].get()]() { receive_thread(*client); });
+	}
+
+	const auto profile_before = dataPlane.get_worker_profile();
+	const uint64_t start_ns = now_ns();
+
+	/// frames are copied from stream to slots of ring by bursts
+	uint64_t offset = 0;
+	while (offset < stream.size())
+	{
+		const uint32_t count = send_ring.reserve(YANET_CONFIG_BURST_SIZE);
+		if (!count)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		uint32_t frames_count = 0;
+		for (;
+		     frames_count < count && offset < stream.size();
+		     frames_count++)
+		{
+			uint32_t length;
+			memcpy(&length, stream.data() + offset, sizeof(length));
+			length = ntohl(length);
+
+			if (length > send_ring.get_slot_size())
+			{
+				YANET_LOG_ERROR("error: frame of %u bytes does not fit in slot of ring\n", length);
+				flag_stop = true;
+				break;
+			}
+
+			memcpy(send_ring.reserved_data(frames_count), stream.data() + offset + sizeof(length), length);
+			send_ring.set_reserved_length(frames_count, length);
+			offset += sizeof(length) + length;
+		}
+
+		send_ring.commit(frames_count);
+
+		if (flag_stop)
+		{
+			break;
+		}
+	}
+
+	/// wait for all packets or one second without progress
+	uint64_t prev_received_packets = 0;
+	uint64_t prev_progress_ns = now_ns();
+	while (!flag_stop)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		const uint64_t current_received_packets = received_packets;
+		if (current_received_packets >= traffic.packets_count)
+		{
+			break;
+		}
+
+		if (current_received_packets != prev_received_packets)
+		{
+			prev_received_packets = current_received_packets;
+			prev_progress_ns = now_ns();
+		}
+		else if (now_ns() - prev_progress_ns > 1000ull * 1000 * 1000)
+		{
+			break;
+		}
+	}
+
+	flag_stop = true;
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	const auto profile_after = dataPlane.get_worker_profile();
+
+	const uint64_t end_ns = last_receive_ns ? (uint64_t)last_receive_ns : now_ns();
+	report(traffic, end_ns - start_ns, profile_before, profile_after);
+
+	return offset == stream.size();
+}
+
+bool bench_t::load_config(const std::string& unit_path)
+{
+	namespace fs = std::filesystem;
+
+	common::icp::loadConfig::request request;
+
+	std::ifstream from_file_stream(fs::path(unit_path).append("controlplane.conf"));
+	std::get<0>(request) = fs::path(unit_path).append("controlplane.conf");
+	std::get<1>(request) = std::string((std::istreambuf_iterator<char>(from_file_stream)), std::istreambuf_iterator<char>());
+
+	for (const auto& entry : fs::directory_iterator(unit_path))
+	{
+		if (has_suffix(entry.path().string(), ".conf"))
+		{
+			std::ifstream conf_file_stream(entry.path().string());
+			std::get<2>(request)[entry.path().string()] = std::string((std::istreambuf_iterator<char>(conf_file_stream)), std::istreambuf_iterator<char>());
+		}
+	}
+
+	const auto result = controlPlane.loadConfig(request);
+	if (result != eResult::success)
+	{
+		YANET_LOG_ERROR("invalid config: eResult %d\n", static_cast<std::uint32_t>(result));
+		return false;
+	}
+
+	return true;
+}
+
+bool bench_t::load_routes(const YAML::Node& yaml_routes)
+{
+	controlPlane.rib_update({common::icp::rib_update::clear("bench", std::nullopt)});
+
+	if (yaml_routes)
+	{
+		/// "prefix -> nexthop"
+		for (const auto& yaml_route : yaml_routes)
+		{
+			const std::string string = yaml_route.as<std::string>();
+			const auto delimiter = string.find(" -> ");
+			if (delimiter == std::string::npos)
+			{
+				YANET_LOG_ERROR("invalid route: '%s'\n", string.data());
+				return false;
+			}
+
+			const common::ip_prefix_t prefix(string.substr(0, delimiter));
+			const common::ip_address_t nexthop(string.substr(delimiter + 4));
+
+			common::icp::rib_update::insert request = {"bench", "default", YANET_RIB_PRIORITY_DEFAULT, {}};
+			std::get<3>(request)[{{}, "incomplete", 0, {}, {}, {}, 0}][prefix.is_ipv4() ? "ipv4" : "ipv6"][nexthop].emplace_back(prefix,
+			                                                                                                                    "0",
+			                                                                                                                    std::vector<uint32_t>());
+			controlPlane.rib_update({request});
+		}
+	}
+
+	controlPlane.rib_flush();
+	return true;
+}
+
+bool bench_t::parse_traffic(const YAML::Node& yaml_root,
+                            traffic_t& traffic)
+{
+	if (!yaml_root["port"])
+	{
+		YANET_LOG_ERROR("bench.yaml: 'port' is required\n");
+		return false;
+	}
+
+	traffic.port = yaml_root["port"].as<std::string>();
+	if (!clients.count(traffic.port))
+	{
+		YANET_LOG_ERROR("bench.yaml: unknown port '%s'\n", traffic.port.data());
+		return false;
+	}
+
+	if (yaml_root["receive"])
+	{
+		for (const auto& yaml_port : yaml_root["receive"])
+		{
+			traffic.receive_ports.emplace_back(yaml_port.as<std::string>());
+			if (!clients.count(traffic.receive_ports.back()))
+			{
+				YANET_LOG_ERROR("bench.yaml: unknown port '%s'\n", traffic.receive_ports.back().data());
+				return false;
+			}
+		}
+	}
+	else
+	{
+		traffic.receive_ports.emplace_back(traffic.port);
+	}
+
+	traffic.destination_mac = yaml_root["destination_mac"].as<std::string>("00:11:22:33:44:55");
+	if (yaml_root["vlan"])
+	{
+		traffic.vlan_id = yaml_root["vlan"].as<uint16_t>();
+	}
+
+	traffic.packets_count = yaml_root["packets"].as<uint64_t>(1024 * 1024);
+	traffic.packet_size = yaml_root["packet_size"].as<uint32_t>(64);
+	traffic.flows_count = std::max(1u, yaml_root["flows"].as<uint32_t>(1024));
+	traffic.zipf = yaml_root["zipf"].as<double>(0.0);
+	traffic.seed = yaml_root["seed"].as<uint32_t>(1);
+
+	traffic.mix = {1, 0, 0, 0};
+	if (const auto& yaml_mix = yaml_root["mix"])
+	{
+		traffic.mix = {yaml_mix["ipv4_tcp"].as<uint32_t>(0),
+		               yaml_mix["ipv4_udp"].as<uint32_t>(0),
+		               yaml_mix["ipv6_tcp"].as<uint32_t>(0),
+		               yaml_mix["ipv6_udp"].as<uint32_t>(0)};
+	}
+
+	if (!traffic.mix[0] &&
+	    !traffic.mix[1] &&
+	    !traffic.mix[2] &&
+	    !traffic.mix[3])
+	{
+		YANET_LOG_ERROR("bench.yaml: empty 'mix'\n");
+		return false;
+	}
+
+	traffic.ipv4_source = yaml_root["ipv4_source"].as<std::string>("10.0.0.0/8");
+	traffic.ipv4_destination = yaml_root["ipv4_destination"].as<std::string>("1.0.0.0/8");
+	traffic.ipv6_source = yaml_root["ipv6_source"].as<std::string>("2000::/16");
+	traffic.ipv6_destination = yaml_root["ipv6_destination"].as<std::string>("2001::/16");
+
+	return true;
+}
+
+std::vector<uint8_t> bench_t::generate(const traffic_t& traffic)
+{
+	std::mt19937 generator(traffic.seed);
+
+	/// flows
+	std::vector<flow_t> flows(traffic.flows_count);
+	{
+		std::discrete_distribution<uint32_t> type_distribution(traffic.mix.begin(), traffic.mix.end());
+		for (auto& flow : flows)
+		{
+			flow.type = (packet_type_e)type_distribution(generator);
+			if (flow.type == packet_type_e::ipv4_tcp ||
+			    flow.type == packet_type_e::ipv4_udp)
+			{
+				flow.source = random_address(traffic.ipv4_source, generator);
+				flow.destination = random_address(traffic.ipv4_destination, generator);
+			}
+			else
+			{
+				flow.source = random_address(traffic.ipv6_source, generator);
+				flow.destination = random_address(traffic.ipv6_destination, generator);
+			}
+
+			flow.source_port = 1024 + generator() % (65536 - 1024);
+			flow.destination_port = 1 + generator() % 1023;
+		}
+	}
+
+	/// zipf: weight of flow with rank i is 1 / (i + 1)^s
+	std::vector<double> weights(traffic.flows_count);
+	for (uint32_t flow_i = 0;
+	     flow_i < traffic.flows_count;
+	     flow_i++)
+	{
+		weights[flow_i] = 1.0 / std::pow(flow_i + 1, traffic.zipf);
+	}
+	std::discrete_distribution<uint32_t> flow_distribution(weights.begin(), weights.end());
+
+	std::vector<uint8_t> stream;
+	stream.reserve(traffic.packets_count * (sizeof(uint32_t) + std::max(traffic.packet_size, 128u)));
+
+	uint8_t frame[16384];
+	for (uint64_t packet_i = 0;
+	     packet_i < traffic.packets_count;
+	     packet_i++)
+	{
+		const auto& flow = flows[flow_distribution(generator)];
+		const bool is_ipv4 = flow.type == packet_type_e::ipv4_tcp || flow.type == packet_type_e::ipv4_udp;
+		const bool is_tcp = flow.type == packet_type_e::ipv4_tcp || flow.type == packet_type_e::ipv6_tcp;
+
+		memset(frame, 0, sizeof(frame));
+
+		/// ethernet
+		uint32_t offset = 0;
+		memcpy(frame, ((const std::array<uint8_t, 6>&)traffic.destination_mac).data(), 6);
+		memcpy(frame + 6, "\x00\x00\x00\x00\x00\x01", 6);
+		offset += 12;
+
+		if (traffic.vlan_id)
+		{
+			*(uint16_t*)(frame + offset) = htons(ether_type_vlan);
+			*(uint16_t*)(frame + offset + 2) = htons(*traffic.vlan_id & 0x0FFF);
+			offset += 4;
+		}
+
+		*(uint16_t*)(frame + offset) = htons(is_ipv4 ? ether_type_ipv4 : ether_type_ipv6);
+		offset += 2;
+
+		const uint32_t network_offset = offset;
+		const uint32_t network_header_size = is_ipv4 ? sizeof(iphdr) : sizeof(ip6_hdr);
+		const uint32_t transport_offset = network_offset + network_header_size;
+		const uint32_t transport_header_size = is_tcp ? sizeof(tcphdr) : sizeof(udphdr);
+		const uint32_t frame_size = std::min<uint32_t>(std::max(traffic.packet_size, transport_offset + transport_header_size), sizeof(frame));
+		const uint32_t transport_size = frame_size - transport_offset;
+
+		/// transport
+		uint32_t pseudo_sum = 0;
+		if (is_ipv4)
+		{
+			iphdr* header = (iphdr*)(frame + network_offset);
+			header->version = 4;
+			header->ihl = 5;
+			header->tot_len = htons(network_header_size + transport_size);
+			header->id = htons(packet_i & 0xFFFF);
+			header->ttl = 64;
+			header->protocol = is_tcp ? IPPROTO_TCP : IPPROTO_UDP;
+			memcpy(&header->saddr, flow.source.data(), 4);
+			memcpy(&header->daddr, flow.destination.data(), 4);
+			header->check = checksum_fold(checksum_add(0, header, sizeof(*header)));
+
+			pseudo_sum = checksum_add(pseudo_sum, &header->saddr, 8);
+		}
+		else
+		{
+			ip6_hdr* header = (ip6_hdr*)(frame + network_offset);
+			header->ip6_flow = htonl(0x60000000);
+			header->ip6_plen = htons(transport_size);
+			header->ip6_nxt = is_tcp ? IPPROTO_TCP : IPPROTO_UDP;
+			header->ip6_hlim = 64;
+			memcpy(&header->ip6_src, flow.source.data(), 16);
+			memcpy(&header->ip6_dst, flow.destination.data(), 16);
+
+			pseudo_sum = checksum_add(pseudo_sum, &header->ip6_src, 32);
+		}
+		pseudo_sum += (is_tcp ? IPPROTO_TCP : IPPROTO_UDP) + transport_size;
+
+		if (is_tcp)
+		{
+			tcphdr* header = (tcphdr*)(frame + transport_offset);
+			header->source = htons(flow.source_port);
+			header->dest = htons(flow.destination_port);
+			header->seq = htonl(packet_i);
+			header->doff = 5;
+			header->ack = 1;
+			header->window = htons(8192);
+			header->check = checksum_fold(checksum_add(pseudo_sum, header, transport_size));
+		}
+		else
+		{
+			udphdr* header = (udphdr*)(frame + transport_offset);
+			header->source = htons(flow.source_port);
+			header->dest = htons(flow.destination_port);
+			header->len = htons(transport_size);
+			header->check = checksum_fold(checksum_add(pseudo_sum, header, transport_size));
+		}
+
+		const uint32_t length = htonl(frame_size);
+		stream.insert(stream.end(), (const uint8_t*)&length, (const uint8_t*)&length + sizeof(length));
+		stream.insert(stream.end(), frame, frame + frame_size);
+	}
+
+	return stream;
+}
+
+void bench_t::receive_thread(const common::sock_dev_ring::client_t& client)
+{
+	const auto& ring = client.from_dataplane();
+
+	while (!flag_stop)
+	{
+		const uint32_t frames_count = ring.ready(YANET_CONFIG_BURST_SIZE);
+		if (!frames_count)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		ring.release(frames_count);
+
+		received_packets += frames_count;
+		last_receive_ns = now_ns();
+	}
+}
+
+void bench_t::report(const traffic_t& traffic,
+                     const uint64_t duration_ns,
+                     const common::idp::get_worker_profile::response& profile_before,
+                     const common::idp::get_worker_profile::response& profile_after)
+{
+	const uint64_t received = received_packets;
+	const double seconds = (double)duration_ns / (1000.0 * 1000.0 * 1000.0);
+
+	YANET_LOG_PRINT("packets: sent %lu, received %lu\n", traffic.packets_count, received);
+	YANET_LOG_PRINT("duration: %.3f s\n", seconds);
+	YANET_LOG_PRINT("rate: %.3f Mpps\n", seconds > 0 ? (double)received / seconds / 1000000.0 : 0.0);
+
+	if (profile_after.empty())
+	{
+		YANET_LOG_PRINT("stages: dataplane is built without 'worker_profile' option\n");
+		return;
+	}
+
+	/// sum of all workers
+	std::map<std::string, std::tuple<uint64_t, uint64_t, uint64_t>> stages;
+	for (const auto& [core_id, stages_after] : profile_after)
+	{
+		for (const auto& [stage, stats_after] : stages_after)
+		{
+			auto stats_before = std::make_tuple<uint64_t, uint64_t, uint64_t>(0, 0, 0);
+			if (auto it = profile_before.find(core_id); it != profile_before.end())
+			{
+				if (auto stage_it = it->second.find(stage); stage_it != it->second.end())
+				{
+					stats_before = stage_it->second;
+				}
+			}
+
+			auto& [cycles, invocations, packets] = stages[stage];
+			cycles += std::get<0>(stats_after) - std::get<0>(stats_before);
+			invocations += std::get<1>(stats_after) - std::get<1>(stats_before);
+			packets += std::get<2>(stats_after) - std::get<2>(stats_before);
+		}
+	}
+
+	uint64_t total_cycles = 0;
+	for (const auto& [stage, stats] : stages)
+	{
+		(void)stage;
+		total_cycles += std::get<0>(stats);
+	}
+
+	YANET_LOG_PRINT("%-32s %12s %12s %12s %8s\n", "stage", "invocations", "packets", "cycles/pkt", "share");
+	for (const auto& [stage, stats] : stages)
+	{
+		const auto& [cycles, invocations, packets] = stats;
+		if (!invocations)
+		{
+			continue;
+		}
+
+		YANET_LOG_PRINT("%-32s %12lu %12lu %12.1f %7.1f%%\n",
+		                stage.data(),
+		                invocations,
+		                packets,
+		                packets ? (double)cycles / packets : 0.0,
+		                total_cycles ? 100.0 * cycles / total_cycles : 0.0);
+	}
+
+	YANET_LOG_PRINT("%-32s %12s %12lu %12.1f\n",
+	                "total",
+	                "",
+	                received,
+	                received ? (double)total_cycles / received : 0.0);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "common/icontrolplane.h"
+#include "common/idataplane.h"
+#include "common/result.h"
+#include "common/sock_dev_ring.h"
+
+namespace bench
+{
+
+/// synthetic traffic of one bench unit, see bench.yaml
+struct traffic_t
+{
+	std::string port; ///< interfaceName to send
+	std::vector<std::string> receive_ports;
+
+	common::mac_address_t destination_mac;
+	std::optional<uint16_t> vlan_id;
+
+	uint64_t packets_count;
+	uint32_t packet_size; ///< without fcs
+	uint32_t flows_count;
+	double zipf; ///< 0: uniform
+
+	/// weights of ipv4_tcp, ipv4_udp, ipv6_tcp, ipv6_udp
+	std::array<uint32_t, 4> mix;
+
+	common::ipv4_prefix_t ipv4_source;
+	common::ipv4_prefix_t ipv4_destination;
+	common::ipv6_prefix_t ipv6_source;
+	common::ipv6_prefix_t ipv6_destination;
+
+	uint32_t seed;
+};
+
+/// drives dataplane built with sock_dev ports by pre-generated bursts, through shared memory rings of sock_dev.
+/// controlplane.conf of each unit is loaded into running controlplane, so globalBase is built by regular code path.
+/// reports Mpps measured on sock_dev and, if dataplane is built with 'worker_profile' option, cycles per packet of each worker stage
+class bench_t
+{
+public:
+	bench_t();
+	~bench_t();
+
+	eResult init(const std::vector<std::string>& unit_paths);
+
+	/// returns false, if any unit failed
+	bool run();
+
+protected:
+	eResult init_clients();
+
+	bool run_unit(const std::string& unit_path);
+
+	bool load_config(const std::string& unit_path);
+	bool load_routes(const YAML::Node& yaml_routes);
+	bool parse_traffic(const YAML::Node& yaml_root, traffic_t& traffic);
+
+	/// frames in sock_dev stream format: be32 length, then ethernet frame
+	std::vector<uint8_t> generate(const traffic_t& traffic);
+
+	void receive_thread(const common::sock_dev_ring::client_t& client);
+
+	void report(const traffic_t& traffic,
+	            const uint64_t duration_ns,
+	            const common::idp::get_worker_profile::response& profile_before,
+	            const common::idp::get_worker_profile::response& profile_after);
+
+protected:
+	std::vector<std::string> unit_paths;
+
+	interface::dataPlane dataPlane;
+	interface::controlPlane controlPlane;
+
+	std::map<std::string, ///< interfaceName
+	         std::unique_ptr<common::sock_dev_ring::client_t>>
+	        clients;
+
+	std::vector<std::tuple<common::ip_prefix_t,
+	                       common::ip_address_t>>
+	        routes; ///< inserted by current unit
+
+	std::atomic<bool> flag_stop;
+	std::atomic<uint64_t> received_packets;
+	std::atomic<uint64_t> last_receive_ns;
+};
+
+}
@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+#include "common/define.h"
+#include "dataplane/lpm.h"
+
+#include "lpm.h"
+
+namespace
+{
+
+uint32_t ipv4(const std::string& string)
+{
+	return common::ipv4_address_t(string);
+}
+
+uint64_t elapsed_ns(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<std::tuple<uint32_t, uint8_t>> full_view_prefixes4()
+{
+	std::vector<std::tuple<uint32_t, uint8_t>> prefixes;
+
+	std::ifstream stream("networks4.txt");
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		auto pos = line.find('/');
+		if (pos == std::string::npos)
+		{
+			prefixes.emplace_back(ipv4(line), 32);
+			continue;
+		}
+
+		const uint8_t mask = std::stoi(line.substr(pos + 1));
+		prefixes.emplace_back(ipv4(line.substr(0, pos)) & (mask ? (0xFFFFFFFFu << (32 - mask)) : 0), mask);
+	}
+
+	if (!prefixes.empty())
+	{
+		return prefixes;
+	}
+
+	/// masks share of ipv4 full view, per mille
+	const std::vector<std::tuple<uint8_t, uint32_t>> masks = {{8, 1}, {12, 1}, {14, 2}, {15, 2}, {16, 14}, {17, 8}, {18, 14}, {19, 24}, {20, 40}, {21, 50}, {22, 120}, {23, 110}, {24, 610}, {25, 1}, {26, 1}, {27, 1}, {28, 1}};
+
+	std::mt19937 generator(42);
+	for (const auto& [mask, share] : masks)
+	{
+		for (uint32_t i = 0; i < share * 1000; i++)
+		{
+			/// allocated space is clustered: /24s gather in a few /16s
+			const uint32_t block = 0x01000000 + (generator() % (0xDF000000 / 0x00100000)) * 0x00100000;
+			const uint32_t ipAddress = block | (generator() & 0x000FFFFF);
+			prefixes.emplace_back(ipAddress & (0xFFFFFFFFu << (32 - mask)), mask);
+		}
+	}
+
+	return prefixes;
+}
+
+std::vector<std::tuple<std::array<uint8_t, 16>, uint8_t>> full_view_prefixes6()
+{
+	std::vector<std::tuple<std::array<uint8_t, 16>, uint8_t>> prefixes;
+
+	std::ifstream stream("networks6.txt");
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		const common::ipv6_prefix_t prefix(line);
+		prefixes.emplace_back(prefix.address(), prefix.mask());
+	}
+
+	if (!prefixes.empty())
+	{
+		return prefixes;
+	}
+
+	/// masks share of ipv6 full view, per mille
+	const std::vector<std::tuple<uint8_t, uint32_t>> masks = {{28, 10}, {29, 30}, {30, 5}, {31, 5}, {32, 130}, {33, 10}, {34, 10}, {35, 5}, {36, 40}, {38, 10}, {40, 80}, {42, 10}, {44, 90}, {45, 10}, {46, 20}, {47, 15}, {48, 510}, {56, 5}, {64, 5}};
+
+	std::mt19937 generator(42);
+
+	/// allocated space is clustered: more specifics gather in few thousands of /32 of few /16
+	std::vector<uint32_t> allocations(8 * 1024);
+	for (auto& allocation : allocations)
+	{
+		allocation = ((0x2001 + 0x100 * (generator() % 12) + generator() % 16) << 16) | (generator() & 0xFFFF);
+	}
+
+	for (const auto& [mask, share] : masks)
+	{
+		for (uint32_t i = 0; i < share * 200; i++)
+		{
+			std::array<uint8_t, 16> address{};
+			const uint32_t high = allocations[generator() % allocations.size()];
+			const uint32_t low = generator();
+			*(uint32_t*)&address[0] = rte_cpu_to_be_32(high);
+			*(uint32_t*)&address[4] = rte_cpu_to_be_32(low);
+
+			for (unsigned int bit_i = mask; bit_i < 128; bit_i++)
+			{
+				address[bit_i / 8] &= ~(0x80 >> (bit_i % 8));
+			}
+
+			prefixes.emplace_back(address, mask);
+		}
+	}
+
+	return prefixes;
+}
+
+/// returns count of inserted prefixes, stops on first failure
+template<typename lpm_T,
+         typename prefixes_T,
+         typename address_T>
+unsigned int full_view(const char* name,
+                       const prefixes_T& prefixes,
+                       const std::vector<address_T>& addresses,
+                       std::vector<uint32_t>& values)
+{
+	auto lpm = std::make_unique<lpm_T>();
+
+	auto start = std::chrono::steady_clock::now();
+	unsigned int inserted = 0;
+	for (const auto& [address, mask] : prefixes)
+	{
+		if (lpm->insert(address, mask, inserted % 1024) != eResult::success)
+		{
+			break;
+		}
+
+		inserted++;
+	}
+	const auto insert_ns = elapsed_ns(start);
+
+	values.resize(addresses.size());
+
+	start = std::chrono::steady_clock::now();
+	for (unsigned int address_i = 0;
+	     address_i + CONFIG_YADECAP_MBUFS_BURST_SIZE <= addresses.size();
+	     address_i += CONFIG_YADECAP_MBUFS_BURST_SIZE)
+	{
+		lpm->lookup(&addresses[address_i], &values[address_i], CONFIG_YADECAP_MBUFS_BURST_SIZE);
+	}
+	const auto lookup_ns = elapsed_ns(start);
+
+	YANET_LOG_PRINT("%s: %lu MB, %u/%lu prefixes, %lu extended chunks, insert %.1f ns/prefix, lookup %.1f ns/address (%.1f Mpps)\n",
+	                name,
+	                sizeof(lpm_T) / (1024 * 1024),
+	                inserted,
+	                prefixes.size(),
+	                lpm->getStats().extendedChunksCount,
+	                (double)insert_ns / RTE_MAX(inserted, 1u),
+	                (double)lookup_ns / addresses.size(),
+	                addresses.size() * 1000.0 / lookup_ns);
+
+	return inserted;
+}
+
+bool full_view4()
+{
+	using atomic_t = dataplane::lpm4_24bit_8bit_atomic<CONFIG_YADECAP_LPM4_EXTENDED_SIZE>;
+	using compressed_t = dataplane::lpm4_16bit_2x8bit_compressed<YANET_CONFIG_ROUTE_LPM4_COMPRESSED_NODES_SIZE,
+	                                                             YANET_CONFIG_ROUTE_LPM4_COMPRESSED_ENTRIES_SIZE>;
+
+	auto prefixes = full_view_prefixes4();
+
+	/// insertion order matters
+	std::stable_sort(prefixes.begin(), prefixes.end(), [](const auto& a, const auto& b) {
+		return std::get<1>(a) < std::get<1>(b);
+	});
+
+	std::mt19937 generator(7);
+	std::vector<uint32_t> addresses(16 * 1024 * 1024);
+	for (auto& address : addresses)
+	{
+		address = rte_cpu_to_be_32(generator());
+	}
+
+	std::vector<uint32_t> atomic_values;
+	std::vector<uint32_t> compressed_values;
+
+	const auto atomic_inserted = full_view<atomic_t>("lpm4_24bit_8bit_atomic", prefixes, addresses, atomic_values);
+	const auto compressed_inserted = full_view<compressed_t>("lpm4_16bit_2x8bit_compressed", prefixes, addresses, compressed_values);
+
+	if (atomic_inserted != prefixes.size() ||
+	    compressed_inserted != prefixes.size())
+	{
+		YANET_LOG_ERROR("lpm4: full view doesn't fit\n");
+		return false;
+	}
+
+	if (atomic_values != compressed_values)
+	{
+		YANET_LOG_ERROR("lpm4: lookups differ\n");
+		return false;
+	}
+
+	return true;
+}
+
+bool full_view6()
+{
+	using atomic_t = dataplane::lpm6_8x16bit_atomic<CONFIG_YADECAP_LPM6_EXTENDED_SIZE>;
+	using compressed_t = dataplane::lpm6_16bit_14x8bit_compressed<YANET_CONFIG_ROUTE_LPM6_COMPRESSED_NODES_SIZE,
+	                                                              YANET_CONFIG_ROUTE_LPM6_COMPRESSED_ENTRIES_SIZE>;
+
+	auto prefixes = full_view_prefixes6();
+
+	/// insertion order matters
+	std::stable_sort(prefixes.begin(), prefixes.end(), [](const auto& a, const auto& b) {
+		return std::get<1>(a) < std::get<1>(b);
+	});
+
+	/// destinations inside routed prefixes, so lookups walk down to prefix length
+	const auto generate_addresses = [](const auto& prefixes) {
+		std::mt19937 generator(7);
+		std::vector<ipv6_address_t> addresses(4 * 1024 * 1024);
+		for (auto& address : addresses)
+		{
+			const auto& [ipv6Address, mask] = prefixes[generator() % prefixes.size()];
+			memcpy(address.bytes, ipv6Address.data(), 16);
+			for (unsigned int byte_i = mask / 8; byte_i < 16; byte_i++)
+			{
+				address.bytes[byte_i] |= generator() & (0xFF >> (byte_i == mask / 8 ? mask % 8 : 0));
+			}
+		}
+
+		return addresses;
+	};
+
+	std::vector<uint32_t> compressed_values;
+	const auto addresses = generate_addresses(prefixes);
+	if (full_view<compressed_t>("lpm6_16bit_14x8bit_compressed", prefixes, addresses, compressed_values) != prefixes.size())
+	{
+		YANET_LOG_ERROR("lpm6: full view doesn't fit\n");
+		return false;
+	}
+
+	/// same lookups over part of view which fits into lpm6_8x16bit_atomic
+	std::vector<uint32_t> atomic_values;
+	prefixes.resize(full_view<atomic_t>("lpm6_8x16bit_atomic", prefixes, addresses, atomic_values));
+
+	const auto part_addresses = generate_addresses(prefixes);
+	full_view<atomic_t>("lpm6_8x16bit_atomic (part)", prefixes, part_addresses, atomic_values);
+	full_view<compressed_t>("lpm6_16bit_14x8bit_compressed (part)", prefixes, part_addresses, compressed_values);
+
+	if (atomic_values != compressed_values)
+	{
+		YANET_LOG_ERROR("lpm6: lookups differ\n");
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+bool bench::lpm::full_view()
+{
+	YANET_LOG_PRINT("\nbench 'lpm full view'\n");
+
+	bool success = true;
+	success &= full_view4();
+	success &= full_view6();
+	return success;
+}
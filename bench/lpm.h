@@ -0,0 +1,12 @@
+#pragma once
+
+namespace bench::lpm
+{
+
+/// insert and lookup rates of route lpms on full view.
+/// prefixes are read from 'networks4.txt' and 'networks6.txt' (one 'address/mask' per line) of current directory,
+/// or generated with masks distribution of full view.
+/// returns false, if lpms give different lookups
+bool full_view();
+
+}
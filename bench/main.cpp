@@ -0,0 +1,52 @@
+#include <signal.h>
+
+#include "common/define.h"
+#include "common/result.h"
+
+#include "bench.h"
+#include "lpm.h"
+#include "reassembly.h"
+
+common::log::LogPriority common::log::logPriority = common::log::TLOG_INFO;
+
+bench::bench_t bench_instance;
+
+int main(int argc,
+         char** argv)
+{
+	if (argc < 2)
+	{
+		YANET_LOG_PRINT("usage: %s [unit_path ...]\n", argv[0]);
+		YANET_LOG_PRINT("       %s lpm\n", argv[0]);
+		YANET_LOG_PRINT("       %s reassembly\n", argv[0]);
+		return 1;
+	}
+
+	if (std::string(argv[1]) == "lpm")
+	{
+		return bench::lpm::full_view() ? 0 : 4;
+	}
+
+	if (std::string(argv[1]) == "reassembly")
+	{
+		return bench::reassembly::flood() ? 0 : 4;
+	}
+
+	if (signal(SIGPIPE, SIG_IGN) == SIG_ERR)
+	{
+		return 3;
+	}
+
+	std::vector<std::string> args(argv + 1, argv + argc);
+	if (bench_instance.init(args) != eResult::success)
+	{
+		return 2;
+	}
+
+	if (!bench_instance.run())
+	{
+		return 4;
+	}
+
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "common/define.h"
+#include "dataplane/reassembly.h"
+
+#include "reassembly.h"
+
+namespace
+{
+
+struct key_t
+{
+	uint32_t source;
+	uint32_t destination;
+	uint32_t packet_id;
+};
+
+using table_t = dataplane::reassembly_t<key_t, uint32_t>;
+using result_e = table_t::result_e;
+
+key_t make_key(const uint32_t packet_id)
+{
+	return {0x0A000001, 0x0A000002, packet_id};
+}
+
+uint64_t elapsed_ns(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// every fragment opens new flow which never completes
+bool flood_new_flows()
+{
+	constexpr uint32_t size = 1024;
+	constexpr uint32_t count = 4 * 1024 * 1024;
+
+	table_t table(size, 64, 32, 16);
+
+	uint64_t overflows = 0;
+	uint64_t expired = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t flow_id;
+		if (table.insert(make_key(i), 0, 7, i, i / (count / 64), flow_id) == result_e::overflow)
+		{
+			overflows++;
+		}
+
+		table.expire(i / (count / 64), [&](uint32_t) {
+			expired++;
+		});
+	}
+	const auto duration = elapsed_ns(start);
+
+	YANET_LOG_PRINT("flood new flows: %.1f ns/fragment, overflows: %lu, expired: %lu\n",
+	                (double)duration / count,
+	                overflows,
+	                expired);
+
+	if (count != overflows + expired + table.get_packets_count())
+	{
+		YANET_LOG_ERROR("flood new flows: fragments lost\n");
+		return false;
+	}
+
+	return true;
+}
+
+/// tiny and overlapping fragments of few flows
+bool flood_tiny_overlapping()
+{
+	constexpr uint32_t size = 4096;
+	constexpr uint32_t flows = 16;
+	constexpr uint32_t count = 4 * 1024 * 1024;
+
+	table_t table(size, 64, 32, 16);
+
+	uint64_t inserted = 0;
+	uint64_t intersects = 0;
+	uint64_t flow_overflows = 0;
+	uint64_t overflows = 0;
+
+	std::mt19937 generator(42);
+	std::vector<uint32_t> offsets(count);
+	for (auto& offset : offsets)
+	{
+		offset = (generator() % 1024) * 8;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		/// 8 bytes fragments, every second one overlaps with neighbor
+		const uint32_t range_from = offsets[i] + (i % 2) * 4;
+
+		uint32_t flow_id;
+		switch (table.insert(make_key(i % flows), range_from, range_from + 7, i, 0, flow_id))
+		{
+			case result_e::inserted:
+				inserted++;
+				break;
+			case result_e::intersect:
+				intersects++;
+				break;
+			case result_e::flow_overflow:
+				flow_overflows++;
+				break;
+			case result_e::overflow:
+				overflows++;
+				break;
+			case result_e::collected:
+				break;
+		}
+	}
+	const auto duration = elapsed_ns(start);
+
+	YANET_LOG_PRINT("flood tiny overlapping fragments: %.1f ns/fragment, inserted: %lu, intersects: %lu, flow_overflows: %lu, overflows: %lu\n",
+	                (double)duration / count,
+	                inserted,
+	                intersects,
+	                flow_overflows,
+	                overflows);
+
+	if (count != inserted + intersects + flow_overflows + overflows ||
+	    inserted != table.get_packets_count())
+	{
+		YANET_LOG_ERROR("flood tiny overlapping fragments: fragments lost\n");
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+bool bench::reassembly::flood()
+{
+	YANET_LOG_PRINT("\nbench 'reassembly flood'\n");
+
+	bool success = true;
+	success &= flood_new_flows();
+	success &= flood_tiny_overlapping();
+	return success;
+}
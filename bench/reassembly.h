@@ -0,0 +1,10 @@
+#pragma once
+
+namespace bench::reassembly
+{
+
+/// insert rate of fragment reassembly table under fragment floods.
+/// returns false, if table loses or leaks fragments
+bool flood();
+
+}
@@ -85,6 +85,7 @@ std::vector<std::tuple<std::string,
                     {"limit", "", [](const auto& args) { call(limit::summary, args); }},
                     {"values", "", [](const auto& args) { call(show::values, args); }},
                     {"durations", "", [](const auto& args) { call(show::durations, args); }},
+                    {"worker profile", "", [](const auto& args) { call(show::worker_profile, args); }},
                     {"dump", "[in|out|drop] [interface_name] [enable|disable]", [](const auto& args) { call(show::physical_port_dump, args); }},
                     {},
                     {"show errors", "", [](const auto& args) { call(show::errors, args); }},
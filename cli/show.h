@@ -743,6 +743,41 @@ void durations()
 	table.print();
 }
 
+void worker_profile()
+{
+	interface::dataPlane dataplane;
+	const auto worker_profile = dataplane.get_worker_profile();
+
+	table_t table;
+	table.insert("core_id",
+	             "stage",
+	             "invocations",
+	             "packets",
+	             "cycles",
+	             "cycles_per_packet");
+
+	for (const auto& [core_id, stages] : worker_profile)
+	{
+		for (const auto& [stage, stats] : stages)
+		{
+			const auto& [cycles, invocations, packets] = stats;
+			if (!invocations)
+			{
+				continue;
+			}
+
+			table.insert(core_id,
+			             stage,
+			             invocations,
+			             packets,
+			             cycles,
+			             packets ? cycles / packets : 0);
+		}
+	}
+
+	table.print();
+}
+
 void version()
 {
 	table_t table;
@@ -98,7 +98,7 @@ void unsafe()
 	interface::controlPlane controlplane;
 	interface::dataPlane dataplane;
 	const auto [responseWorkers, responseWorkerGCs, responseSlowWorkerHashtableGC, responseFragmentation, responseFWState, responseTun64, response_nat64stateful, responseControlplane] = controlplane.telegraf_unsafe();
-	const auto& [responseSlowWorker, hashtable_gc] = responseSlowWorkerHashtableGC;
+	const auto& [responseSlowWorker, hashtable_gc, responseSlowWorkers] = responseSlowWorkerHashtableGC;
 
 	const auto static_counters = dataplane.getCounters(vector_range(0, (tCounterId)common::globalBase::static_counter_type::size));
 
@@ -133,6 +133,7 @@ void unsafe()
 		       "fwsync_multicast_egress_drops=%luu,"
 		       "fwsync_multicast_egress_packets=%luu,"
 		       "fwsync_multicast_egress_imm_packets=%luu,"
+		       "fwsync_multicast_egress_imm_frames=%luu,"
 		       "fwsync_no_config_drops=%luu,"
 		       "repeat_ttl=%luu,"
 		       "acl_ingress_dropPackets=%luu,"
@@ -162,6 +163,7 @@ void unsafe()
 		       stats.fwsync_multicast_egress_drops,
 		       stats.fwsync_multicast_egress_packets,
 		       stats.fwsync_multicast_egress_imm_packets,
+		       stats.fwsync_multicast_egress_imm_frames,
 		       stats.fwsync_no_config_drops,
 		       stats.repeat_ttl,
 		       stats.acl_ingress_dropPackets,
@@ -227,9 +229,18 @@ void unsafe()
 		                        {"ring_to_slowworker_drops", stats.ring_to_slowworker_drops},
 		                        {"fwsync_multicast_egress_packets", stats.fwsync_multicast_egress_packets},
 		                        {"fwsync_multicast_egress_drops", stats.fwsync_multicast_egress_drops},
+		                        {"fwsync_egress_frame_packets", stats.fwsync_egress_frame_packets},
+		                        {"fwsync_egress_frames", stats.fwsync_egress_frames},
 		                        {"drop_samples", stats.drop_samples},
 		                        {"balancer_state_insert_failed", stats.balancer_state_insert_failed},
-		                        {"balancer_state_insert_done", stats.balancer_state_insert_done}});
+		                        {"balancer_state_insert_done", stats.balancer_state_insert_done},
+		                        {"nat64stateful_gc_scanned", stats.nat64stateful_gc_scanned},
+		                        {"nat64stateful_gc_expired", stats.nat64stateful_gc_expired},
+		                        {"nat64stateful_port_blocks_released", stats.nat64stateful_port_blocks_released},
+		                        {"balancer_gc_scanned", stats.balancer_gc_scanned},
+		                        {"balancer_gc_expired", stats.balancer_gc_expired},
+		                        {"acl_gc_scanned", stats.acl_gc_scanned},
+		                        {"acl_gc_expired", stats.acl_gc_expired}});
 	}
 
 	/// slowWorker
@@ -242,10 +253,30 @@ void unsafe()
 		                        {"slowworker_packets", responseSlowWorker.slowworker_packets},
 		                        {"slowworker_drops", responseSlowWorker.slowworker_drops},
 		                        {"fwsync_multicast_ingress_packets", responseSlowWorker.fwsync_multicast_ingress_packets},
+		                        {"fwsync_multicast_ingress_frames", responseSlowWorker.fwsync_multicast_ingress_frames},
 		                        {"mempool_is_empty", responseSlowWorker.mempool_is_empty},
 		                        {"unknown_dump_interface", responseSlowWorker.unknown_dump_interface}});
 	}
 
+	/// slowWorker per core
+	if (responseSlowWorkers.size() > 1)
+	{
+		for (const auto& [core_id, stats] : responseSlowWorkers)
+		{
+			influxdb_format::print("slowWorker",
+			                       {{"core_id", core_id}},
+			                       {{"repeat_packets", stats.repeat_packets},
+			                        {"tofarm_packets", stats.tofarm_packets},
+			                        {"farm_packets", stats.farm_packets},
+			                        {"slowworker_packets", stats.slowworker_packets},
+			                        {"slowworker_drops", stats.slowworker_drops},
+			                        {"fwsync_multicast_ingress_packets", stats.fwsync_multicast_ingress_packets},
+			                        {"fwsync_multicast_ingress_frames", stats.fwsync_multicast_ingress_frames},
+			                        {"mempool_is_empty", stats.mempool_is_empty},
+			                        {"unknown_dump_interface", stats.unknown_dump_interface}});
+		}
+	}
+
 	/// hashtable gc
 	{
 		for (const auto& [socket_id, name, valid_keys, iterations] : hashtable_gc)
@@ -324,7 +355,10 @@ void unsafe()
 		                        {"lan_state_insert_failed", stats[(tCounterId)module_counter::lan_state_insert_failed]},
 		                        {"lan_state_insert_success", stats[(tCounterId)module_counter::lan_state_insert_success]},
 		                        {"lan_state_cross_numa_insert_failed", stats[(tCounterId)module_counter::lan_state_cross_numa_insert_failed]},
-		                        {"lan_state_cross_numa_insert_success", stats[(tCounterId)module_counter::lan_state_cross_numa_insert_success]}});
+		                        {"lan_state_cross_numa_insert_success", stats[(tCounterId)module_counter::lan_state_cross_numa_insert_success]},
+		                        {"port_block_insert_failed", stats[(tCounterId)module_counter::port_block_insert_failed]},
+		                        {"port_block_insert_success", stats[(tCounterId)module_counter::port_block_insert_success]},
+		                        {"port_block_is_full", stats[(tCounterId)module_counter::port_block_is_full]}});
 
 		influxdb_format::print_histogram("nat64stateful",
 		                                 {{"name", name}},
@@ -497,7 +531,9 @@ void dregress_traffic()
 void other()
 {
 	interface::controlPlane controlPlane;
+	interface::dataPlane dataPlane;
 	const auto& [flagFirst, workers, ports] = controlPlane.telegraf_other();
+	const auto worker_profile = dataPlane.get_worker_profile();
 	const auto rib_summary = controlPlane.rib_summary();
 	const auto limit_summary = controlPlane.limit_summary();
 	(void)flagFirst;
@@ -509,6 +545,21 @@ void other()
 		                       {{"usage", std::get<0>(workerIter.second), ""}});
 	}
 
+	for (const auto& [coreId, stages] : worker_profile)
+	{
+		for (const auto& [stage, stats] : stages)
+		{
+			const auto& [cycles, invocations, packets] = stats;
+
+			influxdb_format::print("worker_profile",
+			                       {{"coreId", coreId},
+			                        {"stage", stage}},
+			                       {{"cycles", cycles},
+			                        {"invocations", invocations},
+			                        {"packets", packets}});
+		}
+	}
+
 	for (const auto& [physicalPortName, stats] : ports)
 	{
 		influxdb_format::print("port",
@@ -113,5 +113,8 @@
 #undef YANET_CONFIG_NAT64STATEFUL_HT_SIZE
 #define YANET_CONFIG_NAT64STATEFUL_HT_SIZE (64 * 1024)
 
+#undef YANET_CONFIG_NAT64STATEFUL_PORT_BLOCKS_HT_SIZE
+#define YANET_CONFIG_NAT64STATEFUL_PORT_BLOCKS_HT_SIZE (16 * 1024)
+
 #undef YANET_CONFIG_ACL_TREE_CHUNKS_BUCKET_SIZE
 #define YANET_CONFIG_ACL_TREE_CHUNKS_BUCKET_SIZE (1024)
@@ -69,6 +69,42 @@
 #undef YANET_CONFIG_ROUTE_TUNNEL_LPM6_EXTENDED_SIZE
 #define YANET_CONFIG_ROUTE_TUNNEL_LPM6_EXTENDED_SIZE (256)
 
+#undef YANET_CONFIG_ROUTE_LPM6_COMPRESSED_NODES_SIZE
+#define YANET_CONFIG_ROUTE_LPM6_COMPRESSED_NODES_SIZE (4 * 1024)
+
+#undef YANET_CONFIG_ROUTE_LPM6_COMPRESSED_ENTRIES_SIZE
+#define YANET_CONFIG_ROUTE_LPM6_COMPRESSED_ENTRIES_SIZE (128 * 1024)
+
+#undef YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_NODES_SIZE
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_NODES_SIZE (4 * 1024)
+
+#undef YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_ENTRIES_SIZE
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_ENTRIES_SIZE (128 * 1024)
+
+#undef YANET_CONFIG_ROUTE_LPM4_COMPRESSED_NODES_SIZE
+#define YANET_CONFIG_ROUTE_LPM4_COMPRESSED_NODES_SIZE (1024)
+
+#undef YANET_CONFIG_ROUTE_LPM4_COMPRESSED_ENTRIES_SIZE
+#define YANET_CONFIG_ROUTE_LPM4_COMPRESSED_ENTRIES_SIZE (64 * 1024)
+
+#undef YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_NODES_SIZE
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_NODES_SIZE (1024)
+
+#undef YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_ENTRIES_SIZE
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_ENTRIES_SIZE (64 * 1024)
+
+#undef YANET_CONFIG_ROUTE_LPM4_TYPE
+#define YANET_CONFIG_ROUTE_LPM4_TYPE lpm4_16bit_2x8bit_compressed<YANET_CONFIG_ROUTE_LPM4_COMPRESSED_NODES_SIZE, YANET_CONFIG_ROUTE_LPM4_COMPRESSED_ENTRIES_SIZE>
+
+#undef YANET_CONFIG_ROUTE_TUNNEL_LPM4_TYPE
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM4_TYPE lpm4_16bit_2x8bit_compressed<YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_NODES_SIZE, YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_ENTRIES_SIZE>
+
+#undef YANET_CONFIG_ROUTE_LPM6_TYPE
+#define YANET_CONFIG_ROUTE_LPM6_TYPE lpm6_16bit_14x8bit_compressed<YANET_CONFIG_ROUTE_LPM6_COMPRESSED_NODES_SIZE, YANET_CONFIG_ROUTE_LPM6_COMPRESSED_ENTRIES_SIZE>
+
+#undef YANET_CONFIG_ROUTE_TUNNEL_LPM6_TYPE
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM6_TYPE lpm6_16bit_14x8bit_compressed<YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_NODES_SIZE, YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_ENTRIES_SIZE>
+
 #undef YANET_CONFIG_DREGRESS_VALUES_SIZE
 #define YANET_CONFIG_DREGRESS_VALUES_SIZE (128)
 
@@ -43,6 +43,20 @@
 #define YANET_CONFIG_ROUTE_VALUES_SIZE (32 * 1024)
 #define YANET_CONFIG_ROUTE_TUNNEL_LPM4_EXTENDED_SIZE (16 * 1024)
 #define YANET_CONFIG_ROUTE_TUNNEL_LPM6_EXTENDED_SIZE (10 * 1024)
+#define YANET_CONFIG_ROUTE_LPM4_COMPRESSED_NODES_SIZE (80 * 1024)
+#define YANET_CONFIG_ROUTE_LPM4_COMPRESSED_ENTRIES_SIZE (4 * 1024 * 1024)
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_NODES_SIZE (80 * 1024)
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM4_COMPRESSED_ENTRIES_SIZE (1 * 1024 * 1024)
+/// lpm4_24bit_8bit_atomic<extended chunks> or lpm4_16bit_2x8bit_compressed<nodes, entries>
+#define YANET_CONFIG_ROUTE_LPM4_TYPE lpm4_24bit_8bit_atomic<CONFIG_YADECAP_LPM4_EXTENDED_SIZE>
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM4_TYPE lpm4_24bit_8bit_atomic<YANET_CONFIG_ROUTE_TUNNEL_LPM4_EXTENDED_SIZE>
+#define YANET_CONFIG_ROUTE_LPM6_COMPRESSED_NODES_SIZE (512 * 1024)
+#define YANET_CONFIG_ROUTE_LPM6_COMPRESSED_ENTRIES_SIZE (4 * 1024 * 1024)
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_NODES_SIZE (512 * 1024)
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM6_COMPRESSED_ENTRIES_SIZE (4 * 1024 * 1024)
+/// lpm6_8x16bit_atomic<extended chunks> or lpm6_16bit_14x8bit_compressed<nodes, entries>
+#define YANET_CONFIG_ROUTE_LPM6_TYPE lpm6_8x16bit_atomic<CONFIG_YADECAP_LPM6_EXTENDED_SIZE>
+#define YANET_CONFIG_ROUTE_TUNNEL_LPM6_TYPE lpm6_8x16bit_atomic<YANET_CONFIG_ROUTE_TUNNEL_LPM6_EXTENDED_SIZE>
 #define YANET_CONFIG_ROUTE_TUNNEL_VALUES_SIZE (256 * 1024)
 #define YANET_CONFIG_ROUTE_TUNNEL_ECMP_SIZE (16)
 #define YANET_CONFIG_ACL_COUNTERS_SIZE (128 * 1024)
@@ -54,10 +68,18 @@
 #define YANET_CONFIG_BALANCER_SERVICES_SIZE (2 * 1024 * 1024)
 #define YANET_CONFIG_BALANCER_REALS_SIZE (2 * 1024 * 1024)
 #define YANET_CONFIG_BALANCER_WEIGHTS_SIZE (32 * 1024)
+#define YANET_CONFIG_BALANCER_MAGLEV_TABLE_SIZE (1021) ///< prime
 #define YANET_CONFIG_BALANCER_STATE_HT_SIZE (64 * 1024)
+/// locker of state tables: seqlock_t (lookup without lock on hit) or spinlock_nonrecursive_t
+#define YANET_CONFIG_FW4_STATES_LOCKER_TYPE seqlock_t
+#define YANET_CONFIG_FW6_STATES_LOCKER_TYPE seqlock_t
+#define YANET_CONFIG_NAT64STATEFUL_LAN_LOCKER_TYPE seqlock_t ///< also lan port blocks
+#define YANET_CONFIG_NAT64STATEFUL_WAN_LOCKER_TYPE seqlock_t ///< also wan port blocks
+#define YANET_CONFIG_BALANCER_STATE_LOCKER_TYPE seqlock_t
 #define YANET_CONFIG_SAMPLES_SIZE (1024 * 64)
 #define YANET_CONFIG_RING_PRIORITY_RATIO (4)
 #define YANET_CONFIG_BURST_SIZE CONFIG_YADECAP_MBUFS_BURST_SIZE
+#define YANET_CONFIG_PREFETCH_OFFSET (4) ///< packets ahead in burst loops
 #define YANET_CONFIG_CONFIG_CACHE_SIZE (5)
 #define YANET_CONFIG_BALANCER_WLC_RECONFIGURE (1)
 #define YANET_CONFIG_BALANCER_WLC_DEFAULT_POWER (10)
@@ -65,6 +87,8 @@
 #define YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES (8)
 #define YANET_CONFIG_NAT64STATEFUL_HT_SIZE (32 * 1024 * 1024)
 #define YANET_CONFIG_NAT64STATEFUL_POOL_SIZE (64 * 1024)
+#define YANET_CONFIG_NAT64STATEFUL_PORT_BLOCKS_HT_SIZE (1024) ///< raise by "nat64stateful_port_blocks_size" of dataplane.conf when port_block_size is used
+#define YANET_CONFIG_NAT64STATEFUL_PORT_BLOCK_TIMEOUT (60)
 #define YANET_CONFIG_STATE_TIMEOUT_DEFAULT (180)
 #define YANET_CONFIG_STATE_TIMEOUT_MAX (32 * 1024)
 #define YANET_CONFIG_ACL_TREE_CHUNKS_BUCKET_SIZE (64 * 1024)
@@ -72,4 +96,6 @@
 #define YANET_CONFIG_DUMP_ID_TO_TAG_SIZE (1024 * 1024)
 #define YANET_CONFIG_SHARED_RINGS_NUMBER (32)
 #define YANET_DEFAULT_IPC_SHMKEY (12345)
+#define YANET_DEFAULT_IPC_COUNTERS_SHMKEY (12340)
 #define YANET_CONFIG_KERNEL_INTERFACE_QUEUE_SIZE (4096)
+#define YANET_CONFIG_KERNEL_INTERFACE_QUEUES_SIZE (16)
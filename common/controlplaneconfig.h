@@ -440,7 +440,8 @@ class config_t
 public:
 	config_t() :
 	        dscp_mark_type(common::eDscpMarkType::never),
-	        dscp(0)
+	        dscp(0),
+	        port_block_size(0)
 	{
 	}
 
@@ -451,6 +452,7 @@ public:
 		stream.pop(dscp);
 		stream.pop(ipv6_prefixes);
 		stream.pop(ipv4_prefixes);
+		stream.pop(port_block_size);
 		stream.pop(announces);
 		stream.pop(next_module);
 	}
@@ -462,6 +464,7 @@ public:
 		stream.push(dscp);
 		stream.push(ipv6_prefixes);
 		stream.push(ipv4_prefixes);
+		stream.push(port_block_size);
 		stream.push(announces);
 		stream.push(next_module);
 	}
@@ -472,6 +475,7 @@ public:
 	uint8_t dscp;
 	std::vector<common::ipv6_prefix_t> ipv6_prefixes;
 	std::vector<common::ipv4_prefix_t> ipv4_prefixes;
+	uint16_t port_block_size; ///< ports of ipv4 address per ipv6 source, 0 - without blocks
 	std::set<common::ip_prefix_t> announces;
 	controlplane::state_timeout state_timeout;
 	std::string next_module;
@@ -53,6 +53,10 @@ enum class module_counter : tCounterId
 	lan_state_cross_numa_insert,
 	lan_state_cross_numa_insert_failed = lan_state_cross_numa_insert,
 	lan_state_cross_numa_insert_success,
+	port_block_insert,
+	port_block_insert_failed = port_block_insert,
+	port_block_insert_success,
+	port_block_is_full,
 	size
 };
 
@@ -245,7 +245,9 @@ using response = std::tuple<std::map<tCoreId,
                             std::map<tCoreId,
                                      worker_gc_t>,
                             std::tuple<common::slowworker::stats_t,
-                                       std::vector<hashtable_gc>>,
+                                       std::vector<hashtable_gc>,
+                                       std::map<tCoreId,
+                                                common::slowworker::stats_t>>,
                             common::fragmentation::stats_t,
                             common::fwstate::stats_t,
                             tun64_stats_t,
@@ -8,6 +8,7 @@
 #include "idp.h"
 #include "result.h"
 #include "sendrecv.h"
+#include "shared_counters.h"
 
 namespace interface
 {
@@ -106,6 +107,12 @@ public:
 
 	common::idp::getAclCounters::response getAclCounters() const
 	{
+		common::idp::getAclCounters::response response;
+		if (shared_counters.get_acl_counters(response))
+		{
+			return response;
+		}
+
 		return get<common::idp::requestType::getAclCounters, common::idp::getAclCounters::response>();
 	}
 
@@ -116,6 +123,12 @@ public:
 
 	common::idp::getCounters::response getCounters(const common::idp::getCounters::request& request) const
 	{
+		common::idp::getCounters::response response;
+		if (shared_counters.get_counters(request, response))
+		{
+			return response;
+		}
+
 		return get<common::idp::requestType::getCounters, common::idp::getCounters::response>(request);
 	}
 
@@ -124,6 +137,11 @@ public:
 		return get<common::idp::requestType::getOtherStats, common::idp::getOtherStats::response>();
 	}
 
+	common::idp::get_worker_profile::response get_worker_profile() const
+	{
+		return get<common::idp::requestType::get_worker_profile, common::idp::get_worker_profile::response>();
+	}
+
 	common::idp::getConfig::response getConfig() const
 	{
 		return get<common::idp::requestType::getConfig, common::idp::getConfig::response>();
@@ -278,6 +296,7 @@ protected:
 protected:
 	mutable int clientSocket;
 	mutable std::mutex mutex;
+	mutable common::shared_counters::client_t shared_counters; ///< counters are read without requests to dataplane, if exported
 };
 
 }
@@ -72,6 +72,7 @@ enum class requestType : uint32_t
 	get_shm_info,
 	dump_physical_port,
 	balancer_state_clear,
+	get_worker_profile,
 	size, // size should always be at the bottom of the list, this enum allows us to find out the size of the enum list
 };
 
@@ -140,7 +141,9 @@ enum class requestType : uint32_t
 	acl_network_flags,
 	acl_transport_layers,
 	acl_transport_table,
+	acl_transport_table_delta,
 	acl_total_table,
+	acl_total_table_delta,
 	acl_values,
 	dregress_prefix_update,
 	dregress_prefix_remove,
@@ -219,6 +222,7 @@ using request = std::tuple<nat64stateful_id_t,
                            tCounterId,
                            uint32_t, ///< pool_start
                            uint32_t, ///< pool_size
+                           uint16_t, ///< port_block_size
                            state_timeout,
                            common::globalBase::flow_t>;
 }
@@ -310,7 +314,9 @@ using request = std::vector<acl::tree_chunk_8bit_t>;
 
 namespace acl_network_table
 {
-using request = std::tuple<uint32_t, std::vector<tAclGroupId>>;
+using request = std::tuple<uint32_t, ///< width
+                           std::vector<uint32_t>, ///< row of values by source group_id. empty, if values are not compressed
+                           std::vector<tAclGroupId>>; ///< values
 }
 
 namespace acl_network_flags
@@ -337,11 +343,23 @@ namespace acl_transport_table
 using request = std::vector<std::tuple<acl::transport_key_t, tAclGroupId>>;
 }
 
+namespace acl_transport_table_delta
+{
+using request = std::tuple<std::vector<std::tuple<acl::transport_key_t, tAclGroupId>>, ///< insert or update
+                           std::vector<acl::transport_key_t>>; ///< remove
+}
+
 namespace acl_total_table
 {
 using request = std::vector<std::tuple<acl::total_key_t, tAclGroupId>>;
 }
 
+namespace acl_total_table_delta
+{
+using request = std::tuple<std::vector<std::tuple<acl::total_key_t, tAclGroupId>>, ///< insert or update
+                           std::vector<acl::total_key_t>>; ///< remove
+}
+
 namespace acl_values
 {
 using request = std::vector<acl::value_t>;
@@ -487,7 +505,9 @@ using requestVariant = std::variant<std::tuple<>,
                                     acl_network_flags::request,
                                     acl_transport_layers::request,
                                     acl_transport_table::request,
+                                    acl_transport_table_delta::request,
                                     acl_total_table::request,
+                                    acl_total_table_delta::request,
                                     acl_values::request,
                                     dump_tags_ids::request,
                                     lpm::request,
@@ -583,8 +603,10 @@ using hashtable_gc = std::tuple<tSocketId,
                                 uint64_t, ///< valid_keys
                                 uint64_t>; ///< iterations
 
-using response = std::tuple<common::slowworker::stats_t,
-                            std::vector<hashtable_gc>>;
+using response = std::tuple<common::slowworker::stats_t, ///< sum of all slow workers
+                            std::vector<hashtable_gc>,
+                            std::map<tCoreId,
+                                     common::slowworker::stats_t>>;
 }
 
 namespace get_worker_gc_stats
@@ -674,6 +696,18 @@ using worker = std::tuple<std::array<uint64_t, CONFIG_YADECAP_MBUFS_BURST_SIZE +
 using response = std::tuple<std::map<tCoreId, worker>>;
 }
 
+namespace get_worker_profile
+{
+using stage = std::tuple<uint64_t, ///< cycles
+                         uint64_t, ///< invocations
+                         uint64_t>; ///< packets
+
+/// empty, if dataplane is built without worker_profile option
+using response = std::map<tCoreId,
+                          std::map<std::string, ///< stage
+                                   stage>>;
+}
+
 namespace getConfig
 {
 enum class value_type
@@ -929,6 +963,7 @@ using response = std::variant<std::tuple<>,
                               get_ports_stats_extended::response,
                               getPortStatsEx::response,
                               getOtherStats::response,
+                              get_worker_profile::response,
                               getFragmentationStats::response,
                               getFWState::response,
                               getFWStateStats::response,
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
 #include "type.h"
 
 namespace balancer
@@ -10,6 +14,7 @@ enum class scheduler : uint8_t
 	rr,
 	wrr,
 	wlc,
+	maglev,
 };
 
 class scheduler_params
@@ -36,9 +41,117 @@ constexpr const char* to_string(const scheduler& scheduler)
 		{
 			return "wlc";
 		}
+		case scheduler::maglev:
+		{
+			return "maglev";
+		}
 	}
 
 	return "unknown";
 }
 
+/// Maglev consistent hashing lookup table (Eisenbud et al., NSDI 2016).
+///
+/// every real walks its own permutation of table slots, derived only from its key,
+/// and reals take turns claiming the next free slot of their permutation.
+/// enabling, disabling or reweighting one real remaps mostly the slots of that real.
+class maglev_t
+{
+public:
+	/// reals: [key, weight]. key must identify real across reloads (e.g. hash of its address).
+	/// table_size must be prime.
+	/// returns table of indexes into reals. empty if no real has non-zero weight
+	static std::vector<uint32_t> populate(const std::vector<std::tuple<uint64_t, uint32_t>>& reals,
+	                                      const uint32_t table_size)
+	{
+		std::vector<uint32_t> table;
+
+		uint32_t weight_max = 0;
+		for (const auto& [key, weight] : reals)
+		{
+			(void)key;
+			weight_max = std::max(weight_max, weight);
+		}
+
+		if (weight_max == 0 ||
+		    table_size < 2)
+		{
+			return table;
+		}
+
+		std::vector<uint64_t> offsets(reals.size());
+		std::vector<uint64_t> skips(reals.size());
+		std::vector<uint64_t> nexts(reals.size(), 0);
+		std::vector<uint64_t> credits(reals.size(), 0);
+
+		for (unsigned int real_i = 0;
+		     real_i < reals.size();
+		     real_i++)
+		{
+			const auto& [key, weight] = reals[real_i];
+			(void)weight;
+
+			offsets[real_i] = mix(key) % table_size;
+			skips[real_i] = mix(key ^ 0x9E3779B97F4A7C15ull) % (table_size - 1) + 1;
+		}
+
+		constexpr uint32_t slot_empty = 0xFFFFFFFFu;
+		table.resize(table_size, slot_empty);
+
+		/// heavier reals claim slots more often: each round real gains its weight as credit
+		/// and takes one slot per weight_max of credit
+		uint32_t filled = 0;
+		for (;;)
+		{
+			for (unsigned int real_i = 0;
+			     real_i < reals.size();
+			     real_i++)
+			{
+				const auto& [key, weight] = reals[real_i];
+				(void)key;
+
+				if (weight == 0)
+				{
+					continue;
+				}
+
+				credits[real_i] += weight;
+				if (credits[real_i] < weight_max)
+				{
+					continue;
+				}
+				credits[real_i] -= weight_max;
+
+				uint64_t slot = (offsets[real_i] + nexts[real_i] * skips[real_i]) % table_size;
+				while (table[slot] != slot_empty)
+				{
+					nexts[real_i]++;
+					slot = (offsets[real_i] + nexts[real_i] * skips[real_i]) % table_size;
+				}
+
+				table[slot] = real_i;
+				nexts[real_i]++;
+
+				filled++;
+				if (filled == table_size)
+				{
+					return table;
+				}
+			}
+		}
+	}
+
+protected:
+	/// splitmix64 finalizer
+	static uint64_t mix(uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58476D1CE4E5B9ull;
+		value ^= value >> 27;
+		value *= 0x94D049BB133111EBull;
+		value ^= value >> 31;
+		return value;
+	}
+};
+
 }
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <mutex>
+#include <vector>
+
+#include "config.h"
+#include "type.h"
+
+namespace common::shared_counters
+{
+
+/// counters of dataplane workers, exported by dataplane in ipc shared memory segment:
+///
+///   header_t
+///   worker_t[workers_count]
+///   counters of worker 0: uint64_t counters[counters_size], uint64_t acl_counters[acl_counters_size]
+///   counters of worker 1
+///   ...
+///
+/// workers increment counters in place, readers attach segment read only and aggregate counters
+/// without requests to dataplane
+constexpr uint64_t magic = 0x59414E4554434E54ull; ///< "YANETCNT"
+constexpr uint32_t version = 1; ///< increment on change of layout
+constexpr uint64_t alignment = 64;
+
+struct header_t
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t workers_count;
+	uint64_t counters_size;
+	uint64_t acl_counters_size;
+	uint64_t size; ///< of segment
+	int64_t pid; ///< of dataplane
+};
+
+struct worker_t
+{
+	uint32_t core_id;
+	uint32_t socket_id;
+	uint64_t counters_offset;
+	uint64_t acl_counters_offset;
+};
+
+inline uint64_t align(const uint64_t size)
+{
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+inline uint64_t workers_offset()
+{
+	return align(sizeof(header_t));
+}
+
+inline uint64_t worker_offset(const uint32_t workers_count,
+                              const uint32_t worker_id)
+{
+	const uint64_t worker_size = align((YANET_CONFIG_COUNTERS_SIZE + YANET_CONFIG_ACL_COUNTERS_SIZE) * sizeof(uint64_t));
+	return align(workers_offset() + workers_count * sizeof(worker_t)) + worker_id * worker_size;
+}
+
+inline uint64_t size(const uint32_t workers_count)
+{
+	return worker_offset(workers_count, workers_count);
+}
+
+/// thread safe
+class client_t
+{
+public:
+	client_t(const key_t key = YANET_DEFAULT_IPC_COUNTERS_SHMKEY) :
+	        key(key),
+	        shmid(-1),
+	        data(nullptr)
+	{
+	}
+
+	~client_t()
+	{
+		detach();
+	}
+
+	client_t(const client_t&) = delete;
+	client_t& operator=(const client_t&) = delete;
+
+public:
+	/// returns false, if dataplane doesn't export counters
+	bool get_counters(const std::vector<tCounterId>& counter_ids,
+	                  std::vector<uint64_t>& result)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		if (!attach())
+		{
+			return false;
+		}
+
+		const auto& header = this->header();
+
+		result.assign(counter_ids.size(), 0);
+		for (uint32_t worker_id = 0;
+		     worker_id < header.workers_count;
+		     worker_id++)
+		{
+			const auto* counters = (const volatile uint64_t*)(data + workers()[worker_id].counters_offset);
+
+			for (size_t i = 0;
+			     i < counter_ids.size();
+			     i++)
+			{
+				if (counter_ids[i] < header.counters_size)
+				{
+					result[i] += counters[counter_ids[i]];
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/// returns false, if dataplane doesn't export counters
+	bool get_acl_counters(std::vector<uint64_t>& result)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		if (!attach())
+		{
+			return false;
+		}
+
+		const auto& header = this->header();
+
+		result.assign(header.acl_counters_size, 0);
+		for (uint32_t worker_id = 0;
+		     worker_id < header.workers_count;
+		     worker_id++)
+		{
+			const auto* acl_counters = (const volatile uint64_t*)(data + workers()[worker_id].acl_counters_offset);
+
+			for (uint64_t i = 0;
+			     i < header.acl_counters_size;
+			     i++)
+			{
+				result[i] += acl_counters[i];
+			}
+		}
+
+		return true;
+	}
+
+protected:
+	const header_t& header() const
+	{
+		return *(const header_t*)data;
+	}
+
+	const worker_t* workers() const
+	{
+		return (const worker_t*)(data + workers_offset());
+	}
+
+	/// segment is recreated on restart of dataplane, so it is attached again on change of shmid
+	bool attach()
+	{
+		int current_shmid = shmget(key, 0, 0);
+		if (current_shmid == -1)
+		{
+			detach();
+			return false;
+		}
+
+		if (current_shmid != shmid)
+		{
+			detach();
+
+			void* shmaddr = shmat(current_shmid, nullptr, SHM_RDONLY);
+			if (shmaddr == (void*)-1)
+			{
+				return false;
+			}
+
+			shmid = current_shmid;
+			data = (const uint8_t*)shmaddr;
+
+			if (!validate())
+			{
+				detach();
+				return false;
+			}
+		}
+
+		/// stale segment of stopped dataplane
+		if (kill(header().pid, 0) != 0 &&
+		    errno != EPERM)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool validate() const
+	{
+		struct shmid_ds stat;
+		if (shmctl(shmid, IPC_STAT, &stat) != 0 ||
+		    stat.shm_segsz < sizeof(header_t))
+		{
+			return false;
+		}
+
+		const auto& header = this->header();
+		if (header.magic != magic ||
+		    header.version != version ||
+		    header.size > stat.shm_segsz ||
+		    workers_offset() + header.workers_count * sizeof(worker_t) > header.size)
+		{
+			return false;
+		}
+
+		for (uint32_t worker_id = 0;
+		     worker_id < header.workers_count;
+		     worker_id++)
+		{
+			const auto& worker = workers()[worker_id];
+			if (worker.counters_offset + header.counters_size * sizeof(uint64_t) > header.size ||
+			    worker.acl_counters_offset + header.acl_counters_size * sizeof(uint64_t) > header.size)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void detach()
+	{
+		if (data)
+		{
+			shmdt(data);
+			data = nullptr;
+		}
+
+		shmid = -1;
+	}
+
+protected:
+	key_t key;
+	std::mutex mutex;
+	int shmid;
+	const uint8_t* data;
+};
+
+}
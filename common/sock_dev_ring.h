@@ -0,0 +1,437 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <string>
+
+namespace common::sock_dev_ring
+{
+
+/// shared memory transport of sock_dev ports.
+///
+/// client connects to unix socket of sock_dev and, instead of first frame length, sends
+/// be32 'handshake' and config_t. dataplane answers by one byte with memfd in SCM_RIGHTS:
+///
+///   header_t
+///   ring to dataplane
+///   ring from dataplane
+///
+/// each ring is single producer single consumer:
+///
+///   ring_t (head and tail)
+///   desc_t[slots_count]
+///   uint8_t data[slots_count][slot_size]
+///
+/// frame of position 'p' lies in slot 'p % slots_count'. producer writes frames in place and publishes them
+/// by head, consumer reads them in place and returns slots by tail.
+/// connection stays open while shared memory is used, dataplane releases it after close of socket
+constexpr uint32_t handshake = 0x594E5352; ///< "YNSR", greater than any frame length
+constexpr uint64_t magic = 0x59414E455452494Eull; ///< "YANETRIN"
+constexpr uint32_t version = 1; ///< increment on change of layout
+constexpr uint64_t alignment = 64;
+
+constexpr uint32_t slots_count_default = 4096;
+constexpr uint32_t slots_count_max = 64 * 1024;
+constexpr uint32_t slot_size_default = 2048;
+constexpr uint32_t slot_size_max = 16384;
+
+struct config_t
+{
+	uint32_t slots_count; ///< power of 2
+	uint32_t slot_size;
+};
+
+struct header_t
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t slots_count;
+	uint32_t slot_size;
+	uint32_t reserved;
+	uint64_t to_dataplane_offset;
+	uint64_t from_dataplane_offset;
+	uint64_t size; ///< of memory
+};
+
+struct ring_t
+{
+	alignas(alignment) std::atomic<uint64_t> head; ///< written by producer
+	alignas(alignment) std::atomic<uint64_t> tail; ///< written by consumer
+};
+
+struct desc_t
+{
+	uint32_t length;
+	uint32_t reserved;
+};
+
+inline uint64_t align(const uint64_t size)
+{
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+inline bool is_valid(const config_t& config)
+{
+	return config.slots_count &&
+	       config.slots_count <= slots_count_max &&
+	       __builtin_popcount(config.slots_count) == 1 &&
+	       config.slot_size &&
+	       config.slot_size <= slot_size_max;
+}
+
+inline uint64_t descs_offset()
+{
+	return align(sizeof(ring_t));
+}
+
+inline uint64_t data_offset(const config_t& config)
+{
+	return descs_offset() + align(config.slots_count * sizeof(desc_t));
+}
+
+inline uint64_t ring_size(const config_t& config)
+{
+	return align(data_offset(config) + (uint64_t)config.slots_count * align(config.slot_size));
+}
+
+inline uint64_t size(const config_t& config)
+{
+	return align(sizeof(header_t)) + 2 * ring_size(config);
+}
+
+/// one side of ring. geometry is taken from own config, not from shared memory
+class ring_view_t
+{
+public:
+	ring_view_t() :
+	        ring(nullptr),
+	        descs(nullptr),
+	        data(nullptr),
+	        mask(0),
+	        slot_size(0),
+	        stride(0)
+	{
+	}
+
+	/// initializes empty ring. called by dataplane
+	void create(uint8_t* memory,
+	            const config_t& config)
+	{
+		attach(memory, config);
+
+		new (ring) ring_t();
+		ring->head = 0;
+		ring->tail = 0;
+	}
+
+	void attach(uint8_t* memory,
+	            const config_t& config)
+	{
+		ring = (ring_t*)memory;
+		descs = (desc_t*)(memory + descs_offset());
+		data = memory + data_offset(config);
+		mask = config.slots_count - 1;
+		slot_size = config.slot_size;
+		stride = align(config.slot_size);
+	}
+
+	bool is_attached() const
+	{
+		return ring != nullptr;
+	}
+
+	uint32_t get_slot_size() const
+	{
+		return slot_size;
+	}
+
+public: /// producer
+	/// returns count of free slots, 'count' at most
+	uint32_t reserve(const uint32_t count) const
+	{
+		const uint64_t used = ring->head.load(std::memory_order_relaxed) - ring->tail.load(std::memory_order_acquire);
+		if (used > mask)
+		{
+			return 0;
+		}
+
+		const uint64_t free = mask + 1 - used;
+		return count < free ? count : free;
+	}
+
+	uint8_t* reserved_data(const uint32_t index) const
+	{
+		return data + ((ring->head.load(std::memory_order_relaxed) + index) & mask) * stride;
+	}
+
+	void set_reserved_length(const uint32_t index,
+	                         const uint32_t length) const
+	{
+		descs[(ring->head.load(std::memory_order_relaxed) + index) & mask].length = length;
+	}
+
+	void commit(const uint32_t count) const
+	{
+		ring->head.store(ring->head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+public: /// consumer
+	/// returns count of ready frames, 'count' at most
+	uint32_t ready(const uint32_t count) const
+	{
+		uint64_t used = ring->head.load(std::memory_order_acquire) - ring->tail.load(std::memory_order_relaxed);
+		if (used > (uint64_t)mask + 1)
+		{
+			/// broken by peer
+			used = (uint64_t)mask + 1;
+		}
+
+		return count < used ? count : used;
+	}
+
+	const uint8_t* ready_data(const uint32_t index) const
+	{
+		return data + ((ring->tail.load(std::memory_order_relaxed) + index) & mask) * stride;
+	}
+
+	/// length is written by peer, check it
+	uint32_t ready_length(const uint32_t index) const
+	{
+		const uint32_t length = descs[(ring->tail.load(std::memory_order_relaxed) + index) & mask].length;
+		return length <= slot_size ? length : 0;
+	}
+
+	void release(const uint32_t count) const
+	{
+		ring->tail.store(ring->tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+protected:
+	ring_t* ring;
+	desc_t* descs;
+	uint8_t* data;
+	uint64_t mask;
+	uint32_t slot_size;
+	uint64_t stride;
+};
+
+/// client side, for autotest and traffic generators. one thread sends and one thread receives at most.
+///
+/// send:
+///   count = client.to_dataplane().reserve(burst);
+///   fill client.to_dataplane().reserved_data(i) and set_reserved_length(i, length), i < count
+///   client.to_dataplane().commit(count);
+///
+/// receive:
+///   count = client.from_dataplane().ready(burst);
+///   read ready_data(i) and ready_length(i), i < count
+///   client.from_dataplane().release(count);
+class client_t
+{
+public:
+	client_t() :
+	        fd(-1),
+	        memory(nullptr),
+	        memory_size(0)
+	{
+	}
+
+	~client_t()
+	{
+		close();
+	}
+
+	client_t(const client_t&) = delete;
+	client_t& operator=(const client_t&) = delete;
+
+public:
+	/// path of sock_dev: without prefix "sock_dev:"
+	bool connect(const std::string& path,
+	             const config_t& config = {slots_count_default, slot_size_default})
+	{
+		close();
+
+		if (!is_valid(config))
+		{
+			return false;
+		}
+
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		sockaddr_un sockaddr;
+		memset(&sockaddr, 0, sizeof(sockaddr));
+		sockaddr.sun_family = AF_UNIX;
+		strncpy(sockaddr.sun_path, path.data(), sizeof(sockaddr.sun_path) - 1);
+		if (::connect(fd, (struct sockaddr*)&sockaddr, sizeof(sockaddr)) < 0)
+		{
+			close();
+			return false;
+		}
+
+		struct __attribute__((__packed__))
+		{
+			uint32_t handshake;
+			config_t config;
+		} request = {htonl(sock_dev_ring::handshake), config};
+
+		if (write(fd, &request, sizeof(request)) != sizeof(request))
+		{
+			close();
+			return false;
+		}
+
+		int memory_fd = receive_fd();
+		if (memory_fd < 0)
+		{
+			close();
+			return false;
+		}
+
+		struct stat stat;
+		if (fstat(memory_fd, &stat) < 0 ||
+		    (uint64_t)stat.st_size < size(config))
+		{
+			::close(memory_fd);
+			close();
+			return false;
+		}
+
+		void* pointer = mmap(nullptr, stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd, 0);
+		::close(memory_fd);
+		if (pointer == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+
+		memory = (uint8_t*)pointer;
+		memory_size = stat.st_size;
+
+		const auto& header = *(const header_t*)memory;
+		if (header.magic != magic ||
+		    header.version != version ||
+		    header.slots_count != config.slots_count ||
+		    header.slot_size != config.slot_size ||
+		    header.to_dataplane_offset + ring_size(config) > memory_size ||
+		    header.from_dataplane_offset + ring_size(config) > memory_size)
+		{
+			close();
+			return false;
+		}
+
+		to_dataplane_ring.attach(memory + header.to_dataplane_offset, config);
+		from_dataplane_ring.attach(memory + header.from_dataplane_offset, config);
+
+		return true;
+	}
+
+	void close()
+	{
+		if (memory)
+		{
+			munmap(memory, memory_size);
+			memory = nullptr;
+			memory_size = 0;
+		}
+
+		if (fd >= 0)
+		{
+			::close(fd);
+			fd = -1;
+		}
+
+		to_dataplane_ring = ring_view_t();
+		from_dataplane_ring = ring_view_t();
+	}
+
+	bool is_connected() const
+	{
+		return memory != nullptr;
+	}
+
+	const ring_view_t& to_dataplane() const
+	{
+		return to_dataplane_ring;
+	}
+
+	const ring_view_t& from_dataplane() const
+	{
+		return from_dataplane_ring;
+	}
+
+	/// copies frame, returns false if ring is full or frame doesn't fit in slot
+	bool send(const void* frame,
+	          const uint32_t length)
+	{
+		if (length > to_dataplane_ring.get_slot_size() ||
+		    !to_dataplane_ring.reserve(1))
+		{
+			return false;
+		}
+
+		memcpy(to_dataplane_ring.reserved_data(0), frame, length);
+		to_dataplane_ring.set_reserved_length(0, length);
+		to_dataplane_ring.commit(1);
+		return true;
+	}
+
+protected:
+	int receive_fd()
+	{
+		char byte;
+		iovec iov = {&byte, sizeof(byte)};
+
+		union
+		{
+			cmsghdr align;
+			char buffer[CMSG_SPACE(sizeof(int))];
+		} control;
+		memset(&control, 0, sizeof(control));
+
+		msghdr message;
+		memset(&message, 0, sizeof(message));
+		message.msg_iov = &iov;
+		message.msg_iovlen = 1;
+		message.msg_control = control.buffer;
+		message.msg_controllen = sizeof(control.buffer);
+
+		if (recvmsg(fd, &message, MSG_CMSG_CLOEXEC) != sizeof(byte))
+		{
+			return -1;
+		}
+
+		cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+		if (cmsg == nullptr ||
+		    cmsg->cmsg_level != SOL_SOCKET ||
+		    cmsg->cmsg_type != SCM_RIGHTS ||
+		    cmsg->cmsg_len != CMSG_LEN(sizeof(int)))
+		{
+			return -1;
+		}
+
+		int result;
+		memcpy(&result, CMSG_DATA(cmsg), sizeof(result));
+		return result;
+	}
+
+protected:
+	int fd;
+	uint8_t* memory;
+	uint64_t memory_size;
+	ring_view_t to_dataplane_ring;
+	ring_view_t from_dataplane_ring;
+};
+
+}
@@ -2008,6 +2008,7 @@ struct common
 	uint64_t fwsync_multicast_egress_drops;
 	uint64_t fwsync_multicast_egress_packets;
 	uint64_t fwsync_multicast_egress_imm_packets;
+	uint64_t fwsync_multicast_egress_imm_frames; ///< frames in imm_packets
 	uint64_t fwsync_no_config_drops;
 	uint64_t fwsync_unicast_egress_drops;
 	uint64_t fwsync_unicast_egress_packets;
@@ -2055,9 +2056,18 @@ struct stats_t
 	uint64_t fwsync_multicast_egress_drops;
 	uint64_t fwsync_unicast_egress_packets;
 	uint64_t fwsync_unicast_egress_drops;
+	uint64_t fwsync_egress_frame_packets; ///< sync packets built, before copying to each port
+	uint64_t fwsync_egress_frames; ///< frames in fwsync_egress_frame_packets
 	uint64_t drop_samples;
 	uint64_t balancer_state_insert_failed;
 	uint64_t balancer_state_insert_done;
+	uint64_t nat64stateful_gc_scanned; ///< states checked by gc
+	uint64_t nat64stateful_gc_expired; ///< states removed by gc
+	uint64_t nat64stateful_port_blocks_released;
+	uint64_t balancer_gc_scanned;
+	uint64_t balancer_gc_expired;
+	uint64_t acl_gc_scanned;
+	uint64_t acl_gc_expired;
 };
 }
 
@@ -2466,6 +2476,7 @@ struct stats_t
 	uint64_t tcp_ok;
 	uint64_t tcp_timeout_sessions;
 	uint64_t tcp_unknown_sessions;
+	uint64_t directions_overflow;
 };
 
 using value_t = std::tuple<common::ip_address_t, ///< nexthop
@@ -2495,6 +2506,7 @@ struct stats_t
 	uint64_t tofarm_packets;
 	uint64_t farm_packets;
 	uint64_t fwsync_multicast_ingress_packets;
+	uint64_t fwsync_multicast_ingress_frames;
 	uint64_t slowworker_packets;
 	uint64_t slowworker_drops;
 	uint64_t mempool_is_empty;
@@ -2,8 +2,10 @@
 #include <netdb.h>
 
 #include <array>
+#include <chrono>
 #include <list>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -30,6 +32,7 @@
 #include "acl/network.h"
 #include "acl/rule.h"
 #include "acl_compiler.h"
+#include "acl_tasks.h"
 
 #include "common/acl.h"
 
@@ -358,7 +361,8 @@ static bool unwind(int64_t start_from, firewall_rules_t& fw, const dispatcher_ru
 std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::base::acl_t>& acls,
                                       const iface_map_t& iface_map,
                                       ref_t<filter_t> filter,
-                                      result_t& result);
+                                      result_t& result,
+                                      const unsigned int threads_count = 1);
 std::vector<rule_t> unwind_rules(firewall_rules_t& fw, const dispatcher_rules_t& dispatcher, const ref_t<filter_t>& filter, const std::string& iface);
 
 static inline auto skip_rule(const rule_t& rule,
@@ -782,7 +786,8 @@ unwind_result unwind(const std::map<std::string, controlplane::base::acl_t>& acl
 std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::base::acl_t>& acls,
                                       const iface_map_t& iface_map,
                                       ref_t<filter_t> filter,
-                                      result_t& result)
+                                      result_t& result,
+                                      const unsigned int threads_count)
 {
 	std::unordered_map<std::vector<rule_t>, tAclId> rules_map(acls.size());
 
@@ -804,6 +809,19 @@ std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::
 	result.ids_map.push_back(ids_t());
 	std::set<ids_t> ids_overflow;
 
+	/// rules of acl module, unwinded for each of its interfaces
+	struct module_t
+	{
+		const std::string& name;
+		const controlplane::base::acl_t& acl;
+		const std::set<std::tuple<bool, std::string>>& ifaces;
+		std::unique_ptr<firewall_rules_t> fw;
+		std::unique_ptr<dispatcher_rules_t> dispatcher;
+		std::vector<std::vector<rule_t>> ifaces_rules;
+	};
+
+	std::vector<module_t> modules;
+
 #ifdef ACL_DEBUG
 	uint32_t disp_id = FW_DISPATCHER_START_ID;
 #endif
@@ -818,8 +836,8 @@ std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::
 		}
 
 		// prepare firewall rules in YaNET format
-		firewall_rules_t fw(acl, rule_id);
-		for (auto& [ruleno, yanet_rules] : fw.rules)
+		auto fw = std::make_unique<firewall_rules_t>(acl, rule_id);
+		for (auto& [ruleno, yanet_rules] : fw->rules)
 		{
 			auto& result_rules = result.rules[ruleno];
 			for (auto& rule : yanet_rules)
@@ -851,8 +869,8 @@ std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::
 #endif
 		// prepare dispatcher rules in YaNET format
 		// and generate text representation for them
-		dispatcher_rules_t dispatcher(acl);
-		for (auto& rule : dispatcher.rules)
+		auto dispatcher = std::make_unique<dispatcher_rules_t>(acl);
+		for (auto& rule : dispatcher->rules)
 		{
 #ifdef ACL_DEBUG
 			if (rule.ids.empty())
@@ -875,16 +893,39 @@ std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::
 			ACL_DBGMSG("dispatcher rule: " << rule.to_string());
 		}
 
-		auto aclId = acl.aclId;
-		for (auto& [dir, iface] : it->second)
-		{
-			ref_t<filter_id_t> acl_id = new filter_id_t(aclId);
-			ref_t<filter_id_t> direction(new filter_id_t(dir ? 0 : 1));
+		modules.emplace_back(module_t{moduleName, acl, it->second, std::move(fw), std::move(dispatcher), {}});
+	}
 
-			ref_t<filter_t> start_filter = new filter_t(acl_id, nullptr, nullptr, nullptr, nullptr, direction, nullptr);
-			start_filter = start_filter & filter;
+	// modules don't share filters, so they are unwinded in parallel.
+	// filter of lookup is shared by all modules, its reference counter is not atomic
+	compiler::tasks_t tasks(filter ? 1 : threads_count);
+	for (auto& module : modules)
+	{
+		tasks.add([&module, &filter]() {
+			for (auto& [dir, iface] : module.ifaces)
+			{
+				ref_t<filter_id_t> acl_id = new filter_id_t(module.acl.aclId);
+				ref_t<filter_id_t> direction(new filter_id_t(dir ? 0 : 1));
+
+				ref_t<filter_t> start_filter = new filter_t(acl_id, nullptr, nullptr, nullptr, nullptr, direction, nullptr);
+				start_filter = start_filter & filter;
 
-			auto rules = unwind_rules(fw, dispatcher, start_filter, iface);
+				module.ifaces_rules.emplace_back(unwind_rules(*module.fw, *module.dispatcher, start_filter, iface));
+			}
+		});
+	}
+	tasks.run();
+
+	for (auto& module : modules)
+	{
+		const auto& moduleName = module.name;
+		const auto& acl = module.acl;
+
+		auto aclId = acl.aclId;
+		auto ifaces_rules_it = module.ifaces_rules.begin();
+		for (auto& [dir, iface] : module.ifaces)
+		{
+			auto& rules = *ifaces_rules_it++;
 
 			for (auto& rule : rules)
 			{
@@ -976,14 +1017,18 @@ std::vector<rule_t> unwind_used_rules(const std::map<std::string, controlplane::
 void compile(const unsigned int transport_layers_size,
              const std::map<std::string, controlplane::base::acl_t>& acls,
              const iface_map_t& iface_map,
-             result_t& result)
+             result_t& result,
+             const unsigned int threads_count)
 {
 	try
 	{
-		acl::compiler_t compiler; ///< @todo: move to module
+		acl::compiler_t compiler(threads_count); ///< @todo: move to module
 
 		YANET_LOG_INFO("acl::compile: unwind\n");
-		auto rules_used = unwind_used_rules(acls, iface_map, nullptr, result);
+		const auto start = std::chrono::steady_clock::now();
+		auto rules_used = unwind_used_rules(acls, iface_map, nullptr, result, compiler.threads_count);
+		result.durations.emplace_back("unwind", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
 		compiler.compile(transport_layers_size, rules_used, result);
 	}
 	catch (const std::exception& ex)
@@ -1003,6 +1048,39 @@ void compile(const unsigned int transport_layers_size,
 	}
 }
 
+bool compile(const unsigned int transport_layers_size,
+             const std::map<std::string, controlplane::base::acl_t>& acls,
+             const iface_map_t& iface_map,
+             result_t& result,
+             incremental_t& incremental,
+             const std::function<bool(result_t&)>& load)
+{
+	try
+	{
+		YANET_LOG_INFO("acl::compile: unwind\n");
+		const auto start = std::chrono::steady_clock::now();
+		auto rules_used = unwind_used_rules(acls, iface_map, nullptr, result, compiler::tasks_t::get_threads_count(0));
+		result.durations.emplace_back("unwind", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+		return incremental.compile(transport_layers_size, std::move(rules_used), result, load);
+	}
+	catch (const std::exception& ex)
+	{
+		YANET_LOG_ERROR("dispatcher compilation error \"%s\"\n", ex.what());
+		throw;
+	}
+	catch (const std::string& ex)
+	{
+		YANET_LOG_ERROR("dispatcher compilation error \"%s\"\n", ex.data());
+		throw;
+	}
+	catch (...)
+	{
+		YANET_LOG_ERROR("unknown dispatcher compilation error\n");
+		throw;
+	}
+}
+
 /// @todo: move
 uint8_t string_to_proto(const std::string& string)
 {
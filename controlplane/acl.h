@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include <nlohmann/json.hpp>
 
 #include "base.h"
@@ -37,6 +39,55 @@ struct result_t
 
 	std::vector<std::string> dump_id_to_tag;
 	std::map<std::string, uint32_t> tag_to_dump_id;
+
+	std::vector<std::tuple<std::string, double>> durations; ///< wall time of compilation stages, seconds
+
+	/// all, except durations
+	void pop(common::stream_in_t& stream)
+	{
+		stream.pop(acl_network_ipv4_source);
+		stream.pop(acl_network_ipv4_destination);
+		stream.pop(acl_network_ipv6_source);
+		stream.pop(acl_network_ipv6_destination_ht);
+		stream.pop(acl_network_ipv6_destination);
+		stream.pop(acl_network_table);
+		stream.pop(acl_network_flags);
+		stream.pop(acl_transport_layers);
+		stream.pop(acl_transport_tables);
+		stream.pop(acl_total_table);
+		stream.pop(acl_values);
+		stream.pop(ids_map);
+		stream.pop(dispatcher);
+		stream.pop(rules);
+		stream.pop(in_iface_map);
+		stream.pop(out_iface_map);
+		stream.pop(acl_map);
+		stream.pop(dump_id_to_tag);
+		stream.pop(tag_to_dump_id);
+	}
+
+	void push(common::stream_out_t& stream) const
+	{
+		stream.push(acl_network_ipv4_source);
+		stream.push(acl_network_ipv4_destination);
+		stream.push(acl_network_ipv6_source);
+		stream.push(acl_network_ipv6_destination_ht);
+		stream.push(acl_network_ipv6_destination);
+		stream.push(acl_network_table);
+		stream.push(acl_network_flags);
+		stream.push(acl_transport_layers);
+		stream.push(acl_transport_tables);
+		stream.push(acl_total_table);
+		stream.push(acl_values);
+		stream.push(ids_map);
+		stream.push(dispatcher);
+		stream.push(rules);
+		stream.push(in_iface_map);
+		stream.push(out_iface_map);
+		stream.push(acl_map);
+		stream.push(dump_id_to_tag);
+		stream.push(tag_to_dump_id);
+	}
 };
 
 iface_map_t ifaceMapping(std::map<std::string, controlplane::base::logical_port_t> logicalPorts,
@@ -84,6 +135,19 @@ std::set<uint32_t> lookup(const unsigned int transport_layers_size,
 void compile(const unsigned int transport_layers_size,
              const std::map<std::string, controlplane::base::acl_t>& acls,
              const acl::iface_map_t& ifaces,
-             result_t& result);
+             result_t& result,
+             const unsigned int threads_count = 0); ///< 0: hardware concurrency
+
+class incremental_t;
+
+/// same as compile(), but tables are not filled, if rules are not changed since last commit of 'incremental'.
+/// returns false in this case.
+/// without tables of last commit (restart, rollback) tables are taken by 'load', if it succeeds
+bool compile(const unsigned int transport_layers_size,
+             const std::map<std::string, controlplane::base::acl_t>& acls,
+             const acl::iface_map_t& ifaces,
+             result_t& result,
+             incremental_t& incremental,
+             const std::function<bool(result_t&)>& load = nullptr);
 
 } // namespace acl
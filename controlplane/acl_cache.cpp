@@ -0,0 +1,313 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "common/stream.h"
+#include "common/version.h"
+
+#include "acl_cache.h"
+
+using namespace acl;
+
+namespace
+{
+
+void push_ranges(common::stream_out_t& stream,
+                 const common::ranges_t& ranges)
+{
+	uint64_t size = std::distance(ranges.begin(), ranges.end());
+	stream.push(size);
+	for (const auto& range : ranges)
+	{
+		stream.push(range);
+	}
+}
+
+void push_flow(common::stream_out_t& stream,
+               const common::globalBase::tFlow& flow)
+{
+	stream.push(flow.type_params_atomic);
+	stream.push(flow.data.atomic);
+}
+
+void push_rule(common::stream_out_t& stream,
+               const controlplane::base::acl_rule_t& rule)
+{
+	stream.push((uint8_t)rule.network.has_value());
+	if (rule.network)
+	{
+		std::visit([&](const auto& network) {
+			stream.push(network.sourcePrefixes);
+			stream.push(network.destinationPrefixes);
+		},
+		           *rule.network);
+		stream.push((uint64_t)rule.network->index());
+	}
+
+	stream.push(rule.fragment);
+
+	stream.push((uint8_t)rule.transport.has_value());
+	if (rule.transport)
+	{
+		stream.push((uint64_t)rule.transport->index());
+		if (const auto* tcp = std::get_if<controlplane::base::acl_rule_transport_tcp_t>(&*rule.transport))
+		{
+			push_ranges(stream, tcp->sourcePorts);
+			push_ranges(stream, tcp->destinationPorts);
+			stream.push(tcp->flags);
+		}
+		else if (const auto* udp = std::get_if<controlplane::base::acl_rule_transport_udp_t>(&*rule.transport))
+		{
+			push_ranges(stream, udp->sourcePorts);
+			push_ranges(stream, udp->destinationPorts);
+		}
+		else if (const auto* icmpv4 = std::get_if<controlplane::base::acl_rule_transport_icmpv4_t>(&*rule.transport))
+		{
+			push_ranges(stream, icmpv4->types);
+			push_ranges(stream, icmpv4->codes);
+			push_ranges(stream, icmpv4->identifiers);
+		}
+		else if (const auto* icmpv6 = std::get_if<controlplane::base::acl_rule_transport_icmpv6_t>(&*rule.transport))
+		{
+			push_ranges(stream, icmpv6->types);
+			push_ranges(stream, icmpv6->codes);
+			push_ranges(stream, icmpv6->identifiers);
+		}
+		else if (const auto* other = std::get_if<controlplane::base::acl_rule_transport_other_t>(&*rule.transport))
+		{
+			push_ranges(stream, other->protocolTypes);
+		}
+	}
+
+	stream.push((uint8_t)rule.flow.has_value());
+	if (rule.flow)
+	{
+		push_flow(stream, *rule.flow);
+	}
+}
+
+/// FNV-1a
+uint64_t hash(const std::vector<uint8_t>& buffer)
+{
+	uint64_t result = 0xCBF29CE484222325ull;
+	for (const auto byte : buffer)
+	{
+		result ^= byte;
+		result *= 0x100000001B3ull;
+	}
+
+	return result;
+}
+
+}
+
+cache_t::cache_t(const std::string& directory,
+                 const unsigned int files_count) :
+        directory(directory),
+        files_count(files_count)
+{
+}
+
+bool cache_t::enabled() const
+{
+	return !directory.empty();
+}
+
+uint64_t cache_t::key(const unsigned int transport_layers_size,
+                      const std::map<std::string, controlplane::base::acl_t>& acls,
+                      const iface_map_t& iface_map)
+{
+	common::stream_out_t stream;
+
+	stream.push(version);
+	stream.push(version_to_string());
+	stream.push(version_revision());
+	stream.push(version_hash());
+	stream.push(version_custom());
+
+	stream.push(transport_layers_size);
+	stream.push(iface_map);
+
+	for (const auto& [name, acl] : acls)
+	{
+		stream.push(name);
+		stream.push(acl.aclId);
+		stream.push(acl.firewall ? acl.firewall->sources_hash() : (uint64_t)0);
+
+		stream.push((uint64_t)acl.nextModuleRules.size());
+		for (const auto& rule : acl.nextModuleRules)
+		{
+			push_rule(stream, rule);
+		}
+	}
+
+	return hash(stream.getBuffer());
+}
+
+bool cache_t::load(const uint64_t key, result_t& result) const
+{
+	if (!enabled())
+	{
+		return false;
+	}
+
+	const auto file_path = path(key);
+
+	int fd = open(file_path.data(), O_RDONLY);
+	if (fd < 0)
+	{
+		YANET_LOG_INFO("acl::cache: miss %016lx\n", key);
+		return false;
+	}
+
+	struct stat stat;
+	if (fstat(fd, &stat) < 0 ||
+	    (uint64_t)stat.st_size < sizeof(header_t))
+	{
+		YANET_LOG_WARNING("acl::cache: invalid file '%s'\n", file_path.data());
+		close(fd);
+		return false;
+	}
+
+	void* pointer = mmap(nullptr, stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (pointer == MAP_FAILED)
+	{
+		YANET_LOG_WARNING("acl::cache: mmap('%s'): %s\n", file_path.data(), strerror(errno));
+		return false;
+	}
+
+	bool loaded = false;
+
+	const auto* header = (const header_t*)pointer;
+	if (header->magic == magic &&
+	    header->version == version &&
+	    header->key == key &&
+	    header->size == stat.st_size - sizeof(header_t))
+	{
+		const auto* payload = (const uint8_t*)pointer + sizeof(header_t);
+		std::vector<uint8_t> buffer(payload, payload + header->size);
+
+		common::stream_in_t stream(buffer);
+		result_t cached_result;
+		stream.pop(cached_result);
+
+		if (!stream.isFailed())
+		{
+			cached_result.durations = std::move(result.durations);
+			result = std::move(cached_result);
+			loaded = true;
+		}
+	}
+
+	munmap(pointer, stat.st_size);
+
+	if (!loaded)
+	{
+		YANET_LOG_WARNING("acl::cache: invalid file '%s'\n", file_path.data());
+		return false;
+	}
+
+	/// touch, to keep recently used results
+	utimensat(AT_FDCWD, file_path.data(), nullptr, 0);
+
+	YANET_LOG_INFO("acl::cache: hit %016lx\n", key);
+	return true;
+}
+
+void cache_t::save(const uint64_t key, const result_t& result) const
+{
+	if (!enabled())
+	{
+		return;
+	}
+
+	common::stream_out_t stream;
+	stream.push(result);
+	const auto& buffer = stream.getBuffer();
+
+	header_t header;
+	memset(&header, 0, sizeof(header));
+	header.magic = magic;
+	header.version = version;
+	header.key = key;
+	header.size = buffer.size();
+
+	/// write to temporary file and rename, so that readers never see partial file
+	const auto file_path = path(key);
+	const auto temporary_path = file_path + ".tmp";
+
+	try
+	{
+		std::filesystem::create_directories(directory);
+
+		{
+			std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+			file.write((const char*)&header, sizeof(header));
+			file.write((const char*)buffer.data(), buffer.size());
+			file.close();
+
+			if (!file)
+			{
+				throw std::runtime_error("write failed");
+			}
+		}
+
+		std::filesystem::rename(temporary_path, file_path);
+
+		remove_old_files();
+	}
+	catch (const std::exception& ex)
+	{
+		YANET_LOG_WARNING("acl::cache: can't save '%s': %s\n", file_path.data(), ex.what());
+
+		std::error_code error_code;
+		std::filesystem::remove(temporary_path, error_code);
+		return;
+	}
+
+	YANET_LOG_INFO("acl::cache: saved %016lx, %lu bytes\n", key, buffer.size());
+}
+
+std::string cache_t::path(const uint64_t key) const
+{
+	char name[64];
+	snprintf(name, sizeof(name), "acl.%016lx.cache", key);
+
+	return directory + "/" + name;
+}
+
+void cache_t::remove_old_files() const
+{
+	std::vector<std::tuple<std::filesystem::file_time_type, std::filesystem::path>> files;
+	for (const auto& entry : std::filesystem::directory_iterator(directory))
+	{
+		const auto name = entry.path().filename().string();
+		if (entry.is_regular_file() &&
+		    name.find("acl.") == 0 &&
+		    entry.path().extension() == ".cache")
+		{
+			files.emplace_back(entry.last_write_time(), entry.path());
+		}
+	}
+
+	if (files.size() <= files_count)
+	{
+		return;
+	}
+
+	std::sort(files.begin(), files.end());
+	for (unsigned int i = 0;
+	     i < files.size() - files_count;
+	     i++)
+	{
+		std::error_code error_code;
+		std::filesystem::remove(std::get<1>(files[i]), error_code);
+	}
+}
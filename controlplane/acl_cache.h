@@ -0,0 +1,51 @@
+#pragma once
+
+#include "acl.h"
+
+namespace acl
+{
+
+/// on-disk cache of compiled acls, keyed by hash of compilation inputs.
+/// each file is a fixed header followed by serialized result_t, so it is read by one mmap.
+/// only last 'files_count' results are kept, to make rollback to previous config fast too
+class cache_t
+{
+public:
+	cache_t(const std::string& directory, ///< empty: disabled
+	        const unsigned int files_count = 8);
+
+public:
+	bool enabled() const;
+
+	/// hash of firewall sources, dispatcher rules, interfaces and of build version
+	static uint64_t key(const unsigned int transport_layers_size,
+	                    const std::map<std::string, controlplane::base::acl_t>& acls,
+	                    const iface_map_t& iface_map);
+
+	/// returns false, if there is no valid cached result for key
+	bool load(const uint64_t key, result_t& result) const;
+
+	void save(const uint64_t key, const result_t& result) const;
+
+protected:
+	constexpr static uint64_t magic = 0x59414E4554414331ull; ///< "YANETAC1"
+	constexpr static uint32_t version = 2; ///< increment on change of result_t layout
+
+	struct header_t
+	{
+		uint64_t magic;
+		uint32_t version;
+		uint32_t reserved;
+		uint64_t key;
+		uint64_t size; ///< of serialized result_t, following header
+	};
+
+	std::string path(const uint64_t key) const;
+	void remove_old_files() const;
+
+protected:
+	std::string directory;
+	unsigned int files_count;
+};
+
+}
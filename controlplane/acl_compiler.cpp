@@ -1,9 +1,15 @@
+#include <chrono>
+
+#include "common/stream.h"
+
 #include "acl_compiler.h"
 #include "acl_filter.h"
+#include "acl_tasks.h"
 
 using namespace acl;
 
-compiler_t::compiler_t() :
+compiler_t::compiler_t(const unsigned int threads_count) :
+        threads_count(compiler::tasks_t::get_threads_count(threads_count)),
         transport_layers_size(0),
         transport_layers_shift(0),
         network_ipv4_source(this),
@@ -26,32 +32,25 @@ void compiler_t::compile(const unsigned int transport_layers_size,
 
 	YANET_LOG_INFO("acl::compile: rules: %lu\n", unwind_rules.size());
 
-	YANET_LOG_INFO("acl::compile: clear\n");
-	clear();
-
-	YANET_LOG_INFO("acl::compile: collect\n");
-	collect(unwind_rules);
-
-	YANET_LOG_INFO("acl::compile: network_compile\n");
-	network_compile();
-
-	YANET_LOG_INFO("acl::compile: network_table_compile\n");
-	network_table_compile();
-
-	YANET_LOG_INFO("acl::compile: network_flags_compile\n");
-	network_flags_compile();
-
-	YANET_LOG_INFO("acl::compile: transport_compile\n");
-	transport_compile();
-
-	YANET_LOG_INFO("acl::compile: transport_table_compile\n");
-	transport_table_compile();
-
-	YANET_LOG_INFO("acl::compile: total_table_compile\n");
-	total_table_compile();
-
-	YANET_LOG_INFO("acl::compile: value_compile\n");
-	value_compile();
+	/// wall time of each stage is reported in result.durations
+	auto stage = [&](const char* name, const auto& function) {
+		YANET_LOG_INFO("acl::compile: %s\n", name);
+
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		result.durations.emplace_back(name, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	};
+
+	stage("clear", [&]() { clear(); });
+	stage("collect", [&]() { collect(unwind_rules); });
+	stage("network_compile", [&]() { network_compile(); });
+	stage("network_table_compile", [&]() { network_table_compile(); });
+	stage("network_flags_compile", [&]() { network_flags_compile(); });
+	stage("transport_compile", [&]() { transport_compile(); });
+	stage("transport_table_compile", [&]() { transport_table_compile(); });
+	stage("total_table_compile", [&]() { total_table_compile(); });
+	stage("value_compile", [&]() { value_compile(); });
+	stage("network_table_compress", [&]() { network_table.compress(); });
 
 	YANET_LOG_INFO("acl::compile: result\n");
 
@@ -70,8 +69,9 @@ void compiler_t::compile(const unsigned int transport_layers_size,
 	result.acl_network_ipv6_destination.swap(network_ipv6_destination.tree.chunks);
 
 	{
-		auto& [width, values] = result.acl_network_table;
+		auto& [width, rows, values] = result.acl_network_table;
 		width = network_table.width;
+		rows.swap(network_table.rows);
 		values.swap(network_table.values);
 	}
 
@@ -332,15 +332,29 @@ void compiler_t::collect(const std::vector<rule_t>& unwind_rules)
 
 void compiler_t::network_compile()
 {
-	network_ipv4_source.prepare();
-	network_ipv4_destination.prepare();
-	network_ipv6_source.prepare();
-	network_ipv6_destination.prepare();
-
-	network_ipv4_source.compile();
-	network_ipv4_destination.compile();
-	network_ipv6_source.compile();
-	network_ipv6_destination.compile();
+	/// trees are independent until remap, which shares group ids
+	compiler::tasks_t tasks(threads_count);
+	tasks.add([this]() {
+		network_ipv4_source.prepare();
+		network_ipv4_source.compile();
+		network_ipv4_source.populate();
+	});
+	tasks.add([this]() {
+		network_ipv4_destination.prepare();
+		network_ipv4_destination.compile();
+		network_ipv4_destination.populate();
+	});
+	tasks.add([this]() {
+		network_ipv6_source.prepare();
+		network_ipv6_source.compile();
+		network_ipv6_source.populate();
+	});
+	tasks.add([this]() {
+		network_ipv6_destination.prepare();
+		network_ipv6_destination.compile();
+		network_ipv6_destination.populate();
+	});
+	tasks.run();
 
 	YANET_LOG_INFO("acl::compile: extended_chunks: %lu, %lu, %lu, %lu\n",
 	               network_ipv4_source.tree.chunks.size(),
@@ -348,11 +362,6 @@ void compiler_t::network_compile()
 	               network_ipv6_source.tree.chunks.size(),
 	               network_ipv6_destination.tree.chunks.size());
 
-	network_ipv4_source.populate();
-	network_ipv4_destination.populate();
-	network_ipv6_source.populate();
-	network_ipv6_destination.populate();
-
 	YANET_LOG_INFO("acl::compile: group_ids: %lu, %lu, %lu, %lu\n",
 	               network_ipv4_source.reverse_map.size(),
 	               network_ipv4_destination.reverse_map.size(),
@@ -477,3 +486,210 @@ void compiler_t::value_compile()
 	YANET_LOG_INFO("acl::compile: size: %lu\n",
 	               value.vector.size());
 }
+
+/// rule_t::operator== doesn't compare via, but compiler uses it
+static bool equal_rules(const std::vector<rule_t>& first,
+                        const std::vector<rule_t>& second)
+{
+	if (first.size() != second.size())
+	{
+		return false;
+	}
+
+	for (unsigned int rule_id = 0;
+	     rule_id < first.size();
+	     rule_id++)
+	{
+		if (!(first[rule_id] == second[rule_id]) ||
+		    !(first[rule_id].filter->acl_id == second[rule_id].filter->acl_id))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename request_T>
+static bool equal_tables(const request_T& first,
+                         const request_T& second)
+{
+	common::stream_out_t first_stream;
+	first_stream.push(first);
+
+	common::stream_out_t second_stream;
+	second_stream.push(second);
+
+	return first_stream.getBuffer() == second_stream.getBuffer();
+}
+
+incremental_t::incremental_t() :
+        changed(false)
+{
+}
+
+bool incremental_t::compile(const unsigned int transport_layers_size,
+                            std::vector<rule_t>&& unwind_rules,
+                            result_t& result,
+                            const std::function<bool(result_t&)>& load)
+{
+	if (current.valid &&
+	    current.transport_layers_size == transport_layers_size &&
+	    equal_rules(current.rules, unwind_rules))
+	{
+		YANET_LOG_INFO("acl::compile: rules are not changed, skip\n");
+		changed = false;
+		return false;
+	}
+
+	/// tables of previous reload don't matter: update() pushes difference to loaded tables too
+	if (!load ||
+	    !load(result))
+	{
+		acl::compiler_t compiler;
+		compiler.compile(transport_layers_size, unwind_rules, result);
+	}
+
+	next.transport_layers_size = transport_layers_size;
+	next.rules = std::move(unwind_rules);
+	changed = true;
+	return true;
+}
+
+void incremental_t::update(result_t& result,
+                           common::idp::updateGlobalBase::request& globalbase)
+{
+	using common::idp::updateGlobalBase::requestType;
+
+	if (!changed)
+	{
+		return;
+	}
+
+	update_table(requestType::acl_network_ipv4_source, current.result.acl_network_ipv4_source, result.acl_network_ipv4_source, next.result.acl_network_ipv4_source, globalbase);
+	update_table(requestType::acl_network_ipv4_destination, current.result.acl_network_ipv4_destination, result.acl_network_ipv4_destination, next.result.acl_network_ipv4_destination, globalbase);
+	update_table(requestType::acl_network_ipv6_source, current.result.acl_network_ipv6_source, result.acl_network_ipv6_source, next.result.acl_network_ipv6_source, globalbase);
+	update_table(requestType::acl_network_ipv6_destination_ht, current.result.acl_network_ipv6_destination_ht, result.acl_network_ipv6_destination_ht, next.result.acl_network_ipv6_destination_ht, globalbase);
+	update_table(requestType::acl_network_ipv6_destination, current.result.acl_network_ipv6_destination, result.acl_network_ipv6_destination, next.result.acl_network_ipv6_destination, globalbase);
+	update_table(requestType::acl_network_table, current.result.acl_network_table, result.acl_network_table, next.result.acl_network_table, globalbase);
+	update_table(requestType::acl_network_flags, current.result.acl_network_flags, result.acl_network_flags, next.result.acl_network_flags, globalbase);
+	update_table(requestType::acl_transport_layers, current.result.acl_transport_layers, result.acl_transport_layers, next.result.acl_transport_layers, globalbase);
+
+	{
+		if (result.acl_transport_tables.size() != 1)
+		{
+			throw std::runtime_error("support multithread here");
+		}
+
+		update_hashtable<common::acl::transport_key_t,
+		                 common::idp::updateGlobalBase::acl_transport_table::request,
+		                 common::idp::updateGlobalBase::acl_transport_table_delta::request>(requestType::acl_transport_table,
+		                                                                                     requestType::acl_transport_table_delta,
+		                                                                                     current.transport_table,
+		                                                                                     result.acl_transport_tables[0],
+		                                                                                     next.transport_table,
+		                                                                                     globalbase);
+	}
+
+	update_hashtable<common::acl::total_key_t,
+	                 common::idp::updateGlobalBase::acl_total_table::request,
+	                 common::idp::updateGlobalBase::acl_total_table_delta::request>(requestType::acl_total_table,
+	                                                                                 requestType::acl_total_table_delta,
+	                                                                                 current.total_table,
+	                                                                                 result.acl_total_table,
+	                                                                                 next.total_table,
+	                                                                                 globalbase);
+
+	update_table(requestType::acl_values, current.result.acl_values, result.acl_values, next.result.acl_values, globalbase);
+}
+
+void incremental_t::commit()
+{
+	if (changed)
+	{
+		current = std::move(next);
+		current.valid = true;
+	}
+
+	next = {};
+	changed = false;
+}
+
+void incremental_t::reset()
+{
+	current = {};
+	next = {};
+	changed = false;
+}
+
+template<typename request_T>
+void incremental_t::update_table(const common::idp::updateGlobalBase::requestType type,
+                                 const request_T& current_table,
+                                 request_T& table,
+                                 request_T& next_table,
+                                 common::idp::updateGlobalBase::request& globalbase)
+{
+	if (!current.valid ||
+	    !equal_tables(current_table, table))
+	{
+		globalbase.emplace_back(type, table);
+	}
+
+	next_table = std::move(table);
+}
+
+template<typename key_T,
+         typename request_T,
+         typename delta_request_T>
+void incremental_t::update_hashtable(const common::idp::updateGlobalBase::requestType type,
+                                     const common::idp::updateGlobalBase::requestType delta_type,
+                                     const std::map<key_T, tAclGroupId>& current_table,
+                                     request_T& table,
+                                     std::map<key_T, tAclGroupId>& next_table,
+                                     common::idp::updateGlobalBase::request& globalbase)
+{
+	next_table.clear();
+	for (const auto& [key, group_id] : table)
+	{
+		next_table.emplace(key, group_id);
+	}
+
+	if (!current.valid)
+	{
+		globalbase.emplace_back(type, std::move(table));
+		return;
+	}
+
+	delta_request_T delta;
+	auto& [keys, removed_keys] = delta;
+
+	for (const auto& [key, group_id] : next_table)
+	{
+		auto it = current_table.find(key);
+		if (it == current_table.end() ||
+		    it->second != group_id)
+		{
+			keys.emplace_back(key, group_id);
+		}
+	}
+
+	for (const auto& [key, group_id] : current_table)
+	{
+		(void)group_id;
+
+		if (next_table.find(key) == next_table.end())
+		{
+			removed_keys.emplace_back(key);
+		}
+	}
+
+	YANET_LOG_INFO("acl::update: table: %lu keys, delta: %lu updated, %lu removed\n",
+	               next_table.size(),
+	               keys.size(),
+	               removed_keys.size());
+
+	if (keys.size() || removed_keys.size())
+	{
+		globalbase.emplace_back(delta_type, std::move(delta));
+	}
+}
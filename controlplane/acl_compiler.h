@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "acl/rule.h"
 
 #include "acl_base.h"
@@ -49,7 +51,7 @@ namespace acl
 class compiler_t
 {
 public:
-	compiler_t();
+	compiler_t(const unsigned int threads_count = 0); ///< 0: hardware concurrency
 
 public:
 	void compile(const unsigned int transport_layers_size,
@@ -67,6 +69,7 @@ public:
 	void value_compile();
 
 public:
+	unsigned int threads_count;
 	unsigned int transport_layers_size;
 	unsigned int transport_layers_shift;
 
@@ -91,4 +94,66 @@ public:
 	std::vector<uint32_t> used_rules;
 };
 
+/// keeps acl tables pushed to dataplane by last reload:
+///   unwound rules are equal to previous ones - compilation is skipped
+///   otherwise - only changed tables are pushed, transport and total tables as delta of keys
+class incremental_t
+{
+public:
+	incremental_t();
+
+public:
+	/// returns false, if compilation is skipped.
+	/// 'load' fills tables from cache (see acl::cache_t). it is called only if rules are changed
+	bool compile(const unsigned int transport_layers_size,
+	             std::vector<rule_t>&& unwind_rules,
+	             result_t& result,
+	             const std::function<bool(result_t&)>& load = nullptr);
+
+	/// moves changed tables from result to globalbase
+	void update(result_t& result,
+	            common::idp::updateGlobalBase::request& globalbase);
+
+	/// dataplane accepted globalbase
+	void commit();
+
+	/// dataplane state is unknown. push all tables on next reload
+	void reset();
+
+protected:
+	class tables_t
+	{
+	public:
+		bool valid = false;
+		unsigned int transport_layers_size = 0;
+		std::vector<rule_t> rules;
+
+		result_t result; ///< only tables, except transport and total
+		std::map<common::acl::transport_key_t, tAclGroupId> transport_table;
+		std::map<common::acl::total_key_t, tAclGroupId> total_table;
+	};
+
+	template<typename request_T>
+	void update_table(const common::idp::updateGlobalBase::requestType type,
+	                  const request_T& current_table,
+	                  request_T& table,
+	                  request_T& next_table,
+	                  common::idp::updateGlobalBase::request& globalbase);
+
+	template<typename key_T,
+	         typename request_T,
+	         typename delta_request_T>
+	void update_hashtable(const common::idp::updateGlobalBase::requestType type,
+	                      const common::idp::updateGlobalBase::requestType delta_type,
+	                      const std::map<key_T, tAclGroupId>& current_table,
+	                      request_T& table,
+	                      std::map<key_T, tAclGroupId>& next_table,
+	                      common::idp::updateGlobalBase::request& globalbase);
+
+protected:
+	tables_t current;
+	tables_t next;
+	bool changed;
+};
+
 }
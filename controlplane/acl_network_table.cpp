@@ -1,3 +1,5 @@
+#include <string_view>
+
 #include "acl_network_table.h"
 #include "acl_compiler.h"
 
@@ -13,6 +15,7 @@ void network_table_t::clear()
 {
 	width = 0;
 	values.resize(0);
+	rows.clear();
 	remap_group_ids.clear();
 	group_id = 1;
 	filters.clear();
@@ -250,3 +253,52 @@ void network_table_t::remap()
 		}
 	}
 }
+
+/// many source groups have same row of group_ids. keep each row once and index of row by source group_id,
+/// if it takes less memory than full table
+void network_table_t::compress()
+{
+	rows.clear();
+
+	if (!width)
+	{
+		return;
+	}
+
+	const uint32_t height = values.size() / width;
+	const size_t row_size = width * sizeof(tAclGroupId);
+
+	std::vector<tAclGroupId> compressed_values;
+	std::unordered_map<std::string_view, uint32_t> row_ids;
+
+	rows.reserve(height);
+	for (uint32_t k1 = 0;
+	     k1 < height;
+	     k1++)
+	{
+		const std::string_view row((const char*)&values[k1 * width], row_size);
+
+		auto it = row_ids.find(row);
+		if (it == row_ids.end())
+		{
+			const uint32_t row_id = row_ids.size();
+			if (height + ((size_t)row_id + 1) * width >= values.size())
+			{
+				/// doesn't save memory
+				rows.clear();
+				return;
+			}
+
+			compressed_values.insert(compressed_values.end(), &values[k1 * width], &values[k1 * width] + width);
+			it = row_ids.emplace_hint(it, row, row_id);
+		}
+
+		rows.emplace_back(it->second);
+	}
+
+	YANET_LOG_INFO("acl::compile: network_table: compressed %lu -> %lu\n",
+	               values.size(),
+	               rows.size() + compressed_values.size());
+
+	values.swap(compressed_values);
+}
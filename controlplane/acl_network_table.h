@@ -23,12 +23,14 @@ public:
 	void compile();
 	void populate();
 	void remap();
+	void compress();
 
 public:
 	acl::compiler_t* compiler;
 
 	uint32_t width;
 	std::vector<tAclGroupId> values;
+	std::vector<uint32_t> rows; ///< row of values by source group_id, if values are compressed by compress()
 
 	std::vector<tAclGroupId> remap_group_ids;
 	tAclGroupId group_id;
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace acl::compiler
+{
+
+/// runs independent tasks of acl compilation on up to 'threads_count' threads.
+/// calling thread runs tasks too. first exception of tasks is rethrown by run()
+class tasks_t
+{
+public:
+	tasks_t(const unsigned int threads_count) :
+	        threads_count(std::max(1u, threads_count))
+	{
+	}
+
+	/// 0: hardware concurrency
+	static unsigned int get_threads_count(const unsigned int threads_count)
+	{
+		if (threads_count)
+		{
+			return threads_count;
+		}
+
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+public:
+	void add(std::function<void()>&& task)
+	{
+		tasks.emplace_back(std::move(task));
+	}
+
+	void run()
+	{
+		std::atomic<size_t> next_task_id = 0;
+		std::mutex exception_mutex;
+		std::exception_ptr exception;
+
+		auto thread_main = [&]() {
+			for (;;)
+			{
+				const size_t task_id = next_task_id.fetch_add(1);
+				if (task_id >= tasks.size())
+				{
+					return;
+				}
+
+				try
+				{
+					tasks[task_id]();
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> guard(exception_mutex);
+					if (!exception)
+					{
+						exception = std::current_exception();
+					}
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (size_t thread_id = 1;
+		     thread_id < std::min((size_t)threads_count, tasks.size());
+		     thread_id++)
+		{
+			threads.emplace_back(thread_main);
+		}
+
+		thread_main();
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		tasks.clear();
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+protected:
+	unsigned int threads_count;
+	std::vector<std::function<void()>> tasks;
+};
+
+}
@@ -1,5 +1,8 @@
+#include <algorithm>
+
 #include "acl_total_table.h"
 #include "acl_compiler.h"
+#include "acl_tasks.h"
 
 using namespace acl::compiler;
 
@@ -22,6 +25,8 @@ void total_table_t::clear()
 	map.clear();
 	reverse_map.clear();
 	reverse_map_next.clear();
+	threads.clear();
+	values_size = 0;
 }
 
 unsigned int total_table_t::collect(const unsigned int rule_id, const filter& filter)
@@ -46,6 +51,59 @@ void total_table_t::prepare()
 
 void total_table_t::compile()
 {
+	/// keys of different acl_ids don't intersect, so acl_ids are compiled in parallel.
+	/// values of keys are merged after, as value_t::collect() is not thread safe
+	const unsigned int threads_count = compiler->threads_count;
+
+	values_size = compiler->value.filters.size();
+	threads.resize(threads_count);
+
+	compiler::tasks_t tasks(threads_count);
+	for (unsigned int thread_id = 0;
+	     thread_id < threads_count;
+	     thread_id++)
+	{
+		tasks.add([this, thread_id, threads_count]() {
+			compile_thread(thread_id, threads_count);
+		});
+	}
+	tasks.run();
+
+	for (auto& thread : threads)
+	{
+		for (const auto& [key, thread_group_id] : thread.table)
+		{
+			tAclGroupId group_id = thread_group_id;
+			if (thread_group_id >= values_size)
+			{
+				const auto& chain = thread.chains[thread_group_id - values_size];
+
+				group_id = chain[0];
+				for (unsigned int i = 1;
+				     i < chain.size();
+				     i++)
+				{
+					group_id = compiler->value.collect(group_id, chain[i]);
+				}
+			}
+
+			table.emplace_hint(table.end(), key, group_id);
+		}
+
+		compiler->used_rules.insert(compiler->used_rules.end(),
+		                            thread.used_rules.begin(),
+		                            thread.used_rules.end());
+	}
+
+	std::sort(compiler->used_rules.begin(), compiler->used_rules.end());
+	threads.clear();
+}
+
+void total_table_t::compile_thread(const unsigned int thread_id,
+                                   const unsigned int threads_count)
+{
+	auto& thread = threads[thread_id];
+
 	common::acl::total_key_t key;
 	memset(&key, 0, sizeof(key));
 
@@ -54,27 +112,32 @@ void total_table_t::compile()
 		const auto filter_id = rule.total_table_filter_id;
 		const auto group_id = rule.value_filter_id;
 
-		if (!filter_id_group_ids[filter_id].empty())
+		const auto& [acl_id, transport_table_filter_id] = filters[filter_id];
+		/// @todo: acl_id -> via_filter_id
+
+		if (acl_id % threads_count != thread_id)
 		{
 			continue;
 		}
 
-		const auto& [acl_id, transport_table_filter_id] = filters[filter_id];
-		/// @todo: acl_id -> via_filter_id
+		if (!filter_id_group_ids[filter_id].empty())
+		{
+			continue;
+		}
 
 		key.acl_id = acl_id;
 		bool used = false;
-		for (const auto& thread : compiler->transport_table.threads)
+		for (const auto& transport_table_thread : compiler->transport_table.threads)
 		{
-			for (const auto transport_table_group_id : thread.transport_table_filter_id_group_ids[transport_table_filter_id])
+			for (const auto transport_table_group_id : transport_table_thread.transport_table_filter_id_group_ids[transport_table_filter_id])
 			{
 				key.transport_id = transport_table_group_id;
-				auto it = table.find(key);
-				if (it == table.end())
+				auto it = thread.table.find(key);
+				if (it == thread.table.end())
 				{
 					// If there is no such key in table, then we save [key, group_id]
 					// without any additional checks.
-					it = table.emplace_hint(it, key, group_id);
+					it = thread.table.emplace_hint(it, key, group_id);
 					used = true;
 				}
 				else
@@ -83,7 +146,7 @@ void total_table_t::compile()
 					// new combination of the previous group_id and the current group_id.
 					// If new_group_id differs from the current group_id, then we replace
 					// the previous group_id with the new one. Otherwise we don't do anything.
-					const auto new_group_id = compiler->value.collect(it->second, group_id);
+					const auto new_group_id = collect_thread(thread, it->second, group_id);
 					if (new_group_id != it->second)
 					{
 						it->second = new_group_id;
@@ -102,7 +165,41 @@ void total_table_t::compile()
 
 		if (used)
 		{
-			compiler->used_rules.emplace_back(rule.rule_id);
+			thread.used_rules.emplace_back(rule.rule_id);
 		}
 	}
 }
+
+// Same as value_t::collect(prev_id, id), but new combinations are kept in thread.
+tAclGroupId total_table_t::collect_thread(thread_t& thread,
+                                          const tAclGroupId prev_id,
+                                          const tAclGroupId id)
+{
+	const auto& value_filters = compiler->value.filters;
+
+	std::vector<tAclGroupId> chain;
+	if (prev_id < values_size)
+	{
+		chain.emplace_back(prev_id);
+	}
+	else
+	{
+		chain = thread.chains[prev_id - values_size];
+	}
+
+	if (std::holds_alternative<common::globalBase::flow_t>(value_filters[chain.back()].back()))
+	{
+		return prev_id;
+	}
+
+	chain.emplace_back(id);
+
+	auto it = thread.chain_ids.find(chain);
+	if (it == thread.chain_ids.end())
+	{
+		thread.chains.emplace_back(chain);
+		it = thread.chain_ids.emplace_hint(it, std::move(chain), values_size + thread.chains.size() - 1);
+	}
+
+	return it->second;
+}
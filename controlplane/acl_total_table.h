@@ -17,17 +17,34 @@ public:
 	using filter = std::tuple<unsigned int, ///< via_filter_id
 	                          unsigned int>; ///< transport_table_filter_id
 
+	/// keys of acl_ids with (acl_id % threads_count == thread_id), compiled by one thread.
+	/// group_id is value filter_id, if less than values_size. otherwise it is (values_size + chain_id)
+	class thread_t
+	{
+	public:
+		std::map<common::acl::total_key_t, tAclGroupId> table;
+		std::vector<std::vector<tAclGroupId>> chains; ///< value filter_ids of non-terminating rules and last rule
+		std::map<std::vector<tAclGroupId>, tAclGroupId> chain_ids;
+		std::vector<uint32_t> used_rules;
+	};
+
 	void clear();
 	unsigned int collect(const unsigned int rule_id, const filter& filter);
 	void prepare();
 	void compile();
 	void compile_thread(const unsigned int thread_id, const unsigned int threads_count);
 
+protected:
+	tAclGroupId collect_thread(thread_t& thread, const tAclGroupId prev_id, const tAclGroupId id);
+
 public:
 	acl::compiler_t* compiler;
 
 	std::map<common::acl::total_key_t, tAclGroupId> table;
 
+	std::vector<thread_t> threads;
+	tAclGroupId values_size;
+
 	std::vector<tAclGroupId> remap_group_ids;
 	tAclGroupId group_id;
 
@@ -425,12 +425,17 @@ public:
 	        nat64statelessTranslationsCount(0),
 	        services_count(0),
 	        reals_count(0),
+	        maglev_services_count(0),
 	        tun64MappingsCount(0),
 	        storeSamples(false),
 	        serial(0),
 	        nat64stateful_pool_size(0)
 	{
 		variables["balancer_real_timeout"] = 900;
+		variables["rib_snapshot_interval"] = 60;
+		variables["rib_stale_timeout"] = 300;
+		variables["rib_flush_latency"] = 50;
+		variables["rib_flush_batch_size"] = 4096;
 	}
 
 public:
@@ -439,6 +444,7 @@ public:
 	tNat64statelessTranslationId nat64statelessTranslationsCount;
 	balancer_service_id_t services_count;
 	balancer_real_id_t reals_count;
+	uint32_t maglev_services_count; ///< maglev table of each service takes YANET_CONFIG_BALANCER_MAGLEV_TABLE_SIZE weights
 	tun64_id_t tun64MappingsCount;
 	std::map<tInterfaceId, std::string> interfaceNames; ///< @todo: per route
 	std::map<tSocketId, std::set<tInterfaceId>> socket_interfaces; ///< @todo: per route
@@ -463,6 +469,8 @@ public:
 	uint32_t serial;
 
 	std::map<std::string, common::uint64> variables;
+	std::string acl_cache; ///< directory of compiled acls cache, disabled if empty
+	std::string rib_snapshot; ///< path of rib snapshot for warm restart, disabled if empty
 	std::map<std::string, ///< vrf
 	         std::map<common::ip_address_t,
 	                  std::vector<std::string>>>
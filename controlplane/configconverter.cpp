@@ -6,6 +6,7 @@
 #include <netinet/ip_icmp.h>
 
 #include "acl.h"
+#include "acl_cache.h"
 #include "configconverter.h"
 #include "controlplane.h"
 #include "errors.h"
@@ -1723,24 +1724,48 @@ void config_converter_t::buildAcl()
 	acl::result_t result; ///< @todo: move to class
 
 	auto iface_map = acl::ifaceMapping(baseNext.logicalPorts, baseNext.routes);
+	bool compiled = true;
+	bool cached = false;
 	try
 	{
 		const auto& [dataplane_physicalports, dataplane_workers, dataplane_values] = controlplane->dataPlaneConfig;
 		(void)dataplane_physicalports;
 		(void)dataplane_workers;
 
-		acl::compile(dataplane_values[(unsigned int)common::idp::getConfig::value_type::acl_transport_layers_size],
-		             baseNext.acls,
-		             iface_map,
-		             result);
+		const auto transport_layers_size = dataplane_values[(unsigned int)common::idp::getConfig::value_type::acl_transport_layers_size];
+
+		acl::cache_t cache(baseNext.acl_cache);
+		const auto cache_key = cache.enabled() ? acl::cache_t::key(transport_layers_size, baseNext.acls, iface_map) : 0;
+
+		/// unchanged rules are skipped before, changed rules are loaded from cache if possible (restart or rollback)
+		compiled = acl::compile(transport_layers_size,
+		                        baseNext.acls,
+		                        iface_map,
+		                        result,
+		                        controlplane->acl_incremental,
+		                        [&](acl::result_t& result) {
+			                        cached = cache.load(cache_key, result);
+			                        return cached;
+		                        });
+		if (compiled &&
+		    !cached)
+		{
+			cache.save(cache_key, result);
+		}
 	}
 	catch (...)
 	{
 		throw error_result_t(eResult::invalidConfigurationFile, "can not compile acls");
 	}
 
-	YANET_LOG_INFO("ACL compilation finished in %.3f ms\n",
+	YANET_LOG_INFO("ACL compilation %s in %.3f ms\n",
+	               cached ? "loaded from cache" : (compiled ? "finished" : "skipped"),
 	               std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count());
+	const auto start = controlplane->durations.add("reload.convert.acl_compile", now);
+	for (const auto& [stage, duration] : result.durations)
+	{
+		controlplane->durations.add("reload.convert.acl_compile." + stage, duration);
+	}
 
 	baseNext.iface_map = iface_map;
 	for (const auto& [name, aclId] : result.in_iface_map)
@@ -1767,25 +1792,10 @@ void config_converter_t::buildAcl()
 	serializeLogicalPorts();
 	serializeRoutes();
 
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_ipv4_source, std::move(result.acl_network_ipv4_source));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_ipv4_destination, std::move(result.acl_network_ipv4_destination));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_ipv6_source, std::move(result.acl_network_ipv6_source));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_ipv6_destination_ht, std::move(result.acl_network_ipv6_destination_ht));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_ipv6_destination, std::move(result.acl_network_ipv6_destination));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_table, std::move(result.acl_network_table));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_network_flags, std::move(result.acl_network_flags));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_transport_layers, std::move(result.acl_transport_layers));
-
-	{
-		if (result.acl_transport_tables.size() != 1)
-		{
-			throw std::runtime_error("support multithread here");
-		}
-		globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_transport_table, std::move(result.acl_transport_tables[0]));
-	}
+	/// only changed tables, see acl::incremental_t
+	controlplane->acl_incremental.update(result, globalbase);
+	controlplane->durations.add("reload.convert.acl_update", start);
 
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_total_table, std::move(result.acl_total_table));
-	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::acl_values, std::move(result.acl_values));
 	globalbase.emplace_back(common::idp::updateGlobalBase::requestType::dump_tags_ids, std::move(result.dump_id_to_tag));
 
 	common::idp::updateGlobalBase::fwstate_synchronization_update::request fwstate_sync_request;
@@ -114,6 +114,16 @@ controlplane::base_t config_parser_t::loadConfig(const std::string& rootFilePath
 			loadConfig_variables(baseNext, rootJson["variables"]);
 		}
 
+		if (exist(rootJson, "acl_cache"))
+		{
+			baseNext.acl_cache = rootJson["acl_cache"];
+		}
+
+		if (exist(rootJson, "rib_snapshot"))
+		{
+			baseNext.rib_snapshot = rootJson["rib_snapshot"];
+		}
+
 		if (exist(rootJson, "fqdns"))
 		{
 			for (const auto& path_json : rootJson["fqdns"])
@@ -570,6 +580,17 @@ void config_parser_t::loadConfig_nat64stateful(controlplane::base_t& baseNext,
 		nat64stateful.state_timeout = moduleJson["state_timeout"];
 	}
 
+	if (exist(moduleJson, "port_block_size"))
+	{
+		unsigned int port_block_size = moduleJson["port_block_size"];
+		if (port_block_size > 0xFFFF - 1023)
+		{
+			throw error_result_t(eResult::invalidConfigurationFile, "nat64stateful: invalid port_block_size");
+		}
+
+		nat64stateful.port_block_size = port_block_size;
+	}
+
 	nat64stateful.next_module = moduleJson.value("nextModule", "");
 	nat64stateful.nat64stateful_id = nat64stateful_id;
 
@@ -1578,6 +1599,17 @@ void config_parser_t::loadConfig_balancer_services(controlplane::base_t& baseNex
 				scheduler_params.wlc_power = std::stoll(service_json["scheduler_params"]["wlc_power"].get<std::string>(), nullptr, 10);
 			}
 		}
+		else if (scheduler_string == "maglev")
+		{
+			scheduler = balancer::scheduler::maglev;
+
+			if ((uint64_t)(baseNext.maglev_services_count + 1) * YANET_CONFIG_BALANCER_MAGLEV_TABLE_SIZE > YANET_CONFIG_BALANCER_WEIGHTS_SIZE)
+			{
+				throw error_result_t(eResult::invalidConfigurationFile, "too many maglev services: maglev tables don't fit in balancer weights");
+			}
+
+			baseNext.maglev_services_count++;
+		}
 		else
 		{
 			throw error_result_t(eResult::invalidConfigurationFile, "unknown scheduler: " + scheduler_string);
@@ -1611,7 +1643,7 @@ void config_parser_t::loadConfig_balancer_services(controlplane::base_t& baseNex
 			}
 
 			unsigned int weight = 1;
-			if (scheduler == ::balancer::scheduler::wrr || scheduler == ::balancer::scheduler::wlc)
+			if (scheduler == ::balancer::scheduler::wrr || scheduler == ::balancer::scheduler::wlc || scheduler == ::balancer::scheduler::maglev)
 			{
 				if (exist(real_json, "weight"))
 				{
@@ -901,8 +901,10 @@ eResult cControlPlane::loadConfig(const std::string& rootFilePath,
 				{
 					// Since now the dataplane is locked for further changes
 					// and considered broken.
+					acl_incremental.reset();
 					return result;
 				}
+				acl_incremental.commit();
 				start = durations.add("reload.dataplane", start);
 
 				YANET_LOG_INFO("globalbase updated (stage 6), serial %d\n", serial);
@@ -18,6 +18,7 @@
 #include "common/result.h"
 #include "libprotobuf/controlplane.pb.h"
 
+#include "acl_compiler.h"
 #include "balancer.h"
 #include "base.h"
 #include "counter.h"
@@ -203,6 +204,7 @@ protected:
 private:
 	/// used only in loadConfig()
 	controlplane::base_t base;
+	acl::incremental_t acl_incremental; ///< acl tables of last reload
 
 	/// @todo: move to new module
 	std::mutex mac_addresses_mutex;
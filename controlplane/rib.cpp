@@ -1,10 +1,19 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 #include "rib.h"
 #include "common.h"
 #include "controlplane.h"
 
 using namespace controlplane::module;
 
-rib_t::rib_t()
+rib_t::rib_t() :
+        flush_latency(50),
+        flush_batch_size(4096),
+        snapshot_interval(60),
+        snapshot_time(std::chrono::steady_clock::now()),
+        stale_timeout(300)
 {
 }
 
@@ -73,6 +82,75 @@ eResult rib_t::init()
 	return eResult::success;
 }
 
+void rib_t::reload(const controlplane::base_t& base_prev,
+                   const controlplane::base_t& base_next,
+                   common::idp::updateGlobalBase::request& globalbase)
+{
+	(void)globalbase;
+
+	flush_latency = base_next.variables.find("rib_flush_latency")->second.value;
+	flush_batch_size = std::max((uint64_t)1, base_next.variables.find("rib_flush_batch_size")->second.value);
+	stale_timeout = base_next.variables.find("rib_stale_timeout")->second.value;
+
+	{
+		std::lock_guard<std::mutex> snapshot_guard(snapshot_mutex);
+		snapshot_path = base_next.rib_snapshot;
+		snapshot_interval = std::chrono::seconds(base_next.variables.find("rib_snapshot_interval")->second.value);
+	}
+
+	/// warm restart: rib is restored from snapshot of previous run, before routes are resent by peers.
+	/// restored paths are stale, till peers announce them again
+	if (base_prev.rib_snapshot.empty() &&
+	    !base_next.rib_snapshot.empty() &&
+	    std::filesystem::exists(base_next.rib_snapshot))
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		rib::snapshot::reader_t reader;
+		if (reader.open(base_next.rib_snapshot))
+		{
+			snapshot_read(reader, true);
+
+			YANET_LOG_INFO("rib::snapshot: loaded '%s' in %.3f seconds\n",
+			               base_next.rib_snapshot.data(),
+			               std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+	}
+}
+
+void rib_t::controlplane_values(common::icp::controlplane_values::response& controlplane_values) const
+{
+	uint64_t queue_depth = 0;
+	{
+		std::lock_guard<std::mutex> prefixes_rebuild_guard(prefixes_rebuild_mutex);
+		for (const auto& [vrf_priority, updated_prefixes] : prefixes_reb)
+		{
+			(void)vrf_priority;
+			queue_depth += updated_prefixes.size();
+		}
+	}
+
+	controlplane_values.emplace_back("rib.flush.queue_depth", std::to_string(queue_depth));
+	controlplane_values.emplace_back("rib.flush.batches", std::to_string(flush_stats_batches));
+	controlplane_values.emplace_back("rib.flush.prefixes", std::to_string(flush_stats_prefixes));
+	controlplane_values.emplace_back("rib.flush.convergence_last_us", std::to_string(flush_stats_convergence_last));
+	controlplane_values.emplace_back("rib.flush.convergence_max_us", std::to_string(flush_stats_convergence_max));
+
+	{
+		std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
+		controlplane_values.emplace_back("rib.stale_paths", std::to_string(stale_paths.size()));
+	}
+}
+
+void rib_t::stop()
+{
+	{
+		std::lock_guard<std::mutex> flush_wait_guard(flush_wait_mutex);
+	}
+
+	flush_cv.notify_all();
+}
+
 void rib_t::rib_update(const common::icp::rib_update::request& request)
 {
 	std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
@@ -97,7 +175,8 @@ void rib_t::rib_update(const common::icp::rib_update::request& request)
 		}
 	}
 
-	need_flushing = true;
+	flush_notify();
+	snapshot_changed = true;
 }
 
 void rib_t::rib_insert(const common::icp::rib_update::insert& request)
@@ -206,6 +285,11 @@ void rib_t::rib_insert(const common::icp::rib_update::insert& request)
 
 					prefixes_to_path_info_to_nh_ptr[vrf_priority][prefix][current_pptn_index][path_information] = nh_ptr;
 
+					if (!stale_paths.empty())
+					{
+						stale_paths.refresh({vrf, priority, protocol, peer, table_name}, prefix, path_information);
+					}
+
 					if (prefixes_diff || paths_diff || nxthp_stff_diff)
 					{
 						prefixes_reb[vrf_priority].insert(prefix);
@@ -504,10 +588,17 @@ void rib_t::rib_clear(const common::icp::rib_update::clear& request)
 
 void rib_t::rib_eor(const common::icp::rib_update::eor& request)
 {
-	std::lock_guard<std::mutex> summary_guard(summary_mutex);
-
 	const auto& [protocol, vrf, priority, peer, table_name] = request;
 
+	/// paths restored from snapshot, which peer didn't announce again, are withdrawn
+	if (!stale_paths.empty())
+	{
+		const rib::stale_paths_t::key_t key = {vrf, priority, protocol, peer, table_name};
+		stale_remove(key, stale_paths.eor(key));
+	}
+
+	std::lock_guard<std::mutex> summary_guard(summary_mutex);
+
 	auto& [summary_prefixes, summary_paths, summary_eor] = this->summary[{vrf, priority, protocol, peer, table_name}];
 	(void)summary_prefixes;
 	(void)summary_paths;
@@ -517,40 +608,68 @@ void rib_t::rib_eor(const common::icp::rib_update::eor& request)
 
 void rib_t::rib_flush(bool force_flush)
 {
-	std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
+	std::lock_guard<std::mutex> flush_guard(flush_mutex);
+
+	bool pending;
+	std::chrono::steady_clock::time_point pending_time;
+	{
+		std::lock_guard<std::mutex> flush_wait_guard(flush_wait_mutex);
+		pending = need_flushing;
+		pending_time = flush_pending_time;
+		need_flushing = false;
+	}
 
-	bool flush;
+	/// prefixes changed during flush are flushed too, but not more than were queued at start
+	uint64_t prefixes_count = 0;
 	{
+		std::lock_guard<std::mutex> prefixes_rebuild_guard(prefixes_rebuild_mutex);
+		for (const auto& [vrf_priority, updated_prefixes] : prefixes_reb)
+		{
+			(void)vrf_priority;
+			prefixes_count += updated_prefixes.size();
+		}
+	}
+
+	bool flush = false;
+	while (prefixes_count)
+	{
+		std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
 		std::lock_guard<std::mutex> prefixes_guard(prefixes_mutex);
 		std::lock_guard<std::mutex> prefixes_rebuild_guard(prefixes_rebuild_mutex);
 
-		for (const auto& [vrf_priority, updated_prefixes] : prefixes_reb)
+		if (prefixes_reb.empty())
 		{
-			for (const auto& updated_prefix : updated_prefixes)
+			break;
+		}
+
+		uint64_t batch_size = 0;
+		for (auto vrf_priority_it = prefixes_reb.begin();
+		     vrf_priority_it != prefixes_reb.end() && batch_size < flush_batch_size && batch_size < prefixes_count;)
+		{
+			auto& [vrf_priority, updated_prefixes] = *vrf_priority_it;
+
+			for (auto prefix_it = updated_prefixes.begin();
+			     prefix_it != updated_prefixes.end() && batch_size < flush_batch_size && batch_size < prefixes_count;)
 			{
-				if (prefixes_to_path_info_to_nh_ptr.count(vrf_priority) &&
-				    prefixes_to_path_info_to_nh_ptr[vrf_priority].count(updated_prefix) &&
-				    prefixes_to_path_info_to_nh_ptr[vrf_priority][updated_prefix].size())
-				{
-					const auto& destination = prefixes_to_path_info_to_nh_ptr[vrf_priority][updated_prefix];
+				flush_prefix(vrf_priority, *prefix_it);
+				prefix_it = updated_prefixes.erase(prefix_it);
+				batch_size++;
+			}
 
-					controlPlane->route.prefix_update(vrf_priority, updated_prefix, proto_peer_table_name, destination);
-					controlPlane->route.tunnel_prefix_update(vrf_priority, updated_prefix, destination);
-					//controlPlane->route.linux_prefix_update(vrf_priority, updated_prefix, destination);
-					controlPlane->dregress.prefix_insert(vrf_priority, updated_prefix, destination);
-				}
-				else
-				{
-					controlPlane->route.prefix_update(vrf_priority, updated_prefix, {}, std::monostate()); // TODO: get rid of third parameter
-					controlPlane->route.tunnel_prefix_update(vrf_priority, updated_prefix, std::monostate());
-					//controlPlane->route.linux_prefix_update(vrf_priority, updated_prefix, std::monostate());
-					controlPlane->dregress.prefix_remove(vrf_priority, updated_prefix);
-				}
+			if (updated_prefixes.empty())
+			{
+				vrf_priority_it = prefixes_reb.erase(vrf_priority_it);
+			}
+			else
+			{
+				++vrf_priority_it;
 			}
 		}
 
-		flush = prefixes_reb.size();
-		prefixes_reb.clear();
+		prefixes_count -= batch_size;
+		flush_stats_batches++;
+		flush_stats_prefixes += batch_size;
+		flush = true;
 	}
 
 	if (force_flush ||
@@ -560,7 +679,53 @@ void rib_t::rib_flush(bool force_flush)
 		controlPlane->dregress.prefix_flush();
 	}
 
-	need_flushing = false;
+	if (pending &&
+	    flush)
+	{
+		const uint64_t convergence = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pending_time).count();
+		flush_stats_convergence_last = convergence;
+		if (convergence > flush_stats_convergence_max)
+		{
+			flush_stats_convergence_max = convergence;
+		}
+	}
+}
+
+void rib_t::flush_prefix(const rib::vrf_priority_t& vrf_priority,
+                         const ip_prefix_t& prefix)
+{
+	if (prefixes_to_path_info_to_nh_ptr.count(vrf_priority) &&
+	    prefixes_to_path_info_to_nh_ptr[vrf_priority].count(prefix) &&
+	    prefixes_to_path_info_to_nh_ptr[vrf_priority][prefix].size())
+	{
+		const auto& destination = prefixes_to_path_info_to_nh_ptr[vrf_priority][prefix];
+
+		controlPlane->route.prefix_update(vrf_priority, prefix, proto_peer_table_name, destination);
+		controlPlane->route.tunnel_prefix_update(vrf_priority, prefix, destination);
+		//controlPlane->route.linux_prefix_update(vrf_priority, prefix, destination);
+		controlPlane->dregress.prefix_insert(vrf_priority, prefix, destination);
+	}
+	else
+	{
+		controlPlane->route.prefix_update(vrf_priority, prefix, {}, std::monostate()); // TODO: get rid of third parameter
+		controlPlane->route.tunnel_prefix_update(vrf_priority, prefix, std::monostate());
+		//controlPlane->route.linux_prefix_update(vrf_priority, prefix, std::monostate());
+		controlPlane->dregress.prefix_remove(vrf_priority, prefix);
+	}
+}
+
+void rib_t::flush_notify()
+{
+	{
+		std::lock_guard<std::mutex> flush_wait_guard(flush_wait_mutex);
+		if (!need_flushing)
+		{
+			need_flushing = true;
+			flush_pending_time = std::chrono::steady_clock::now();
+		}
+	}
+
+	flush_cv.notify_one();
 }
 
 common::icp::rib_summary::response rib_t::rib_summary()
@@ -693,57 +858,40 @@ common::icp::rib_get::response rib_t::rib_get(const common::icp::rib_get::reques
 
 common::icp::rib_save::response rib_t::rib_save()
 {
-	common::stream_out_t stream;
-
-	{
-		std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
-		std::lock_guard<std::mutex> prefixes_guard(prefixes_mutex);
-		std::lock_guard<std::mutex> summary_guard(summary_mutex);
-
-		stream.push(proto_peer_table_name);
+	std::ostringstream stream;
+	snapshot_write(stream);
 
-		std::unordered_map<rib::nexthop_stuff_t, std::pair<uint32_t, uint32_t>> nh_to_index_ref_count_pair;
-		uint32_t i = 0;
-		for (const auto& [nh, ref_count] : nh_to_ref_count)
-		{
-			nh_to_index_ref_count_pair[nh] = {i, ref_count};
-			++i;
-		}
-
-		stream.push(nh_to_index_ref_count_pair);
-
-		std::unordered_map<rib::vrf_priority_t,
-		                   std::unordered_map<ip_prefix_t,
-		                                      std::unordered_map<uint32_t, // index from proto_peer_table_name
-		                                                         std::unordered_map<std::string,
-		                                                                            uint32_t // index from nh_ptr_to_index
-		                                                                            >>>>
-		        prefixes_to_save;
-
-		for (const auto& [vrf_priority, prefixes_to_pptn_to_path_info_to_nh_ptr] : prefixes_to_path_info_to_nh_ptr)
-		{
-			for (const auto& [prefix, pptn_to_path_info_to_nh_ptr] : prefixes_to_pptn_to_path_info_to_nh_ptr)
-			{
-				for (const auto& [pptn_index, path_info_to_nh_ptr] : pptn_to_path_info_to_nh_ptr)
-				{
-					for (const auto& [path_info, nh_ptr] : path_info_to_nh_ptr)
-					{
-						uint32_t nh_index = nh_to_index_ref_count_pair[*nh_ptr].first;
-						prefixes_to_save[vrf_priority][prefix][pptn_index][path_info] = nh_index;
-					}
-				}
-			}
-		}
+	const auto buffer = stream.str();
+	return {buffer.begin(), buffer.end()};
+}
 
-		stream.push(prefixes_to_save);
+void rib_t::rib_load(const common::icp::rib_load::request& request)
+{
+	const uint32_t version = rib::snapshot::version_of(request.data(), request.size());
+	if (version == rib::snapshot::version_legacy)
+	{
+		rib_load_legacy(request);
+		snapshot_changed = true;
+		return;
+	}
+	else if (version != rib::snapshot::version)
+	{
+		YANET_LOG_WARNING("rib_load: unsupported snapshot version %u\n", version);
+		return;
+	}
 
-		stream.push(summary);
+	rib::snapshot::reader_t reader;
+	if (!reader.open(request.data(), request.size()))
+	{
+		YANET_LOG_WARNING("rib_load: invalid snapshot\n");
+		return;
 	}
 
-	return stream.getBuffer();
+	snapshot_read(reader);
+	snapshot_changed = true;
 }
 
-void rib_t::rib_load(const common::icp::rib_load::request& request)
+void rib_t::rib_load_legacy(const common::icp::rib_load::request& request)
 {
 	common::stream_in_t stream(request);
 
@@ -764,6 +912,12 @@ void rib_t::rib_load(const common::icp::rib_load::request& request)
 	decltype(this->summary) summary;
 	stream.pop(summary);
 
+	if (stream.isFailed())
+	{
+		YANET_LOG_WARNING("rib_load: invalid snapshot\n");
+		return;
+	}
+
 	{
 		std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
 		std::lock_guard<std::mutex> prefixes_guard(prefixes_mutex);
@@ -794,9 +948,10 @@ void rib_t::rib_load(const common::icp::rib_load::request& request)
 			auto [nh_to_ref_count_it, insert_result] = this->nh_to_ref_count.insert({nh, ref_count});
 			(void)insert_result;
 
-			const rib::nexthop_stuff_t* nh_ptr = &(nh_to_ref_count_it->first);
-
-			nh_to_index[index] = nh_ptr;
+			if (index < nh_to_index.size())
+			{
+				nh_to_index[index] = &(nh_to_ref_count_it->first);
+			}
 		}
 
 		// replace indexes with pointers from nh_to_ref_count, obtained on previous step
@@ -808,8 +963,13 @@ void rib_t::rib_load(const common::icp::rib_load::request& request)
 				{
 					for (const auto& [path_info, nh_index] : path_info_to_nh_index)
 					{
-						const rib::nexthop_stuff_t* nh_ptr = nh_to_index[nh_index];
-						this->prefixes_to_path_info_to_nh_ptr[vrf_priority][prefix][pptn_index][path_info] = nh_ptr;
+						if (nh_index >= nh_to_index.size() ||
+						    nh_to_index[nh_index] == nullptr)
+						{
+							continue;
+						}
+
+						this->prefixes_to_path_info_to_nh_ptr[vrf_priority][prefix][pptn_index][path_info] = nh_to_index[nh_index];
 
 						// all loaded prefixes should be marked as rebuilt as well (as they or their routes might differ from stored)
 						this->prefixes_reb[vrf_priority].insert(prefix);
@@ -818,17 +978,381 @@ void rib_t::rib_load(const common::icp::rib_load::request& request)
 			}
 		}
 	}
+
+	flush_notify();
+}
+
+bool rib_t::snapshot_write(std::ostream& stream) const
+{
+	using namespace rib::snapshot;
+
+	std::vector<prefix_t> prefixes;
+	std::vector<path_t> paths;
+	std::vector<rib::nexthop_stuff_t> nexthops;
+	std::vector<rib::pptn_t> pptns;
+	std::vector<rib::vrf_priority_t> vrf_priorities;
+	std::vector<std::string> strings;
+	decltype(this->summary) summary;
+
+	/// copy rib to columns under locks, serialization and write to stream are done without locks
+	{
+		std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
+		std::lock_guard<std::mutex> prefixes_guard(prefixes_mutex);
+		std::lock_guard<std::mutex> summary_guard(summary_mutex);
+
+		std::unordered_map<std::string, uint32_t> string_ids;
+		std::unordered_map<const rib::nexthop_stuff_t*, uint32_t> nexthop_ids;
+
+		for (const auto& [vrf_priority, prefixes_to_pptn_to_path_info_to_nh_ptr] : prefixes_to_path_info_to_nh_ptr)
+		{
+			const uint32_t vrf_priority_id = vrf_priorities.size();
+			vrf_priorities.emplace_back(vrf_priority);
+
+			for (const auto& [prefix, pptn_to_path_info_to_nh_ptr] : prefixes_to_pptn_to_path_info_to_nh_ptr)
+			{
+				prefix_t& prefix_record = prefixes.emplace_back(prefix);
+				prefix_record.vrf_priority_id = vrf_priority_id;
+				prefix_record.paths_offset = paths.size();
+
+				for (const auto& [pptn_index, path_info_to_nh_ptr] : pptn_to_path_info_to_nh_ptr)
+				{
+					for (const auto& [path_info, nh_ptr] : path_info_to_nh_ptr)
+					{
+						auto [string_it, string_inserted] = string_ids.emplace(path_info, strings.size());
+						if (string_inserted)
+						{
+							strings.emplace_back(path_info);
+						}
+
+						auto [nexthop_it, nexthop_inserted] = nexthop_ids.emplace(nh_ptr, nexthops.size());
+						if (nexthop_inserted)
+						{
+							nexthops.emplace_back(*nh_ptr);
+						}
+
+						path_t path_record;
+						path_record.pptn_id = pptn_index;
+						path_record.path_info_id = string_it->second;
+						path_record.nexthop_id = nexthop_it->second;
+						path_record.reserved = 0;
+
+						paths.emplace_back(path_record);
+					}
+				}
+
+				prefix_record.paths_count = paths.size() - prefix_record.paths_offset;
+			}
+		}
+
+		pptns = proto_peer_table_name;
+		summary = this->summary;
+	}
+
+	header_t header;
+	memset(&header, 0, sizeof(header));
+
+	writer_t writer(stream);
+
+	writer.begin(header.prefixes);
+	for (const auto& record : prefixes)
+	{
+		writer.append(header.prefixes, record);
+	}
+
+	writer.begin(header.paths);
+	for (const auto& record : paths)
+	{
+		writer.append(header.paths, record);
+	}
+
+	writer.write_entries(header.nexthops, header.nexthops_index, nexthops);
+	writer.write_entries(header.pptns, header.pptns_index, pptns);
+	writer.write_entries(header.vrf_priorities, header.vrf_priorities_index, vrf_priorities);
+	writer.write_entries(header.strings, header.strings_index, strings);
+	writer.write_value(header.summary, summary);
+
+	return writer.finish(header);
+}
+
+void rib_t::snapshot_read(const rib::snapshot::reader_t& reader,
+                          const bool stale)
+{
+	using namespace rib::snapshot;
+
+	const auto& header = reader.header();
+
+	decltype(this->proto_peer_table_name) proto_peer_table_name;
+	proto_peer_table_name.resize(header.pptns.count);
+	for (uint64_t i = 0;
+	     i < header.pptns.count;
+	     i++)
+	{
+		if (!reader.entry(header.pptns, header.pptns_index, i, proto_peer_table_name[i]))
+		{
+			YANET_LOG_WARNING("rib::snapshot: invalid pptn %lu\n", i);
+			return;
+		}
+	}
+
+	std::vector<rib::vrf_priority_t> vrf_priorities(header.vrf_priorities.count);
+	for (uint64_t i = 0;
+	     i < header.vrf_priorities.count;
+	     i++)
+	{
+		if (!reader.entry(header.vrf_priorities, header.vrf_priorities_index, i, vrf_priorities[i]))
+		{
+			YANET_LOG_WARNING("rib::snapshot: invalid vrf_priority %lu\n", i);
+			return;
+		}
+	}
+
+	decltype(this->summary) summary;
+	if (!reader.value(header.summary, summary))
+	{
+		YANET_LOG_WARNING("rib::snapshot: invalid summary\n");
+		return;
+	}
+
+	std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
+	std::lock_guard<std::mutex> prefixes_guard(prefixes_mutex);
+	std::lock_guard<std::mutex> prefixes_rebuild_guard(prefixes_rebuild_mutex);
+	std::lock_guard<std::mutex> summary_guard(summary_mutex);
+
+	// first get rid of all prefixes stored prior to load, they should be marked as rebuilt for rib_flush()
+	for (const auto& [vrf_priority, prefixes_to_pptn_to_path_info_to_nh_ptr] : prefixes_to_path_info_to_nh_ptr)
+	{
+		for (const auto& [prefix, pptn_to_path_info_to_nh_ptr] : prefixes_to_pptn_to_path_info_to_nh_ptr)
+		{
+			(void)pptn_to_path_info_to_nh_ptr;
+			prefixes_reb[vrf_priority].insert(prefix);
+		}
+	}
+
+	this->summary.swap(summary);
+	this->proto_peer_table_name.swap(proto_peer_table_name);
+	prefixes_to_path_info_to_nh_ptr.clear();
+	nh_to_ref_count.clear();
+
+	stale_paths.reset(std::chrono::steady_clock::now() + std::chrono::seconds(stale_timeout));
+	if (stale)
+	{
+		/// end-of-rib is expected again from every peer
+		for (auto& [summary_key, summary_value] : this->summary)
+		{
+			(void)summary_key;
+			std::get<2>(summary_value) = false;
+		}
+	}
+
+	// nexthops and path_info strings are decoded on first reference
+	std::vector<const rib::nexthop_stuff_t*> nexthops(header.nexthops.count, nullptr);
+	std::vector<std::optional<std::string>> strings(header.strings.count);
+
+	const auto* prefixes = reader.records<prefix_t>(header.prefixes);
+	const auto* paths = reader.records<path_t>(header.paths);
+	uint64_t invalid_paths = 0;
+	for (uint64_t prefix_i = 0;
+	     prefix_i < header.prefixes.count;
+	     prefix_i++)
+	{
+		const auto& record = prefixes[prefix_i];
+		const auto& vrf_priority = vrf_priorities[record.vrf_priority_id];
+		const auto prefix = record.prefix();
+
+		auto& pptn_to_path_info_to_nh_ptr = prefixes_to_path_info_to_nh_ptr[vrf_priority][prefix];
+		for (uint64_t path_i = record.paths_offset;
+		     path_i < record.paths_offset + record.paths_count;
+		     path_i++)
+		{
+			const auto& path = paths[path_i];
+
+			auto& path_info = strings[path.path_info_id];
+			if (!path_info)
+			{
+				std::string string;
+				if (!reader.entry(header.strings, header.strings_index, path.path_info_id, string))
+				{
+					invalid_paths++;
+					continue;
+				}
+
+				path_info = std::move(string);
+			}
+
+			auto& nh_ptr = nexthops[path.nexthop_id];
+			if (!nh_ptr)
+			{
+				rib::nexthop_stuff_t nexthop;
+				if (!reader.entry(header.nexthops, header.nexthops_index, path.nexthop_id, nexthop))
+				{
+					invalid_paths++;
+					continue;
+				}
+
+				nh_ptr = &nh_to_ref_count.emplace(std::move(nexthop), 0).first->first;
+			}
+
+			nh_to_ref_count[*nh_ptr]++;
+			pptn_to_path_info_to_nh_ptr[path.pptn_id][*path_info] = nh_ptr;
+
+			if (stale &&
+			    path.pptn_id < this->proto_peer_table_name.size())
+			{
+				/// static routes of init() are not resent, so they are never stale
+				const auto& [protocol, peer, table_name] = this->proto_peer_table_name[path.pptn_id];
+				if (protocol != "static")
+				{
+					const auto& [vrf, priority] = vrf_priority;
+					stale_paths.insert({vrf, priority, protocol, peer, table_name}, prefix, *path_info);
+				}
+			}
+		}
+
+		// all loaded prefixes should be marked as rebuilt as well (as they or their routes might differ from stored)
+		prefixes_reb[vrf_priority].insert(prefix);
+	}
+
+	if (invalid_paths)
+	{
+		YANET_LOG_WARNING("rib::snapshot: skipped %lu invalid paths\n", invalid_paths);
+	}
+
+	flush_notify();
+}
+
+void rib_t::snapshot_save()
+{
+	std::string path;
+	{
+		std::lock_guard<std::mutex> snapshot_guard(snapshot_mutex);
+		path = snapshot_path;
+	}
+
+	if (path.empty())
+	{
+		return;
+	}
+
+	snapshot_changed = false;
+
+	/// write to temporary file and rename, so that file is never partial after restart
+	const auto temporary_path = path + ".tmp";
+
+	bool written;
+	{
+		std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+		written = file && snapshot_write(file);
+	}
+
+	std::error_code error_code;
+	if (written)
+	{
+		std::filesystem::rename(temporary_path, path, error_code);
+	}
+
+	if (!written || error_code)
+	{
+		YANET_LOG_WARNING("rib::snapshot: can't save '%s'\n", path.data());
+		std::filesystem::remove(temporary_path, error_code);
+		snapshot_changed = true;
+	}
+}
+
+void rib_t::stale_remove(const rib::stale_paths_t::key_t& key,
+                         const rib::stale_paths_t::paths_t& paths)
+{
+	if (paths.empty())
+	{
+		return;
+	}
+
+	const auto& [vrf, priority, protocol, peer, table_name] = key;
+
+	common::icp::rib_update::remove request = {protocol, vrf, priority, {}};
+	auto& nlris = std::get<3>(request)[peer][table_name];
+	for (const auto& [prefix, path_information] : paths)
+	{
+		nlris.emplace_back(prefix, path_information, std::vector<uint32_t>());
+	}
+
+	rib_remove(request);
+}
+
+void rib_t::stale_expire()
+{
+	{
+		std::lock_guard<std::mutex> rib_update_guard(rib_update_mutex);
+
+		if (stale_paths.empty())
+		{
+			return;
+		}
+
+		const auto expired = stale_paths.expire(std::chrono::steady_clock::now());
+
+		uint64_t paths_count = 0;
+		for (const auto& [key, paths] : expired)
+		{
+			stale_remove(key, paths);
+			paths_count += paths.size();
+		}
+
+		if (!paths_count)
+		{
+			return;
+		}
+
+		YANET_LOG_INFO("rib: withdrawn %lu stale paths without end-of-rib\n", paths_count);
+	}
+
+	flush_notify();
+	snapshot_changed = true;
 }
 
 void rib_t::rib_thread()
 {
 	while (!flagStop)
 	{
+		{
+			std::unique_lock<std::mutex> flush_wait_lock(flush_wait_mutex);
+
+			/// wake up periodically for snapshots
+			flush_cv.wait_for(flush_wait_lock, std::chrono::seconds(1), [this]() {
+				return need_flushing || flagStop;
+			});
+
+			if (need_flushing)
+			{
+				/// coalesce following updates, within latency target
+				flush_cv.wait_until(flush_wait_lock,
+				                    flush_pending_time + std::chrono::milliseconds(flush_latency),
+				                    [this]() { return flagStop; });
+			}
+		}
+
+		if (flagStop)
+		{
+			break;
+		}
+
+		stale_expire();
+
 		if (need_flushing)
 		{
 			rib_flush();
 		}
 
-		std::this_thread::sleep_for(std::chrono::milliseconds{200});
+		std::chrono::seconds snapshot_interval;
+		{
+			std::lock_guard<std::mutex> snapshot_guard(snapshot_mutex);
+			snapshot_interval = this->snapshot_interval;
+		}
+
+		if (snapshot_changed &&
+		    std::chrono::steady_clock::now() - snapshot_time >= snapshot_interval)
+		{
+			snapshot_save();
+			snapshot_time = std::chrono::steady_clock::now();
+		}
 	}
 }
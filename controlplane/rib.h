@@ -2,6 +2,8 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -16,6 +18,8 @@
 
 #include "isystem.h"
 #include "module.h"
+#include "rib_snapshot.h"
+#include "rib_stale.h"
 #include "type.h"
 
 namespace rib
@@ -42,6 +46,9 @@ public:
 	~rib_t() override;
 
 	eResult init() override;
+	void reload(const controlplane::base_t& base_prev, const controlplane::base_t& base_next, common::idp::updateGlobalBase::request& globalbase) override;
+	void controlplane_values(common::icp::controlplane_values::response& controlplane_values) const override;
+	void stop() override;
 
 	void rib_update(const common::icp::rib_update::request& request);
 	void rib_flush(bool force_flush = false);
@@ -62,11 +69,55 @@ private:
 
 	void rib_thread();
 
+	/// marks rib as changed and wakes rib_thread
+	void flush_notify();
+	void flush_prefix(const rib::vrf_priority_t& vrf_priority, const ip_prefix_t& prefix);
+
+	/// replaces rib by rib_save of previous releases, see rib::snapshot::version_legacy
+	void rib_load_legacy(const common::icp::rib_load::request& request);
+
+	/// copies rib under locks, then writes it to snapshot without locks, see rib_snapshot.h
+	bool snapshot_write(std::ostream& stream) const;
+	/// replaces rib by snapshot. prefixes of previous and of loaded rib are marked for rebuild.
+	/// if 'stale', loaded paths are withdrawn unless peers announce them again, see rib::stale_paths_t
+	void snapshot_read(const rib::snapshot::reader_t& reader, const bool stale = false);
+
+	void snapshot_save();
+
+	/// withdraws stale paths of key. rib_update_mutex must be held
+	void stale_remove(const rib::stale_paths_t::key_t& key, const rib::stale_paths_t::paths_t& paths);
+	/// withdraws all stale paths after 'stale_timeout'
+	void stale_expire();
+
 protected:
 	mutable std::mutex rib_update_mutex;
 
 	std::atomic<bool> need_flushing = false;
 
+	/// rib_thread waits for first change, then waits 'flush_latency' to coalesce updates of same prefixes.
+	/// rib_flush() processes prefixes by batches of 'flush_batch_size', releasing locks between batches,
+	/// so that rib_update() is not blocked for whole flush
+	std::mutex flush_mutex; ///< serializes rib_flush()
+	std::mutex flush_wait_mutex;
+	std::condition_variable flush_cv;
+	std::chrono::steady_clock::time_point flush_pending_time; ///< of first change since last flush
+	std::atomic<uint64_t> flush_latency; ///< milliseconds
+	std::atomic<uint64_t> flush_batch_size;
+
+	std::atomic<uint64_t> flush_stats_batches = 0;
+	std::atomic<uint64_t> flush_stats_prefixes = 0;
+	std::atomic<uint64_t> flush_stats_convergence_last = 0; ///< microseconds, from first change to dataplane update
+	std::atomic<uint64_t> flush_stats_convergence_max = 0;
+
+	mutable std::mutex snapshot_mutex;
+	std::string snapshot_path; ///< empty: snapshots are disabled
+	std::chrono::seconds snapshot_interval;
+	std::chrono::steady_clock::time_point snapshot_time;
+	std::atomic<bool> snapshot_changed = false;
+
+	rib::stale_paths_t stale_paths; ///< guarded by rib_update_mutex
+	std::atomic<uint64_t> stale_timeout; ///< seconds
+
 	mutable std::mutex prefixes_mutex;
 	mutable std::mutex prefixes_rebuild_mutex;
 
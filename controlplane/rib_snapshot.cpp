@@ -0,0 +1,267 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "common/define.h"
+
+#include "rib_snapshot.h"
+
+using namespace rib::snapshot;
+
+prefix_t::prefix_t(const common::ip_prefix_t& prefix)
+{
+	memset(this, 0, sizeof(*this));
+
+	if (prefix.is_ipv4())
+	{
+		const uint32_t address = prefix.get_ipv4().address();
+		memcpy(this->address, &address, sizeof(address));
+		is_ipv4 = 1;
+	}
+	else
+	{
+		memcpy(this->address, prefix.get_ipv6().address().data(), sizeof(this->address));
+	}
+
+	mask = prefix.mask();
+}
+
+common::ip_prefix_t prefix_t::prefix() const
+{
+	if (is_ipv4)
+	{
+		uint32_t address;
+		memcpy(&address, this->address, sizeof(address));
+		return common::ipv4_prefix_t(common::ipv4_address_t(address), mask);
+	}
+
+	return common::ipv6_prefix_t(common::ipv6_address_t(address), mask);
+}
+
+writer_t::writer_t(std::ostream& stream) :
+        stream(stream),
+        position(0)
+{
+	header_t header;
+	memset(&header, 0, sizeof(header));
+	write(&header, sizeof(header));
+}
+
+void writer_t::begin(section_t& section)
+{
+	/// keep records aligned
+	static const uint8_t padding[8] = {};
+	write(padding, (8 - position % 8) % 8);
+
+	section.offset = position;
+	section.size = 0;
+	section.count = 0;
+}
+
+bool writer_t::finish(header_t& header)
+{
+	header.magic = magic;
+	header.version = version;
+	header.reserved = 0;
+
+	stream.seekp(0);
+	stream.write((const char*)&header, sizeof(header));
+	stream.seekp(0, std::ios::end);
+	stream.flush();
+
+	return !stream.fail();
+}
+
+void writer_t::write(const void* data, const uint64_t size)
+{
+	stream.write((const char*)data, size);
+	position += size;
+}
+
+reader_t::reader_t() :
+        data(nullptr),
+        size(0),
+        mapped(nullptr)
+{
+}
+
+reader_t::~reader_t()
+{
+	close();
+}
+
+bool reader_t::open(const std::string& path)
+{
+	close();
+
+	int fd = ::open(path.data(), O_RDONLY);
+	if (fd < 0)
+	{
+		YANET_LOG_WARNING("rib::snapshot: open('%s'): %s\n", path.data(), strerror(errno));
+		return false;
+	}
+
+	struct stat stat;
+	if (fstat(fd, &stat) < 0 ||
+	    (uint64_t)stat.st_size < sizeof(header_t))
+	{
+		YANET_LOG_WARNING("rib::snapshot: invalid file '%s'\n", path.data());
+		::close(fd);
+		return false;
+	}
+
+	/// pages are read by kernel on first access to record
+	void* pointer = mmap(nullptr, stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (pointer == MAP_FAILED)
+	{
+		YANET_LOG_WARNING("rib::snapshot: mmap('%s'): %s\n", path.data(), strerror(errno));
+		return false;
+	}
+
+	mapped = pointer;
+	data = (const uint8_t*)pointer;
+	size = stat.st_size;
+
+	if (!validate())
+	{
+		YANET_LOG_WARNING("rib::snapshot: invalid file '%s'\n", path.data());
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+uint32_t rib::snapshot::version_of(const uint8_t* data, const uint64_t size)
+{
+	header_t header;
+	if (size < sizeof(header_t))
+	{
+		return version_legacy;
+	}
+
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != magic)
+	{
+		return version_legacy;
+	}
+
+	return header.version;
+}
+
+bool reader_t::open(const uint8_t* data, const uint64_t size)
+{
+	close();
+
+	if (size < sizeof(header_t))
+	{
+		return false;
+	}
+
+	this->data = data;
+	this->size = size;
+
+	if (!validate())
+	{
+		this->data = nullptr;
+		this->size = 0;
+		return false;
+	}
+
+	return true;
+}
+
+bool reader_t::validate() const
+{
+	const auto& header = this->header();
+	if (header.magic != magic ||
+	    header.version != version)
+	{
+		return false;
+	}
+
+	for (const auto* section : {&header.prefixes,
+	                            &header.paths,
+	                            &header.nexthops,
+	                            &header.nexthops_index,
+	                            &header.pptns,
+	                            &header.pptns_index,
+	                            &header.vrf_priorities,
+	                            &header.vrf_priorities_index,
+	                            &header.strings,
+	                            &header.strings_index,
+	                            &header.summary})
+	{
+		if (section->offset < sizeof(header_t) ||
+		    section->offset > size ||
+		    section->size > size - section->offset)
+		{
+			return false;
+		}
+	}
+
+	if (header.prefixes.size != header.prefixes.count * sizeof(prefix_t) ||
+	    header.paths.size != header.paths.count * sizeof(path_t))
+	{
+		return false;
+	}
+
+	for (const auto& [entries, index] : {std::make_tuple(&header.nexthops, &header.nexthops_index),
+	                                     std::make_tuple(&header.pptns, &header.pptns_index),
+	                                     std::make_tuple(&header.vrf_priorities, &header.vrf_priorities_index),
+	                                     std::make_tuple(&header.strings, &header.strings_index)})
+	{
+		if (index->count != entries->count + 1 ||
+		    index->size != index->count * sizeof(uint64_t))
+		{
+			return false;
+		}
+	}
+
+	const auto* prefixes = records<prefix_t>(header.prefixes);
+	for (uint64_t i = 0;
+	     i < header.prefixes.count;
+	     i++)
+	{
+		const auto& prefix = prefixes[i];
+		if (prefix.vrf_priority_id >= header.vrf_priorities.count ||
+		    prefix.paths_offset > header.paths.count ||
+		    prefix.paths_count > header.paths.count - prefix.paths_offset)
+		{
+			return false;
+		}
+	}
+
+	const auto* paths = records<path_t>(header.paths);
+	for (uint64_t i = 0;
+	     i < header.paths.count;
+	     i++)
+	{
+		const auto& path = paths[i];
+		if (path.pptn_id >= header.pptns.count ||
+		    path.path_info_id >= header.strings.count ||
+		    path.nexthop_id >= header.nexthops.count)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void reader_t::close()
+{
+	if (mapped)
+	{
+		munmap(mapped, size);
+		mapped = nullptr;
+	}
+
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "common/stream.h"
+#include "common/type.h"
+
+namespace rib::snapshot
+{
+
+/// binary snapshot of rib.
+/// fixed size columns are read in place from mmaped file, variable size
+/// entries (nexthops, pptns, strings) are interned and decoded on demand by index:
+///
+///   header
+///   prefixes[]              - prefix_t, paths of prefix are paths[paths_offset .. paths_offset + paths_count)
+///   paths[]                 - path_t, ids of pptn, path_info and nexthop
+///   nexthops, nexthops_index[]
+///   pptns, pptns_index[]
+///   vrf_priorities, vrf_priorities_index[]
+///   strings, strings_index[]
+///   summary
+constexpr uint64_t magic = 0x59414E4554524942ull; ///< "YANETRIB"
+constexpr uint32_t version = 1;
+/// rib_save of previous releases: common::stream_out_t of rib tables, without header
+constexpr uint32_t version_legacy = 0;
+
+struct section_t
+{
+	uint64_t offset;
+	uint64_t size;
+	uint64_t count;
+};
+
+struct header_t
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+
+	section_t prefixes;
+	section_t paths;
+	section_t nexthops;
+	section_t nexthops_index;
+	section_t pptns;
+	section_t pptns_index;
+	section_t vrf_priorities;
+	section_t vrf_priorities_index;
+	section_t strings;
+	section_t strings_index;
+	section_t summary;
+};
+
+struct prefix_t
+{
+	prefix_t() = default;
+	prefix_t(const common::ip_prefix_t& prefix);
+
+	common::ip_prefix_t prefix() const;
+
+	uint8_t address[16]; ///< ipv4 address in host byte order in first 4 bytes
+	uint8_t is_ipv4;
+	uint8_t mask;
+	uint16_t reserved;
+	uint32_t vrf_priority_id;
+	uint64_t paths_offset;
+	uint64_t paths_count;
+};
+
+static_assert(sizeof(prefix_t) == 40, "invalid size of prefix_t");
+
+struct path_t
+{
+	uint32_t pptn_id;
+	uint32_t path_info_id; ///< index in strings
+	uint32_t nexthop_id;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(path_t) == 16, "invalid size of path_t");
+
+/// writes snapshot sequentially to stream, without building it in memory.
+/// stream must be seekable, header is written last
+class writer_t
+{
+public:
+	writer_t(std::ostream& stream);
+
+public:
+	void begin(section_t& section);
+
+	template<typename record_T>
+	void append(section_t& section, const record_T& record)
+	{
+		write(&record, sizeof(record));
+		section.size += sizeof(record);
+		section.count++;
+	}
+
+	/// each value is serialized by common::stream_out_t and placed to 'entries', offsets are placed to 'index'
+	template<typename container_T>
+	void write_entries(section_t& entries, section_t& index, const container_T& values)
+	{
+		std::vector<uint64_t> offsets;
+		offsets.reserve(values.size() + 1);
+
+		begin(entries);
+		for (const auto& value : values)
+		{
+			offsets.emplace_back(entries.size);
+
+			common::stream_out_t stream;
+			if constexpr (std::is_pointer_v<std::decay_t<decltype(value)>>)
+			{
+				stream.push(*value);
+			}
+			else
+			{
+				stream.push(value);
+			}
+
+			const auto& buffer = stream.getBuffer();
+			write(buffer.data(), buffer.size());
+			entries.size += buffer.size();
+			entries.count++;
+		}
+		offsets.emplace_back(entries.size);
+
+		begin(index);
+		for (const auto offset : offsets)
+		{
+			append(index, offset);
+		}
+	}
+
+	template<typename value_T>
+	void write_value(section_t& section, const value_T& value)
+	{
+		common::stream_out_t stream;
+		stream.push(value);
+
+		const auto& buffer = stream.getBuffer();
+
+		begin(section);
+		write(buffer.data(), buffer.size());
+		section.size = buffer.size();
+		section.count = 1;
+	}
+
+	/// returns false, if stream is failed
+	bool finish(header_t& header);
+
+protected:
+	void write(const void* data, const uint64_t size);
+
+protected:
+	std::ostream& stream;
+	uint64_t position;
+};
+
+/// returns version of snapshot in buffer, or version_legacy if buffer has no snapshot header
+uint32_t version_of(const uint8_t* data, const uint64_t size);
+
+/// snapshot of mmaped file or of memory buffer
+class reader_t
+{
+public:
+	reader_t();
+	~reader_t();
+
+	reader_t(const reader_t&) = delete;
+	reader_t& operator=(const reader_t&) = delete;
+
+public:
+	bool open(const std::string& path);
+	bool open(const uint8_t* data, const uint64_t size);
+
+	const header_t& header() const
+	{
+		return *(const header_t*)data;
+	}
+
+	template<typename record_T>
+	const record_T* records(const section_t& section) const
+	{
+		return (const record_T*)(data + section.offset);
+	}
+
+	/// decodes entry 'id' of section written by writer_t::write_entries()
+	template<typename value_T>
+	bool entry(const section_t& entries,
+	           const section_t& index,
+	           const uint64_t id,
+	           value_T& value) const
+	{
+		if (id >= entries.count)
+		{
+			return false;
+		}
+
+		const auto* offsets = records<uint64_t>(index);
+		if (offsets[id] > offsets[id + 1] ||
+		    offsets[id + 1] > entries.size)
+		{
+			return false;
+		}
+
+		return decode(data + entries.offset + offsets[id], offsets[id + 1] - offsets[id], value);
+	}
+
+	template<typename value_T>
+	bool value(const section_t& section, value_T& value) const
+	{
+		return decode(data + section.offset, section.size, value);
+	}
+
+protected:
+	template<typename value_T>
+	static bool decode(const uint8_t* pointer, const uint64_t size, value_T& value)
+	{
+		std::vector<uint8_t> buffer(pointer, pointer + size);
+
+		common::stream_in_t stream(buffer);
+		stream.pop(value);
+
+		return !stream.isFailed();
+	}
+
+	bool validate() const;
+	void close();
+
+protected:
+	const uint8_t* data;
+	uint64_t size;
+
+	void* mapped;
+};
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+
+#include "common/type.h"
+
+namespace rib
+{
+
+/// paths restored from snapshot on warm restart, which are not re-announced by their peers yet.
+///
+/// path is fresh again, when peer announces it. on end-of-rib of (vrf, priority, protocol, peer, table_name)
+/// its remaining stale paths are withdrawn. paths of peers, which never send end-of-rib, are withdrawn after timeout.
+/// not thread safe, rib_t guards it by rib_update_mutex
+class stale_paths_t
+{
+public:
+	using key_t = std::tuple<std::string, ///< vrf
+	                         uint32_t, ///< priority
+	                         std::string, ///< protocol
+	                         common::ip_address_t, ///< peer
+	                         std::string>; ///< table_name
+
+	using paths_t = std::set<std::tuple<common::ip_prefix_t,
+	                                    std::string>>; ///< path_information
+
+public:
+	bool empty() const
+	{
+		return paths.empty();
+	}
+
+	uint64_t size() const
+	{
+		uint64_t result = 0;
+		for (const auto& [key, key_paths] : paths)
+		{
+			(void)key;
+			result += key_paths.size();
+		}
+		return result;
+	}
+
+	/// forgets all stale paths, remaining ones expire at 'deadline'
+	void reset(const std::chrono::steady_clock::time_point& deadline)
+	{
+		paths.clear();
+		this->deadline = deadline;
+	}
+
+	void insert(const key_t& key,
+	            const common::ip_prefix_t& prefix,
+	            const std::string& path_information)
+	{
+		paths[key].emplace(prefix, path_information);
+	}
+
+	/// path is announced by peer
+	void refresh(const key_t& key,
+	             const common::ip_prefix_t& prefix,
+	             const std::string& path_information)
+	{
+		auto it = paths.find(key);
+		if (it == paths.end())
+		{
+			return;
+		}
+
+		it->second.erase({prefix, path_information});
+		if (it->second.empty())
+		{
+			paths.erase(it);
+		}
+	}
+
+	/// returns paths of 'key', which are not announced till end-of-rib
+	paths_t eor(const key_t& key)
+	{
+		paths_t result;
+
+		auto it = paths.find(key);
+		if (it != paths.end())
+		{
+			result.swap(it->second);
+			paths.erase(it);
+		}
+
+		return result;
+	}
+
+	/// returns all remaining paths, if deadline is passed
+	std::map<key_t, paths_t> expire(const std::chrono::steady_clock::time_point& now)
+	{
+		std::map<key_t, paths_t> result;
+
+		if (now >= deadline)
+		{
+			result.swap(paths);
+		}
+
+		return result;
+	}
+
+protected:
+	std::map<key_t, paths_t> paths;
+	std::chrono::steady_clock::time_point deadline;
+};
+
+}
@@ -1,8 +1,14 @@
+#include <chrono>
+#include <filesystem>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
 
 #include "../acl.h"
+#include "../acl_cache.h"
+#include "../acl_compiler.h"
+#include "common/stream.h"
 
 namespace
 {
@@ -474,4 +480,372 @@ add 200 deny ip from any to any
 	EXPECT_THAT(std::get<1>(result.rules[200].front()), ::testing::Eq("deny"));
 }
 
+TEST(ACL, 019_Incremental)
+{
+	using common::idp::updateGlobalBase::requestType;
+
+	auto rules = [](const std::string& udp_port) {
+		return R"IPFW(
+:BEGIN
+add skipto :IN ip from any to any in
+
+:IN
+add allow tcp from any to 1.2.3.4 dst-port 80
+add allow udp from any to 1.2.3.5 dst-port )IPFW" +
+		       udp_port + R"IPFW(
+add deny ip from any to any
+)IPFW";
+	};
+
+	auto types = [](const common::idp::updateGlobalBase::request& globalbase) {
+		std::set<requestType> result;
+		for (const auto& [type, data] : globalbase)
+		{
+			(void)data;
+			result.emplace(type);
+		}
+		return result;
+	};
+
+	acl::incremental_t incremental;
+
+	/// first reload pushes all tables
+	{
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("53"))}};
+		acl::result_t result;
+		common::idp::updateGlobalBase::request globalbase;
+		EXPECT_TRUE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result, incremental));
+		incremental.update(result, globalbase);
+		incremental.commit();
+
+		EXPECT_EQ(11, globalbase.size());
+		EXPECT_EQ(1, types(globalbase).count(requestType::acl_transport_table));
+		EXPECT_EQ(1, types(globalbase).count(requestType::acl_total_table));
+	}
+
+	/// same rules
+	{
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("53"))}};
+		acl::result_t result;
+		common::idp::updateGlobalBase::request globalbase;
+		EXPECT_FALSE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result, incremental));
+		incremental.update(result, globalbase);
+		incremental.commit();
+
+		EXPECT_EQ(0, globalbase.size());
+		EXPECT_FALSE(result.rules.empty());
+	}
+
+	/// changed port pushes only changed tables, hashtables as delta
+	{
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("54"))}};
+		acl::result_t result;
+		common::idp::updateGlobalBase::request globalbase;
+		EXPECT_TRUE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result, incremental));
+		incremental.update(result, globalbase);
+		incremental.commit();
+
+		const auto pushed = types(globalbase);
+		EXPECT_EQ(0, pushed.count(requestType::acl_network_ipv4_source));
+		EXPECT_EQ(0, pushed.count(requestType::acl_network_ipv4_destination));
+		EXPECT_EQ(1, pushed.count(requestType::acl_transport_layers));
+		EXPECT_EQ(0, pushed.count(requestType::acl_transport_table));
+		EXPECT_EQ(0, pushed.count(requestType::acl_total_table));
+	}
+
+	/// unknown dataplane state
+	{
+		incremental.reset();
+
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("54"))}};
+		acl::result_t result;
+		common::idp::updateGlobalBase::request globalbase;
+		EXPECT_TRUE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result, incremental));
+		incremental.update(result, globalbase);
+
+		EXPECT_EQ(11, globalbase.size());
+	}
+
+	/// without tables of last reload tables are loaded, if possible
+	incremental.reset();
+	acl::result_t compiled;
+	{
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("54"))}};
+		common::idp::updateGlobalBase::request globalbase;
+		unsigned int loads = 0;
+		EXPECT_TRUE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, compiled, incremental, [&](acl::result_t&) {
+			loads++;
+			return false;
+		}));
+		EXPECT_EQ(1, loads);
+
+		acl::result_t result = compiled;
+		incremental.update(result, globalbase);
+		incremental.commit();
+	}
+
+	/// unchanged rules are skipped before load
+	{
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("54"))}};
+		acl::result_t result;
+		unsigned int loads = 0;
+		EXPECT_FALSE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result, incremental, [&](acl::result_t&) {
+			loads++;
+			return true;
+		}));
+		EXPECT_EQ(0, loads);
+	}
+
+	/// restart with cached tables
+	{
+		incremental.reset();
+
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("54"))}};
+		acl::result_t result;
+		common::idp::updateGlobalBase::request globalbase;
+		EXPECT_TRUE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result, incremental, [&](acl::result_t& result) {
+			result = compiled;
+			return true;
+		}));
+		incremental.update(result, globalbase);
+		incremental.commit();
+		EXPECT_EQ(11, globalbase.size());
+
+		/// rules are known after load, so next reload is skipped
+		acl::result_t result_next;
+		EXPECT_FALSE(acl::compile(4, acls, {{1, {{true, "vlan1"}}}}, result_next, incremental));
+	}
+}
+
+TEST(ACL, 020_Benchmark)
+{
+	std::map<std::string, controlplane::base::acl_t> acls;
+	acl::iface_map_t ifaces;
+	for (tAclId aclId = 1;
+	     aclId <= 8;
+	     aclId++)
+	{
+		acls.emplace("acl" + std::to_string(aclId), make_default_acl(generate_firewall_conf(250 * aclId), aclId));
+		ifaces[aclId] = {{true, "vlan" + std::to_string(aclId)},
+		                 {false, "vlan" + std::to_string(100 + aclId)}};
+	}
+
+	auto compile = [&](const unsigned int threads_count) {
+		acl::result_t result;
+
+		const auto start = std::chrono::steady_clock::now();
+		acl::compile(4, acls, ifaces, result, threads_count);
+		const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		printf("threads: %u, total: %.3f s\n", threads_count, duration);
+		for (const auto& [stage, stage_duration] : result.durations)
+		{
+			printf("  %s: %.3f s\n", stage.data(), stage_duration);
+		}
+
+		return result;
+	};
+
+	const auto single = compile(1);
+	const auto multi = compile(4);
+
+	auto serialize = [](const auto& value) {
+		common::stream_out_t stream;
+		stream.push(value);
+		return stream.getBuffer();
+	};
+
+	/// ids of combined values are numbered in other order, compare values of keys
+	ASSERT_EQ(single.acl_total_table.size(), multi.acl_total_table.size());
+	for (unsigned int i = 0;
+	     i < single.acl_total_table.size();
+	     i++)
+	{
+		const auto& [single_key, single_value_id] = single.acl_total_table[i];
+		const auto& [multi_key, multi_value_id] = multi.acl_total_table[i];
+
+		EXPECT_EQ(serialize(single_key), serialize(multi_key));
+		EXPECT_EQ(serialize(single.acl_values[single_value_id]), serialize(multi.acl_values[multi_value_id]));
+	}
+
+	EXPECT_EQ(serialize(single.acl_transport_tables), serialize(multi.acl_transport_tables));
+	EXPECT_EQ(single.ids_map, multi.ids_map);
+	EXPECT_EQ(single.in_iface_map, multi.in_iface_map);
+	EXPECT_EQ(single.out_iface_map, multi.out_iface_map);
+}
+
+TEST(ACL, 021_Cache)
+{
+	auto rules = [](const std::string& udp_port) {
+		return R"IPFW(
+:BEGIN
+add skipto :IN ip from any to any in
+
+:IN
+add allow tcp from any to 1.2.3.4 dst-port 80
+add allow udp from any to 1.2.3.5 dst-port )IPFW" +
+		       udp_port + R"IPFW(
+add deny ip from any to any
+)IPFW";
+	};
+
+	char directory_template[] = "/tmp/yanet-acl-cache-XXXXXX";
+	ASSERT_NE(nullptr, mkdtemp(directory_template));
+	const std::string directory = directory_template;
+
+	const acl::iface_map_t ifaces = {{1, {{true, "vlan1"}}}};
+
+	std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules("53"))}};
+	const auto key = acl::cache_t::key(4, acls, ifaces);
+
+	/// same sources, same key
+	{
+		std::map<std::string, controlplane::base::acl_t> same_acls{{"acl0", make_default_acl(rules("53"))}};
+		EXPECT_EQ(key, acl::cache_t::key(4, same_acls, ifaces));
+		EXPECT_NE(key, acl::cache_t::key(8, same_acls, ifaces));
+		EXPECT_NE(key, acl::cache_t::key(4, same_acls, {{1, {{true, "vlan2"}}}}));
+	}
+
+	{
+		std::map<std::string, controlplane::base::acl_t> other_acls{{"acl0", make_default_acl(rules("54"))}};
+		EXPECT_NE(key, acl::cache_t::key(4, other_acls, ifaces));
+	}
+
+	acl::cache_t cache(directory, 2);
+
+	acl::result_t result;
+	EXPECT_FALSE(cache.load(key, result));
+
+	acl::compile(4, acls, ifaces, result);
+	cache.save(key, result);
+
+	acl::result_t cached_result;
+	ASSERT_TRUE(cache.load(key, cached_result));
+
+	auto serialize = [](const acl::result_t& result) {
+		common::stream_out_t stream;
+		stream.push(result);
+		return stream.getBuffer();
+	};
+
+	EXPECT_EQ(serialize(result), serialize(cached_result));
+	EXPECT_FALSE(cached_result.acl_total_table.empty());
+
+	/// disabled cache
+	{
+		acl::cache_t disabled_cache("");
+		acl::result_t disabled_result;
+		EXPECT_FALSE(disabled_cache.load(key, disabled_result));
+	}
+
+	/// only last files are kept
+	cache.save(key + 1, result);
+	cache.save(key + 2, result);
+
+	unsigned int files_count = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(directory))
+	{
+		(void)entry;
+		files_count++;
+	}
+	EXPECT_EQ(2, files_count);
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST(ACL, 022_CacheRollback)
+{
+	using common::idp::updateGlobalBase::requestType;
+
+	auto rules = [](const std::string& udp_port) {
+		return R"IPFW(
+:BEGIN
+add skipto :IN ip from any to any in
+
+:IN
+add allow tcp from any to 1.2.3.4 dst-port 80
+add allow udp from any to 1.2.3.5 dst-port )IPFW" +
+		       udp_port + R"IPFW(
+add deny ip from any to any
+)IPFW";
+	};
+
+	char directory_template[] = "/tmp/yanet-acl-cache-XXXXXX";
+	ASSERT_NE(nullptr, mkdtemp(directory_template));
+	const std::string directory = directory_template;
+
+	const acl::iface_map_t ifaces = {{1, {{true, "vlan1"}}}};
+	acl::cache_t cache(directory);
+	acl::incremental_t incremental;
+
+	/// as config_converter_t::buildAcl(). returns true, if tables are loaded from cache
+	auto reload = [&](const std::string& udp_port,
+	                  common::idp::updateGlobalBase::request& globalbase,
+	                  acl::result_t& result) {
+		std::map<std::string, controlplane::base::acl_t> acls{{"acl0", make_default_acl(rules(udp_port))}};
+		const auto key = acl::cache_t::key(4, acls, ifaces);
+
+		bool cached = false;
+		const bool compiled = acl::compile(4, acls, ifaces, result, incremental, [&](acl::result_t& result) {
+			cached = cache.load(key, result);
+			return cached;
+		});
+		if (compiled &&
+		    !cached)
+		{
+			cache.save(key, result);
+		}
+
+		incremental.update(result, globalbase);
+		incremental.commit();
+		return cached;
+	};
+
+	/// config A, then B are compiled
+	{
+		common::idp::updateGlobalBase::request globalbase;
+		acl::result_t result;
+		EXPECT_FALSE(reload("53", globalbase, result));
+		EXPECT_EQ(11, globalbase.size());
+	}
+
+	{
+		common::idp::updateGlobalBase::request globalbase;
+		acl::result_t result;
+		EXPECT_FALSE(reload("54", globalbase, result));
+	}
+
+	/// rollback to config A is loaded, without compilation
+	{
+		common::idp::updateGlobalBase::request globalbase;
+		acl::result_t result;
+		EXPECT_TRUE(reload("53", globalbase, result));
+
+		/// durations are not cached, so there are no compiler stages after unwind
+		ASSERT_EQ(1, result.durations.size());
+		EXPECT_EQ("unwind", std::get<0>(result.durations[0]));
+
+		/// only tables changed since config B are pushed
+		std::set<requestType> pushed;
+		for (const auto& [type, data] : globalbase)
+		{
+			(void)data;
+			pushed.emplace(type);
+		}
+		EXPECT_EQ(1, pushed.count(requestType::acl_transport_layers));
+		EXPECT_EQ(0, pushed.count(requestType::acl_network_ipv4_source));
+		EXPECT_EQ(0, pushed.count(requestType::acl_total_table));
+	}
+
+	/// rolled back rules are known, next reload of A is skipped
+	{
+		common::idp::updateGlobalBase::request globalbase;
+		acl::result_t result;
+		EXPECT_FALSE(reload("53", globalbase, result));
+		EXPECT_EQ(0, globalbase.size());
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
 } // namespace
@@ -0,0 +1,57 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../acl_network_table.h"
+
+namespace
+{
+
+TEST(acl_network_table, compress)
+{
+	acl::compiler::network_table_t table(nullptr);
+
+	table.width = 4;
+	table.values = {1, 2, 3, 0,
+	                4, 5, 6, 0,
+	                1, 2, 3, 0,
+	                1, 2, 3, 0,
+	                4, 5, 6, 0,
+	                1, 2, 3, 0};
+	const auto values = table.values;
+
+	table.compress();
+
+	EXPECT_THAT(table.rows, ::testing::ElementsAre(0, 1, 0, 0, 1, 0));
+	EXPECT_THAT(table.values.size(), 8);
+
+	for (uint32_t k1 = 0;
+	     k1 < table.rows.size();
+	     k1++)
+	{
+		for (uint32_t k2 = 0;
+		     k2 < table.width;
+		     k2++)
+		{
+			EXPECT_THAT(table.values[table.rows[k1] * table.width + k2], values[k1 * table.width + k2]);
+		}
+	}
+}
+
+TEST(acl_network_table, compress_no_savings)
+{
+	acl::compiler::network_table_t table(nullptr);
+
+	table.width = 2;
+	table.values = {1, 2,
+	                3, 4,
+	                1, 2};
+	const auto values = table.values;
+
+	/// 3 rows + 2 distinct rows of 2 values is more than 6 values
+	table.compress();
+
+	EXPECT_TRUE(table.rows.empty());
+	EXPECT_THAT(table.values, values);
+}
+
+}
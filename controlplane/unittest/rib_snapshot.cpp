@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+
+#include "common/type.h"
+
+#include "../rib_snapshot.h"
+
+namespace
+{
+
+using namespace rib::snapshot;
+
+TEST(rib_snapshot, prefix)
+{
+	for (const auto& string : {"10.0.0.0/8", "0.0.0.0/0", "1.2.3.4/32", "2a02:6b8::/32", "::/0"})
+	{
+		common::ip_prefix_t prefix(string);
+		EXPECT_EQ(prefix, prefix_t(prefix).prefix());
+	}
+}
+
+TEST(rib_snapshot, roundtrip)
+{
+	std::vector<common::rib::pptn_t> pptns = {{"bgp", common::ip_address_t("::1"), "default"},
+	                                          {"static", common::ip_address_t("10.0.0.1"), ""}};
+	std::vector<std::string> strings = {"", "path_info"};
+
+	std::stringstream stream;
+	header_t header;
+
+	{
+		writer_t writer(stream);
+
+		writer.begin(header.prefixes);
+		prefix_t prefix(common::ip_prefix_t("10.0.0.0/8"));
+		prefix.vrf_priority_id = 0;
+		prefix.paths_offset = 0;
+		prefix.paths_count = 2;
+		writer.append(header.prefixes, prefix);
+
+		writer.begin(header.paths);
+		writer.append(header.paths, path_t{0, 1, 0, 0});
+		writer.append(header.paths, path_t{1, 0, 0, 0});
+
+		writer.write_entries(header.nexthops, header.nexthops_index, std::vector<std::string>{"nexthop"});
+		writer.write_entries(header.pptns, header.pptns_index, pptns);
+		writer.write_entries(header.vrf_priorities, header.vrf_priorities_index, std::vector<common::rib::vrf_priority_t>{{"default", 10000}});
+		writer.write_entries(header.strings, header.strings_index, strings);
+		writer.write_value(header.summary, (uint64_t)42);
+
+		EXPECT_TRUE(writer.finish(header));
+	}
+
+	const auto buffer = stream.str();
+
+	reader_t reader;
+	ASSERT_TRUE(reader.open((const uint8_t*)buffer.data(), buffer.size()));
+
+	const auto& loaded = reader.header();
+	ASSERT_EQ(1, loaded.prefixes.count);
+	ASSERT_EQ(2, loaded.paths.count);
+	EXPECT_EQ(common::ip_prefix_t("10.0.0.0/8"), reader.records<prefix_t>(loaded.prefixes)[0].prefix());
+	EXPECT_EQ(1, reader.records<path_t>(loaded.paths)[0].path_info_id);
+
+	for (uint64_t i = 0;
+	     i < pptns.size();
+	     i++)
+	{
+		common::rib::pptn_t pptn;
+		EXPECT_TRUE(reader.entry(loaded.pptns, loaded.pptns_index, i, pptn));
+		EXPECT_EQ(pptns[i], pptn);
+	}
+
+	std::string string;
+	EXPECT_TRUE(reader.entry(loaded.strings, loaded.strings_index, 1, string));
+	EXPECT_EQ("path_info", string);
+	EXPECT_FALSE(reader.entry(loaded.strings, loaded.strings_index, 2, string));
+
+	uint64_t summary = 0;
+	EXPECT_TRUE(reader.value(loaded.summary, summary));
+	EXPECT_EQ(42, summary);
+
+	/// path refers to unknown nexthop
+	auto corrupted = buffer;
+	((path_t*)(corrupted.data() + loaded.paths.offset))[1].nexthop_id = 1;
+	reader_t corrupted_reader;
+	EXPECT_FALSE(corrupted_reader.open((const uint8_t*)corrupted.data(), corrupted.size()));
+}
+
+TEST(rib_snapshot, version)
+{
+	std::stringstream stream;
+	header_t header;
+	memset(&header, 0, sizeof(header));
+
+	{
+		writer_t writer(stream);
+		EXPECT_TRUE(writer.finish(header));
+	}
+
+	auto buffer = stream.str();
+	EXPECT_EQ(version, version_of((const uint8_t*)buffer.data(), buffer.size()));
+
+	((header_t*)buffer.data())->version = version + 1;
+	EXPECT_EQ(version + 1, version_of((const uint8_t*)buffer.data(), buffer.size()));
+	reader_t reader;
+	EXPECT_FALSE(reader.open((const uint8_t*)buffer.data(), buffer.size()));
+
+	/// rib_save of previous releases starts with proto_peer_table_name
+	common::stream_out_t legacy;
+	legacy.push(std::vector<common::rib::pptn_t>{{"bgp", common::ip_address_t("::1"), "default"}});
+	legacy.push((uint64_t)0);
+	EXPECT_EQ(version_legacy, version_of(legacy.getBuffer().data(), legacy.getBuffer().size()));
+	EXPECT_EQ(version_legacy, version_of(nullptr, 0));
+}
+
+} // namespace
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "../rib_stale.h"
+
+namespace
+{
+
+using common::ip_address_t;
+using common::ip_prefix_t;
+
+const rib::stale_paths_t::key_t peer1 = {"default", 10000, "bgp", ip_address_t("::1"), "ipv6 unicast"};
+const rib::stale_paths_t::key_t peer2 = {"default", 10000, "bgp", ip_address_t("::2"), "ipv6 unicast"};
+
+TEST(rib_stale, withdrawn_while_down)
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	/// restored from snapshot
+	rib::stale_paths_t stale;
+	stale.reset(now + std::chrono::seconds(300));
+	stale.insert(peer1, ip_prefix_t("2a02:6b8::/32"), "");
+	stale.insert(peer1, ip_prefix_t("2a02:6b8:1::/48"), ""); ///< withdrawn while process was down
+	stale.insert(peer2, ip_prefix_t("2a02:6b8:1::/48"), "");
+	EXPECT_EQ(3, stale.size());
+
+	/// peer1 announces only one of its prefixes again
+	stale.refresh(peer1, ip_prefix_t("2a02:6b8::/32"), "");
+	stale.refresh(peer1, ip_prefix_t("10.0.0.0/8"), ""); ///< not restored
+	EXPECT_EQ(2, stale.size());
+
+	/// end-of-rib of peer1 withdraws its not announced prefix, paths of peer2 are kept
+	const auto withdrawn = stale.eor(peer1);
+	ASSERT_EQ(1, withdrawn.size());
+	EXPECT_EQ(ip_prefix_t("2a02:6b8:1::/48"), std::get<0>(*withdrawn.begin()));
+	EXPECT_EQ(1, stale.size());
+
+	/// second end-of-rib withdraws nothing
+	EXPECT_TRUE(stale.eor(peer1).empty());
+
+	/// announce after end-of-rib doesn't matter
+	stale.refresh(peer1, ip_prefix_t("2a02:6b8:1::/48"), "");
+	EXPECT_EQ(1, stale.size());
+}
+
+TEST(rib_stale, timeout)
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	rib::stale_paths_t stale;
+	stale.reset(now + std::chrono::seconds(300));
+	stale.insert(peer1, ip_prefix_t("2a02:6b8::/32"), "path1");
+	stale.insert(peer1, ip_prefix_t("2a02:6b8::/32"), "path2");
+	stale.insert(peer2, ip_prefix_t("10.0.0.0/8"), "");
+
+	/// path_information distinguishes paths of prefix
+	stale.refresh(peer1, ip_prefix_t("2a02:6b8::/32"), "path1");
+	EXPECT_EQ(2, stale.size());
+
+	EXPECT_TRUE(stale.expire(now + std::chrono::seconds(299)).empty());
+	EXPECT_EQ(2, stale.size());
+
+	/// peer, which never comes back, is withdrawn after timeout
+	const auto expired = stale.expire(now + std::chrono::seconds(300));
+	ASSERT_EQ(2, expired.size());
+	EXPECT_EQ(1, expired.at(peer1).count({ip_prefix_t("2a02:6b8::/32"), "path2"}));
+	EXPECT_EQ(1, expired.at(peer2).count({ip_prefix_t("10.0.0.0/8"), ""}));
+	EXPECT_TRUE(stale.empty());
+
+	/// reset forgets paths
+	stale.insert(peer1, ip_prefix_t("2a02:6b8::/32"), "");
+	stale.reset(now);
+	EXPECT_TRUE(stale.empty());
+}
+
+}
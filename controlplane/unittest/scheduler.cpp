@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include "common/scheduler.h"
+
+namespace
+{
+
+using maglev_reals_t = std::vector<std::tuple<uint64_t, uint32_t>>;
+
+constexpr uint32_t table_size = 1021;
+
+maglev_reals_t make_reals(const unsigned int count)
+{
+	maglev_reals_t reals;
+	for (unsigned int real_i = 0;
+	     real_i < count;
+	     real_i++)
+	{
+		reals.emplace_back(0x0A000000ull + real_i, 1);
+	}
+	return reals;
+}
+
+std::vector<uint32_t> count_slots(const std::vector<uint32_t>& table,
+                                  const unsigned int reals_count)
+{
+	std::vector<uint32_t> result(reals_count, 0);
+	for (const auto& real_i : table)
+	{
+		result[real_i]++;
+	}
+	return result;
+}
+
+/// percent of slots, which moved to another real
+double remap_percent(const std::vector<uint32_t>& before,
+                     const std::vector<uint32_t>& after)
+{
+	unsigned int remapped = 0;
+	for (unsigned int slot_i = 0;
+	     slot_i < before.size();
+	     slot_i++)
+	{
+		if (before[slot_i] != after[slot_i])
+		{
+			remapped++;
+		}
+	}
+	return 100.0 * remapped / before.size();
+}
+
+TEST(maglev, basic)
+{
+	EXPECT_TRUE(balancer::maglev_t::populate({}, table_size).empty());
+	EXPECT_TRUE(balancer::maglev_t::populate({{1, 0}, {2, 0}}, table_size).empty());
+
+	const auto reals = make_reals(10);
+	const auto table = balancer::maglev_t::populate(reals, table_size);
+	ASSERT_EQ(table_size, table.size());
+
+	/// balanced
+	for (const auto& count : count_slots(table, reals.size()))
+	{
+		EXPECT_LE(table_size / reals.size() - 2, count);
+		EXPECT_GE(table_size / reals.size() + 2, count);
+	}
+
+	/// deterministic and independent of order of reals
+	auto reals_reversed = reals;
+	std::reverse(reals_reversed.begin(), reals_reversed.end());
+	const auto table_reversed = balancer::maglev_t::populate(reals_reversed, table_size);
+	unsigned int equal = 0;
+	for (unsigned int slot_i = 0;
+	     slot_i < table_size;
+	     slot_i++)
+	{
+		equal += (std::get<0>(reals[table[slot_i]]) == std::get<0>(reals_reversed[table_reversed[slot_i]]));
+	}
+	EXPECT_LE(table_size * 9 / 10, equal);
+}
+
+TEST(maglev, weight)
+{
+	auto reals = make_reals(4);
+	std::get<1>(reals[0]) = 3;
+	std::get<1>(reals[1]) = 2;
+
+	const auto counts = count_slots(balancer::maglev_t::populate(reals, table_size), reals.size());
+
+	/// 3:2:1:1
+	EXPECT_NEAR(table_size * 3 / 7, counts[0], 2);
+	EXPECT_NEAR(table_size * 2 / 7, counts[1], 2);
+	EXPECT_NEAR(table_size * 1 / 7, counts[2], 2);
+	EXPECT_NEAR(table_size * 1 / 7, counts[3], 2);
+}
+
+TEST(maglev, remap)
+{
+	for (unsigned int reals_count : {4, 10, 32, 100})
+	{
+		auto reals = make_reals(reals_count);
+		const auto table = balancer::maglev_t::populate(reals, table_size);
+
+		/// disable one real
+		std::get<1>(reals[reals_count / 2]) = 0;
+		const auto table_disabled = balancer::maglev_t::populate(reals, table_size);
+
+		for (unsigned int slot_i = 0;
+		     slot_i < table_size;
+		     slot_i++)
+		{
+			EXPECT_NE(reals_count / 2, table_disabled[slot_i]);
+		}
+
+		/// ideal: only slots of disabled real are remapped (100 / reals_count %).
+		/// maglev adds a few percent, which grows with reals_count / table_size
+		const double ideal = 100.0 / reals_count;
+		const double disabled = remap_percent(table, table_disabled);
+		EXPECT_LE(ideal - 1.0, disabled);
+		EXPECT_GE(ideal + 5.0, disabled) << "reals: " << reals_count;
+
+		/// enable it back
+		std::get<1>(reals[reals_count / 2]) = 1;
+		const auto table_enabled = balancer::maglev_t::populate(reals, table_size);
+		EXPECT_EQ(table, table_enabled);
+
+		/// reweight one real
+		std::get<1>(reals[0]) = 2;
+		const auto table_reweighted = balancer::maglev_t::populate(reals, table_size);
+		EXPECT_GE(ideal * 2 + 5.0, remap_percent(table, table_reweighted)) << "reals: " << reals_count;
+
+		/// compare with modulo of weighted ring (rr/wrr)
+		unsigned int ring_remapped = 0;
+		for (unsigned int hash = 0;
+		     hash < table_size;
+		     hash++)
+		{
+			unsigned int before = hash % reals_count;
+			unsigned int after = hash % (reals_count - 1);
+			after += (after >= reals_count / 2);
+			ring_remapped += (before != after);
+		}
+		EXPECT_LT(disabled, 100.0 * ring_remapped / table_size);
+	}
+}
+
+} // namespace
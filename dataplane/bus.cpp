@@ -263,6 +263,10 @@ void cBus::clientThread(int clientSocket)
 		{
 			response = callWithResponse(&cControlPlane::getOtherStats, request);
 		}
+		else if (type == common::idp::requestType::get_worker_profile)
+		{
+			response = callWithResponse(&cControlPlane::get_worker_profile, request);
+		}
 		else if (type == common::idp::requestType::getConfig)
 		{
 			response = callWithResponse(&cControlPlane::getConfig, request);
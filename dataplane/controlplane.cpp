@@ -22,14 +22,11 @@
 
 cControlPlane::cControlPlane(cDataPlane* dataPlane) :
         dataPlane(dataPlane),
-        fragmentation(this, dataPlane),
         dregress(this, dataPlane),
         mempool(nullptr),
         use_kernel_interface(false),
-        slowWorker(nullptr),
-        prevTimePointForSWRateLimiter(std::chrono::high_resolution_clock::now())
+        slow_workers_stop(false)
 {
-	memset(&stats, 0, sizeof(stats));
 }
 
 cControlPlane::~cControlPlane()
@@ -58,12 +55,72 @@ cControlPlane::~cControlPlane()
 		remove_kernel_interface(port_id, interface_name);
 	}
 
+	slow_workers.clear();
+
 	if (mempool)
 	{
 		rte_mempool_free(mempool);
 	}
 }
 
+cControlPlane::slow_worker_t::slow_worker_t(cControlPlane* controlPlane,
+                                            cDataPlane* dataPlane,
+                                            const uint32_t id,
+                                            cWorker* worker) :
+        id(id),
+        worker(worker),
+        ring_handover(nullptr),
+        fragmentation(controlPlane, dataPlane, dataPlane->getConfigValue(eConfigType::fragmentation_size) / (dataPlane->config.slowWorkerCoreIds.size() + 1)),
+        prevTimePointForSWRateLimiter(std::chrono::high_resolution_clock::now()),
+        icmpOutRemainder(0),
+        running(false)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+cControlPlane::slow_worker_t::~slow_worker_t()
+{
+	while (!mbufs.empty())
+	{
+		rte_pktmbuf_free(std::get<0>(mbufs.front()));
+		mbufs.pop();
+	}
+
+	if (ring_handover)
+	{
+		rte_mbuf* mbuf;
+		while (rte_ring_sc_dequeue(ring_handover, (void**)&mbuf) == 0)
+		{
+			rte_pktmbuf_free(mbuf);
+		}
+
+		rte_ring_free(ring_handover);
+	}
+}
+
+eResult cControlPlane::add_slow_worker(cWorker* worker)
+{
+	auto item = std::make_unique<slow_worker_t>(this,
+	                                            dataPlane,
+	                                            slow_workers.size(),
+	                                            worker);
+
+	item->ring_handover = rte_ring_create(("r_sw_" + std::to_string(worker->coreId)).c_str(),
+	                                      dataPlane->getConfigValue(eConfigType::ring_slowWorker_size),
+	                                      rte_lcore_to_socket_id(worker->coreId),
+	                                      RING_F_SC_DEQ); ///< multi-producers
+	if (!item->ring_handover)
+	{
+		YADECAP_LOG_ERROR("rte_ring_create(): %s [%u]\n", rte_strerror(rte_errno), rte_errno);
+		return eResult::errorInitRing;
+	}
+
+	item->workers.emplace_back(worker);
+
+	slow_workers.emplace_back(std::move(item));
+	return eResult::success;
+}
+
 eResult cControlPlane::init(bool use_kernel_interface)
 {
 	this->use_kernel_interface = use_kernel_interface;
@@ -80,13 +137,55 @@ eResult cControlPlane::init(bool use_kernel_interface)
 	gc_step = dataPlane->getConfigValue(eConfigType::gc_step);
 	dregress.gc_step = gc_step;
 
-	icmpOutRemainder = dataPlane->config.SWICMPOutRateLimit / dataPlane->config.rateLimitDivisor;
+	if (slow_workers.empty())
+	{
+		YADECAP_LOG_ERROR("slow worker not found\n");
+		return eResult::invalidCoreId;
+	}
+
+	/// rings of forwarding workers are distributed round-robin between slow workers
+	{
+		unsigned int worker_i = 0;
+		for (const auto& [core_id, worker] : dataPlane->workers)
+		{
+			if (core_id == dataPlane->config.controlPlaneCoreId ||
+			    exist(dataPlane->config.slowWorkerCoreIds, core_id))
+			{
+				/// slow worker
+				continue;
+			}
+
+			slow_workers[worker_i % slow_workers.size()]->workers.emplace_back(worker);
+			worker_i++;
+		}
+	}
+
+	for (auto& item : slow_workers)
+	{
+		item->icmpOutRemainder = dataPlane->config.SWICMPOutRateLimit / dataPlane->config.rateLimitDivisor / slow_workers.size();
+	}
 
 	return result;
 }
 
-void cControlPlane::start()
+eResult cControlPlane::start()
 {
+	for (auto& iter : slow_workers)
+	{
+		if (iter->worker->coreId == rte_lcore_id())
+		{
+			slow_worker = iter.get();
+		}
+	}
+
+	if (!slow_worker)
+	{
+		YADECAP_LOG_ERROR("invalid core id: '%u'\n", rte_lcore_id());
+		stop();
+		join();
+		return eResult::invalidCoreId;
+	}
+
 	int rc = pthread_barrier_wait(&dataPlane->initPortBarrier);
 	if (rc == PTHREAD_BARRIER_SERIAL_THREAD)
 	{
@@ -95,31 +194,35 @@ void cControlPlane::start()
 	else if (rc != 0)
 	{
 		YADECAP_LOG_ERROR("pthread_barrier_wait() = %d\n", rc);
-		/// @todo: stop
-		return;
+		stop();
+		join();
+		return eResult::errorInitBarrier;
 	}
 
-	/// start devices
-	for (tPortId portId = 0; portId < rte_eth_dev_count_avail(); portId++)
+	if (slow_worker->id == 0)
 	{
-		int rc = rte_eth_dev_start(portId);
-		if (rc)
+		/// start devices
+		for (tPortId portId = 0; portId < rte_eth_dev_count_avail(); portId++)
 		{
-			YADECAP_LOG_ERROR("can't start eth dev(%d, %d): %s\n",
-			                  rc,
-			                  rte_errno,
-			                  rte_strerror(rte_errno));
-			abort();
-		}
+			int rc = rte_eth_dev_start(portId);
+			if (rc)
+			{
+				YADECAP_LOG_ERROR("can't start eth dev(%d, %d): %s\n",
+				                  rc,
+				                  rte_errno,
+				                  rte_strerror(rte_errno));
+				abort();
+			}
 
-		rte_eth_promiscuous_enable(portId);
-	}
+			rte_eth_promiscuous_enable(portId);
+		}
 
-	if (use_kernel_interface)
-	{
-		if (init_kernel_interfaces() != eResult::success)
+		if (use_kernel_interface)
 		{
-			abort();
+			if (init_kernel_interfaces() != eResult::success)
+			{
+				abort();
+			}
 		}
 	}
 
@@ -131,19 +234,47 @@ void cControlPlane::start()
 	else if (rc != 0)
 	{
 		YADECAP_LOG_ERROR("pthread_barrier_wait() = %d\n", rc);
-		/// @todo: stop
-		return;
+		stop();
+		join();
+		return eResult::errorInitBarrier;
 	}
 
-	for (const auto& [port_id, kernel_interface] : kernel_interfaces)
+	if (slow_worker->id == 0)
 	{
-		(void)port_id;
-		const auto& interface_name = std::get<0>(kernel_interface);
+		for (const auto& [port_id, kernel_interface] : kernel_interfaces)
+		{
+			(void)port_id;
+			const auto& interface_name = std::get<0>(kernel_interface);
 
-		set_kernel_interface_up(interface_name);
+			set_kernel_interface_up(interface_name);
+		}
 	}
 
 	mainThread();
+	return eResult::success;
+}
+
+/// main loops of all slow workers exit
+void cControlPlane::stop()
+{
+	slow_workers_stop = true;
+}
+
+/// waits for other slow workers which are in main loop
+void cControlPlane::join()
+{
+	for (const auto& iter : slow_workers)
+	{
+		if (iter.get() == slow_worker)
+		{
+			continue;
+		}
+
+		while (iter->running)
+		{
+			std::this_thread::yield();
+		}
+	}
 }
 
 common::idp::updateGlobalBase::response cControlPlane::updateGlobalBase(const common::idp::updateGlobalBase::request& request)
@@ -156,12 +287,19 @@ common::idp::updateGlobalBase::response cControlPlane::updateGlobalBase(const co
 
 	YADECAP_MEMORY_BARRIER_COMPILE;
 
+	const auto start = std::chrono::steady_clock::now();
+	dataplane::globalBase::generation::update_durations_t durations;
+
+	/// writes to journaled tables of next generation, per socket
+	std::map<tSocketId, dataplane::journal_t> journals;
+
 	auto result = eResult::success;
 	for (auto& iter : dataPlane->globalBases)
 	{
 		auto* globalBaseNext = iter.second[dataPlane->currentGlobalBaseId ^ 1];
+		auto& journal = journals.emplace(iter.first, globalBaseNext->make_journal()).first->second;
 		DEBUG_LATCH_WAIT(common::idp::debug_latch_update::id::global_base_pre_update);
-		result = globalBaseNext->update(request);
+		result = globalBaseNext->update(request, &journal, &durations);
 		DEBUG_LATCH_WAIT(common::idp::debug_latch_update::id::global_base_post_update);
 		if (result != eResult::success)
 		{
@@ -183,12 +321,15 @@ common::idp::updateGlobalBase::response cControlPlane::updateGlobalBase(const co
 
 	YADECAP_MEMORY_BARRIER_COMPILE;
 
+	uint64_t journal_bytes = 0;
+
 	result = eResult::success;
 	for (auto& iter : dataPlane->globalBases)
 	{
 		auto* globalBaseNext = iter.second[dataPlane->currentGlobalBaseId ^ 1];
+		const auto& journal = journals.find(iter.first)->second;
 		DEBUG_LATCH_WAIT(common::idp::debug_latch_update::id::global_base_pre_update);
-		result = globalBaseNext->update(request);
+		result = globalBaseNext->update_stale(request, journal, &durations);
 		DEBUG_LATCH_WAIT(common::idp::debug_latch_update::id::global_base_post_update);
 		if (result != eResult::success)
 		{
@@ -196,6 +337,8 @@ common::idp::updateGlobalBase::response cControlPlane::updateGlobalBase(const co
 			++errors["updateGlobalBase"];
 			break;
 		}
+
+		journal_bytes += journal.dirty_size();
 	}
 
 	if (result != eResult::success)
@@ -209,6 +352,19 @@ common::idp::updateGlobalBase::response cControlPlane::updateGlobalBase(const co
 
 	YADECAP_MEMORY_BARRIER_COMPILE;
 
+	dregress.update_snapshot();
+
+	{
+		std::lock_guard<std::mutex> guard(update_global_base_stats_mutex);
+
+		update_global_base_stats.update(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		for (const auto& [type, duration] : durations)
+		{
+			update_global_base_type_stats[type].update(duration);
+		}
+		update_global_base_journal_bytes += journal_bytes;
+	}
+
 	return eResult::success;
 }
 
@@ -302,6 +458,33 @@ common::idp::getOtherStats::response cControlPlane::getOtherStats()
 	return response;
 }
 
+common::idp::get_worker_profile::response cControlPlane::get_worker_profile()
+{
+	/// unsafe
+
+	common::idp::get_worker_profile::response response;
+
+#ifdef YANET_CONFIG_WORKER_PROFILE
+	for (const auto& iter : dataPlane->workers)
+	{
+		const tCoreId& coreId = iter.first;
+		const auto& profile = iter.second->profile;
+
+		auto& response_stages = response[coreId];
+		for (uint32_t stage_i = 0;
+		     stage_i < (uint32_t)worker::stage_e::size;
+		     stage_i++)
+		{
+			response_stages[worker::stage_to_string((worker::stage_e)stage_i)] = {profile.cycles[stage_i],
+			                                                                       profile.invocations[stage_i],
+			                                                                       profile.packets[stage_i]};
+		}
+	}
+#endif
+
+	return response;
+}
+
 common::idp::getWorkerStats::response cControlPlane::getWorkerStats(const common::idp::getWorkerStats::request& request)
 {
 	/// unsafe
@@ -357,11 +540,16 @@ common::idp::getSlowWorkerStats::response cControlPlane::getSlowWorkerStats()
 	/// unsafe
 
 	common::idp::getSlowWorkerStats::response response;
-	auto& [slowworker_stats, hashtable_gc_stats] = response;
+	auto& [slowworker_stats, hashtable_gc_stats, slowworker_stats_per_core] = response;
+
+	slowworker_stats = get_slow_worker_stats();
+	for (const auto& item : slow_workers)
+	{
+		slowworker_stats_per_core[item->worker->coreId] = item->stats;
+	}
 
-	slowworker_stats = stats;
 	/// @todo
-	// hashtable_gc_stats.emplace_back(slowWorker->socketId,
+	// hashtable_gc_stats.emplace_back(slow_worker->worker->socketId,
 	//                                 "dregress",
 	//                                 dregress.connections);
 
@@ -387,6 +575,16 @@ common::idp::getSlowWorkerStats::response cControlPlane::getSlowWorkerStats()
 		                                worker->nat64stateful_wan_state_gc.valid_keys,
 		                                worker->nat64stateful_wan_state_gc.iterations);
 
+		hashtable_gc_stats.emplace_back(worker->socket_id,
+		                                "nat64stateful.lan.block.ht",
+		                                worker->nat64stateful_lan_block_gc.valid_keys,
+		                                worker->nat64stateful_lan_block_gc.iterations);
+
+		hashtable_gc_stats.emplace_back(worker->socket_id,
+		                                "nat64stateful.wan.block.ht",
+		                                worker->nat64stateful_wan_block_gc.valid_keys,
+		                                worker->nat64stateful_wan_block_gc.iterations);
+
 		hashtable_gc_stats.emplace_back(worker->socket_id,
 		                                "acl.state.v4.ht",
 		                                worker->fw4_state_gc.valid_keys,
@@ -401,6 +599,31 @@ common::idp::getSlowWorkerStats::response cControlPlane::getSlowWorkerStats()
 	return response;
 }
 
+common::slowworker::stats_t cControlPlane::get_slow_worker_stats() const
+{
+	/// unsafe
+
+	common::slowworker::stats_t result;
+	memset(&result, 0, sizeof(result));
+
+	for (const auto& item : slow_workers)
+	{
+		const auto& stats = item->stats;
+
+		result.repeat_packets += stats.repeat_packets;
+		result.tofarm_packets += stats.tofarm_packets;
+		result.farm_packets += stats.farm_packets;
+		result.fwsync_multicast_ingress_packets += stats.fwsync_multicast_ingress_packets;
+		result.fwsync_multicast_ingress_frames += stats.fwsync_multicast_ingress_frames;
+		result.slowworker_packets += stats.slowworker_packets;
+		result.slowworker_drops += stats.slowworker_drops;
+		result.mempool_is_empty += stats.mempool_is_empty;
+		result.unknown_dump_interface += stats.unknown_dump_interface;
+	}
+
+	return result;
+}
+
 common::idp::get_worker_gc_stats::response cControlPlane::get_worker_gc_stats()
 {
 	common::idp::get_worker_gc_stats::response response;
@@ -488,15 +711,22 @@ common::idp::getControlPlanePortStats::response cControlPlane::getControlPlanePo
 			const auto& stats = std::get<2>(port);
 
 			uint64_t controlPlane_drops = 0;
+			uint64_t ipackets = stats.ipackets;
+			uint64_t ibytes = stats.ibytes;
 			for (const auto& [coreId, worker] : dataPlane->workers)
 			{
 				(void)coreId;
 
 				controlPlane_drops += worker->statsPorts[portId].controlPlane_drops;
+
+				const auto& kernel_interface_queue = worker->kernel_interface_queues[portId];
+				ipackets += kernel_interface_queue.packets;
+				ibytes += kernel_interface_queue.bytes;
+				controlPlane_drops += kernel_interface_queue.drops;
 			}
 
-			response[portId] = {stats.ipackets,
-			                    stats.ibytes,
+			response[portId] = {ipackets,
+			                    ibytes,
 			                    0,
 			                    stats.idropped + controlPlane_drops,
 			                    stats.opackets,
@@ -514,15 +744,22 @@ common::idp::getControlPlanePortStats::response cControlPlane::getControlPlanePo
 			const auto& stats = std::get<2>(port);
 
 			uint64_t controlPlane_drops = 0;
+			uint64_t ipackets = stats.ipackets;
+			uint64_t ibytes = stats.ibytes;
 			for (const auto& [coreId, worker] : dataPlane->workers)
 			{
 				(void)coreId;
 
 				controlPlane_drops += worker->statsPorts[portId].controlPlane_drops;
+
+				const auto& kernel_interface_queue = worker->kernel_interface_queues[portId];
+				ipackets += kernel_interface_queue.packets;
+				ibytes += kernel_interface_queue.bytes;
+				controlPlane_drops += kernel_interface_queue.drops;
 			}
 
-			response[portId] = {stats.ipackets,
-			                    stats.ibytes,
+			response[portId] = {ipackets,
+			                    ibytes,
 			                    0,
 			                    stats.idropped + controlPlane_drops,
 			                    stats.opackets,
@@ -537,7 +774,26 @@ common::idp::getControlPlanePortStats::response cControlPlane::getControlPlanePo
 
 common::idp::getFragmentationStats::response cControlPlane::getFragmentationStats()
 {
-	return fragmentation.getStats();
+	/// unsafe
+
+	common::idp::getFragmentationStats::response response;
+	memset(&response, 0, sizeof(response));
+
+	for (const auto& item : slow_workers)
+	{
+		const auto stats = item->fragmentation.getStats();
+
+		response.current_count_packets += stats.current_count_packets;
+		response.total_overflow_packets += stats.total_overflow_packets;
+		response.not_fragment_packets += stats.not_fragment_packets;
+		response.empty_packets += stats.empty_packets;
+		response.flow_overflow_packets += stats.flow_overflow_packets;
+		response.intersect_packets += stats.intersect_packets;
+		response.unknown_network_type_packets += stats.unknown_network_type_packets;
+		response.timeout_packets += stats.timeout_packets;
+	}
+
+	return response;
 }
 
 common::idp::getFWState::response cControlPlane::getFWState()
@@ -951,26 +1207,10 @@ common::idp::limits::response cControlPlane::limits()
 		{
 			const auto* globalBase = generations[dataPlane->currentGlobalBaseId];
 
-			limit_insert(response,
-			             "route.v4.lpm.extended_chunks",
-			             socket_id,
-			             globalBase->route_lpm4.getStats().extendedChunksCount,
-			             CONFIG_YADECAP_LPM4_EXTENDED_SIZE);
-			limit_insert(response,
-			             "route.v6.lpm.extended_chunks",
-			             socket_id,
-			             globalBase->route_lpm6.getStats().extendedChunksCount,
-			             CONFIG_YADECAP_LPM6_EXTENDED_SIZE);
-			limit_insert(response,
-			             "route.tunnel.v4.lpm.extended_chunks",
-			             socket_id,
-			             globalBase->route_tunnel_lpm4.getStats().extendedChunksCount,
-			             YANET_CONFIG_ROUTE_TUNNEL_LPM4_EXTENDED_SIZE);
-			limit_insert(response,
-			             "route.tunnel.v6.lpm.extended_chunks",
-			             socket_id,
-			             globalBase->route_tunnel_lpm6.getStats().extendedChunksCount,
-			             YANET_CONFIG_ROUTE_TUNNEL_LPM6_EXTENDED_SIZE);
+			globalBase->route_lpm4.limits(response, "route.v4.lpm", socket_id);
+			globalBase->route_lpm6.limits(response, "route.v6.lpm", socket_id);
+			globalBase->route_tunnel_lpm4.limits(response, "route.tunnel.v4.lpm", socket_id);
+			globalBase->route_tunnel_lpm6.limits(response, "route.tunnel.v6.lpm", socket_id);
 
 			globalBase->updater.acl.network_table.limits(response, "acl.network.ht");
 			globalBase->updater.acl.transport_table.limits(response, "acl.transport.ht");
@@ -996,6 +1236,15 @@ common::idp::limits::response cControlPlane::limits()
 		}
 	}
 
+	for (const auto& [socket_id, globalbase_atomic] : dataPlane->globalBaseAtomics)
+	{
+		limit_insert(response,
+		             "balancer.weights",
+		             socket_id,
+		             globalbase_atomic->balancer_weights_size,
+		             YANET_CONFIG_BALANCER_WEIGHTS_SIZE);
+	}
+
 	for (const auto& [core_id, worker_gc] : dataPlane->worker_gcs)
 	{
 		(void)core_id;
@@ -1451,9 +1700,11 @@ eResult cControlPlane::init_kernel_interfaces()
 	for (const auto& [port_id, port] : dataPlane->ports)
 	{
 		const auto& interface_name = std::get<0>(port);
+		const auto& rx_queues = std::get<1>(port);
+		const uint16_t queues_count = std::get<3>(dataPlane->config.ports[interface_name]);
 
 		{
-			auto kernel_port_id = add_kernel_interface(port_id, interface_name);
+			auto kernel_port_id = add_kernel_interface(port_id, interface_name, queues_count);
 			if (!kernel_port_id)
 			{
 				return eResult::errorAllocatingKernelInterface;
@@ -1463,11 +1714,34 @@ eResult cControlPlane::init_kernel_interfaces()
 			                              *kernel_port_id,
 			                              {},
 			                              {},
-			                              0};
+			                              0,
+			                              std::vector<sKniStats>(queues_count)};
+
+			/// queue 0 stays with slow worker. each of other queues is owned by one worker of port,
+			/// worker transmits to it without ring_normalPriority and convertMempool()
+			tQueueId queue_id = 1;
+			for (const auto& [core_id, rx_queue_id] : rx_queues)
+			{
+				(void)rx_queue_id;
+
+				if (queue_id >= queues_count)
+				{
+					YANET_LOG_WARNING("kernel interface '%s': not enough queues for worker on core '%u', using slow worker\n",
+					                  interface_name.data(),
+					                  core_id);
+					continue;
+				}
+
+				auto& kernel_interface_queue = dataPlane->workers.find(core_id)->second->kernel_interface_queues[port_id];
+				kernel_interface_queue.kernel_port_id = *kernel_port_id;
+				kernel_interface_queue.queue_id = queue_id;
+
+				queue_id++;
+			}
 		}
 
 		{
-			auto kernel_port_id = add_kernel_interface(port_id, "in." + interface_name);
+			auto kernel_port_id = add_kernel_interface(port_id, "in." + interface_name, 1);
 			if (!kernel_port_id)
 			{
 				return eResult::errorAllocatingKernelInterface;
@@ -1480,7 +1754,7 @@ eResult cControlPlane::init_kernel_interfaces()
 		}
 
 		{
-			auto kernel_port_id = add_kernel_interface(port_id, "out." + interface_name);
+			auto kernel_port_id = add_kernel_interface(port_id, "out." + interface_name, 1);
 			if (!kernel_port_id)
 			{
 				return eResult::errorAllocatingKernelInterface;
@@ -1493,7 +1767,7 @@ eResult cControlPlane::init_kernel_interfaces()
 		}
 
 		{
-			auto kernel_port_id = add_kernel_interface(port_id, "drop." + interface_name);
+			auto kernel_port_id = add_kernel_interface(port_id, "drop." + interface_name, 1);
 			if (!kernel_port_id)
 			{
 				return eResult::errorAllocatingKernelInterface;
@@ -1510,7 +1784,8 @@ eResult cControlPlane::init_kernel_interfaces()
 }
 
 std::optional<tPortId> cControlPlane::add_kernel_interface(const tPortId port_id,
-                                                           const std::string& interface_name)
+                                                           const std::string& interface_name,
+                                                           const uint16_t queues_count)
 {
 	rte_ether_addr ether_addr;
 	rte_eth_macaddr_get(port_id, &ether_addr);
@@ -1526,7 +1801,8 @@ std::optional<tPortId> cControlPlane::add_kernel_interface(const tPortId port_id
 
 	snprintf(vdev_args,
 	         sizeof(vdev_args),
-	         "path=/dev/vhost-net,queues=1,queue_size=%lu,iface=%s,mac=%s",
+	         "path=/dev/vhost-net,queues=%u,queue_size=%lu,iface=%s,mac=%s",
+	         queues_count,
 	         dataPlane->getConfigValue(eConfigType::kernel_interface_queue_size),
 	         interface_name.data(),
 	         common::mac_address_t(ether_addr.addr_bytes).toString().data());
@@ -1551,8 +1827,8 @@ std::optional<tPortId> cControlPlane::add_kernel_interface(const tPortId port_id
 	memset(&eth_conf, 0, sizeof(eth_conf));
 
 	int ret = rte_eth_dev_configure(kernel_port_id,
-	                                1,
-	                                1,
+	                                queues_count,
+	                                queues_count,
 	                                &eth_conf);
 	if (ret < 0)
 	{
@@ -1567,29 +1843,36 @@ std::optional<tPortId> cControlPlane::add_kernel_interface(const tPortId port_id
 		rte_eth_dev_set_mtu(kernel_port_id, mtu);
 	}
 
-	int rc = rte_eth_rx_queue_setup(kernel_port_id,
-	                                0,
-	                                dataPlane->getConfigValue(eConfigType::kernel_interface_queue_size),
-	                                0, ///< @todo: socket
-	                                nullptr,
-	                                mempool);
-	if (rc < 0)
+	int rc;
+	for (tQueueId queue_id = 0;
+	     queue_id < queues_count;
+	     queue_id++)
 	{
-		YADECAP_LOG_ERROR("rte_eth_rx_queue_setup() = %d\n", rc);
-		rte_eal_hotplug_remove("vdev", vdev_name);
-		return std::nullopt;
-	}
+		/// packets from kernel are always received by slow worker
+		rc = rte_eth_rx_queue_setup(kernel_port_id,
+		                            queue_id,
+		                            dataPlane->getConfigValue(eConfigType::kernel_interface_queue_size),
+		                            0, ///< @todo: socket
+		                            nullptr,
+		                            mempool);
+		if (rc < 0)
+		{
+			YADECAP_LOG_ERROR("rte_eth_rx_queue_setup(%u, %u) = %d\n", kernel_port_id, queue_id, rc);
+			rte_eal_hotplug_remove("vdev", vdev_name);
+			return std::nullopt;
+		}
 
-	rc = rte_eth_tx_queue_setup(kernel_port_id,
-	                            0,
-	                            dataPlane->getConfigValue(eConfigType::kernel_interface_queue_size),
-	                            0, ///< @todo: socket
-	                            nullptr);
-	if (rc < 0)
-	{
-		YADECAP_LOG_ERROR("rte_eth_tx_queue_setup(%u, %u) = %d\n", kernel_port_id, 0, ret);
-		rte_eal_hotplug_remove("vdev", vdev_name);
-		return std::nullopt;
+		rc = rte_eth_tx_queue_setup(kernel_port_id,
+		                            queue_id,
+		                            dataPlane->getConfigValue(eConfigType::kernel_interface_queue_size),
+		                            0, ///< @todo: socket
+		                            nullptr);
+		if (rc < 0)
+		{
+			YADECAP_LOG_ERROR("rte_eth_tx_queue_setup(%u, %u) = %d\n", kernel_port_id, queue_id, rc);
+			rte_eal_hotplug_remove("vdev", vdev_name);
+			return std::nullopt;
+		}
 	}
 
 	rc = rte_eth_dev_start(kernel_port_id);
@@ -1688,28 +1971,35 @@ void cControlPlane::mainThread()
 
 	uint32_t prevTime = 0;
 
-	for (;;)
-	{
-		currentTime = time(nullptr);
+	/// primary slow worker also serves dregress, worker_gc rings and currentTime
+	const bool is_primary = (slow_worker->id == 0);
 
+	slow_worker->running = true;
+	while (!slow_workers_stop)
+	{
 		if (dataPlane->config.SWNormalPriorityRateLimitPerWorker || dataPlane->config.SWICMPOutRateLimit)
 		{
 			SWRateLimiterTimeTracker();
 		}
 
-		slowWorker->slowWorkerBeforeHandlePackets();
+		slow_worker->worker->slowWorkerBeforeHandlePackets();
 
-		if (currentTime != prevTime)
+		if (is_primary)
 		{
-			for (const auto& iter : dataPlane->globalBaseAtomics)
+			currentTime = time(nullptr);
+
+			if (currentTime != prevTime)
 			{
-				auto* globalBaseAtomic = iter.second;
+				for (const auto& iter : dataPlane->globalBaseAtomics)
+				{
+					auto* globalBaseAtomic = iter.second;
 
-				globalBaseAtomic->currentTime = currentTime;
-			}
+					globalBaseAtomic->currentTime = currentTime;
+				}
 
-			prevTime = currentTime;
-		};
+				prevTime = currentTime;
+			};
+		}
 
 		/// dequeue packets from worker's rings
 		for (unsigned nIter = 0; nIter < YANET_CONFIG_RING_PRIORITY_RATIO; nIter++)
@@ -1717,9 +2007,8 @@ void cControlPlane::mainThread()
 			for (unsigned hIter = 0; hIter < YANET_CONFIG_RING_PRIORITY_RATIO; hIter++)
 			{
 				unsigned hProcessed = 0;
-				for (const auto& iter : dataPlane->workers)
+				for (cWorker* worker : slow_worker->workers)
 				{
-					cWorker* worker = iter.second;
 					hProcessed += ring_handle(worker->ring_toFreePackets, worker->ring_highPriority);
 				}
 				if (!hProcessed)
@@ -1729,9 +2018,8 @@ void cControlPlane::mainThread()
 			}
 
 			unsigned nProcessed = 0;
-			for (const auto& iter : dataPlane->workers)
+			for (cWorker* worker : slow_worker->workers)
 			{
-				cWorker* worker = iter.second;
 				nProcessed += ring_handle(worker->ring_toFreePackets, worker->ring_normalPriority);
 			}
 			if (!nProcessed)
@@ -1739,97 +2027,143 @@ void cControlPlane::mainThread()
 				break;
 			}
 		}
-		for (const auto& iter : dataPlane->workers)
+		for (cWorker* worker : slow_worker->workers)
 		{
-			cWorker* worker = iter.second;
 			ring_handle(worker->ring_toFreePackets, worker->ring_lowPriority);
 		}
 
-		for (auto& iter : kernel_interfaces)
+		/// dequeue packets from other slow workers
+		ring_handover_handle();
+
+		for (auto& [port_id, kernel_interface] : kernel_interfaces)
 		{
-			auto& [interface_name, kernel_port_id, stats, mbufs, count] = iter.second;
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
+			auto& [interface_name, kernel_port_id, stats, mbufs, count, queues_stats] = kernel_interface;
 			(void)interface_name;
+			(void)queues_stats;
 			flush_kernel_interface(kernel_port_id, stats, mbufs.data(), count);
 		}
 		for (auto& [port_id, kernel_interface] : in_dump_kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto& [interface_name, kernel_port_id, mbufs, count] = kernel_interface;
-			(void)port_id;
 			(void)interface_name;
 
 			flush_kernel_interface(kernel_port_id, mbufs.data(), count);
 		}
 		for (auto& [port_id, kernel_interface] : out_dump_kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto& [interface_name, kernel_port_id, mbufs, count] = kernel_interface;
-			(void)port_id;
 			(void)interface_name;
 
 			flush_kernel_interface(kernel_port_id, mbufs.data(), count);
 		}
 		for (auto& [port_id, kernel_interface] : drop_dump_kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto& [interface_name, kernel_port_id, mbufs, count] = kernel_interface;
-			(void)port_id;
 			(void)interface_name;
 
 			flush_kernel_interface(kernel_port_id, mbufs.data(), count);
 		}
 
-		/// dequeue packets from worker_gc's ring to slowworker
-		for (const auto& [core_id, worker_gc] : dataPlane->worker_gcs)
+		if (is_primary)
 		{
-			(void)core_id;
+			/// dequeue packets from worker_gc's ring to slowworker
+			for (const auto& [core_id, worker_gc] : dataPlane->worker_gcs)
+			{
+				(void)core_id;
 
-			rte_mbuf* mbufs[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+				rte_mbuf* mbufs[CONFIG_YADECAP_MBUFS_BURST_SIZE];
 
-			unsigned rxSize = rte_ring_sc_dequeue_burst(worker_gc->ring_to_slowworker,
-			                                            (void**)mbufs,
-			                                            CONFIG_YADECAP_MBUFS_BURST_SIZE,
-			                                            nullptr);
+				unsigned rxSize = rte_ring_sc_dequeue_burst(worker_gc->ring_to_slowworker,
+				                                            (void**)mbufs,
+				                                            CONFIG_YADECAP_MBUFS_BURST_SIZE,
+				                                            nullptr);
 
-			for (uint16_t mbuf_i = 0; mbuf_i < rxSize; mbuf_i++)
-			{
-				rte_mbuf* mbuf = convertMempool(worker_gc->ring_to_free_mbuf, mbufs[mbuf_i]);
-				if (!mbuf)
+				for (uint16_t mbuf_i = 0; mbuf_i < rxSize; mbuf_i++)
 				{
-					continue;
-				}
+					rte_mbuf* mbuf = convertMempool(worker_gc->ring_to_free_mbuf, mbufs[mbuf_i]);
+					if (!mbuf)
+					{
+						continue;
+					}
 
-				dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+					dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-				sendPacketToSlowWorker(mbuf, metadata->flow);
+					sendPacketToSlowWorker(mbuf, metadata->flow);
+				}
 			}
 		}
 
-		fragmentation.handle();
-		dregress.handle();
+		slow_worker->fragmentation.handle();
+
+		if (is_primary)
+		{
+			dregress.handle();
+		}
 
 		/// recv packets from kernel interface and send to physical port
 		for (auto& [port_id, kernel_interface] : kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto kernel_port_id = std::get<1>(kernel_interface);
+			auto& queues_stats = std::get<5>(kernel_interface);
 
-			unsigned rxSize = rte_eth_rx_burst(kernel_port_id,
-			                                   0,
-			                                   mbufs,
-			                                   CONFIG_YADECAP_MBUFS_BURST_SIZE);
-			for (uint16_t mbuf_i = 0; mbuf_i < rxSize; mbuf_i++)
+			for (tQueueId queue_id = 0;
+			     queue_id < queues_stats.size();
+			     queue_id++)
 			{
-				rte_mbuf* mbuf = mbufs[mbuf_i];
+				unsigned rxSize = rte_eth_rx_burst(kernel_port_id,
+				                                   queue_id,
+				                                   mbufs,
+				                                   CONFIG_YADECAP_MBUFS_BURST_SIZE);
+				for (uint16_t mbuf_i = 0; mbuf_i < rxSize; mbuf_i++)
+				{
+					rte_mbuf* mbuf = mbufs[mbuf_i];
+
+					dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+					metadata->fromPortId = port_id;
 
-				dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
-				metadata->fromPortId = port_id;
+					queues_stats[queue_id].obytes += rte_pktmbuf_pkt_len(mbuf);
 
-				handle_packet_from_kernel(mbuf);
+					handle_packet_from_kernel(mbuf);
+				}
+
+				queues_stats[queue_id].opackets += rxSize;
 			}
 		}
 
 		/// recv from in.X/out.X/drop.X interfaces and free packets
 		for (auto& [port_id, kernel_interface] : in_dump_kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto kernel_port_id = std::get<1>(kernel_interface);
-			(void)port_id;
 
 			unsigned rxSize = rte_eth_rx_burst(kernel_port_id,
 			                                   0,
@@ -1843,8 +2177,12 @@ void cControlPlane::mainThread()
 		}
 		for (auto& [port_id, kernel_interface] : out_dump_kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto kernel_port_id = std::get<1>(kernel_interface);
-			(void)port_id;
 
 			unsigned rxSize = rte_eth_rx_burst(kernel_port_id,
 			                                   0,
@@ -1858,8 +2196,12 @@ void cControlPlane::mainThread()
 		}
 		for (auto& [port_id, kernel_interface] : drop_dump_kernel_interfaces)
 		{
+			if (!is_owner(port_id))
+			{
+				continue;
+			}
+
 			auto kernel_port_id = std::get<1>(kernel_interface);
-			(void)port_id;
 
 			unsigned rxSize = rte_eth_rx_burst(kernel_port_id,
 			                                   0,
@@ -1873,27 +2215,27 @@ void cControlPlane::mainThread()
 		}
 
 		/// push packets to slow worker
-		while (!slowWorkerMbufs.empty())
+		while (!slow_worker->mbufs.empty())
 		{
 			for (unsigned int i = 0;
 			     i < CONFIG_YADECAP_MBUFS_BURST_SIZE;
 			     i++)
 			{
-				if (slowWorkerMbufs.empty())
+				if (slow_worker->mbufs.empty())
 				{
 					break;
 				}
 
-				auto& tuple = slowWorkerMbufs.front();
-				slowWorker->slowWorkerFlow(std::get<0>(tuple), std::get<1>(tuple));
+				auto& tuple = slow_worker->mbufs.front();
+				slow_worker->worker->slowWorkerFlow(std::get<0>(tuple), std::get<1>(tuple));
 
-				slowWorkerMbufs.pop();
+				slow_worker->mbufs.pop();
 			}
 
-			slowWorker->slowWorkerHandlePackets();
+			slow_worker->worker->slowWorkerHandlePackets();
 		}
 
-		slowWorker->slowWorkerAfterHandlePackets();
+		slow_worker->worker->slowWorkerAfterHandlePackets();
 
 		/// @todo: AUTOTEST_CONTROLPLANE
 
@@ -1903,6 +2245,8 @@ void cControlPlane::mainThread()
 		std::this_thread::sleep_for(std::chrono::microseconds{1});
 #endif // CONFIG_YADECAP_AUTOTEST
 	}
+
+	slow_worker->running = false;
 }
 
 unsigned cControlPlane::ring_handle(rte_ring* ring_to_free_mbuf,
@@ -1930,65 +2274,134 @@ unsigned cControlPlane::ring_handle(rte_ring* ring_to_free_mbuf,
 			continue;
 		}
 
-		dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
-
-		if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_ingress_icmp)
-		{
-			handlePacket_icmp_translate_v6_to_v4(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_ingress_fragmentation)
-		{
-			metadata->flow.type = common::globalBase::eFlowType::nat64stateless_ingress_checked;
-			handlePacket_fragment(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_egress_icmp)
-		{
-			handlePacket_icmp_translate_v4_to_v6(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_egress_fragmentation)
-		{
-			metadata->flow.type = common::globalBase::eFlowType::nat64stateless_egress_checked;
-			handlePacket_fragment(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_dregress)
+		slow_worker_t* owner = slow_worker_owner(mbuf);
+		if (owner != slow_worker)
 		{
-			handlePacket_dregress(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_egress_farm)
-		{
-			handlePacket_farm(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_dump)
-		{
-			handlePacket_dump(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_repeat)
-		{
-			handlePacket_repeat(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_fw_sync)
-		{
-			handlePacket_fw_state_sync(mbuf);
-		}
-		else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_balancer_icmp_forward)
-		{
-			handlePacket_balancer_icmp_forward(mbuf);
-		}
-		else
-		{
-			handlePacketFromForwardingPlane(mbuf);
+			if (rte_ring_mp_enqueue(owner->ring_handover, mbuf) != 0)
+			{
+				slow_worker->stats.slowworker_drops++;
+				rte_pktmbuf_free(mbuf);
+			}
+
+			continue;
 		}
+
+		handle_packet(mbuf);
 	}
 	return rxSize;
 }
 
+unsigned cControlPlane::ring_handover_handle()
+{
+	rte_mbuf* mbufs[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+
+	unsigned rxSize = rte_ring_sc_dequeue_burst(slow_worker->ring_handover,
+	                                            (void**)mbufs,
+	                                            CONFIG_YADECAP_MBUFS_BURST_SIZE,
+	                                            nullptr);
+	for (uint16_t mbuf_i = 0; mbuf_i < rxSize; mbuf_i++)
+	{
+		handle_packet(mbufs[mbuf_i]);
+	}
+	return rxSize;
+}
+
+cControlPlane::slow_worker_t* cControlPlane::slow_worker_owner(rte_mbuf* mbuf) const
+{
+	if (slow_workers.size() == 1)
+	{
+		return slow_worker;
+	}
+
+	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+
+	switch (metadata->flow.type)
+	{
+		case common::globalBase::eFlowType::slowWorker_nat64stateless_ingress_fragmentation:
+		case common::globalBase::eFlowType::slowWorker_nat64stateless_egress_fragmentation:
+			/// all fragments of packet must be collected by one slow worker
+			return slow_workers[fragmentation_t::hash(mbuf) % slow_workers.size()].get();
+		case common::globalBase::eFlowType::slowWorker_dregress:
+			return slow_workers[0].get();
+		case common::globalBase::eFlowType::slowWorker_dump:
+			return slow_workers[metadata->flow.data.dump.id % slow_workers.size()].get();
+		case common::globalBase::eFlowType::slowWorker_nat64stateless_ingress_icmp:
+		case common::globalBase::eFlowType::slowWorker_nat64stateless_egress_icmp:
+		case common::globalBase::eFlowType::slowWorker_nat64stateless_egress_farm:
+		case common::globalBase::eFlowType::slowWorker_repeat:
+		case common::globalBase::eFlowType::slowWorker_fw_sync:
+		case common::globalBase::eFlowType::slowWorker_balancer_icmp_forward:
+			return slow_worker;
+		default:
+			/// kernel interface of port
+			return slow_workers[metadata->fromPortId % slow_workers.size()].get();
+	}
+}
+
+bool cControlPlane::is_owner(const tPortId port_id) const
+{
+	return port_id % slow_workers.size() == slow_worker->id;
+}
+
+void cControlPlane::handle_packet(rte_mbuf* mbuf)
+{
+	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+
+	if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_ingress_icmp)
+	{
+		handlePacket_icmp_translate_v6_to_v4(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_ingress_fragmentation)
+	{
+		metadata->flow.type = common::globalBase::eFlowType::nat64stateless_ingress_checked;
+		handlePacket_fragment(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_egress_icmp)
+	{
+		handlePacket_icmp_translate_v4_to_v6(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_egress_fragmentation)
+	{
+		metadata->flow.type = common::globalBase::eFlowType::nat64stateless_egress_checked;
+		handlePacket_fragment(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_dregress)
+	{
+		handlePacket_dregress(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_nat64stateless_egress_farm)
+	{
+		handlePacket_farm(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_dump)
+	{
+		handlePacket_dump(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_repeat)
+	{
+		handlePacket_repeat(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_fw_sync)
+	{
+		handlePacket_fw_state_sync(mbuf);
+	}
+	else if (metadata->flow.type == common::globalBase::eFlowType::slowWorker_balancer_icmp_forward)
+	{
+		handlePacket_balancer_icmp_forward(mbuf);
+	}
+	else
+	{
+		handlePacketFromForwardingPlane(mbuf);
+	}
+}
+
 void cControlPlane::handlePacketFromForwardingPlane(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
 	if (handlePacket_fw_state_sync_ingress(mbuf))
 	{
-		stats.fwsync_multicast_ingress_packets++;
+		slow_worker->stats.fwsync_multicast_ingress_packets++;
 		rte_pktmbuf_free(mbuf);
 		return;
 	}
@@ -1997,7 +2410,7 @@ void cControlPlane::handlePacketFromForwardingPlane(rte_mbuf* mbuf)
 	if (metadata->flow.type != common::globalBase::eFlowType::slowWorker_kni_local)
 	{
 		// drop by default in tests
-		stats.slowworker_drops++;
+		slow_worker->stats.slowworker_drops++;
 		rte_pktmbuf_free(mbuf);
 		return;
 	}
@@ -2012,7 +2425,7 @@ void cControlPlane::handlePacketFromForwardingPlane(rte_mbuf* mbuf)
 	if (iter == kernel_interfaces.end())
 	{
 		// TODO stats
-		unsigned txSize = rte_eth_tx_burst(metadata->fromPortId, 0, &mbuf, 1);
+		unsigned txSize = rte_eth_tx_burst(metadata->fromPortId, slow_worker->worker->basePermanently.outQueueId, &mbuf, 1);
 		if (!txSize)
 		{
 			rte_pktmbuf_free(mbuf);
@@ -2020,8 +2433,9 @@ void cControlPlane::handlePacketFromForwardingPlane(rte_mbuf* mbuf)
 		return;
 	}
 
-	auto& [name, kernel_port_id, stats, mbufs, count] = iter->second;
+	auto& [name, kernel_port_id, stats, mbufs, count, queues_stats] = iter->second;
 	(void)name;
+	(void)queues_stats;
 	mbufs[count++] = mbuf;
 	if (count == CONFIG_YADECAP_MBUFS_BURST_SIZE)
 	{
@@ -2038,7 +2452,7 @@ void cControlPlane::handle_packet_from_kernel(rte_mbuf* mbuf)
 	uint32_t packetLength = rte_pktmbuf_pkt_len(mbuf);
 
 	uint16_t txSize = rte_eth_tx_burst(metadata->fromPortId,
-	                                   0,
+	                                   slow_worker->worker->basePermanently.outQueueId,
 	                                   &mbuf,
 	                                   1);
 	if (!txSize)
@@ -2314,20 +2728,20 @@ void cControlPlane::handlePacket_icmp_translate_v6_to_v4(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 	const auto& nat64stateless = base.globalBase->nat64statelesses[metadata->flow.data.nat64stateless.id];
 	const auto& translation = base.globalBase->nat64statelessTranslations[metadata->flow.data.nat64stateless.translationId];
 
-	slowWorker->slowWorkerTranslation(mbuf, nat64stateless, translation, true);
+	slow_worker->worker->slowWorkerTranslation(mbuf, nat64stateless, translation, true);
 
 	if (do_icmp_translate_v6_to_v4(mbuf, translation))
 	{
-		slowWorker->stats.nat64stateless_ingressPackets++;
+		slow_worker->worker->stats.nat64stateless_ingressPackets++;
 		sendPacketToSlowWorker(mbuf, nat64stateless.flow);
 	}
 	else
 	{
-		slowWorker->stats.nat64stateless_ingressUnknownICMP++;
+		slow_worker->worker->stats.nat64stateless_ingressUnknownICMP++;
 		rte_pktmbuf_free(mbuf);
 	}
 }
@@ -2589,20 +3003,20 @@ void cControlPlane::handlePacket_icmp_translate_v4_to_v6(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 	const auto& nat64stateless = base.globalBase->nat64statelesses[metadata->flow.data.nat64stateless.id];
 	const auto& translation = base.globalBase->nat64statelessTranslations[metadata->flow.data.nat64stateless.translationId];
 
-	slowWorker->slowWorkerTranslation(mbuf, nat64stateless, translation, false);
+	slow_worker->worker->slowWorkerTranslation(mbuf, nat64stateless, translation, false);
 
 	if (do_icmp_translate_v4_to_v6(mbuf, translation))
 	{
-		slowWorker->stats.nat64stateless_egressPackets++;
+		slow_worker->worker->stats.nat64stateless_egressPackets++;
 		sendPacketToSlowWorker(mbuf, nat64stateless.flow);
 	}
 	else
 	{
-		slowWorker->stats.nat64stateless_egressUnknownICMP++;
+		slow_worker->worker->stats.nat64stateless_egressUnknownICMP++;
 		rte_pktmbuf_free(mbuf);
 	}
 }
@@ -2629,12 +3043,12 @@ void cControlPlane::handlePacket_repeat(rte_mbuf* mbuf)
 	}
 
 	/// @todo: opt
-	slowWorker->preparePacket(mbuf);
+	slow_worker->worker->preparePacket(mbuf);
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 	const auto& logicalPort = base.globalBase->logicalPorts[metadata->flow.data.logicalPortId];
 
-	stats.repeat_packets++;
+	slow_worker->stats.repeat_packets++;
 	sendPacketToSlowWorker(mbuf, logicalPort.flow);
 }
 
@@ -2642,31 +3056,31 @@ void cControlPlane::handlePacket_fragment(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 	const auto& nat64stateless = base.globalBase->nat64statelesses[metadata->flow.data.nat64stateless.id];
 
 	if (nat64stateless.defrag_farm_prefix.empty() || metadata->network_headerType != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) || nat64stateless.farm)
 	{
-		fragmentation.insert(mbuf);
+		slow_worker->fragmentation.insert(mbuf);
 		return;
 	}
 
-	stats.tofarm_packets++;
-	slowWorker->slowWorkerHandleFragment(mbuf);
+	slow_worker->stats.tofarm_packets++;
+	slow_worker->worker->slowWorkerHandleFragment(mbuf);
 	sendPacketToSlowWorker(mbuf, nat64stateless.flow);
 }
 
 void cControlPlane::handlePacket_farm(rte_mbuf* mbuf)
 {
-	stats.farm_packets++;
-	slowWorker->slowWorkerFarmHandleFragment(mbuf);
+	slow_worker->stats.farm_packets++;
+	slow_worker->worker->slowWorkerFarmHandleFragment(mbuf);
 }
 
 void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 	const auto& fw_state_config = base.globalBase->fw_state_sync_configs[metadata->flow.data.aclId];
 
 	metadata->network_headerType = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
@@ -2674,6 +3088,9 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 	metadata->transport_headerType = IPPROTO_UDP;
 	metadata->transport_headerOffset = metadata->network_headerOffset + sizeof(rte_ipv6_hdr);
 
+	// Packet may carry several frames.
+	const uint16_t frames_size = rte_pktmbuf_data_len(mbuf) - (metadata->transport_headerOffset + sizeof(rte_udp_hdr));
+
 	generic_rte_ether_hdr* ethernetHeader = rte_pktmbuf_mtod(mbuf, generic_rte_ether_hdr*);
 	ethernetHeader->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_VLAN);
 	rte_ether_addr_copy(&fw_state_config.ether_address_destination, &ethernetHeader->dst_addr);
@@ -2683,7 +3100,7 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 
 	rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
 	ipv6Header->vtc_flow = rte_cpu_to_be_32(0x6 << 28);
-	ipv6Header->payload_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+	ipv6Header->payload_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + frames_size);
 	ipv6Header->proto = IPPROTO_UDP;
 	ipv6Header->hop_limits = 64;
 	memcpy(ipv6Header->src_addr, fw_state_config.ipv6_address_source.bytes, 16);
@@ -2692,7 +3109,7 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 	rte_udp_hdr* udpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_udp_hdr*, metadata->network_headerOffset + sizeof(rte_ipv6_hdr));
 	udpHeader->src_port = fw_state_config.port_multicast; // IPFW reuses the same port for both src and dst.
 	udpHeader->dst_port = fw_state_config.port_multicast;
-	udpHeader->dgram_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+	udpHeader->dgram_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + frames_size);
 	udpHeader->dgram_cksum = 0;
 	udpHeader->dgram_cksum = rte_ipv6_udptcp_cksum(ipv6Header, udpHeader);
 
@@ -2702,7 +3119,7 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 		rte_mbuf* mbuf_clone = rte_pktmbuf_alloc(mempool);
 		if (mbuf_clone == nullptr)
 		{
-			slowWorker->stats.fwsync_multicast_egress_drops++;
+			slow_worker->worker->stats.fwsync_multicast_egress_drops++;
 			continue;
 		}
 
@@ -2715,7 +3132,7 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 		mbuf_clone->pkt_len = mbuf->pkt_len;
 
 		const auto& flow = fw_state_config.flows[port_id];
-		slowWorker->stats.fwsync_multicast_egress_packets++;
+		slow_worker->worker->stats.fwsync_multicast_egress_packets++;
 		sendPacketToSlowWorker(mbuf_clone, flow);
 	}
 
@@ -2731,7 +3148,7 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 		rte_mbuf* mbuf_clone = rte_pktmbuf_alloc(mempool);
 		if (mbuf_clone == nullptr)
 		{
-			slowWorker->stats.fwsync_unicast_egress_drops++;
+			slow_worker->worker->stats.fwsync_unicast_egress_drops++;
 		}
 		else
 		{
@@ -2743,7 +3160,7 @@ void cControlPlane::handlePacket_fw_state_sync(rte_mbuf* mbuf)
 			mbuf_clone->data_len = mbuf->data_len;
 			mbuf_clone->pkt_len = mbuf->pkt_len;
 
-			slowWorker->stats.fwsync_unicast_egress_packets++;
+			slow_worker->worker->stats.fwsync_unicast_egress_packets++;
 			sendPacketToSlowWorker(mbuf_clone, fw_state_config.ingress_flow);
 		}
 	}
@@ -2780,6 +3197,12 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 		return false;
 	}
 
+	if (rte_be_to_cpu_16(ipv6Header->payload_len) < sizeof(rte_udp_hdr) ||
+	    sizeof(rte_ether_hdr) + sizeof(rte_vlan_hdr) + sizeof(rte_ipv6_hdr) + rte_be_to_cpu_16(ipv6Header->payload_len) > rte_pktmbuf_data_len(mbuf))
+	{
+		return false;
+	}
+
 	const auto udp_payload_len = rte_be_to_cpu_16(ipv6Header->payload_len) - sizeof(rte_udp_hdr);
 	// Can contain multiple states per sync packet.
 	if (udp_payload_len % sizeof(dataplane::globalBase::fw_state_sync_frame_t) != 0)
@@ -2799,7 +3222,7 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 		aclId = it->second;
 	}
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 	const auto& fw_state_config = base.globalBase->fw_state_sync_configs[aclId];
 
 	if (memcmp(ipv6Header->src_addr, fw_state_config.ipv6_address_source.bytes, 16) == 0)
@@ -2814,12 +3237,17 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 		return false;
 	}
 
-	for (size_t idx = 0; idx < udp_payload_len / sizeof(dataplane::globalBase::fw_state_sync_frame_t); ++idx)
+	const size_t frames_count = udp_payload_len / sizeof(dataplane::globalBase::fw_state_sync_frame_t);
+	const dataplane::globalBase::fw_state_sync_frame_t* frames = rte_pktmbuf_mtod_offset(
+	        mbuf,
+	        dataplane::globalBase::fw_state_sync_frame_t*,
+	        sizeof(rte_ether_hdr) + sizeof(rte_vlan_hdr) + sizeof(rte_ipv6_hdr) + sizeof(rte_udp_hdr));
+
+	slow_worker->stats.fwsync_multicast_ingress_frames += frames_count;
+
+	for (size_t idx = 0; idx < frames_count; ++idx)
 	{
-		dataplane::globalBase::fw_state_sync_frame_t* payload = rte_pktmbuf_mtod_offset(
-		        mbuf,
-		        dataplane::globalBase::fw_state_sync_frame_t*,
-		        sizeof(rte_ether_hdr) + sizeof(rte_vlan_hdr) + sizeof(rte_ipv6_hdr) + sizeof(rte_udp_hdr) + idx * sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+		const dataplane::globalBase::fw_state_sync_frame_t* payload = &frames[idx];
 
 		if (payload->addr_type == 6)
 		{
@@ -2845,10 +3273,10 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 			dataplane::globalBase::fw_state_value_t value;
 			value.type = static_cast<dataplane::globalBase::fw_state_type>(payload->proto);
 			value.owner = dataplane::globalBase::fw_state_owner_e::external;
-			value.last_seen = slowWorker->basePermanently.globalBaseAtomic->currentTime;
+			value.last_seen = slow_worker->worker->basePermanently.globalBaseAtomic->currentTime;
 			value.flow = fw_state_config.ingress_flow;
 			value.acl_id = aclId;
-			value.last_sync = slowWorker->basePermanently.globalBaseAtomic->currentTime;
+			value.last_sync = slow_worker->worker->basePermanently.globalBaseAtomic->currentTime;
 			value.packets_since_last_sync = 0;
 			value.packets_backward = 0;
 			value.packets_forward = 0;
@@ -2859,13 +3287,13 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 				(void)socketId;
 
 				dataplane::globalBase::fw_state_value_t* lookup_value;
-				dataplane::spinlock_nonrecursive_t* locker;
+				dataplane::globalBase::acl::ipv6_states_ht::locker_t* locker;
 				const uint32_t hash = globalBaseAtomic->fw6_state->lookup(key, lookup_value, locker);
 				if (lookup_value)
 				{
 					// Keep state alive for us even if there were no packets received.
 					// Do not reset other counters.
-					lookup_value->last_seen = slowWorker->basePermanently.globalBaseAtomic->currentTime;
+					lookup_value->last_seen = slow_worker->worker->basePermanently.globalBaseAtomic->currentTime;
 					lookup_value->tcp.src_flags |= value.tcp.src_flags;
 					lookup_value->tcp.dst_flags |= value.tcp.dst_flags;
 				}
@@ -2900,10 +3328,10 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 			dataplane::globalBase::fw_state_value_t value;
 			value.type = static_cast<dataplane::globalBase::fw_state_type>(payload->proto);
 			value.owner = dataplane::globalBase::fw_state_owner_e::external;
-			value.last_seen = slowWorker->basePermanently.globalBaseAtomic->currentTime;
+			value.last_seen = slow_worker->worker->basePermanently.globalBaseAtomic->currentTime;
 			value.flow = fw_state_config.ingress_flow;
 			value.acl_id = aclId;
-			value.last_sync = slowWorker->basePermanently.globalBaseAtomic->currentTime;
+			value.last_sync = slow_worker->worker->basePermanently.globalBaseAtomic->currentTime;
 			value.packets_since_last_sync = 0;
 			value.packets_backward = 0;
 			value.packets_forward = 0;
@@ -2914,13 +3342,13 @@ bool cControlPlane::handlePacket_fw_state_sync_ingress(rte_mbuf* mbuf)
 				(void)socketId;
 
 				dataplane::globalBase::fw_state_value_t* lookup_value;
-				dataplane::spinlock_nonrecursive_t* locker;
+				dataplane::globalBase::acl::ipv4_states_ht::locker_t* locker;
 				const uint32_t hash = globalBaseAtomic->fw4_state->lookup(key, lookup_value, locker);
 				if (lookup_value)
 				{
 					// Keep state alive for us even if there were no packets received.
 					// Do not reset other counters.
-					lookup_value->last_seen = slowWorker->basePermanently.globalBaseAtomic->currentTime;
+					lookup_value->last_seen = slow_worker->worker->basePermanently.globalBaseAtomic->currentTime;
 					lookup_value->tcp.src_flags |= value.tcp.src_flags;
 					lookup_value->tcp.dst_flags |= value.tcp.dst_flags;
 				}
@@ -2940,21 +3368,21 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 {
 	if (dataPlane->config.SWICMPOutRateLimit != 0)
 	{
-		if (icmpOutRemainder == 0)
+		if (slow_worker->icmpOutRemainder == 0)
 		{
-			slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_out_rate_limit_reached]++;
+			slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_out_rate_limit_reached]++;
 			rte_pktmbuf_free(mbuf);
 			return;
 		}
 
-		--icmpOutRemainder;
+		--slow_worker->icmpOutRemainder;
 	}
 
 	std::lock_guard<std::mutex> unrdup_guard(unrdup_mutex);
 	std::lock_guard<std::mutex> interfaces_ips_guard(interfaces_ips_mutex);
 	std::lock_guard<std::mutex> services_guard(vip_vport_proto_mutex);
 
-	const auto& base = slowWorker->bases[slowWorker->localBaseId & 1];
+	const auto& base = slow_worker->worker->bases[slow_worker->worker->localBaseId & 1];
 
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
@@ -2995,11 +3423,11 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 		   but we needed to call prepareL3() to determine icmp payload original packets transport header offset */
 		if (inner_metadata.network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
 		{
-			slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_icmpv4_payload_too_short_ip]++;
+			slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_icmpv4_payload_too_short_ip]++;
 		}
 		else
 		{
-			slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_icmpv6_payload_too_short_ip]++;
+			slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_icmpv6_payload_too_short_ip]++;
 		}
 
 		rte_pktmbuf_free(mbuf);
@@ -3010,7 +3438,7 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 	{
 		// not supported protocol for cloning and distributing, drop
 		rte_pktmbuf_free(mbuf);
-		slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_unexpected_transport_protocol]++;
+		slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_unexpected_transport_protocol]++;
 		return;
 	}
 
@@ -3024,7 +3452,7 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 	{
 		// no vip_to_balancers table for this balancer_id
 		rte_pktmbuf_free(mbuf);
-		slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_no_unrdup_table_for_balancer_id]++;
+		slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_no_unrdup_table_for_balancer_id]++;
 		return;
 	}
 
@@ -3032,7 +3460,7 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 	{
 		// vip is not listed in unrdup config - neighbor balancers are unknown, drop
 		rte_pktmbuf_free(mbuf);
-		slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_unrdup_vip_not_found]++;
+		slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_unrdup_vip_not_found]++;
 		return;
 	}
 
@@ -3040,7 +3468,7 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 	{
 		// no vip_vport_proto table for this balancer_id
 		rte_pktmbuf_free(mbuf);
-		slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_no_vip_vport_proto_table_for_balancer_id]++;
+		slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_no_vip_vport_proto_table_for_balancer_id]++;
 		return;
 	}
 
@@ -3048,7 +3476,7 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 	{
 		// such combination of vip-vport-protocol is absent, don't clone, drop
 		rte_pktmbuf_free(mbuf);
-		slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_unknown_service]++;
+		slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_drop_unknown_service]++;
 		return;
 	}
 
@@ -3059,20 +3487,20 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 		// will not send a cloned packet if source address in "balancer" section of controlplane.conf is absent
 		if (neighbor_balancer.is_ipv4() && !base.globalBase->balancers[metadata->flow.data.balancer.id].source_ipv4.address)
 		{
-			slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_no_balancer_src_ipv4]++;
+			slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_no_balancer_src_ipv4]++;
 			continue;
 		}
 
 		if (neighbor_balancer.is_ipv6() && base.globalBase->balancers[metadata->flow.data.balancer.id].source_ipv6.empty())
 		{
-			slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_no_balancer_src_ipv6]++;
+			slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_no_balancer_src_ipv6]++;
 			continue;
 		}
 
 		rte_mbuf* mbuf_clone = rte_pktmbuf_alloc(mempool);
 		if (mbuf_clone == nullptr)
 		{
-			slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_failed_to_clone]++;
+			slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_failed_to_clone]++;
 			continue;
 		}
 
@@ -3180,11 +3608,11 @@ void cControlPlane::handlePacket_balancer_icmp_forward(rte_mbuf* mbuf)
 			}
 		}
 
-		slowWorker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_clone_forwarded]++;
+		slow_worker->worker->counters[(uint32_t)common::globalBase::static_counter_type::balancer_icmp_clone_forwarded]++;
 
 		const auto& flow = base.globalBase->balancers[metadata->flow.data.balancer.id].flow;
 
-		slowWorker->preparePacket(mbuf_clone);
+		slow_worker->worker->preparePacket(mbuf_clone);
 		sendPacketToSlowWorker(mbuf_clone, flow);
 	}
 
@@ -3254,7 +3682,7 @@ void cControlPlane::handlePacket_dump(rte_mbuf* mbuf)
 		}
 	}
 
-	stats.unknown_dump_interface++;
+	slow_worker->stats.unknown_dump_interface++;
 	rte_pktmbuf_free(mbuf);
 }
 
@@ -3266,7 +3694,7 @@ rte_mbuf* cControlPlane::convertMempool(rte_ring* ring_to_free_mbuf,
 	rte_mbuf* mbuf = rte_pktmbuf_alloc(mempool);
 	if (!mbuf)
 	{
-		stats.mempool_is_empty++;
+		slow_worker->stats.mempool_is_empty++;
 
 		freeWorkerPacket(ring_to_free_mbuf, old_mbuf);
 		return nullptr;
@@ -3298,21 +3726,21 @@ void cControlPlane::sendPacketToSlowWorker(rte_mbuf* mbuf,
 {
 	/// we dont support attached mbufs
 
-	if (slowWorkerMbufs.size() >= 1024) ///< @todo: variable
+	if (slow_worker->mbufs.size() >= 1024) ///< @todo: variable
 	{
-		stats.slowworker_drops++;
+		slow_worker->stats.slowworker_drops++;
 		rte_pktmbuf_free(mbuf);
 		return;
 	}
 
-	stats.slowworker_packets++;
-	slowWorkerMbufs.emplace(mbuf, flow);
+	slow_worker->stats.slowworker_packets++;
+	slow_worker->mbufs.emplace(mbuf, flow);
 }
 
 void cControlPlane::freeWorkerPacket(rte_ring* ring_to_free_mbuf,
                                      rte_mbuf* mbuf)
 {
-	if (ring_to_free_mbuf == slowWorker->ring_toFreePackets)
+	if (ring_to_free_mbuf == slow_worker->worker->ring_toFreePackets)
 	{
 		rte_pktmbuf_free(mbuf);
 		return;
@@ -3330,14 +3758,12 @@ void cControlPlane::SWRateLimiterTimeTracker()
 	std::chrono::high_resolution_clock::time_point curTimePointForSWRateLimiter = std::chrono::high_resolution_clock::now();
 
 	// is it time to reset icmpPacketsToSW counters?
-	if (std::chrono::duration_cast<std::chrono::milliseconds>(curTimePointForSWRateLimiter - prevTimePointForSWRateLimiter) >= std::chrono::milliseconds(1000 / dataPlane->config.rateLimitDivisor))
+	if (std::chrono::duration_cast<std::chrono::milliseconds>(curTimePointForSWRateLimiter - slow_worker->prevTimePointForSWRateLimiter) >= std::chrono::milliseconds(1000 / dataPlane->config.rateLimitDivisor))
 	{
-		// the only place thread-shared variable icmpPacketsToSW is changed
-		for (auto& [coreId, worker] : dataPlane->workers)
+		// the only place thread-shared variable icmpPacketsToSW is changed (each worker is owned by one slow worker)
+		for (cWorker* worker : slow_worker->workers)
 		{
-			(void)coreId;
-
-			if (slowWorker == worker)
+			if (slow_worker->worker == worker)
 			{
 				continue;
 			}
@@ -3345,8 +3771,8 @@ void cControlPlane::SWRateLimiterTimeTracker()
 			__atomic_store_n(&worker->packetsToSWNPRemainder, dataPlane->config.SWNormalPriorityRateLimitPerWorker, __ATOMIC_RELAXED);
 		}
 
-		icmpOutRemainder = dataPlane->config.SWICMPOutRateLimit / dataPlane->config.rateLimitDivisor;
+		slow_worker->icmpOutRemainder = dataPlane->config.SWICMPOutRateLimit / dataPlane->config.rateLimitDivisor / slow_workers.size();
 
-		prevTimePointForSWRateLimiter = curTimePointForSWRateLimiter;
+		slow_worker->prevTimePointForSWRateLimiter = curTimePointForSWRateLimiter;
 	}
 }
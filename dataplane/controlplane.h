@@ -2,9 +2,12 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <unordered_map>
@@ -31,7 +34,7 @@ public:
 	virtual ~cControlPlane();
 
 	eResult init(bool use_kernel_interface);
-	void start();
+	eResult start();
 	void stop();
 	void join();
 
@@ -53,6 +56,7 @@ public:
 	common::idp::getAclCounters::response getAclCounters();
 	common::idp::getCounters::response getCounters(const common::idp::getCounters::request& request);
 	common::idp::getOtherStats::response getOtherStats();
+	common::idp::get_worker_profile::response get_worker_profile();
 	common::idp::getConfig::response getConfig() const;
 	common::idp::getErrors::response getErrors();
 	common::idp::getReport::response getReport();
@@ -81,15 +85,19 @@ public:
 	void sendPacketToSlowWorker(rte_mbuf* mbuf, const common::globalBase::tFlow& flow); ///< @todo: remove flow
 	void freeWorkerPacket(rte_ring* ring_to_free_mbuf, rte_mbuf* mbuf);
 
+	eResult add_slow_worker(cWorker* worker);
+
 protected:
 	eResult initMempool();
 	eResult init_kernel_interfaces();
-	std::optional<tPortId> add_kernel_interface(const tPortId port_id, const std::string& interface_name);
+	std::optional<tPortId> add_kernel_interface(const tPortId port_id, const std::string& interface_name, const uint16_t queues_count);
 	void remove_kernel_interface(const tPortId port_id, const std::string& interface_name);
 	void set_kernel_interface_up(const std::string& interface_name);
 
 	void mainThread();
 	unsigned ring_handle(rte_ring* ring_to_free_mbuf, rte_ring* ring);
+	unsigned ring_handover_handle();
+	void handle_packet(rte_mbuf* mbuf);
 
 	void handlePacketFromForwardingPlane(rte_mbuf* mbuf); ///< @todo: rename
 	void handle_packet_from_kernel(rte_mbuf* mbuf);
@@ -106,6 +114,8 @@ protected:
 
 	void SWRateLimiterTimeTracker();
 
+	common::slowworker::stats_t get_slow_worker_stats() const;
+
 	rte_mbuf* convertMempool(rte_ring* ring_to_free_mbuf, rte_mbuf* mbuf);
 
 protected:
@@ -129,12 +139,59 @@ protected:
 		uint64_t odropped;
 	};
 
+	/// latency of updateGlobalBase()
+	struct update_global_base_stats_t
+	{
+		void update(const uint64_t duration_ns)
+		{
+			count++;
+			last_ns = duration_ns;
+			max_ns = std::max(max_ns, duration_ns);
+			total_ns += duration_ns;
+		}
+
+		uint64_t count{};
+		uint64_t last_ns{};
+		uint64_t max_ns{};
+		uint64_t total_ns{};
+	};
+
+	/// one slow worker core.
+	/// slow_workers[0] is primary (controlPlaneCoreId), it also handles dregress, worker_gc rings and updates currentTime
+	class slow_worker_t
+	{
+	public:
+		slow_worker_t(cControlPlane* controlPlane, cDataPlane* dataPlane, const uint32_t id, cWorker* worker);
+		~slow_worker_t();
+
+	public:
+		uint32_t id;
+		cWorker* worker;
+
+		std::vector<cWorker*> workers; ///< rings of these workers are dequeued by this slow worker
+		rte_ring* ring_handover; ///< packets from other slow workers
+
+		fragmentation_t fragmentation;
+		std::queue<std::tuple<rte_mbuf*,
+		                      common::globalBase::tFlow>>
+		        mbufs;
+
+		common::slowworker::stats_t stats;
+
+		std::chrono::high_resolution_clock::time_point prevTimePointForSWRateLimiter;
+		uint32_t icmpOutRemainder;
+
+		std::atomic<bool> running; ///< in mainThread()
+	};
+
+	slow_worker_t* slow_worker_owner(rte_mbuf* mbuf) const;
+	bool is_owner(const tPortId port_id) const;
+
 	void flush_kernel_interface(tPortId kernel_port_id, sKniStats& stats, rte_mbuf** mbufs, uint32_t& count);
 	void flush_kernel_interface(tPortId kernel_port_id, rte_mbuf** mbufs, uint32_t& count);
 
 	cDataPlane* dataPlane;
 
-	fragmentation_t fragmentation;
 	dregress_t dregress;
 
 	std::mutex mutex;
@@ -150,7 +207,8 @@ protected:
 	                    tPortId, ///< kernel_port_id
 	                    sKniStats,
 	                    std::array<rte_mbuf*, CONFIG_YADECAP_MBUFS_BURST_SIZE>,
-	                    uint32_t>>
+	                    uint32_t,
+	                    std::vector<sKniStats>>> ///< per queue opackets and obytes. packets to kernel of queues owned by workers are in cWorker::kernel_interface_queues
 	        kernel_interfaces;
 
 	std::map<tPortId,
@@ -174,13 +232,16 @@ protected:
 	                    uint32_t>>
 	        drop_dump_kernel_interfaces;
 
-	common::slowworker::stats_t stats;
+	mutable std::mutex update_global_base_stats_mutex;
+	update_global_base_stats_t update_global_base_stats;
+	std::map<common::idp::updateGlobalBase::requestType, update_global_base_stats_t> update_global_base_type_stats;
+	uint64_t update_global_base_journal_bytes{};
+
 	common::idp::getErrors::response errors; ///< @todo: class errorsManager
 
-	cWorker* slowWorker;
-	std::queue<std::tuple<rte_mbuf*,
-	                      common::globalBase::tFlow>>
-	        slowWorkerMbufs;
+	std::vector<std::unique_ptr<slow_worker_t>> slow_workers;
+	inline static thread_local slow_worker_t* slow_worker = nullptr; ///< slow worker of current thread
+	std::atomic<bool> slow_workers_stop;
 	std::mutex fw_state_multicast_acl_ids_mutex;
 	std::map<common::ipv6_address_t, tAclId> fw_state_multicast_acl_ids;
 
@@ -189,10 +250,6 @@ protected:
 	// check presence prior to cloning
 	std::vector<std::unordered_set<std::tuple<common::ip_address_t, uint16_t, uint8_t>>> vip_vport_proto;
 
-	std::chrono::high_resolution_clock::time_point prevTimePointForSWRateLimiter;
-
-	uint32_t icmpOutRemainder;
-
 	uint32_t currentTime;
 	uint32_t gc_step;
 };
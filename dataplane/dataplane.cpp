@@ -54,7 +54,8 @@ cDataPlane::cDataPlane() :
         globalBaseSerial(0),
         report(this),
         controlPlane(new cControlPlane(this)),
-        bus(this)
+        bus(this),
+        shared_counters(nullptr)
 {
 	configValues = {{eConfigType::port_rx_queue_size, 4096},
 	                {eConfigType::port_tx_queue_size, 4096},
@@ -62,6 +63,7 @@ cDataPlane::cDataPlane() :
 	                {eConfigType::ring_normalPriority_size, 256},
 	                {eConfigType::ring_lowPriority_size, 64},
 	                {eConfigType::ring_toFreePackets_size, 64},
+	                {eConfigType::ring_slowWorker_size, 1024},
 	                {eConfigType::ring_log_size, 1024},
 	                {eConfigType::fragmentation_size, 1024},
 	                {eConfigType::fragmentation_timeout_first, 32},
@@ -85,7 +87,10 @@ cDataPlane::cDataPlane() :
 	                {eConfigType::acl_values_size, YANET_CONFIG_ACL_VALUES_SIZE},
 	                {eConfigType::master_mempool_size, 8192},
 	                {eConfigType::nat64stateful_states_size, YANET_CONFIG_NAT64STATEFUL_HT_SIZE},
-	                {eConfigType::kernel_interface_queue_size, YANET_CONFIG_KERNEL_INTERFACE_QUEUE_SIZE}};
+	                {eConfigType::nat64stateful_port_blocks_size, YANET_CONFIG_NAT64STATEFUL_PORT_BLOCKS_HT_SIZE},
+	                {eConfigType::kernel_interface_queue_size, YANET_CONFIG_KERNEL_INTERFACE_QUEUE_SIZE},
+	                {eConfigType::fw_state_sync_frames_per_packet, 1},
+	                {eConfigType::fw_state_sync_flush_timeout, 1000}};
 }
 
 cDataPlane::~cDataPlane()
@@ -131,6 +136,12 @@ eResult cDataPlane::init(const std::string& binaryPath,
 		return result;
 	}
 
+	result = allocateSharedCounters();
+	if (result != eResult::success)
+	{
+		return result;
+	}
+
 	result = initEal(binaryPath, filePrefix);
 	if (result != eResult::success)
 	{
@@ -446,7 +457,8 @@ eResult cDataPlane::initPorts()
 	for (const auto& configPortIter : config.ports)
 	{
 		const std::string& interfaceName = configPortIter.first;
-		const auto& [pci, symmetric_mode, rss_flags] = configPortIter.second;
+		const auto& [pci, symmetric_mode, rss_flags, kernel_interface_queues] = configPortIter.second;
+		(void)kernel_interface_queues;
 
 		tPortId portId;
 		if (strncmp(pci.data(), SOCK_DEV_PREFIX, strlen(SOCK_DEV_PREFIX)) == 0)
@@ -511,7 +523,7 @@ eResult cDataPlane::initPorts()
 		std::map<tCoreId, tQueueId> rx_queues;
 
 		uint16_t rxQueuesCount = 0;
-		uint16_t txQueuesCount = config.workers.size() + 1; ///< tx queue '0' for control plane
+		uint16_t txQueuesCount = config.workers.size() + 1 + config.slowWorkerCoreIds.size(); ///< tx queue '0' for control plane, then slow workers
 		for (const auto& configWorkerIter : config.workers)
 		{
 			const tCoreId& coreId = configWorkerIter.first;
@@ -623,10 +635,24 @@ eResult cDataPlane::initGlobalBases()
 					return eResult::errorAllocatingMemory;
 				}
 
+				auto* nat64stateful_lan_block = hugepage_create_dynamic<dataplane::globalBase::nat64stateful::lan_block_ht>(socket_id, getConfigValue(eConfigType::nat64stateful_port_blocks_size), globalbase_atomic->updater.nat64stateful_lan_block);
+				if (!nat64stateful_lan_block)
+				{
+					return eResult::errorAllocatingMemory;
+				}
+
+				auto* nat64stateful_wan_block = hugepage_create_dynamic<dataplane::globalBase::nat64stateful::wan_block_ht>(socket_id, getConfigValue(eConfigType::nat64stateful_port_blocks_size), globalbase_atomic->updater.nat64stateful_wan_block);
+				if (!nat64stateful_wan_block)
+				{
+					return eResult::errorAllocatingMemory;
+				}
+
 				globalbase_atomic->fw4_state = ipv4_states_ht;
 				globalbase_atomic->fw6_state = ipv6_states_ht;
 				globalbase_atomic->nat64stateful_lan_state = nat64stateful_lan_state;
 				globalbase_atomic->nat64stateful_wan_state = nat64stateful_wan_state;
+				globalbase_atomic->nat64stateful_lan_block = nat64stateful_lan_block;
+				globalbase_atomic->nat64stateful_wan_block = nat64stateful_wan_block;
 			}
 
 			globalBaseAtomics[socket_id] = globalbase_atomic;
@@ -781,6 +807,23 @@ eResult cDataPlane::initGlobalBases()
 		}
 	}
 
+	for (const auto& coreId : config.slowWorkerCoreIds)
+	{
+		tSocketId socketId = rte_lcore_to_socket_id(coreId);
+
+		result = create_globalbase_atomics(socketId);
+		if (result != eResult::success)
+		{
+			return result;
+		}
+
+		result = create_globalbases(socketId);
+		if (result != eResult::success)
+		{
+			return result;
+		}
+	}
+
 	for (const auto& configWorkerIter : config.workers)
 	{
 		const tCoreId& coreId = configWorkerIter.first;
@@ -806,9 +849,14 @@ eResult cDataPlane::initWorkers()
 {
 	tQueueId outQueueId = 0;
 
-	/// slow worker
+	/// slow workers. first is primary
+	std::vector<tCoreId> slow_worker_core_ids = {config.controlPlaneCoreId};
+	slow_worker_core_ids.insert(slow_worker_core_ids.end(),
+	                            config.slowWorkerCoreIds.begin(),
+	                            config.slowWorkerCoreIds.end());
+
+	for (const tCoreId& coreId : slow_worker_core_ids)
 	{
-		const tCoreId& coreId = config.controlPlaneCoreId;
 		const tSocketId socket_id = rte_lcore_to_socket_id(coreId);
 
 		YADECAP_LOG_INFO("initWorker. coreId: %u [slow worker]\n", coreId);
@@ -820,9 +868,11 @@ eResult cDataPlane::initWorkers()
 			return eResult::errorAllocatingMemory;
 		}
 
+		attachSharedCounters(worker, coreId);
+
 		dataplane::base::permanently basePermanently;
 		basePermanently.globalBaseAtomic = globalBaseAtomics[socket_id];
-		basePermanently.outQueueId = outQueueId; ///< 0
+		basePermanently.outQueueId = outQueueId; ///< 0 for primary
 		basePermanently.ports_count = ports.size();
 		basePermanently.SWNormalPriorityRateLimitPerWorker = config.SWNormalPriorityRateLimitPerWorker;
 
@@ -840,7 +890,12 @@ eResult cDataPlane::initWorkers()
 		worker->fillStatsNamesToAddrsTable(coreId_to_stats_tables[coreId]);
 
 		workers[coreId] = worker;
-		controlPlane->slowWorker = worker;
+
+		result = controlPlane->add_slow_worker(worker);
+		if (result != eResult::success)
+		{
+			return result;
+		}
 
 		outQueueId++;
 	}
@@ -859,6 +914,8 @@ eResult cDataPlane::initWorkers()
 			return eResult::errorAllocatingMemory;
 		}
 
+		attachSharedCounters(worker, coreId);
+
 		dataplane::base::permanently basePermanently;
 		{
 			auto iter = globalBaseAtomics.find(socket_id);
@@ -1149,9 +1206,14 @@ int cDataPlane::lcoreThread(void* args)
 {
 	cDataPlane* dataPlane = (cDataPlane*)args;
 
-	if (rte_lcore_id() == dataPlane->config.controlPlaneCoreId)
+	if (rte_lcore_id() == dataPlane->config.controlPlaneCoreId ||
+	    exist(dataPlane->config.slowWorkerCoreIds, rte_lcore_id()))
 	{
-		dataPlane->controlPlane->start();
+		if (dataPlane->controlPlane->start() != eResult::success)
+		{
+			return -1;
+		}
+
 		return 0;
 	}
 
@@ -1288,6 +1350,82 @@ eResult cDataPlane::allocateSharedMemory()
 	return eResult::success;
 }
 
+eResult cDataPlane::allocateSharedCounters()
+{
+	const uint32_t workers_count = 1 + config.slowWorkerCoreIds.size() + config.workers.size();
+	const uint64_t size = common::shared_counters::size(workers_count);
+
+	key_t key = YANET_DEFAULT_IPC_COUNTERS_SHMKEY;
+
+	// deleting old shared memory if exists
+	int shmid = shmget(key, 0, 0);
+	if (shmid != -1)
+	{
+		shmctl(shmid, IPC_RMID, NULL);
+	}
+
+	int flags = IPC_CREAT | 0644;
+	if (config.useHugeMem)
+	{
+		flags |= SHM_HUGETLB;
+	}
+
+	shmid = shmget(key, size, flags);
+	if (shmid == -1)
+	{
+		YADECAP_LOG_ERROR("shmget(%d, %lu, %d) = %d\n", key, size, flags, errno);
+		return eResult::errorInitSharedMemory;
+	}
+
+	void* shmaddr = shmat(shmid, NULL, 0);
+	if (shmaddr == (void*)-1)
+	{
+		YADECAP_LOG_ERROR("shmat(%d, NULL, %d) = %d\n", shmid, 0, errno);
+		return eResult::errorInitSharedMemory;
+	}
+
+	/// segment is zeroed by kernel. counters pages are not touched here,
+	/// so that they are allocated on numa node of worker at first increment
+	shared_counters = (common::shared_counters::header_t*)shmaddr;
+	shared_counters->version = common::shared_counters::version;
+	shared_counters->workers_count = 0;
+	shared_counters->counters_size = YANET_CONFIG_COUNTERS_SIZE;
+	shared_counters->acl_counters_size = YANET_CONFIG_ACL_COUNTERS_SIZE;
+	shared_counters->size = size;
+	shared_counters->pid = getpid();
+
+	YADECAP_LOG_INFO("shared counters: key: %d, size: %lu, workers: %u\n", key, size, workers_count);
+
+	return eResult::success;
+}
+
+void cDataPlane::attachSharedCounters(cWorker* worker,
+                                      const tCoreId& coreId)
+{
+	const uint32_t workers_count = 1 + config.slowWorkerCoreIds.size() + config.workers.size();
+	const uint32_t worker_id = shared_counters->workers_count;
+
+	auto* data = (uint8_t*)shared_counters;
+	const uint64_t offset = common::shared_counters::worker_offset(workers_count, worker_id);
+
+	auto& descriptor = ((common::shared_counters::worker_t*)(data + common::shared_counters::workers_offset()))[worker_id];
+	descriptor.core_id = coreId;
+	descriptor.socket_id = rte_lcore_to_socket_id(coreId);
+	descriptor.counters_offset = offset;
+	descriptor.acl_counters_offset = offset + YANET_CONFIG_COUNTERS_SIZE * sizeof(uint64_t);
+
+	worker->counters = (uint64_t*)(data + descriptor.counters_offset);
+	worker->aclCounters = (uint64_t*)(data + descriptor.acl_counters_offset);
+
+	shared_counters->workers_count++;
+
+	/// readers check magic, so it is written when all workers are attached
+	if (shared_counters->workers_count == workers_count)
+	{
+		__atomic_store_n(&shared_counters->magic, common::shared_counters::magic, __ATOMIC_RELEASE);
+	}
+}
+
 eResult cDataPlane::splitSharedMemoryPerWorkers()
 {
 	std::map<void*, uint64_t> offsets;
@@ -1493,6 +1631,14 @@ eResult cDataPlane::parseConfig(const std::string& configFilePath)
 	}
 	config.controlPlaneCoreId = rootJson.find("controlPlaneCoreId").value();
 
+	if (rootJson.find("slowWorkerCoreIds") != rootJson.end())
+	{
+		for (const auto& core_id : rootJson.find("slowWorkerCoreIds").value())
+		{
+			config.slowWorkerCoreIds.emplace(core_id);
+		}
+	}
+
 	if (rootJson.find("configValues") != rootJson.end())
 	{
 		result = parseConfigValues(rootJson.find("configValues").value());
@@ -1562,6 +1708,7 @@ eResult cDataPlane::parseJsonPorts(const nlohmann::json& json)
 		std::string pci = portJson["pci"];
 		bool symmetric_mode = false;
 		uint64_t rss_flags = 0;
+		uint16_t kernel_interface_queues = 1;
 
 		if (exist(config.ports, interfaceName))
 		{
@@ -1588,7 +1735,20 @@ eResult cDataPlane::parseJsonPorts(const nlohmann::json& json)
 			rss_flags = RTE_ETH_RSS_IP;
 		}
 
-		config.ports[interfaceName] = {pci, symmetric_mode, rss_flags};
+		if (exist(portJson, "kernel_interface_queues"))
+		{
+			kernel_interface_queues = portJson["kernel_interface_queues"];
+			if (kernel_interface_queues == 0 ||
+			    kernel_interface_queues > YANET_CONFIG_KERNEL_INTERFACE_QUEUES_SIZE)
+			{
+				YADECAP_LOG_ERROR("invalid kernel_interface_queues '%u' for interfaceName '%s'\n",
+				                  kernel_interface_queues,
+				                  interfaceName.data());
+				return eResult::invalidConfigurationFile;
+			}
+		}
+
+		config.ports[interfaceName] = {pci, symmetric_mode, rss_flags, kernel_interface_queues};
 
 		for (tCoreId coreId : portJson["coreIds"])
 		{
@@ -1641,6 +1801,11 @@ eResult cDataPlane::parseConfigValues(const nlohmann::json& json)
 		configValues[eConfigType::ring_lowPriority_size] = json["ring_lowPriority_size"];
 	}
 
+	if (exist(json, "ring_slowWorker_size"))
+	{
+		configValues[eConfigType::ring_slowWorker_size] = json["ring_slowWorker_size"];
+	}
+
 	if (exist(json, "fragmentation_size"))
 	{
 		configValues[eConfigType::fragmentation_size] = json["fragmentation_size"];
@@ -1730,11 +1895,26 @@ eResult cDataPlane::parseConfigValues(const nlohmann::json& json)
 		configValues[eConfigType::master_mempool_size] = json["master_mempool_size"];
 	}
 
+	if (exist(json, "nat64stateful_port_blocks_size"))
+	{
+		configValues[eConfigType::nat64stateful_port_blocks_size] = json["nat64stateful_port_blocks_size"];
+	}
+
 	if (exist(json, "kernel_interface_queue_size"))
 	{
 		configValues[eConfigType::kernel_interface_queue_size] = json["kernel_interface_queue_size"];
 	}
 
+	if (exist(json, "fw_state_sync_frames_per_packet"))
+	{
+		configValues[eConfigType::fw_state_sync_frames_per_packet] = json["fw_state_sync_frames_per_packet"];
+	}
+
+	if (exist(json, "fw_state_sync_flush_timeout"))
+	{
+		configValues[eConfigType::fw_state_sync_flush_timeout] = json["fw_state_sync_flush_timeout"];
+	}
+
 	return eResult::success;
 }
 
@@ -1797,9 +1977,10 @@ eResult cDataPlane::checkConfig()
 		std::set<std::string> pcis;
 		for (const auto& portIter : config.ports)
 		{
-			const auto& [pci, symmetric_mode, rss_flags] = portIter.second;
+			const auto& [pci, symmetric_mode, rss_flags, kernel_interface_queues] = portIter.second;
 			(void)symmetric_mode;
 			(void)rss_flags;
+			(void)kernel_interface_queues;
 
 			if (exist(pcis, pci))
 			{
@@ -1811,6 +1992,18 @@ eResult cDataPlane::checkConfig()
 		}
 	}
 
+	for (const auto& coreId : config.slowWorkerCoreIds)
+	{
+		if (coreId >= std::thread::hardware_concurrency() ||
+		    coreId == config.controlPlaneCoreId ||
+		    exist(config.workerGCs, coreId) ||
+		    exist(config.workers, coreId))
+		{
+			YADECAP_LOG_ERROR("invalid slow worker coreId: '%u'\n", coreId);
+			return eResult::invalidConfigurationFile;
+		}
+	}
+
 	for (const auto& workerIter : config.workers)
 	{
 		const tCoreId& coreId = workerIter.first;
@@ -1863,6 +2056,10 @@ eResult cDataPlane::initEal(const std::string& binaryPath,
 
 	uint64_t coresMask = 0;
 	coresMask |= (((uint64_t)1) << (uint64_t)config.controlPlaneCoreId);
+	for (const auto& coreId : config.slowWorkerCoreIds)
+	{
+		coresMask |= (((uint64_t)1) << (uint64_t)coreId);
+	}
 	for (const auto& coreId : config.workerGCs)
 	{
 		coresMask |= (((uint64_t)1) << (uint64_t)coreId);
@@ -1891,9 +2088,10 @@ eResult cDataPlane::initEal(const std::string& binaryPath,
 
 	for (const auto& port : config.ports)
 	{
-		const auto& [pci, symmetric_mode, rss_flags] = port.second;
+		const auto& [pci, symmetric_mode, rss_flags, kernel_interface_queues] = port.second;
 		(void)symmetric_mode;
 		(void)rss_flags;
+		(void)kernel_interface_queues;
 
 		// Do not whitelist sock dev virtual devices
 		if (strncmp(pci.data(), SOCK_DEV_PREFIX, strlen(SOCK_DEV_PREFIX)) == 0)
@@ -16,6 +16,7 @@
 
 #include "common/idp.h"
 #include "common/result.h"
+#include "common/shared_counters.h"
 #include "common/type.h"
 
 #include "bus.h"
@@ -33,6 +34,7 @@ enum class eConfigType
 	ring_normalPriority_size,
 	ring_lowPriority_size,
 	ring_toFreePackets_size,
+	ring_slowWorker_size,
 	ring_log_size,
 	fragmentation_size,
 	fragmentation_timeout_first,
@@ -56,7 +58,10 @@ enum class eConfigType
 	acl_values_size,
 	master_mempool_size,
 	nat64stateful_states_size,
+	nat64stateful_port_blocks_size,
 	kernel_interface_queue_size,
+	fw_state_sync_frames_per_packet,
+	fw_state_sync_flush_timeout,
 };
 
 struct tDataPlaneConfig
@@ -70,12 +75,15 @@ struct tDataPlaneConfig
 	std::map<std::string, ///< interfaceName
 	         std::tuple<std::string, ///< pci
 	                    bool, ///< symmetric_mode
-	                    uint64_t ///< rssFlags
+	                    uint64_t, ///< rssFlags
+	                    uint16_t ///< kernel_interface_queues
 	                    >>
 	        ports;
 
 	std::set<tCoreId> workerGCs;
 	tCoreId controlPlaneCoreId;
+	std::set<tCoreId> slowWorkerCoreIds; ///< additional slow workers
+
 	std::map<tCoreId, std::vector<std::string>> workers;
 	bool useHugeMem = true;
 	bool use_kernel_interface = true;
@@ -142,6 +150,8 @@ protected:
 
 	eResult allocateSharedMemory();
 	eResult splitSharedMemoryPerWorkers();
+	eResult allocateSharedCounters();
+	void attachSharedCounters(cWorker* worker, const tCoreId& coreId);
 
 	std::optional<uint64_t> getCounterValueByName(const std::string& counter_name, uint32_t coreId);
 	common::idp::get_shm_info::response getShmInfo();
@@ -338,6 +348,7 @@ protected:
 	std::unordered_map<uint32_t, std::unordered_map<std::string, uint64_t*>> coreId_to_stats_tables;
 
 	std::map<tSocketId, std::tuple<key_t, void*>> shm_by_socket_id;
+	common::shared_counters::header_t* shared_counters; ///< counters of workers, exported to other processes
 
 	std::mutex hugepage_pointers_mutex;
 	std::map<void*, hugepage_pointer> hugepage_pointers;
@@ -1,3 +1,5 @@
+#include <array>
+
 #include <rte_tcp.h>
 #include <rte_udp.h>
 
@@ -7,10 +9,123 @@
 #include "metadata.h"
 #include "worker.h"
 
+namespace
+{
+
+/// matches destination with prefixes of snapshot. longer prefix overrides direction of shorter prefix
+template<typename address_t>
+std::optional<dregress::direction_t> lookup_levels(const std::vector<dregress::snapshot_t::level_t<address_t>>& levels,
+                                                   const std::vector<common::dregress::value_t>& values,
+                                                   const address_t& address,
+                                                   const bool only_longest,
+                                                   common::dregress::stats_t& stats)
+{
+	std::array<std::tuple<const dregress::snapshot_t::entry_t*, uint8_t>, 129> matches;
+	unsigned int matches_count = 0;
+
+	for (const auto& level : levels)
+	{
+		auto it = level.entries.find(address.applyMask(level.mask));
+		if (it == level.entries.end())
+		{
+			continue;
+		}
+
+		const auto& entry = it->second;
+		if (entry.local)
+		{
+			return std::nullopt;
+		}
+
+		if (entry.prefix)
+		{
+			matches[matches_count++] = {&entry, level.mask};
+		}
+	}
+
+	if (only_longest &&
+	    matches_count)
+	{
+		matches[0] = matches[matches_count - 1];
+		matches_count = 1;
+	}
+
+	std::array<std::tuple<const common::dregress::value_t*, uint8_t>, dregress_t::directions_size> directions;
+	unsigned int directions_count = 0;
+	uint8_t mask_max = 0;
+
+	for (unsigned int match_i = 0;
+	     match_i < matches_count;
+	     match_i++)
+	{
+		const auto& [entry, mask] = matches[match_i];
+
+		for (uint32_t value_i = entry->values_begin;
+		     value_i < entry->values_end;
+		     value_i++)
+		{
+			const auto& value = values[value_i];
+			const auto& [nexthop, label, community, peer_as, origin_as, is_best] = value;
+			(void)community;
+			(void)peer_as;
+			(void)origin_as;
+			(void)is_best;
+
+			unsigned int direction_i = 0;
+			for (;
+			     direction_i < directions_count;
+			     direction_i++)
+			{
+				const auto& direction_value = *std::get<0>(directions[direction_i]);
+				if (std::get<0>(direction_value) == nexthop &&
+				    std::get<1>(direction_value) == label)
+				{
+					break;
+				}
+			}
+
+			if (direction_i == directions_count)
+			{
+				if (directions_count == directions.size())
+				{
+					stats.directions_overflow++;
+					continue;
+				}
+
+				directions_count++;
+			}
+
+			directions[direction_i] = {&value, mask};
+			mask_max = mask;
+		}
+	}
+
+	if (!directions_count)
+	{
+		return std::nullopt;
+	}
+
+	const auto& [value, mask] = directions[rand() % directions_count];
+	const auto& [nexthop, label, community, peer_as, origin_as, is_best] = *value;
+
+	return dregress::direction_t{common::ip_prefix_t(address.applyMask(mask), mask),
+	                             nexthop,
+	                             is_best && mask == mask_max,
+	                             label,
+	                             community,
+	                             peer_as,
+	                             origin_as};
+}
+
+}
+
 dregress_t::dregress_t(cControlPlane* controlplane,
                        cDataPlane* dataplane) :
         controlplane(controlplane),
-        dataplane(dataplane)
+        dataplane(dataplane),
+        snapshot_changed(false),
+        snapshot(new dregress::snapshot_t()),
+        counters_id(0)
 {
 	memset(&stats, 0, sizeof(stats));
 	connections = new dataplane::hashtable_chain_spinlock_t<dregress::connection_key_t, dregress::connection_value_t, YANET_CONFIG_DREGRESS_HT_SIZE, YANET_CONFIG_DREGRESS_HT_EXTENDED_SIZE, 4, 4>();
@@ -18,6 +133,7 @@ dregress_t::dregress_t(cControlPlane* controlplane,
 
 dregress_t::~dregress_t()
 {
+	delete snapshot.load();
 	delete connections;
 }
 
@@ -25,9 +141,15 @@ void dregress_t::insert(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-	const auto& base = controlplane->slowWorker->bases[controlplane->slowWorker->localBaseId & 1];
+	const auto& base = controlplane->slow_worker->worker->bases[controlplane->slow_worker->worker->localBaseId & 1];
 	const auto& dregress = base.globalBase->dregresses[metadata->flow.data.dregressId];
 
+	/// snapshot is released by updater only after end of iteration of slow worker
+	const auto& snapshot = *this->snapshot.load(std::memory_order_acquire);
+	const uint32_t counters_i = counters_id.load(std::memory_order_acquire) & 1;
+	auto& counters_v4 = this->counters_v4[counters_i];
+	auto& counters_v6 = this->counters_v6[counters_i];
+
 	if (metadata->network_flags & YANET_NETWORK_FLAG_FRAGMENT)
 	{
 		stats.fragment++;
@@ -76,7 +198,7 @@ void dregress_t::insert(rte_mbuf* mbuf)
 	{
 		connections->remove(key);
 
-		auto direction = lookup(mbuf);
+		auto direction = lookup(snapshot, mbuf);
 		if (!direction)
 		{
 			stats.lookup_miss++;
@@ -114,7 +236,7 @@ void dregress_t::insert(rte_mbuf* mbuf)
 
 		if (!value)
 		{
-			auto direction = lookup(mbuf);
+			auto direction = lookup(snapshot, mbuf);
 			if (!direction)
 			{
 				stats.lookup_miss++;
@@ -168,7 +290,6 @@ void dregress_t::insert(rte_mbuf* mbuf)
 					rtt_count = 0;
 				}
 
-				std::lock_guard<std::mutex> guard(counters_mutex);
 				if (prefix.is_ipv4())
 				{
 					counters_v4.append(community,
@@ -255,7 +376,6 @@ void dregress_t::insert(rte_mbuf* mbuf)
 					nexthop = common::ip_address_t(6, value->nexthop.bytes);
 				}
 
-				std::lock_guard<std::mutex> guard(counters_mutex);
 				if (prefix.is_ipv4())
 				{
 					counters_v4.append(value->community,
@@ -374,7 +494,7 @@ void dregress_t::insert(rte_mbuf* mbuf)
 	}
 
 	/// @todo: opt
-	controlplane->slowWorker->preparePacket(mbuf);
+	controlplane->slow_worker->worker->preparePacket(mbuf);
 
 	common::globalBase::tFlow flow = dregress.flow;
 	{
@@ -382,28 +502,24 @@ void dregress_t::insert(rte_mbuf* mbuf)
 
 		common::mac_address_t neighbor;
 
+		if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
 		{
-			std::lock_guard<std::mutex> guard(neighbor_mutex);
-
-			if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
+			if (snapshot.neighbor_v4.size())
 			{
-				if (neighbor_v4.size())
-				{
-					const auto& [dregress_neighbor, dregress_flow] = *std::next(neighbor_v4.begin(), metadata->hash % neighbor_v4.size());
+				const auto& [dregress_neighbor, dregress_flow] = snapshot.neighbor_v4[metadata->hash % snapshot.neighbor_v4.size()];
 
-					neighbor = dregress_neighbor;
-					flow = dregress_flow;
-				}
+				neighbor = dregress_neighbor;
+				flow = dregress_flow;
 			}
-			else
+		}
+		else
+		{
+			if (snapshot.neighbor_v6.size())
 			{
-				if (neighbor_v6.size())
-				{
-					const auto& [dregress_neighbor, dregress_flow] = *std::next(neighbor_v6.begin(), metadata->hash % neighbor_v6.size());
+				const auto& [dregress_neighbor, dregress_flow] = snapshot.neighbor_v6[metadata->hash % snapshot.neighbor_v6.size()];
 
-					neighbor = dregress_neighbor;
-					flow = dregress_flow;
-				}
+				neighbor = dregress_neighbor;
+				flow = dregress_flow;
 			}
 		}
 
@@ -454,111 +570,25 @@ void dregress_t::handle()
 	}
 }
 
-std::optional<dregress::direction_t> dregress_t::lookup(rte_mbuf* mbuf)
+std::optional<dregress::direction_t> dregress_t::lookup(const dregress::snapshot_t& snapshot,
+                                                        rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
-	const auto& base = controlplane->slowWorker->bases[controlplane->slowWorker->localBaseId & 1];
+	const auto& base = controlplane->slow_worker->worker->bases[controlplane->slow_worker->worker->localBaseId & 1];
 	const auto& dregress = base.globalBase->dregresses[metadata->flow.data.dregressId];
 
-	std::map<std::tuple<common::ip_address_t, ///< nexthop
-	                    uint32_t>, ///< label
-	         dregress::direction_t>
-	        directions;
-
-	uint8_t mask_max = 0;
-
-	common::ip_prefix_t prefix;
 	if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
 	{
 		rte_ipv4_hdr* ipv4_header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv4_hdr*, metadata->network_headerOffset);
 		common::ipv4_address_t address = rte_be_to_cpu_32(ipv4_header->dst_addr);
-		prefix = common::ip_prefix_t(address, 32);
+		return lookup_levels(snapshot.levels_v4, snapshot.values, address, dregress.onlyLongest, stats);
 	}
 	else
 	{
 		rte_ipv6_hdr* ipv6_header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
 		common::ipv6_address_t address = ipv6_header->dst_addr;
-		prefix = common::ip_prefix_t(address, 128);
-	}
-
-	{
-		std::lock_guard<std::mutex> guard(prefixes_mutex);
-
-		if (prefix.is_ipv4())
-		{
-			for (const auto& local_prefix : local_prefixes_v4)
-			{
-				if (prefix.get_ipv4().subnetOf(local_prefix))
-				{
-					return std::nullopt;
-				}
-			}
-		}
-		else
-		{
-			for (const auto& local_prefix : local_prefixes_v6)
-			{
-				if (prefix.get_ipv6().subnetOf(local_prefix))
-				{
-					return std::nullopt;
-				}
-			}
-		}
-
-		auto append = [this, &directions, &prefix, &mask_max](const uint32_t& value_id, const uint32_t mask) {
-			auto it = values.find(value_id);
-			if (it != values.end())
-			{
-				for (const auto& [nexthop, label, community, peer_as, origin_as, is_best] : it->second)
-				{
-					directions[{nexthop, label}] = {prefix.applyMask(mask),
-					                                nexthop,
-					                                is_best,
-					                                label,
-					                                community,
-					                                peer_as,
-					                                origin_as};
-
-					mask_max = mask;
-				}
-			}
-		};
-
-		if (dregress.onlyLongest)
-		{
-			auto dregress_prefixes_value = prefixes.lookup(prefix);
-			if (dregress_prefixes_value)
-			{
-				std::apply(append, *dregress_prefixes_value);
-			}
-		}
-		else
-		{
-			prefixes.lookup_all(prefix, append);
-		}
+		return lookup_levels(snapshot.levels_v6, snapshot.values, address, dregress.onlyLongest, stats);
 	}
-
-	if (directions.empty())
-	{
-		return std::nullopt;
-	}
-
-	auto direction = (*std::next(directions.begin(), rand() % directions.size())).second;
-	{
-		auto& [prefix, nexthop, is_best, label, community, peer_as, origin_as] = direction;
-		(void)nexthop;
-		(void)label;
-		(void)community;
-		(void)peer_as;
-		(void)origin_as;
-
-		if (prefix.mask() != mask_max)
-		{
-			is_best = false;
-		}
-	}
-
-	return direction;
 }
 
 bool dregress_t::tcp_parse(rte_mbuf* mbuf,
@@ -649,24 +679,126 @@ bool dregress_t::tcp_parse(rte_mbuf* mbuf,
 	return false;
 }
 
-common::idp::get_dregress_counters::response dregress_t::get_dregress_counters()
+void dregress_t::update_snapshot()
 {
-	common::idp::get_dregress_counters::response response;
+	std::unique_ptr<dregress::snapshot_t> snapshot_next;
 
 	{
-		std::lock_guard<std::mutex> guard(counters_mutex); ///< @todo: free lock
-		common::stream_out_t stream;
-		counters_v4.push(stream);
-		counters_v6.push(stream);
-		response = stream.getBuffer();
+		std::lock_guard<std::mutex> guard(prefixes_mutex);
 
-		YANET_MEMORY_BARRIER_COMPILE;
+		if (!snapshot_changed)
+		{
+			return;
+		}
+
+		snapshot_next = compile_snapshot();
+		snapshot_changed = false;
+	}
+
+	const auto* snapshot_prev = snapshot.exchange(snapshot_next.release(), std::memory_order_acq_rel);
+
+	/// slow worker may use previous snapshot till end of current iteration
+	wait_slow_worker();
+
+	delete snapshot_prev;
+}
+
+std::unique_ptr<dregress::snapshot_t> dregress_t::compile_snapshot() const
+{
+	auto snapshot = std::make_unique<dregress::snapshot_t>();
+
+	std::map<uint32_t, std::tuple<uint32_t, uint32_t>> value_ranges;
+	for (const auto& [value_id, value] : values)
+	{
+		const uint32_t values_begin = snapshot->values.size();
+		snapshot->values.insert(snapshot->values.end(), value.begin(), value.end());
+		value_ranges[value_id] = {values_begin, snapshot->values.size()};
+	}
 
-		counters_v4.clear(); ///< @todo: swap
-		counters_v6.clear(); ///< @todo: swap
+	std::map<uint8_t, std::unordered_map<common::ipv4_address_t, dregress::snapshot_t::entry_t>> entries_v4;
+	std::map<uint8_t, std::unordered_map<common::ipv6_address_t, dregress::snapshot_t::entry_t>> entries_v6;
+
+	for (const auto& prefix : local_prefixes_v4)
+	{
+		entries_v4[prefix.mask()][prefix.address().applyMask(prefix.mask())].local = true;
+	}
+
+	for (const auto& prefix : local_prefixes_v6)
+	{
+		entries_v6[prefix.mask()][prefix.address().applyMask(prefix.mask())].local = true;
 	}
 
-	return response;
+	for (const auto& [prefix, value_id] : prefixes)
+	{
+		auto& entry = prefix.is_ipv4() ? entries_v4[prefix.mask()][prefix.get_ipv4().address().applyMask(prefix.mask())] :
+		                                 entries_v6[prefix.mask()][prefix.get_ipv6().address().applyMask(prefix.mask())];
+
+		entry.prefix = true;
+
+		auto it = value_ranges.find(value_id);
+		if (it != value_ranges.end())
+		{
+			std::tie(entry.values_begin, entry.values_end) = it->second;
+		}
+	}
+
+	for (auto& [mask, entries] : entries_v4)
+	{
+		snapshot->levels_v4.push_back({mask, std::move(entries)});
+	}
+
+	for (auto& [mask, entries] : entries_v6)
+	{
+		snapshot->levels_v6.push_back({mask, std::move(entries)});
+	}
+
+	snapshot->neighbor_v4.assign(neighbor_v4.begin(), neighbor_v4.end());
+	snapshot->neighbor_v6.assign(neighbor_v6.begin(), neighbor_v6.end());
+
+	return snapshot;
+}
+
+void dregress_t::wait_slow_worker() const
+{
+	/// dregress is handled by primary slow worker only
+	if (controlplane->slow_workers.empty())
+	{
+		return;
+	}
+
+	const cWorker* worker = controlplane->slow_workers[0]->worker;
+
+	YANET_MEMORY_BARRIER_COMPILE;
+
+	uint64_t startIteration = worker->iteration;
+	uint64_t nextIteration = startIteration;
+	while (nextIteration - startIteration < 2)
+	{
+		YANET_MEMORY_BARRIER_COMPILE;
+		nextIteration = worker->iteration;
+	}
+
+	YANET_MEMORY_BARRIER_COMPILE;
+}
+
+common::idp::get_dregress_counters::response dregress_t::get_dregress_counters()
+{
+	std::lock_guard<std::mutex> guard(counters_mutex);
+
+	/// slow worker continues with other pair of counters
+	const uint32_t id = counters_id.load() & 1;
+	counters_id.store(id ^ 1, std::memory_order_release);
+
+	wait_slow_worker();
+
+	common::stream_out_t stream;
+	counters_v4[id].push(stream);
+	counters_v6[id].push(stream);
+
+	counters_v4[id].clear();
+	counters_v6[id].clear();
+
+	return stream.getBuffer();
 }
 
 void dregress_t::limits(common::idp::limits::response& response)
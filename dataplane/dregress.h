@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 
-#include "common/btree.h"
 #include "common/idp.h"
 #include "common/result.h"
 #include "common/type.h"
@@ -44,6 +47,35 @@ using direction_t = std::tuple<common::ip_prefix_t, ///< prefix
                                uint32_t, ///< peer_as
                                uint32_t>; ///< origin_as
 
+/// local prefixes, prefixes, values and neighbors, compiled for slow worker.
+/// snapshot is not changed after publish: updater compiles next snapshot and swaps pointer
+class snapshot_t
+{
+public:
+	struct entry_t
+	{
+		bool local; ///< destinations of local prefix are not dregressed
+		bool prefix; ///< prefix of dregress, values are [values_begin, values_end)
+		uint32_t values_begin;
+		uint32_t values_end;
+	};
+
+	/// prefixes of one mask, by masked address
+	template<typename address_t>
+	struct level_t
+	{
+		uint8_t mask;
+		std::unordered_map<address_t, entry_t> entries;
+	};
+
+	std::vector<level_t<common::ipv4_address_t>> levels_v4; ///< by ascending mask
+	std::vector<level_t<common::ipv6_address_t>> levels_v6; ///< by ascending mask
+	std::vector<common::dregress::value_t> values;
+
+	std::vector<std::tuple<common::mac_address_t, common::globalBase::tFlow>> neighbor_v4;
+	std::vector<std::tuple<common::mac_address_t, common::globalBase::tFlow>> neighbor_v6;
+};
+
 }
 
 class dregress_t
@@ -55,17 +87,25 @@ public:
 	void insert(rte_mbuf* mbuf);
 	void handle();
 
-	std::optional<dregress::direction_t> lookup(rte_mbuf* mbuf);
+	std::optional<dregress::direction_t> lookup(const dregress::snapshot_t& snapshot, rte_mbuf* mbuf);
 	bool tcp_parse(rte_mbuf* mbuf, uint16_t& rtt, uint32_t& loss_count, uint32_t& ack_count);
 
+	/// compiles and publishes snapshot, if prefixes, values or neighbors are changed. called after update of globalbase
+	void update_snapshot();
+
 	common::idp::get_dregress_counters::response get_dregress_counters();
 	void limits(common::idp::limits::response& response);
 
+protected:
+	std::unique_ptr<dregress::snapshot_t> compile_snapshot() const;
+	void wait_slow_worker() const;
+
 public:
 	cControlPlane* controlplane;
 	cDataPlane* dataplane;
 
 	constexpr static double median_multiplier = 0.01;
+	constexpr static unsigned int directions_size = 64; ///< distinct (nexthop, label) of packet, others are ignored and counted in stats.directions_overflow
 
 	common::dregress::stats_t stats;
 	dataplane::hashtable_chain_spinlock_t<dregress::connection_key_t,
@@ -75,19 +115,23 @@ public:
 	                                      4,
 	                                      4>* connections;
 
+	/// state of updater. slow worker reads only snapshot
 	std::mutex prefixes_mutex;
 	std::set<common::ipv4_prefix_t> local_prefixes_v4; ///< @todo: set<ip_prefix_t>
 	std::set<common::ipv6_prefix_t> local_prefixes_v6;
-	common::btree<common::ip_address_t, uint32_t> prefixes;
+	std::map<common::ip_prefix_t, uint32_t> prefixes;
 	std::map<uint32_t, std::set<common::dregress::value_t>> values;
-
-	std::mutex counters_mutex;
-	common::dregress::counters_t counters_v4;
-	common::dregress::counters_t counters_v6;
-
-	std::mutex neighbor_mutex;
 	std::set<std::tuple<common::mac_address_t, common::globalBase::tFlow>> neighbor_v4;
 	std::set<std::tuple<common::mac_address_t, common::globalBase::tFlow>> neighbor_v6;
+	bool snapshot_changed;
+
+	std::atomic<const dregress::snapshot_t*> snapshot;
+
+	/// slow worker appends to counters of counters_id, reader takes other pair after switch of counters_id
+	std::mutex counters_mutex; ///< readers
+	std::atomic<uint32_t> counters_id;
+	common::dregress::counters_t counters_v4[2];
+	common::dregress::counters_t counters_v6[2];
 
 	uint32_t gc_step;
 };
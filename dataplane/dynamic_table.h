@@ -2,6 +2,7 @@
 
 #include <inttypes.h>
 
+#include <type_traits>
 #include <vector>
 
 #include "common/config.h"
@@ -12,9 +13,16 @@
 namespace dataplane
 {
 
+/// two-dimensional table of values by (k1, k2).
+///
+/// dense: values[(k1 << width_bits) + k2]
+/// compressed: values[values[k1] + k2]. head of values holds offset of row for each k1 (height entries),
+/// followed by distinct rows
 template<typename value_t>
 class dynamic_table
 {
+	static_assert(std::is_same_v<value_t, uint32_t>, "offsets of rows are stored in values");
+
 public:
 	using table_t = dynamic_table<value_t>;
 
@@ -34,14 +42,18 @@ public:
 			this->size = size;
 		}
 
+		/// rows: index of row in values by k1. empty, if values are dense
 		eResult update(const uint32_t width,
+		               const std::vector<uint32_t>& rows,
 		               const std::vector<value_t>& values)
 		{
 			keys_count = 0;
+			dense_keys_count = 0;
 
 			if (width == 0)
 			{
 				table->width_bits = 0;
+				table->height = 0;
 				return eResult::success;
 			}
 
@@ -51,16 +63,31 @@ public:
 				return eResult::invalidCount;
 			}
 
-			if (values.size() > size)
+			if (rows.size() + values.size() > size)
 			{
-				YANET_LOG_ERROR("wrong size: %lu\n", values.size());
+				YANET_LOG_ERROR("wrong size: %lu\n", rows.size() + values.size());
 				return eResult::invalidCount;
 			}
 
+			for (uint32_t k1 = 0;
+			     k1 < rows.size();
+			     k1++)
+			{
+				if (((uint64_t)rows[k1] + 1) * width > values.size())
+				{
+					YANET_LOG_ERROR("wrong row: %u\n", rows[k1]);
+					return eResult::invalidCount;
+				}
+
+				table->values[k1] = rows.size() + rows[k1] * width;
+			}
+
 			table->width_bits = __builtin_popcount(width - 1);
-			memcpy(table->values, values.data(), values.size() * sizeof(value_t));
+			table->height = rows.size();
+			memcpy(table->values + rows.size(), values.data(), values.size() * sizeof(value_t));
 
-			keys_count = values.size();
+			keys_count = rows.size() + values.size();
+			dense_keys_count = rows.empty() ? values.size() : (uint64_t)rows.size() * width;
 
 			return eResult::success;
 		}
@@ -74,13 +101,21 @@ public:
 			                  socket_id,
 			                  keys_count,
 			                  size);
+
+			/// keys of same table without compression
+			list.emplace_back(name + ".dense_keys",
+			                  socket_id,
+			                  dense_keys_count,
+			                  size);
 		}
 
 		template<typename json_t> ///< @todo: nlohmann::json
 		void report(json_t& json) const
 		{
 			json["keys_count"] = keys_count;
+			json["dense_keys_count"] = dense_keys_count;
 			json["width"] = 1u << table->width_bits;
+			json["height"] = table->height;
 		}
 
 	public:
@@ -88,11 +123,13 @@ public:
 		tSocketId socket_id;
 		uint32_t size;
 		unsigned int keys_count;
+		uint64_t dense_keys_count;
 	};
 
 public:
 	dynamic_table() :
-	        width_bits(0)
+	        width_bits(0),
+	        height(0)
 	{
 	}
 
@@ -114,26 +151,54 @@ public:
 	                   value_t (&group_ids)[burst_size],
 	                   const unsigned int count) const
 	{
-		for (unsigned int i = 0;
-		     i < count;
-		     i++)
+		if (height)
+		{
+			/// offsets of rows first, so loads of burst are independent
+			uint32_t offsets[burst_size];
+			for (unsigned int i = 0;
+			     i < count;
+			     i++)
+			{
+				offsets[i] = values[k1s[i]];
+			}
+
+			for (unsigned int i = 0;
+			     i < count;
+			     i++)
+			{
+				group_ids[i] = values[offsets[i] + k2s[i]];
+			}
+		}
+		else
 		{
-			group_ids[i] = values[(k1s[i] << width_bits) + k2s[i]];
+			for (unsigned int i = 0;
+			     i < count;
+			     i++)
+			{
+				group_ids[i] = values[(k1s[i] << width_bits) + k2s[i]];
+			}
 		}
 	}
 
 	inline const value_t& lookup(const uint32_t k1, const uint32_t k2) const
 	{
-		return values[(k1 << width_bits) + k2];
+		return values[offset(k1) + k2];
 	}
 
 	inline value_t& lookup(const uint32_t k1, const uint32_t k2)
 	{
-		return values[(k1 << width_bits) + k2];
+		return values[offset(k1) + k2];
+	}
+
+protected:
+	inline uint32_t offset(const uint32_t k1) const
+	{
+		return height ? values[k1] : k1 << width_bits;
 	}
 
 public:
 	uint32_t width_bits;
+	uint32_t height; ///< count of offsets of rows. zero, if values are dense
 	value_t values[];
 };
 
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace dataplane
+{
+
+/// index of hashtable pairs by time of expiration, gc checks only pairs which are due.
+///
+/// hierarchical timer wheel with resolution of one second:
+/// level 0 holds handles due in current 256 seconds, by second,
+/// level 1 holds handles due in next 65536 seconds, by 256 seconds. bucket of level 1 is moved to level 0
+/// when its 256 seconds begin.
+///
+/// handle is index of pair in hashtable. handle is scheduled once at most: it is unscheduled before callback
+/// and callback schedules it again, if pair is still alive.
+/// not thread safe, used only by gc thread
+class expiry_wheel_t
+{
+public:
+	constexpr static uint32_t level_bits = 8;
+	constexpr static uint32_t level_size = 1u << level_bits;
+	constexpr static uint32_t level_mask = level_size - 1;
+	constexpr static uint32_t delay_max = level_size * level_size - 1;
+
+public:
+	expiry_wheel_t() :
+	        time(0),
+	        scheduled_count(0)
+	{
+	}
+
+	/// unschedules all handles
+	void reset(const uint32_t handles_size,
+	           const uint32_t current_time)
+	{
+		deadlines.assign(handles_size, deadline_none);
+
+		for (auto& bucket : level0)
+		{
+			bucket.clear();
+		}
+
+		for (auto& bucket : level1)
+		{
+			bucket.clear();
+		}
+
+		time = current_time;
+		scheduled_count = 0;
+	}
+
+	uint32_t handles_size() const
+	{
+		return deadlines.size();
+	}
+
+	uint32_t size() const
+	{
+		return scheduled_count;
+	}
+
+	bool is_scheduled(const uint32_t handle) const
+	{
+		return deadlines[handle] != deadline_none;
+	}
+
+	/// deadline is absolute time in seconds, clamped to (time, time + delay_max]
+	void schedule(const uint32_t handle,
+	              uint32_t deadline)
+	{
+		if ((int32_t)(deadline - time) < 1)
+		{
+			deadline = time + 1;
+		}
+		else if (deadline - time > delay_max)
+		{
+			deadline = time + delay_max;
+		}
+
+		deadlines[handle] = deadline;
+		scheduled_count++;
+
+		if ((deadline >> level_bits) == (time >> level_bits))
+		{
+			level0[deadline & level_mask].emplace_back(handle);
+		}
+		else
+		{
+			level1[(deadline >> level_bits) & level_mask].emplace_back(handle);
+		}
+	}
+
+	/// calls callback(handle) for handles due till current_time, 'limit' handles at most.
+	/// returns count of handles
+	template<typename callback_t>
+	uint32_t expire(const uint32_t current_time,
+	                const uint32_t limit,
+	                const callback_t& callback)
+	{
+		uint32_t count = 0;
+		while (count < limit)
+		{
+			auto& bucket = level0[time & level_mask];
+			if (!bucket.empty())
+			{
+				const uint32_t handle = bucket.back();
+				bucket.pop_back();
+
+				deadlines[handle] = deadline_none;
+				scheduled_count--;
+				count++;
+
+				callback(handle);
+				continue;
+			}
+
+			if ((int32_t)(current_time - time) <= 0)
+			{
+				break;
+			}
+
+			if (!scheduled_count)
+			{
+				/// all buckets are empty
+				time = current_time;
+				break;
+			}
+
+			time++;
+			if ((time & level_mask) == 0)
+			{
+				cascade();
+			}
+		}
+
+		return count;
+	}
+
+protected:
+	void cascade()
+	{
+		auto& bucket = level1[(time >> level_bits) & level_mask];
+		for (const uint32_t handle : bucket)
+		{
+			level0[deadlines[handle] & level_mask].emplace_back(handle);
+		}
+		bucket.clear();
+	}
+
+protected:
+	constexpr static uint32_t deadline_none = 0xFFFFFFFFu;
+
+	uint32_t time; ///< buckets before time are empty
+	uint32_t scheduled_count;
+	std::vector<uint32_t> deadlines; ///< by handle
+	std::array<std::vector<uint32_t>, level_size> level0;
+	std::array<std::vector<uint32_t>, level_size> level1;
+};
+
+}
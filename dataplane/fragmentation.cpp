@@ -4,29 +4,22 @@
 #include "dataplane.h"
 
 fragmentation_t::fragmentation_t(cControlPlane* controlPlane,
-                                 cDataPlane* dataPlane) :
+                                 cDataPlane* dataPlane,
+                                 const uint64_t size) :
         controlPlane(controlPlane),
-        dataPlane(dataPlane)
+        table(size,
+              dataPlane->getConfigValue(eConfigType::fragmentation_packets_per_flow),
+              dataPlane->getConfigValue(eConfigType::fragmentation_timeout_first),
+              dataPlane->getConfigValue(eConfigType::fragmentation_timeout_last))
 {
 	memset(&stats, 0, sizeof(stats));
 }
 
 fragmentation_t::~fragmentation_t()
 {
-	for (const auto& [key, value] : fragments)
-	{
-		(void)key;
-
-		for (const auto& [range_from, range_value] : std::get<0>(value))
-		{
-			(void)range_from;
-
-			const auto& [range_to, mbuf] = range_value;
-			(void)range_to;
-
-			rte_pktmbuf_free(mbuf);
-		}
-	}
+	table.clear([](rte_mbuf* mbuf) {
+		rte_pktmbuf_free(mbuf);
+	});
 }
 
 common::fragmentation::stats_t fragmentation_t::getStats()
@@ -34,16 +27,39 @@ common::fragmentation::stats_t fragmentation_t::getStats()
 	return stats;
 }
 
-void fragmentation_t::insert(rte_mbuf* mbuf)
+uint32_t fragmentation_t::hash(rte_mbuf* mbuf)
 {
-	if (stats.current_count_packets > dataPlane->getConfigValue(eConfigType::fragmentation_size))
+	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+
+	uint32_t result = 0;
+	if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
 	{
-		stats.total_overflow_packets++;
-		rte_pktmbuf_free(mbuf);
-		return;
+		rte_ipv4_hdr* ipv4Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv4_hdr*, metadata->network_headerOffset);
+
+		result = yanet_hash_crc<4>(&ipv4Header->src_addr, result);
+		result = yanet_hash_crc<4>(&ipv4Header->dst_addr, result);
+		result = yanet_hash_crc<2>(&ipv4Header->packet_id, result);
+	}
+	else if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6))
+	{
+		rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
+
+		result = yanet_hash_crc<16>(ipv6Header->src_addr, result);
+		result = yanet_hash_crc<16>(ipv6Header->dst_addr, result);
+
+		if (metadata->network_flags & YANET_NETWORK_FLAG_FRAGMENT)
+		{
+			ipv6_extension_fragment_t* extension = rte_pktmbuf_mtod_offset(mbuf, ipv6_extension_fragment_t*, metadata->network_fragmentHeaderOffset);
+			result = yanet_hash_crc<4>(&extension->identification, result);
+		}
 	}
 
-	uint16_t currentTime = time(nullptr);
+	return result;
+}
+
+void fragmentation_t::insert(rte_mbuf* mbuf)
+{
+	uint32_t currentTime = time(nullptr);
 
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 	if (!(metadata->network_flags & YANET_NETWORK_FLAG_FRAGMENT))
@@ -56,6 +72,7 @@ void fragmentation_t::insert(rte_mbuf* mbuf)
 	uint32_t range_from = 0;
 	uint32_t range_to = 0;
 	fragmentation::key_t key;
+	memset(&key, 0, sizeof(key));
 
 	if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
 	{
@@ -78,14 +95,12 @@ void fragmentation_t::insert(rte_mbuf* mbuf)
 		}
 		else
 		{
-			range_to = 0xFFFFFFFF;
+			range_to = fragmentation::table_t::range_to_last;
 		}
 
-		key = fragmentation::key_ipv4_t{metadata->flow.type, ///< @todo
-		                                metadata->flow.getId(), ///< @todo
-		                                {ipv4Header->src_addr},
-		                                {ipv4Header->dst_addr},
-		                                ipv4Header->packet_id};
+		memcpy(key.source, &ipv4Header->src_addr, 4);
+		memcpy(key.destination, &ipv4Header->dst_addr, 4);
+		key.packet_id = ipv4Header->packet_id;
 	}
 	else if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6))
 	{
@@ -109,14 +124,13 @@ void fragmentation_t::insert(rte_mbuf* mbuf)
 		}
 		else
 		{
-			range_to = 0xFFFFFFFF;
+			range_to = fragmentation::table_t::range_to_last;
 		}
 
-		key = fragmentation::key_ipv6_t{metadata->flow.type, ///< @todo
-		                                metadata->flow.getId(), ///< @todo
-		                                {ipv6Header->src_addr},
-		                                {ipv6Header->dst_addr},
-		                                extension->identification};
+		memcpy(key.source, ipv6Header->src_addr, 16);
+		memcpy(key.destination, ipv6Header->dst_addr, 16);
+		key.packet_id = extension->identification;
+		key.is_ipv6 = 1;
 	}
 	else
 	{
@@ -125,184 +139,79 @@ void fragmentation_t::insert(rte_mbuf* mbuf)
 		return;
 	}
 
-	if (!exist(fragments, key))
+	key.flow_id = metadata->flow.getId();
+	key.flow_type = metadata->flow.type;
+
+	uint32_t flow_id;
+	const auto result = table.insert(key, range_from, range_to, mbuf, currentTime, flow_id);
+	if (result == fragmentation::table_t::result_e::overflow)
 	{
-		fragments[key] = {{{range_from,
-		                    {range_to,
-		                     mbuf}}},
-		                  currentTime,
-		                  currentTime};
+		stats.total_overflow_packets++;
+		rte_pktmbuf_free(mbuf);
+		return;
 	}
-	else
+	else if (result == fragmentation::table_t::result_e::flow_overflow)
 	{
-		auto& value = fragments[key];
-
-		if (std::get<0>(value).size() > dataPlane->getConfigValue(eConfigType::fragmentation_packets_per_flow))
-		{
-			stats.flow_overflow_packets++;
-			rte_pktmbuf_free(mbuf);
-			return;
-		}
-
-		if (isIntersect(value, range_from, range_to))
-		{
-			stats.intersect_packets++;
-			rte_pktmbuf_free(mbuf);
-			return;
-		}
-
-		std::get<0>(value)[range_from] = {range_to, mbuf};
-		std::get<2>(value) = currentTime;
+		stats.flow_overflow_packets++;
+		rte_pktmbuf_free(mbuf);
+		return;
 	}
-
-	stats.current_count_packets++;
-}
-
-void fragmentation_t::handle()
-{
-	std::vector<fragmentation::key_t> gc_keys;
-
-	for (auto& [key, value] : fragments)
+	else if (result == fragmentation::table_t::result_e::intersect)
 	{
-		if (isTimeout(value))
-		{
-			gc_keys.emplace_back(key);
-			continue;
-		}
-
-		if (isCollected(value))
-		{
-			rte_mbuf* lastPacket_mbuf = std::get<1>(std::get<0>(value).rbegin()->second);
-
-			dataplane::metadata* firstPacket_metadata = YADECAP_METADATA(std::get<1>(std::get<0>(value).begin()->second));
-			dataplane::metadata* lastPacket_metadata = YADECAP_METADATA(lastPacket_mbuf);
-
-			const uint16_t& lastPacket_range_from = std::get<0>(value).rbegin()->first;
-
-			if (firstPacket_metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
-			{
-				rte_ipv4_hdr* ipv4Header = rte_pktmbuf_mtod_offset(lastPacket_mbuf, rte_ipv4_hdr*, lastPacket_metadata->network_headerOffset);
-
-				firstPacket_metadata->payload_length = lastPacket_range_from +
-				                                       rte_be_to_cpu_16(ipv4Header->total_length) -
-				                                       (lastPacket_metadata->transport_headerOffset - lastPacket_metadata->network_headerOffset);
-			}
-			else if (firstPacket_metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6))
-			{
-				rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(lastPacket_mbuf, rte_ipv6_hdr*, lastPacket_metadata->network_headerOffset);
-
-				firstPacket_metadata->payload_length = lastPacket_range_from +
-				                                       rte_be_to_cpu_16(ipv6Header->payload_len) -
-				                                       (lastPacket_metadata->transport_headerOffset - lastPacket_metadata->network_headerOffset) +
-				                                       sizeof(rte_ipv6_hdr);
-			}
-			else
-			{
-				/// you found a secret area
-
-				gc_keys.emplace_back(key);
-				continue;
-			}
-
-			for (auto& [range_from, range_value] : std::get<0>(value))
-			{
-				(void)range_from;
-
-				const auto& [range_to, mbuf] = range_value;
-				(void)range_to;
-
-				dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
-				metadata->flow.data = firstPacket_metadata->flow.data;
-
-				controlPlane->sendPacketToSlowWorker(mbuf, metadata->flow);
-				stats.current_count_packets--;
-			}
-
-			std::get<0>(value).clear();
-			gc_keys.emplace_back(key);
-		}
+		stats.intersect_packets++;
+		rte_pktmbuf_free(mbuf);
+		return;
 	}
 
-	for (const auto& key : gc_keys)
-	{
-		for (auto& [range_from, range_value] : std::get<0>(fragments[key]))
-		{
-			(void)range_from;
-
-			const auto& [range_to, mbuf] = range_value;
-			(void)range_to;
-
-			stats.timeout_packets++;
-			rte_pktmbuf_free(mbuf);
-
-			stats.current_count_packets--;
-		}
+	stats.current_count_packets++;
 
-		fragments.erase(key);
+	if (result == fragmentation::table_t::result_e::collected)
+	{
+		collect(flow_id);
 	}
 }
 
-bool fragmentation_t::isTimeout(const fragmentation::value_t& value)
+void fragmentation_t::handle()
 {
-	uint16_t currentTime = time(nullptr);
-
-	if ((uint16_t)(currentTime - std::get<1>(value)) >= dataPlane->getConfigValue(eConfigType::fragmentation_timeout_first))
-	{
-		return true;
-	}
-
-	if ((uint16_t)(currentTime - std::get<2>(value)) >= dataPlane->getConfigValue(eConfigType::fragmentation_timeout_last))
-	{
-		return true;
-	}
+	table.expire(time(nullptr), [this](rte_mbuf* mbuf) {
+		stats.timeout_packets++;
+		rte_pktmbuf_free(mbuf);
 
-	return false;
+		stats.current_count_packets--;
+	});
 }
 
-bool fragmentation_t::isCollected(const fragmentation::value_t& value)
+void fragmentation_t::collect(const uint32_t flow_id)
 {
-	uint32_t next_range_from = 0;
-	for (const auto& [range_from, range_value] : std::get<0>(value))
-	{
-		const auto& [range_to, mbuf] = range_value;
-		(void)mbuf;
+	uint32_t lastPacket_range_from;
+	rte_mbuf* lastPacket_mbuf = table.last(flow_id, lastPacket_range_from);
 
-		if (range_from != next_range_from)
-		{
-			return false;
-		}
+	dataplane::metadata* firstPacket_metadata = YADECAP_METADATA(table.first(flow_id));
+	dataplane::metadata* lastPacket_metadata = YADECAP_METADATA(lastPacket_mbuf);
 
-		if (range_to == 0xFFFFFFFF)
-		{
-			return true;
-		}
+	if (firstPacket_metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
+	{
+		rte_ipv4_hdr* ipv4Header = rte_pktmbuf_mtod_offset(lastPacket_mbuf, rte_ipv4_hdr*, lastPacket_metadata->network_headerOffset);
 
-		next_range_from = range_to + 1;
+		firstPacket_metadata->payload_length = lastPacket_range_from +
+		                                       rte_be_to_cpu_16(ipv4Header->total_length) -
+		                                       (lastPacket_metadata->transport_headerOffset - lastPacket_metadata->network_headerOffset);
 	}
-
-	return false;
-}
-
-bool fragmentation_t::isIntersect(const fragmentation::value_t& value,
-                                  const uint32_t& second_range_from,
-                                  const uint32_t& second_range_to)
-{
-	for (const auto& [range_from, range_value] : std::get<0>(value))
+	else
 	{
-		const auto& [range_to, mbuf] = range_value;
-		(void)mbuf;
+		rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(lastPacket_mbuf, rte_ipv6_hdr*, lastPacket_metadata->network_headerOffset);
 
-		if (second_range_to < range_from)
-		{
-			continue;
-		}
-		else if (second_range_from > range_to)
-		{
-			continue;
-		}
-
-		return true;
+		firstPacket_metadata->payload_length = lastPacket_range_from +
+		                                       rte_be_to_cpu_16(ipv6Header->payload_len) -
+		                                       (lastPacket_metadata->transport_headerOffset - lastPacket_metadata->network_headerOffset) +
+		                                       sizeof(rte_ipv6_hdr);
 	}
 
-	return false;
+	table.pop(flow_id, [this, firstPacket_metadata](rte_mbuf* mbuf) {
+		dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+		metadata->flow.data = firstPacket_metadata->flow.data;
+
+		controlPlane->sendPacketToSlowWorker(mbuf, metadata->flow);
+		stats.current_count_packets--;
+	});
 }
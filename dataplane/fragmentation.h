@@ -2,48 +2,39 @@
 
 #include <inttypes.h>
 
-#include <atomic>
-#include <map>
-#include <tuple>
-#include <variant>
-
 #include <rte_mbuf.h>
 
 #include "common/result.h"
 #include "common/type.h"
 
+#include "reassembly.h"
 #include "type.h"
 
 namespace fragmentation
 {
 
-using key_ipv4_t = std::tuple<common::globalBase::eFlowType, ///< @todo
-                              uint64_t, ///< @todo
-                              common::ipv4_address_t,
-                              common::ipv4_address_t,
-                              uint16_t>; ///< packet_id
-
-using key_ipv6_t = std::tuple<common::globalBase::eFlowType, ///< @todo
-                              uint64_t, ///< @todo
-                              common::ipv6_address_t,
-                              common::ipv6_address_t,
-                              uint32_t>; ///< identification
+/// ipv4 addresses are stored in first 4 bytes, unused bytes are zero
+struct key_t
+{
+	uint8_t source[16];
+	uint8_t destination[16];
+	uint64_t flow_id; ///< @todo
+	uint32_t packet_id; ///< packet_id or identification
+	common::globalBase::eFlowType flow_type; ///< @todo
+	uint8_t is_ipv6;
+	uint8_t reserved[2];
+};
 
-using key_t = std::variant<key_ipv4_t,
-                           key_ipv6_t>;
+static_assert(sizeof(key_t) == 48, "invalid size of fragmentation::key_t");
 
-using value_t = std::tuple<std::map<uint32_t, ///< range_from
-                                    std::tuple<uint32_t, ///< range_to
-                                               rte_mbuf*>>,
-                           uint16_t, ///< first packet time
-                           uint16_t>; ///< last packet time
+using table_t = dataplane::reassembly_t<key_t, rte_mbuf*>;
 
 }
 
 class fragmentation_t
 {
 public:
-	fragmentation_t(cControlPlane* controlPlane, cDataPlane* dataPlane);
+	fragmentation_t(cControlPlane* controlPlane, cDataPlane* dataPlane, const uint64_t size);
 	~fragmentation_t();
 
 public:
@@ -52,16 +43,16 @@ public:
 	void insert(rte_mbuf* mbuf);
 	void handle();
 
+	/// all fragments of one packet have same hash (addresses and packet id)
+	static uint32_t hash(rte_mbuf* mbuf);
+
 protected:
-	bool isTimeout(const fragmentation::value_t& value);
-	bool isCollected(const fragmentation::value_t& value);
-	bool isIntersect(const fragmentation::value_t& value, const uint32_t& range_from, const uint32_t& range_to);
+	void collect(const uint32_t flow_id);
 
 protected:
 	cControlPlane* controlPlane;
-	cDataPlane* dataPlane;
 
 	common::fragmentation::stats_t stats;
 
-	std::map<fragmentation::key_t, fragmentation::value_t> fragments;
+	fragmentation::table_t table;
 };
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+
+namespace dataplane
+{
+
+/// pending fw state sync packet of worker.
+///
+/// frames of one acl are collected to one packet. packet is sent when it is full, when frame of other acl comes,
+/// or when flush timeout is expired since its first frame. both fast and slow workers create states, so both
+/// check timeout of pending packet on each iteration.
+/// not thread safe, one per worker
+template<typename packet_T>
+class fw_state_sync_batch_t
+{
+public:
+	fw_state_sync_batch_t() :
+	        packet(nullptr),
+	        acl_id(0),
+	        frames_count(0),
+	        tsc(0),
+	        frames_per_packet(1),
+	        flush_cycles(0)
+	{
+	}
+
+	void configure(const uint32_t frames_per_packet,
+	               const uint64_t flush_cycles)
+	{
+		this->frames_per_packet = frames_per_packet ? frames_per_packet : 1;
+		this->flush_cycles = flush_cycles;
+	}
+
+	packet_T* get() const
+	{
+		return packet;
+	}
+
+	/// returns pending packet of other acl, which must be sent before frame of 'acl_id'
+	packet_T* take_other(const uint32_t acl_id)
+	{
+		if (packet &&
+		    this->acl_id != acl_id)
+		{
+			return take();
+		}
+
+		return nullptr;
+	}
+
+	/// new pending packet, 'tsc' is time of its first frame
+	void start(packet_T* packet,
+	           const uint32_t acl_id,
+	           const uint64_t tsc)
+	{
+		this->packet = packet;
+		this->acl_id = acl_id;
+		this->frames_count = 0;
+		this->tsc = tsc;
+	}
+
+	/// frame is appended to pending packet. returns packet, if it is full
+	packet_T* append()
+	{
+		frames_count++;
+		if (frames_count >= frames_per_packet)
+		{
+			return take();
+		}
+
+		return nullptr;
+	}
+
+	/// returns pending packet, if flush timeout is expired at 'tsc'
+	packet_T* take_expired(const uint64_t tsc)
+	{
+		if (packet &&
+		    tsc - this->tsc >= flush_cycles)
+		{
+			return take();
+		}
+
+		return nullptr;
+	}
+
+	packet_T* take()
+	{
+		packet_T* result = packet;
+		packet = nullptr;
+		frames_count = 0;
+		return result;
+	}
+
+protected:
+	packet_T* packet;
+	uint32_t acl_id;
+	uint32_t frames_count;
+	uint64_t tsc; ///< of first frame in packet
+
+	uint32_t frames_per_packet;
+	uint64_t flush_cycles;
+};
+
+}
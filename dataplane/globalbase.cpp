@@ -1,5 +1,6 @@
 #include <memory.h>
 
+#include <chrono>
 #include <string>
 
 #include <rte_errno.h>
@@ -25,6 +26,9 @@ atomic::atomic(cDataPlane* dataPlane,
 	fw_state_config.other_protocols_timeout = dataPlane->getConfigValue(eConfigType::stateful_firewall_other_protocols_timeout);
 	fw_state_config.sync_timeout = 8;
 
+	balancer_weights_size = 0;
+	balancer_weights_overflows = 0;
+
 	memset(physicalPort_flags, 0, sizeof(physicalPort_flags));
 	memset(counter_shifts, 0, sizeof(counter_shifts));
 	memset(gc_counter_shifts, 0, sizeof(gc_counter_shifts));
@@ -52,7 +56,9 @@ generation::~generation()
 {
 }
 
-eResult generation::update(const common::idp::updateGlobalBase::request& request)
+eResult generation::update(const common::idp::updateGlobalBase::request& request,
+                           journal_t* journal,
+                           update_durations_t* durations)
 {
 	eResult result = eResult::success;
 
@@ -63,185 +69,272 @@ eResult generation::update(const common::idp::updateGlobalBase::request& request
 
 		YADECAP_LOG_DEBUG("running update of type %d\n", (int)type);
 
-		if (type == common::idp::updateGlobalBase::requestType::clear)
-		{
-			result = clear();
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::updateLogicalPort)
-		{
-			result = updateLogicalPort(std::get<common::idp::updateGlobalBase::updateLogicalPort::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::updateDecap)
-		{
-			result = updateDecap(std::get<common::idp::updateGlobalBase::updateDecap::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::updateDregress)
-		{
-			result = updateDregress(std::get<common::idp::updateGlobalBase::updateDregress::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::update_route)
-		{
-			result = update_route(std::get<common::idp::updateGlobalBase::update_route::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::updateInterface)
-		{
-			result = updateInterface(std::get<common::idp::updateGlobalBase::updateInterface::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::nat64stateful_update)
-		{
-			result = nat64stateful_update(std::get<common::idp::updateGlobalBase::nat64stateful_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::nat64stateful_pool_update)
-		{
-			result = nat64stateful_pool_update(std::get<common::idp::updateGlobalBase::nat64stateful_pool_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::updateNat64stateless)
-		{
-			result = updateNat64stateless(std::get<common::idp::updateGlobalBase::updateNat64stateless::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::updateNat64statelessTranslation)
-		{
-			result = updateNat64statelessTranslation(std::get<common::idp::updateGlobalBase::updateNat64statelessTranslation::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::update_balancer)
-		{
-			result = update_balancer(std::get<common::idp::updateGlobalBase::update_balancer::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::update_balancer_services)
-		{
-			result = update_balancer_services(std::get<common::idp::updateGlobalBase::update_balancer_services::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::route_lpm_update)
-		{
-			result = route_lpm_update(std::get<common::idp::updateGlobalBase::route_lpm_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::route_value_update)
-		{
-			result = route_value_update(std::get<common::idp::updateGlobalBase::route_value_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::route_tunnel_lpm_update)
-		{
-			result = route_tunnel_lpm_update(std::get<common::idp::updateGlobalBase::route_tunnel_lpm_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::route_tunnel_weight_update)
-		{
-			result = route_tunnel_weight_update(std::get<common::idp::updateGlobalBase::route_tunnel_weight_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::route_tunnel_value_update)
-		{
-			result = route_tunnel_value_update(std::get<common::idp::updateGlobalBase::route_tunnel_value_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::early_decap_flags)
-		{
-			result = update_early_decap_flags(std::get<common::idp::updateGlobalBase::update_early_decap_flags::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv4_source)
-		{
-			result = acl_network_ipv4_source(std::get<common::idp::updateGlobalBase::acl_network_ipv4_source::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv4_destination)
-		{
-			result = acl_network_ipv4_destination(std::get<common::idp::updateGlobalBase::acl_network_ipv4_destination::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv6_source)
-		{
-			result = acl_network_ipv6_source(std::get<common::idp::updateGlobalBase::acl_network_ipv6_source::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv6_destination_ht)
-		{
-			result = acl_network_ipv6_destination_ht(std::get<common::idp::updateGlobalBase::acl_network_ipv6_destination_ht::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv6_destination)
-		{
-			result = acl_network_ipv6_destination(std::get<common::idp::updateGlobalBase::acl_network_ipv6_destination::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_table)
-		{
-			result = acl_network_table(std::get<common::idp::updateGlobalBase::acl_network_table::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_network_flags)
-		{
-			result = acl_network_flags(std::get<common::idp::updateGlobalBase::acl_network_flags::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_transport_layers)
-		{
-			result = acl_transport_layers(std::get<common::idp::updateGlobalBase::acl_transport_layers::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_transport_table)
-		{
-			result = acl_transport_table(std::get<common::idp::updateGlobalBase::acl_transport_table::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_total_table)
-		{
-			result = acl_total_table(std::get<common::idp::updateGlobalBase::acl_total_table::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::acl_values)
-		{
-			result = acl_values(std::get<common::idp::updateGlobalBase::acl_values::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dump_tags_ids)
-		{
-			result = dump_tags_ids(std::get<common::idp::updateGlobalBase::dump_tags_ids::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dregress_prefix_update)
-		{
-			result = dregress_prefix_update(std::get<common::idp::updateGlobalBase::dregress_prefix_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dregress_prefix_remove)
-		{
-			result = dregress_prefix_remove(std::get<common::idp::updateGlobalBase::dregress_prefix_remove::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dregress_prefix_clear)
-		{
-			result = dregress_prefix_clear();
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dregress_local_prefix_update)
-		{
-			result = dregress_local_prefix_update(std::get<common::idp::updateGlobalBase::dregress_local_prefix_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dregress_neighbor_update)
-		{
-			result = dregress_neighbor_update(std::get<common::idp::updateGlobalBase::dregress_neighbor_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::dregress_value_update)
-		{
-			result = dregress_value_update(std::get<common::idp::updateGlobalBase::dregress_value_update::request>(data));
-		}
-		else if (type == common::idp::updateGlobalBase::requestType::fwstate_synchronization_update)
+		const auto start = std::chrono::steady_clock::now();
+
+		if (journal &&
+		    is_journaled(type))
 		{
-			result = fwstate_synchronization_update(std::get<common::idp::updateGlobalBase::fwstate_synchronization_update::request>(data));
+			journal_t::scope scope(*journal);
+			result = update(type, data);
 		}
-		else if (type == common::idp::updateGlobalBase::requestType::sampler_update)
+		else
 		{
-			result = eResult::success;
-			sampler_enabled = std::get<common::idp::updateGlobalBase::sampler_update::request>(data);
+			result = update(type, data);
 		}
-		else if (type == common::idp::updateGlobalBase::requestType::tun64_update)
+
+		if (durations)
 		{
-			result = tun64_update(std::get<common::idp::updateGlobalBase::tun64_update::request>(data));
+			(*durations)[type] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
 		}
-		else if (type == common::idp::updateGlobalBase::requestType::tun64mappings_update)
+
+		YADECAP_LOG_DEBUG("done update of type %d %i\n", (int)type, result != eResult::success ? 0 : 1);
+
+		if (result != eResult::success)
 		{
-			result = tun64mappings_update(std::get<common::idp::updateGlobalBase::tun64mappings_update::request>(data));
+			return result;
 		}
-		else if (type == common::idp::updateGlobalBase::requestType::serial_update)
+	}
+	YADECAP_LOG_DEBUG("done update %i\n", result != eResult::success ? 0 : 1);
+
+	return result;
+}
+
+eResult generation::update_stale(const common::idp::updateGlobalBase::request& request,
+                                 const journal_t& journal,
+                                 update_durations_t* durations)
+{
+	eResult result = eResult::success;
+
+	for (const auto& iter : request)
+	{
+		const auto& type = std::get<0>(iter);
+		const auto& data = std::get<1>(iter);
+
+		if (is_journaled(type))
 		{
-			result = eResult::success;
-			serial = std::get<common::idp::updateGlobalBase::serial_update::request>(data);
+			continue;
 		}
-		else
+
+		const auto start = std::chrono::steady_clock::now();
+
+		result = update(type, data);
+
+		if (durations)
 		{
-			YADECAP_LOG_ERROR("invalid request type\n");
-			return eResult::invalidType;
+			(*durations)[type] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
 		}
-		YADECAP_LOG_DEBUG("done update of type %d %i\n", (int)type, result != eResult::success ? 0 : 1);
 
 		if (result != eResult::success)
 		{
 			return result;
 		}
 	}
-	YADECAP_LOG_DEBUG("done update %i\n", result != eResult::success ? 0 : 1);
+
+	/// journaled tables are already updated in other generation
+	journal.copy(align2);
+
+	return result;
+}
+
+journal_t generation::make_journal() const
+{
+	return journal_t(align2, (const uint8_t*)align4 - (const uint8_t*)align2);
+}
+
+bool generation::is_journaled(const common::idp::updateGlobalBase::requestType type)
+{
+	/// handlers of these types write only to tables in [align2, align4)
+	return type == common::idp::updateGlobalBase::requestType::route_lpm_update ||
+	       type == common::idp::updateGlobalBase::requestType::route_value_update ||
+	       type == common::idp::updateGlobalBase::requestType::route_tunnel_lpm_update ||
+	       type == common::idp::updateGlobalBase::requestType::route_tunnel_weight_update ||
+	       type == common::idp::updateGlobalBase::requestType::route_tunnel_value_update;
+}
+
+eResult generation::update(const common::idp::updateGlobalBase::requestType type,
+                           const common::idp::updateGlobalBase::requestVariant& data)
+{
+	eResult result = eResult::success;
+
+	if (type == common::idp::updateGlobalBase::requestType::clear)
+	{
+		result = clear();
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::updateLogicalPort)
+	{
+		result = updateLogicalPort(std::get<common::idp::updateGlobalBase::updateLogicalPort::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::updateDecap)
+	{
+		result = updateDecap(std::get<common::idp::updateGlobalBase::updateDecap::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::updateDregress)
+	{
+		result = updateDregress(std::get<common::idp::updateGlobalBase::updateDregress::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::update_route)
+	{
+		result = update_route(std::get<common::idp::updateGlobalBase::update_route::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::updateInterface)
+	{
+		result = updateInterface(std::get<common::idp::updateGlobalBase::updateInterface::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::nat64stateful_update)
+	{
+		result = nat64stateful_update(std::get<common::idp::updateGlobalBase::nat64stateful_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::nat64stateful_pool_update)
+	{
+		result = nat64stateful_pool_update(std::get<common::idp::updateGlobalBase::nat64stateful_pool_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::updateNat64stateless)
+	{
+		result = updateNat64stateless(std::get<common::idp::updateGlobalBase::updateNat64stateless::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::updateNat64statelessTranslation)
+	{
+		result = updateNat64statelessTranslation(std::get<common::idp::updateGlobalBase::updateNat64statelessTranslation::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::update_balancer)
+	{
+		result = update_balancer(std::get<common::idp::updateGlobalBase::update_balancer::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::update_balancer_services)
+	{
+		result = update_balancer_services(std::get<common::idp::updateGlobalBase::update_balancer_services::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::route_lpm_update)
+	{
+		result = route_lpm_update(std::get<common::idp::updateGlobalBase::route_lpm_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::route_value_update)
+	{
+		result = route_value_update(std::get<common::idp::updateGlobalBase::route_value_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::route_tunnel_lpm_update)
+	{
+		result = route_tunnel_lpm_update(std::get<common::idp::updateGlobalBase::route_tunnel_lpm_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::route_tunnel_weight_update)
+	{
+		result = route_tunnel_weight_update(std::get<common::idp::updateGlobalBase::route_tunnel_weight_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::route_tunnel_value_update)
+	{
+		result = route_tunnel_value_update(std::get<common::idp::updateGlobalBase::route_tunnel_value_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::early_decap_flags)
+	{
+		result = update_early_decap_flags(std::get<common::idp::updateGlobalBase::update_early_decap_flags::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv4_source)
+	{
+		result = acl_network_ipv4_source(std::get<common::idp::updateGlobalBase::acl_network_ipv4_source::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv4_destination)
+	{
+		result = acl_network_ipv4_destination(std::get<common::idp::updateGlobalBase::acl_network_ipv4_destination::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv6_source)
+	{
+		result = acl_network_ipv6_source(std::get<common::idp::updateGlobalBase::acl_network_ipv6_source::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv6_destination_ht)
+	{
+		result = acl_network_ipv6_destination_ht(std::get<common::idp::updateGlobalBase::acl_network_ipv6_destination_ht::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_ipv6_destination)
+	{
+		result = acl_network_ipv6_destination(std::get<common::idp::updateGlobalBase::acl_network_ipv6_destination::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_table)
+	{
+		result = acl_network_table(std::get<common::idp::updateGlobalBase::acl_network_table::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_network_flags)
+	{
+		result = acl_network_flags(std::get<common::idp::updateGlobalBase::acl_network_flags::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_transport_layers)
+	{
+		result = acl_transport_layers(std::get<common::idp::updateGlobalBase::acl_transport_layers::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_transport_table)
+	{
+		result = acl_transport_table(std::get<common::idp::updateGlobalBase::acl_transport_table::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_transport_table_delta)
+	{
+		result = acl_transport_table_delta(std::get<common::idp::updateGlobalBase::acl_transport_table_delta::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_total_table)
+	{
+		result = acl_total_table(std::get<common::idp::updateGlobalBase::acl_total_table::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_total_table_delta)
+	{
+		result = acl_total_table_delta(std::get<common::idp::updateGlobalBase::acl_total_table_delta::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::acl_values)
+	{
+		result = acl_values(std::get<common::idp::updateGlobalBase::acl_values::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dump_tags_ids)
+	{
+		result = dump_tags_ids(std::get<common::idp::updateGlobalBase::dump_tags_ids::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dregress_prefix_update)
+	{
+		result = dregress_prefix_update(std::get<common::idp::updateGlobalBase::dregress_prefix_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dregress_prefix_remove)
+	{
+		result = dregress_prefix_remove(std::get<common::idp::updateGlobalBase::dregress_prefix_remove::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dregress_prefix_clear)
+	{
+		result = dregress_prefix_clear();
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dregress_local_prefix_update)
+	{
+		result = dregress_local_prefix_update(std::get<common::idp::updateGlobalBase::dregress_local_prefix_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dregress_neighbor_update)
+	{
+		result = dregress_neighbor_update(std::get<common::idp::updateGlobalBase::dregress_neighbor_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::dregress_value_update)
+	{
+		result = dregress_value_update(std::get<common::idp::updateGlobalBase::dregress_value_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::fwstate_synchronization_update)
+	{
+		result = fwstate_synchronization_update(std::get<common::idp::updateGlobalBase::fwstate_synchronization_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::sampler_update)
+	{
+		result = eResult::success;
+		sampler_enabled = std::get<common::idp::updateGlobalBase::sampler_update::request>(data);
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::tun64_update)
+	{
+		result = tun64_update(std::get<common::idp::updateGlobalBase::tun64_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::tun64mappings_update)
+	{
+		result = tun64mappings_update(std::get<common::idp::updateGlobalBase::tun64mappings_update::request>(data));
+	}
+	else if (type == common::idp::updateGlobalBase::requestType::serial_update)
+	{
+		result = eResult::success;
+		serial = std::get<common::idp::updateGlobalBase::serial_update::request>(data);
+	}
+	else
+	{
+		YADECAP_LOG_ERROR("invalid request type\n");
+		result = eResult::invalidType;
+	}
 
 	return result;
 }
@@ -404,10 +497,7 @@ eResult generation::clear()
 	sampler_enabled = 0;
 	serial = 0;
 
-	updater.acl.network_ipv6_destination_ht.clear();
-	updater.acl.transport_table.clear();
-	updater.acl.total_table.clear();
-	acl.values[0] = {};
+	/// acl tables are cleared by their full updates, as controlplane skips unchanged ones
 	tun64mappingsTable.clear();
 
 	for (unsigned int fw_state_sync_config_id = 0;
@@ -921,7 +1011,7 @@ eResult generation::updateInterface(const common::idp::updateGlobalBase::updateI
 
 eResult generation::nat64stateful_update(const common::idp::updateGlobalBase::nat64stateful_update::request& request)
 {
-	const auto& [nat64stateful_id, dscp_mark_type, dscp, counter_id, pool_start, pool_size, state_timeout, flow] = request;
+	const auto& [nat64stateful_id, dscp_mark_type, dscp, counter_id, pool_start, pool_size, port_block_size, state_timeout, flow] = request;
 
 	if (nat64stateful_id >= YANET_CONFIG_NAT64STATEFULS_SIZE)
 	{
@@ -952,6 +1042,7 @@ eResult generation::nat64stateful_update(const common::idp::updateGlobalBase::na
 	auto& nat64stateful = nat64statefuls[nat64stateful_id];
 	nat64stateful.pool_start = pool_start;
 	nat64stateful.pool_size = pool_size;
+	nat64stateful.port_block_size = port_block_size;
 	nat64stateful.counter_id = counter_id;
 	nat64stateful.flow = flow;
 
@@ -1389,9 +1480,33 @@ void generation::evaluate_service_ring(uint32_t balancer_service_ring_id)
 {
 	balancer_service_ring_t* ring = balancer_service_rings + balancer_service_ring_id;
 	uint32_t weight_pos = 0;
+	uint64_t weights_size = 0;
+
+	/// maglev tables are placed first: their size is fixed, and controlplane rejects config,
+	/// if they don't fit in YANET_CONFIG_BALANCER_WEIGHTS_SIZE
+	for (uint32_t service_idx = 0; service_idx < balancer_services_count; ++service_idx)
+	{
+		balancer_service_t* service = balancer_services + balancer_active_services[service_idx];
+		if (service->scheduler != ::balancer::scheduler::maglev)
+		{
+			continue;
+		}
+
+		balancer_service_range_t* range = ring->ranges + balancer_active_services[service_idx];
+		range->start = weight_pos;
+		weights_size += YANET_CONFIG_BALANCER_MAGLEV_TABLE_SIZE;
+		evaluate_service_ring_maglev(ring, service, weight_pos);
+		range->size = weight_pos - range->start;
+	}
+
 	for (uint32_t service_idx = 0; service_idx < balancer_services_count; ++service_idx)
 	{
 		balancer_service_t* service = balancer_services + balancer_active_services[service_idx];
+		if (service->scheduler == ::balancer::scheduler::maglev)
+		{
+			continue;
+		}
+
 		uint64_t connection_sum = 0;
 		uint32_t weight_sum = 0;
 		if (service->scheduler == ::balancer::scheduler::wlc)
@@ -1434,13 +1549,62 @@ void generation::evaluate_service_ring(uint32_t balancer_service_ring_id)
 				weight = (int)(weight * wlc_ratio(state->weight, real_connections, weight_sum, connection_sum, service->wlc_power));
 				// todo check weight change
 			}
-			while (weight-- > 0)
+			weights_size += weight;
+			while (weight-- > 0 &&
+			       weight_pos < YANET_CONFIG_BALANCER_WEIGHTS_SIZE)
 			{
 				ring->reals[weight_pos++] = real_id;
 			}
 		}
 		range->size = weight_pos - range->start;
 	}
+
+	auto* globalbase_atomic = dataPlane->globalBaseAtomics[socketId];
+	globalbase_atomic->balancer_weights_size = weights_size;
+	if (weights_size > YANET_CONFIG_BALANCER_WEIGHTS_SIZE)
+	{
+		YADECAP_LOG_ERROR("not enough weights for balancer services: %lu > %u\n",
+		                  weights_size,
+		                  YANET_CONFIG_BALANCER_WEIGHTS_SIZE);
+		globalbase_atomic->balancer_weights_overflows++;
+	}
+}
+
+void generation::evaluate_service_ring_maglev(balancer_service_ring_t* ring,
+                                             const balancer_service_t* service,
+                                             uint32_t& weight_pos)
+{
+	if (weight_pos + YANET_CONFIG_BALANCER_MAGLEV_TABLE_SIZE > YANET_CONFIG_BALANCER_WEIGHTS_SIZE)
+	{
+		YADECAP_LOG_ERROR("not enough weights for maglev table\n");
+		return;
+	}
+
+	std::vector<std::tuple<uint64_t, uint32_t>> maglev_reals;
+	maglev_reals.reserve(service->real_size);
+	for (uint32_t real_idx = service->real_start;
+	     real_idx < service->real_start + service->real_size;
+	     ++real_idx)
+	{
+		uint32_t real_id = balancer_service_reals[real_idx];
+		const balancer_real_t& real = balancer_reals[real_id];
+		const balancer_real_state_t* state = balancer_real_states + real_id;
+
+		/// real_id may change after reload, destination may not
+		uint64_t key_high;
+		uint64_t key_low;
+		memcpy(&key_high, real.destination.bytes, 8);
+		memcpy(&key_low, real.destination.bytes + 8, 8);
+		const uint64_t key = key_high * 0x9E3779B97F4A7C15ull + key_low;
+
+		maglev_reals.emplace_back(key, state->weight);
+	}
+
+	const auto table = ::balancer::maglev_t::populate(maglev_reals, YANET_CONFIG_BALANCER_MAGLEV_TABLE_SIZE);
+	for (const auto& real_i : table)
+	{
+		ring->reals[weight_pos++] = balancer_service_reals[service->real_start + real_i];
+	}
 }
 
 eResult generation::route_lpm_update(const common::idp::updateGlobalBase::route_lpm_update::request& request)
@@ -1527,6 +1691,7 @@ eResult generation::route_value_update(const common::idp::updateGlobalBase::rout
 	}
 
 	auto& route_value = route_values[request_route_value_id];
+	journal_t::touch(&route_value, sizeof(route_value));
 	route_value.type = common::globalBase::eNexthopType::drop;
 
 	if (request_type == common::globalBase::eNexthopType::drop)
@@ -1678,6 +1843,7 @@ eResult generation::route_tunnel_weight_update(const common::idp::updateGlobalBa
 		return eResult::invalidCount;
 	}
 
+	journal_t::touch(route_tunnel_weights, request.size() * sizeof(route_tunnel_weights[0]));
 	std::copy(request.begin(), request.end(), route_tunnel_weights);
 
 	return eResult::success;
@@ -1701,6 +1867,7 @@ eResult generation::route_tunnel_value_update(const common::idp::updateGlobalBas
 	}
 
 	auto& route_tunnel_value = route_tunnel_values[request_route_tunnel_value_id];
+	journal_t::touch(&route_tunnel_value, sizeof(route_tunnel_value));
 	route_tunnel_value.type = common::globalBase::eNexthopType::drop;
 
 	if (request_type == common::globalBase::eNexthopType::drop)
@@ -1820,6 +1987,8 @@ eResult generation::acl_network_ipv6_source(const common::idp::updateGlobalBase:
 
 eResult generation::acl_network_ipv6_destination_ht(const common::idp::updateGlobalBase::acl_network_ipv6_destination_ht::request& request)
 {
+	updater.acl.network_ipv6_destination_ht.clear();
+
 	auto result = updater.acl.network_ipv6_destination_ht.update(request);
 	if (result != eResult::success)
 	{
@@ -1847,9 +2016,9 @@ eResult generation::acl_network_table(const common::idp::updateGlobalBase::acl_n
 {
 	eResult result = eResult::success;
 
-	const auto& [width, values] = request;
+	const auto& [width, rows, values] = request;
 
-	result = updater.acl.network_table.update(width, values);
+	result = updater.acl.network_table.update(width, rows, values);
 	if (result != eResult::success)
 	{
 		YANET_LOG_ERROR("acl.network_table.update(): %s\n", result_to_c_str(result));
@@ -1973,6 +2142,8 @@ eResult generation::acl_transport_table(const common::idp::updateGlobalBase::acl
 {
 	eResult result = eResult::success;
 
+	updater.acl.transport_table.clear();
+
 	result = updater.acl.transport_table.update(request);
 	if (result != eResult::success)
 	{
@@ -1983,10 +2154,36 @@ eResult generation::acl_transport_table(const common::idp::updateGlobalBase::acl
 	return result;
 }
 
+eResult generation::acl_transport_table_delta(const common::idp::updateGlobalBase::acl_transport_table_delta::request& request)
+{
+	eResult result = eResult::success;
+
+	const auto& [keys, removed_keys] = request;
+
+	/// remove first, so inserted keys may reuse freed pairs
+	result = updater.acl.transport_table.remove(removed_keys);
+	if (result != eResult::success)
+	{
+		YANET_LOG_ERROR("acl.transport_table.remove(): %s\n", result_to_c_str(result));
+		return result;
+	}
+
+	result = updater.acl.transport_table.update(keys);
+	if (result != eResult::success)
+	{
+		YANET_LOG_ERROR("acl.transport_table.update(): %s\n", result_to_c_str(result));
+		return result;
+	}
+
+	return result;
+}
+
 eResult generation::acl_total_table(const common::idp::updateGlobalBase::acl_total_table::request& request)
 {
 	eResult result = eResult::success;
 
+	updater.acl.total_table.clear();
+
 	result = updater.acl.total_table.update(request);
 	if (result != eResult::success)
 	{
@@ -1997,6 +2194,29 @@ eResult generation::acl_total_table(const common::idp::updateGlobalBase::acl_tot
 	return result;
 }
 
+eResult generation::acl_total_table_delta(const common::idp::updateGlobalBase::acl_total_table_delta::request& request)
+{
+	eResult result = eResult::success;
+
+	const auto& [keys, removed_keys] = request;
+
+	result = updater.acl.total_table.remove(removed_keys);
+	if (result != eResult::success)
+	{
+		YANET_LOG_ERROR("acl.total_table.remove(): %s\n", result_to_c_str(result));
+		return result;
+	}
+
+	result = updater.acl.total_table.update(keys);
+	if (result != eResult::success)
+	{
+		YANET_LOG_ERROR("acl.total_table.update(): %s\n", result_to_c_str(result));
+		return result;
+	}
+
+	return result;
+}
+
 eResult generation::acl_values(const common::idp::updateGlobalBase::acl_values::request& request)
 {
 	if (request.size() > dataPlane->getConfigValue(eConfigType::acl_values_size))
@@ -2032,11 +2252,14 @@ eResult generation::dregress_prefix_update(const common::idp::updateGlobalBase::
 {
 	eResult result = eResult::success;
 
+	auto& dregress = dataPlane->controlPlane->dregress;
+	std::lock_guard<std::mutex> guard(dregress.prefixes_mutex);
+
 	for (const auto& [prefix, value_id] : request)
 	{
-		std::lock_guard<std::mutex> guard(dataPlane->controlPlane->dregress.prefixes_mutex);
-		dataPlane->controlPlane->dregress.prefixes.insert(prefix, value_id);
+		dregress.prefixes[prefix] = value_id;
 	}
+	dregress.snapshot_changed = true;
 
 	return result;
 }
@@ -2045,11 +2268,14 @@ eResult generation::dregress_prefix_remove(const common::idp::updateGlobalBase::
 {
 	eResult result = eResult::success;
 
+	auto& dregress = dataPlane->controlPlane->dregress;
+	std::lock_guard<std::mutex> guard(dregress.prefixes_mutex);
+
 	for (const auto& prefix : request)
 	{
-		std::lock_guard<std::mutex> guard(dataPlane->controlPlane->dregress.prefixes_mutex);
-		dataPlane->controlPlane->dregress.prefixes.remove(prefix);
+		dregress.prefixes.erase(prefix);
 	}
+	dregress.snapshot_changed = true;
 
 	return result;
 }
@@ -2058,8 +2284,11 @@ eResult generation::dregress_prefix_clear()
 {
 	eResult result = eResult::success;
 
-	std::lock_guard<std::mutex> guard(dataPlane->controlPlane->dregress.prefixes_mutex);
-	dataPlane->controlPlane->dregress.prefixes.clear();
+	auto& dregress = dataPlane->controlPlane->dregress;
+	std::lock_guard<std::mutex> guard(dregress.prefixes_mutex);
+
+	dregress.prefixes.clear();
+	dregress.snapshot_changed = true;
 
 	return result;
 }
@@ -2068,22 +2297,24 @@ eResult generation::dregress_local_prefix_update(const common::idp::updateGlobal
 {
 	eResult result = eResult::success;
 
-	std::lock_guard<std::mutex> guard(dataPlane->controlPlane->dregress.prefixes_mutex);
+	auto& dregress = dataPlane->controlPlane->dregress;
+	std::lock_guard<std::mutex> guard(dregress.prefixes_mutex);
 
-	dataPlane->controlPlane->dregress.local_prefixes_v4.clear();
-	dataPlane->controlPlane->dregress.local_prefixes_v6.clear();
+	dregress.local_prefixes_v4.clear();
+	dregress.local_prefixes_v6.clear();
 
 	for (const auto& prefix : request)
 	{
 		if (prefix.is_ipv4())
 		{
-			dataPlane->controlPlane->dregress.local_prefixes_v4.emplace(prefix.get_ipv4());
+			dregress.local_prefixes_v4.emplace(prefix.get_ipv4());
 		}
 		else
 		{
-			dataPlane->controlPlane->dregress.local_prefixes_v6.emplace(prefix.get_ipv6());
+			dregress.local_prefixes_v6.emplace(prefix.get_ipv6());
 		}
 	}
+	dregress.snapshot_changed = true;
 
 	return result;
 }
@@ -2094,10 +2325,12 @@ eResult generation::dregress_neighbor_update(const common::idp::updateGlobalBase
 
 	const auto& [neighbor_v4, neighbor_v6] = request;
 
-	std::lock_guard<std::mutex> guard(dataPlane->controlPlane->dregress.neighbor_mutex);
+	auto& dregress = dataPlane->controlPlane->dregress;
+	std::lock_guard<std::mutex> guard(dregress.prefixes_mutex);
 
-	dataPlane->controlPlane->dregress.neighbor_v4 = neighbor_v4;
-	dataPlane->controlPlane->dregress.neighbor_v6 = neighbor_v6;
+	dregress.neighbor_v4 = neighbor_v4;
+	dregress.neighbor_v6 = neighbor_v6;
+	dregress.snapshot_changed = true;
 
 	return result;
 }
@@ -2106,14 +2339,16 @@ eResult generation::dregress_value_update(const common::idp::updateGlobalBase::d
 {
 	eResult result = eResult::success;
 
-	std::lock_guard<std::mutex> guard(dataPlane->controlPlane->dregress.prefixes_mutex);
+	auto& dregress = dataPlane->controlPlane->dregress;
+	std::lock_guard<std::mutex> guard(dregress.prefixes_mutex);
 
 	for (const auto& [value_id, value] : request)
 	{
 		/// @todo: check value_id
 
-		dataPlane->controlPlane->dregress.values[value_id] = value;
+		dregress.values[value_id] = value;
 	}
+	dregress.snapshot_changed = true;
 
 	return result;
 }
@@ -15,6 +15,7 @@
 #include "dynamic_table.h"
 #include "flat.h"
 #include "hashtable.h"
+#include "journal.h"
 #include "lpm.h"
 #include "type.h"
 
@@ -29,8 +30,8 @@ namespace dataplane::globalBase
 
 namespace acl
 {
-using ipv4_states_ht = hashtable_mod_spinlock_dynamic<fw4_state_key_t, fw_state_value_t, 16>;
-using ipv6_states_ht = hashtable_mod_spinlock_dynamic<fw6_state_key_t, fw_state_value_t, 16>;
+using ipv4_states_ht = hashtable_mod_spinlock_dynamic<fw4_state_key_t, fw_state_value_t, 16, YANET_CONFIG_FW4_STATES_LOCKER_TYPE>;
+using ipv6_states_ht = hashtable_mod_spinlock_dynamic<fw6_state_key_t, fw_state_value_t, 16, YANET_CONFIG_FW6_STATES_LOCKER_TYPE>;
 
 struct transport_layer_t
 {
@@ -73,10 +74,18 @@ using total_table = hashtable_mod_id32_dynamic<common::acl::total_key_t, 16>;
 
 namespace nat64stateful
 {
-using lan_ht = hashtable_mod_spinlock_dynamic<nat64stateful_lan_key, nat64stateful_lan_value, 16>;
-using wan_ht = hashtable_mod_spinlock_dynamic<nat64stateful_wan_key, nat64stateful_wan_value, 16>;
+using lan_ht = hashtable_mod_spinlock_dynamic<nat64stateful_lan_key, nat64stateful_lan_value, 16, YANET_CONFIG_NAT64STATEFUL_LAN_LOCKER_TYPE>;
+using wan_ht = hashtable_mod_spinlock_dynamic<nat64stateful_wan_key, nat64stateful_wan_value, 16, YANET_CONFIG_NAT64STATEFUL_WAN_LOCKER_TYPE>;
+using lan_block_ht = hashtable_mod_spinlock_dynamic<nat64stateful_lan_block_key, nat64stateful_lan_block_value, 16, YANET_CONFIG_NAT64STATEFUL_LAN_LOCKER_TYPE>;
+using wan_block_ht = hashtable_mod_spinlock_dynamic<nat64stateful_wan_block_key, nat64stateful_wan_block_value, 16, YANET_CONFIG_NAT64STATEFUL_WAN_LOCKER_TYPE>;
 }
 
+using balancer_state_ht = hashtable_mod_spinlock<balancer_state_key_t,
+                                                 balancer_state_value_t,
+                                                 YANET_CONFIG_BALANCER_STATE_HT_SIZE,
+                                                 16,
+                                                 YANET_CONFIG_BALANCER_STATE_LOCKER_TYPE>;
+
 class atomic
 {
 public:
@@ -93,6 +102,8 @@ public: ///< @todo
 		acl::ipv6_states_ht::updater fw6_state;
 		nat64stateful::lan_ht::updater nat64stateful_lan_state;
 		nat64stateful::wan_ht::updater nat64stateful_wan_state;
+		nat64stateful::lan_block_ht::updater nat64stateful_lan_block;
+		nat64stateful::wan_block_ht::updater nat64stateful_wan_block;
 	} updater;
 
 	hashtable_gc_t balancer_state_gc;
@@ -100,6 +111,9 @@ public: ///< @todo
 	uint64_t counter_shifts[YANET_CONFIG_COUNTERS_SIZE];
 	uint64_t gc_counter_shifts[YANET_CONFIG_COUNTERS_SIZE];
 
+	uint64_t balancer_weights_size; ///< requested by services at last evaluate_service_ring(), may exceed YANET_CONFIG_BALANCER_WEIGHTS_SIZE
+	uint64_t balancer_weights_overflows; ///< evaluations of service ring, which didn't fit in YANET_CONFIG_BALANCER_WEIGHTS_SIZE
+
 	/// variables above are not needed for cWorker::mainThread()
 	YADECAP_CACHE_ALIGNED(align11);
 	void* nap[1];
@@ -115,12 +129,10 @@ public: ///< @todo
 	acl::ipv6_states_ht* fw6_state;
 	nat64stateful::lan_ht* nat64stateful_lan_state;
 	nat64stateful::wan_ht* nat64stateful_wan_state;
+	nat64stateful::lan_block_ht* nat64stateful_lan_block;
+	nat64stateful::wan_block_ht* nat64stateful_wan_block;
 
-	hashtable_mod_spinlock<balancer_state_key_t,
-	                       balancer_state_value_t,
-	                       YANET_CONFIG_BALANCER_STATE_HT_SIZE,
-	                       16>
-	        balancer_state;
+	balancer_state_ht balancer_state;
 };
 
 //
@@ -132,11 +144,28 @@ public:
 	~generation();
 
 public:
-	eResult update(const common::idp::updateGlobalBase::request& request);
+	/// nanoseconds spent by update() per request type
+	using update_durations_t = std::map<common::idp::updateGlobalBase::requestType, uint64_t>;
+
+	/// writes of journaled request types are recorded in 'journal' (see make_journal())
+	eResult update(const common::idp::updateGlobalBase::request& request,
+	               journal_t* journal = nullptr,
+	               update_durations_t* durations = nullptr);
+
+	/// bring stale generation up to date after update() of other generation:
+	/// replay not journaled request types, copy dirty ranges of journaled
+	eResult update_stale(const common::idp::updateGlobalBase::request& request,
+	                     const journal_t& journal,
+	                     update_durations_t* durations = nullptr);
+
+	journal_t make_journal() const;
+	static bool is_journaled(const common::idp::updateGlobalBase::requestType type);
+
 	eResult updateBalancer(const common::idp::updateGlobalBaseBalancer::request& request);
 	eResult get(const common::idp::getGlobalBase::request& request, common::idp::getGlobalBase::globalBase& globalBaseResponse) const;
 
 protected:
+	eResult update(const common::idp::updateGlobalBase::requestType type, const common::idp::updateGlobalBase::requestVariant& data);
 	eResult clear();
 	eResult updateLogicalPort(const common::idp::updateGlobalBase::updateLogicalPort::request& request);
 	eResult updateDecap(const common::idp::updateGlobalBase::updateDecap::request& request);
@@ -165,7 +194,9 @@ protected:
 	eResult acl_network_flags(const common::idp::updateGlobalBase::acl_network_flags::request& request);
 	eResult acl_transport_layers(const common::idp::updateGlobalBase::acl_transport_layers::request& request);
 	eResult acl_transport_table(const common::idp::updateGlobalBase::acl_transport_table::request& request);
+	eResult acl_transport_table_delta(const common::idp::updateGlobalBase::acl_transport_table_delta::request& request);
 	eResult acl_total_table(const common::idp::updateGlobalBase::acl_total_table::request& request);
+	eResult acl_total_table_delta(const common::idp::updateGlobalBase::acl_total_table_delta::request& request);
 	eResult acl_values(const common::idp::updateGlobalBase::acl_values::request& request);
 	eResult dump_tags_ids(const common::idp::updateGlobalBase::dump_tags_ids::request& request);
 	eResult dregress_prefix_update(const common::idp::updateGlobalBase::dregress_prefix_update::request& request);
@@ -179,6 +210,7 @@ protected:
 	eResult tun64mappings_update(const common::idp::updateGlobalBase::tun64mappings_update::request& request);
 
 	void evaluate_service_ring(uint32_t next_balancer_reals_id);
+	void evaluate_service_ring_maglev(balancer_service_ring_t* ring, const balancer_service_t* service, uint32_t& weight_pos);
 	inline uint64_t count_real_connections(uint32_t counter_id);
 
 public: ///< @todo
@@ -227,16 +259,17 @@ public: ///< @todo
 
 	uint32_t serial;
 
+	/// tables from align2 to align4 are copied to stale generation by journal, see is_journaled()
 	YADECAP_CACHE_ALIGNED(align2);
 
-	lpm4_24bit_8bit_atomic<CONFIG_YADECAP_LPM4_EXTENDED_SIZE> route_lpm4;
-	lpm6_8x16bit_atomic<CONFIG_YADECAP_LPM6_EXTENDED_SIZE> route_lpm6;
+	YANET_CONFIG_ROUTE_LPM4_TYPE route_lpm4;
+	YANET_CONFIG_ROUTE_LPM6_TYPE route_lpm6;
 	route_value_t route_values[YANET_CONFIG_ROUTE_VALUES_SIZE];
 
 	YADECAP_CACHE_ALIGNED(align3);
 
-	lpm4_24bit_8bit_atomic<YANET_CONFIG_ROUTE_TUNNEL_LPM4_EXTENDED_SIZE> route_tunnel_lpm4;
-	lpm6_8x16bit_atomic<YANET_CONFIG_ROUTE_TUNNEL_LPM6_EXTENDED_SIZE> route_tunnel_lpm6;
+	YANET_CONFIG_ROUTE_TUNNEL_LPM4_TYPE route_tunnel_lpm4;
+	YANET_CONFIG_ROUTE_TUNNEL_LPM6_TYPE route_tunnel_lpm6;
 	uint8_t route_tunnel_weights[YANET_CONFIG_ROUTE_TUNNEL_WEIGHTS_SIZE];
 	route_tunnel_value_t route_tunnel_values[YANET_CONFIG_ROUTE_TUNNEL_VALUES_SIZE];
 	ipv4_address_t nat64stateful_pool[YANET_CONFIG_NAT64STATEFUL_POOL_SIZE];
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <memory.h>
+#include <type_traits>
 
 #include <rte_byteorder.h>
 #include <rte_common.h>
 #include <rte_hash_crc.h>
 #include <rte_mbuf.h>
+#include <rte_pause.h>
 #include <rte_spinlock.h>
 
 #include "common/generation.h"
@@ -71,6 +73,64 @@ protected:
 	rte_spinlock_t locker;
 };
 
+/// sequence lock. same lock()/unlock() as spinlock_nonrecursive_t for writers,
+/// writers are serialized by cas on sequence, which is odd while locked.
+/// readers do not write to lock: read_begin(), read data, retry if read_retry()
+class seqlock_t final
+{
+public:
+	seqlock_t() :
+	        sequence(0)
+	{
+	}
+
+public:
+	inline void lock()
+	{
+		for (;;)
+		{
+			uint32_t current = __atomic_load_n(&sequence, __ATOMIC_RELAXED);
+			if (!(current & 1) &&
+			    __atomic_compare_exchange_n(&sequence, &current, current + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			{
+				/// data stores must not be visible before odd sequence
+				__atomic_thread_fence(__ATOMIC_RELEASE);
+				return;
+			}
+
+			rte_pause();
+		}
+	}
+
+	inline void unlock()
+	{
+		__atomic_store_n(&sequence, sequence + 1, __ATOMIC_RELEASE);
+	}
+
+	inline uint32_t read_begin() const
+	{
+		for (;;)
+		{
+			const uint32_t current = __atomic_load_n(&sequence, __ATOMIC_ACQUIRE);
+			if (!(current & 1))
+			{
+				return current;
+			}
+
+			rte_pause();
+		}
+	}
+
+	inline bool read_retry(const uint32_t begin) const
+	{
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return __atomic_load_n(&sequence, __ATOMIC_RELAXED) != begin;
+	}
+
+protected:
+	uint32_t sequence;
+};
+
 struct hashtable_gc_t
 {
 	hashtable_gc_t() :
@@ -1771,9 +1831,6 @@ public:
 		{
 			eResult result = eResult::success;
 
-			keys_count = 0;
-			keys_in_chunks.fill(0);
-			longest_chain = 0;
 			insert_failed = 0;
 			rewrites = 0;
 
@@ -1795,26 +1852,30 @@ public:
 				}
 			}
 
-			for (uint32_t chunk_i = 0;
-			     chunk_i < total_size / chunk_size;
-			     chunk_i++)
-			{
-				unsigned int count = 0;
+			update_keys_in_chunks();
 
-				for (uint32_t pair_i = 0;
-				     pair_i < chunk_size;
-				     pair_i++)
+			return result;
+		}
+
+		/// keys, which are not found, are skipped
+		template<typename update_key_t>
+		eResult remove(const std::vector<update_key_t>& keys)
+		{
+			for (const auto& key : keys)
+			{
+				if constexpr (std::is_same_v<update_key_t, key_t>)
 				{
-					if (hashtable->is_valid(chunk_i * chunk_size + pair_i))
-					{
-						count++;
-					}
+					erase(key);
+				}
+				else
+				{
+					erase(key_t::convert(key));
 				}
-
-				keys_in_chunks[count]++;
 			}
 
-			return result;
+			update_keys_in_chunks();
+
+			return eResult::success;
 		}
 
 		void clear()
@@ -1825,6 +1886,12 @@ public:
 			{
 				hashtable->pairs[i].value = 0;
 			}
+
+			keys_count = 0;
+			keys_in_chunks.fill(0);
+			longest_chain = 0;
+			insert_failed = 0;
+			rewrites = 0;
 		}
 
 	public:
@@ -1902,6 +1969,88 @@ public:
 			return eResult::isFull;
 		}
 
+		/// backward shift deletion: keys after removed one are moved to free pair,
+		/// if it is still on their chain. so lookup can stop on first invalid pair
+		void erase(const key_t& key)
+		{
+			const uint32_t hash = calculate_hash(key) & (total_size - 1);
+
+			uint32_t index = 0;
+			unsigned int try_i = 0;
+			for (;
+			     try_i < chunk_size;
+			     try_i++)
+			{
+				index = (hash + try_i) % total_size;
+
+				if (!hashtable->is_valid(index))
+				{
+					return;
+				}
+				else if (hashtable->is_equal(index, key))
+				{
+					break;
+				}
+			}
+
+			if (try_i == chunk_size)
+			{
+				return;
+			}
+
+			hashtable->pairs[index].value = 0;
+			keys_count--;
+
+			for (unsigned int next_i = 1;
+			     next_i < chunk_size;
+			     next_i++)
+			{
+				const uint32_t next_index = (index + next_i) % total_size;
+
+				if (!hashtable->is_valid(next_index))
+				{
+					break;
+				}
+
+				const uint32_t next_hash = calculate_hash(hashtable->pairs[next_index].key) & (total_size - 1);
+				if (((next_index - next_hash) & (total_size - 1)) < next_i)
+				{
+					/// free pair is before start of chain
+					continue;
+				}
+
+				hashtable->pairs[index] = hashtable->pairs[next_index];
+				hashtable->pairs[next_index].value = 0;
+
+				index = next_index;
+				next_i = 0;
+			}
+		}
+
+		void update_keys_in_chunks()
+		{
+			keys_in_chunks.fill(0);
+
+			for (uint32_t chunk_i = 0;
+			     chunk_i < total_size / chunk_size;
+			     chunk_i++)
+			{
+				unsigned int count = 0;
+
+				for (uint32_t pair_i = 0;
+				     pair_i < chunk_size;
+				     pair_i++)
+				{
+					if (hashtable->is_valid(chunk_i * chunk_size + pair_i))
+					{
+						count++;
+					}
+				}
+
+				keys_in_chunks[count]++;
+			}
+		}
+
 	public:
 		hashtable_t* hashtable;
 		tSocketId socket_id;
@@ -2085,6 +2234,7 @@ public:
 };
 
 /// hashtable with spinlocks. multithread allowed
+/// locker_T is spinlock_nonrecursive_t or seqlock_t. with seqlock_t lookup_optimistic() does not write to chunk
 ///
 /// chunk
 /// [
@@ -2113,10 +2263,13 @@ public:
 template<typename key_t,
          typename value_t,
          uint32_t total_size,
-         uint32_t chunk_size>
+         uint32_t chunk_size,
+         typename locker_T = spinlock_nonrecursive_t>
 class hashtable_mod_spinlock
 {
 public:
+	using locker_t = locker_T;
+
 	constexpr static uint32_t valid_mask_full = 0xFFFFFFFFu >> (32 - chunk_size);
 	constexpr static uint64_t pairs_size = total_size;
 	constexpr static uint64_t keys_in_chunk_size = chunk_size;
@@ -2133,47 +2286,91 @@ public:
 	}
 
 public:
+	/// step 1 of burst lookup: hash all keys and prefetch their chunks.
+	/// step 2 is lookup(hashes[i], keys[i], value, locker) for each key
+	template<unsigned int burst_size = YANET_CONFIG_BURST_SIZE>
+	inline void prefetch(uint32_t (&hashes)[burst_size],
+	                     const key_t (&keys)[burst_size],
+	                     const unsigned int count) const
+	{
+		for (unsigned int i = 0;
+		     i < count;
+		     i++)
+		{
+			hashes[i] = calculate_hash(keys[i]);
+			prefetch(hashes[i]);
+		}
+	}
+
+	inline void prefetch(const uint32_t hash) const
+	{
+		const auto& chunk = chunks[hash & (total_size / chunk_size - 1)];
+		const uint32_t pair_index = (hash >> hash_shift) & (chunk_size - 1);
+
+		rte_prefetch0(&chunk);
+		rte_prefetch0(&chunk.pairs[pair_index]);
+	}
+
 	inline uint32_t lookup(const key_t& key,
 	                       value_t*& value,
-	                       spinlock_nonrecursive_t*& locker)
+	                       locker_t*& locker)
+	{
+		return lookup(calculate_hash(key), key, value, locker);
+	}
+
+	/// returns with chunk locked, even if key not found
+	inline uint32_t lookup(const uint32_t hash,
+	                       const key_t& key,
+	                       value_t*& value,
+	                       locker_t*& locker)
 	{
-		uint32_t hash = calculate_hash(key);
 		auto& chunk = chunks[hash & (total_size / chunk_size - 1)];
 
-		value = nullptr;
 		locker = &chunk.locker;
-
 		locker->lock();
 
-		const uint32_t pair_index = (hash >> hash_shift) & (chunk_size - 1);
-		if (is_valid_and_equal(chunk, pair_index, key))
-		{
-			value = &chunk.pairs[pair_index].value;
-			return hash;
-		}
+		value = find(chunk, hash, key);
+		return hash;
+	}
 
-		if (chunk_size == 1)
+	/// lookup without holding lock. on hit copies consistent value to value_copy and returns true.
+	/// fields of *value may be updated only by relaxed atomics: pair can be removed or reused concurrently,
+	/// so such update is lost or lands on another state at worst. other changes require lookup() with lock
+	inline bool lookup_optimistic(const uint32_t hash,
+	                              const key_t& key,
+	                              value_t& value_copy,
+	                              value_t*& value)
+	{
+		auto& chunk = chunks[hash & (total_size / chunk_size - 1)];
+
+		if constexpr (std::is_same_v<locker_t, seqlock_t>)
 		{
-			return hash;
-		}
+			uint32_t sequence;
+			do
+			{
+				sequence = chunk.locker.read_begin();
 
-		/// check collision
-		uint32_t valid_mask = chunk.valid_mask;
-		for (unsigned int try_i = 1;
-		     try_i < chunk_size && valid_mask;
-		     try_i++)
+				value = find(chunk, hash, key);
+				if (value)
+				{
+					memcpy(&value_copy, value, sizeof(value_t));
+				}
+			} while (chunk.locker.read_retry(sequence));
+		}
+		else
 		{
-			const uint32_t pair_index = ((hash >> hash_shift) + try_i) & (chunk_size - 1);
-			if (is_valid_and_equal(chunk, pair_index, key))
+			chunk.locker.lock();
+
+			value = find(chunk, hash, key);
+			if (value)
 			{
-				value = &chunk.pairs[pair_index].value;
-				return hash;
+				memcpy(&value_copy, value, sizeof(value_t));
 			}
-			valid_mask &= 0xFFFFFFFFu ^ (1u << pair_index);
+
+			chunk.locker.unlock();
 		}
 
-		/// not found
-		return hash;
+		return value != nullptr;
 	}
 
 	inline bool insert(const uint32_t hash,
@@ -2237,7 +2434,7 @@ public:
 		bool result = true;
 
 		value_t* ht_value;
-		spinlock_nonrecursive_t* locker;
+		locker_t* locker;
 
 		uint32_t hash = lookup(key, ht_value, locker);
 		if (ht_value)
@@ -2426,7 +2623,7 @@ public:
 protected:
 	struct chunk_t
 	{
-		spinlock_nonrecursive_t locker;
+		locker_t locker;
 		uint32_t valid_mask;
 		struct
 		{
@@ -2449,11 +2646,43 @@ protected:
 	{
 		return is_valid(chunk, pair_index) && is_equal(chunk, pair_index, key);
 	}
+
+	inline value_t* find(chunk_t& chunk, const uint32_t hash, const key_t& key)
+	{
+		const uint32_t pair_index = (hash >> hash_shift) & (chunk_size - 1);
+		if (is_valid_and_equal(chunk, pair_index, key))
+		{
+			return &chunk.pairs[pair_index].value;
+		}
+
+		if (chunk_size == 1)
+		{
+			return nullptr;
+		}
+
+		/// check collision
+		uint32_t valid_mask = chunk.valid_mask;
+		for (unsigned int try_i = 1;
+		     try_i < chunk_size && valid_mask;
+		     try_i++)
+		{
+			const uint32_t pair_index = ((hash >> hash_shift) + try_i) & (chunk_size - 1);
+			if (is_valid_and_equal(chunk, pair_index, key))
+			{
+				return &chunk.pairs[pair_index].value;
+			}
+			valid_mask &= 0xFFFFFFFFu ^ (1u << pair_index);
+		}
+
+		/// not found
+		return nullptr;
+	}
 } __rte_aligned(RTE_CACHE_LINE_SIZE);
 
 //
 
 /// hashtable with spinlocks. multithread allowed. runtime allocation.
+/// locker_T is spinlock_nonrecursive_t or seqlock_t. with seqlock_t lookup_optimistic() does not write to chunk
 ///
 /// chunk
 /// [
@@ -2481,11 +2710,13 @@ protected:
 /// ]
 template<typename key_t,
          typename value_t,
-         uint32_t chunk_size>
+         uint32_t chunk_size,
+         typename locker_T = spinlock_nonrecursive_t>
 class hashtable_mod_spinlock_dynamic
 {
 public:
-	using hashtable_t = hashtable_mod_spinlock_dynamic<key_t, value_t, chunk_size>;
+	using hashtable_t = hashtable_mod_spinlock_dynamic<key_t, value_t, chunk_size, locker_T>;
+	using locker_t = locker_T;
 
 	constexpr static uint32_t valid_mask_full = 0xFFFFFFFFu >> (32 - chunk_size);
 	constexpr static uint64_t keys_in_chunk_size = chunk_size;
@@ -2579,6 +2810,11 @@ public:
 			return stats.current();
 		}
 
+		uint32_t get_total_size() const
+		{
+			return total_size;
+		}
+
 		template<typename list_T> ///< @todo: common::idp::limits::response
 		void limits(list_T& list,
 		            const std::string& name) const
@@ -2637,47 +2873,91 @@ public:
 	}
 
 public:
+	/// step 1 of burst lookup: hash all keys and prefetch their chunks.
+	/// step 2 is lookup(hashes[i], keys[i], value, locker) for each key
+	template<unsigned int burst_size = YANET_CONFIG_BURST_SIZE>
+	inline void prefetch(uint32_t (&hashes)[burst_size],
+	                     const key_t (&keys)[burst_size],
+	                     const unsigned int count) const
+	{
+		for (unsigned int i = 0;
+		     i < count;
+		     i++)
+		{
+			hashes[i] = calculate_hash(keys[i]);
+			prefetch(hashes[i]);
+		}
+	}
+
+	inline void prefetch(const uint32_t hash) const
+	{
+		const auto& chunk = chunks[hash & total_mask];
+		const uint32_t pair_index = (hash >> total_shift) & (chunk_size - 1);
+
+		rte_prefetch0(&chunk);
+		rte_prefetch0(&chunk.pairs[pair_index]);
+	}
+
 	inline uint32_t lookup(const key_t& key,
 	                       value_t*& value,
-	                       spinlock_nonrecursive_t*& locker)
+	                       locker_t*& locker)
+	{
+		return lookup(calculate_hash(key), key, value, locker);
+	}
+
+	/// returns with chunk locked, even if key not found
+	inline uint32_t lookup(const uint32_t hash,
+	                       const key_t& key,
+	                       value_t*& value,
+	                       locker_t*& locker)
 	{
-		uint32_t hash = calculate_hash(key);
 		auto& chunk = chunks[hash & total_mask];
 
-		value = nullptr;
 		locker = &chunk.locker;
-
 		locker->lock();
 
-		const uint32_t pair_index = (hash >> total_shift) & (chunk_size - 1);
-		if (is_valid_and_equal(chunk, pair_index, key))
-		{
-			value = &chunk.pairs[pair_index].value;
-			return hash;
-		}
+		value = find(chunk, hash, key);
+		return hash;
+	}
 
-		if (chunk_size == 1)
+	/// lookup without holding lock. on hit copies consistent value to value_copy and returns true.
+	/// fields of *value may be updated only by relaxed atomics: pair can be removed or reused concurrently,
+	/// so such update is lost or lands on another state at worst. other changes require lookup() with lock
+	inline bool lookup_optimistic(const uint32_t hash,
+	                              const key_t& key,
+	                              value_t& value_copy,
+	                              value_t*& value)
+	{
+		auto& chunk = chunks[hash & total_mask];
+
+		if constexpr (std::is_same_v<locker_t, seqlock_t>)
 		{
-			return hash;
-		}
+			uint32_t sequence;
+			do
+			{
+				sequence = chunk.locker.read_begin();
 
-		/// check collision
-		uint32_t valid_mask = chunk.valid_mask;
-		for (unsigned int try_i = 1;
-		     try_i < chunk_size && valid_mask;
-		     try_i++)
+				value = find(chunk, hash, key);
+				if (value)
+				{
+					memcpy(&value_copy, value, sizeof(value_t));
+				}
+			} while (chunk.locker.read_retry(sequence));
+		}
+		else
 		{
-			const uint32_t pair_index = ((hash >> total_shift) + try_i) & (chunk_size - 1);
-			if (is_valid_and_equal(chunk, pair_index, key))
+			chunk.locker.lock();
+
+			value = find(chunk, hash, key);
+			if (value)
 			{
-				value = &chunk.pairs[pair_index].value;
-				return hash;
+				memcpy(&value_copy, value, sizeof(value_t));
 			}
-			valid_mask &= 0xFFFFFFFFu ^ (1u << pair_index);
+
+			chunk.locker.unlock();
 		}
 
-		/// not found
-		return hash;
+		return value != nullptr;
 	}
 
 	inline bool insert(const uint32_t hash,
@@ -2741,7 +3021,7 @@ public:
 		bool result = true;
 
 		value_t* ht_value;
-		spinlock_nonrecursive_t* locker;
+		locker_t* locker;
 
 		uint32_t hash = lookup(key, ht_value, locker);
 		if (ht_value)
@@ -2913,6 +3193,12 @@ public:
 			return hashtable->chunks[index / chunk_size];
 		}
 
+		/// position of pair, it is not changed while pair is valid
+		uint32_t get_index() const
+		{
+			return index;
+		}
+
 	protected:
 		friend class updater;
 		hashtable_t* hashtable;
@@ -2973,7 +3259,7 @@ protected:
 
 	struct chunk_t
 	{
-		spinlock_nonrecursive_t locker;
+		locker_t locker;
 		uint32_t valid_mask;
 		struct
 		{
@@ -2996,6 +3282,37 @@ protected:
 	{
 		return is_valid(chunk, pair_index) && is_equal(chunk, pair_index, key);
 	}
+
+	inline value_t* find(chunk_t& chunk, const uint32_t hash, const key_t& key)
+	{
+		const uint32_t pair_index = (hash >> total_shift) & (chunk_size - 1);
+		if (is_valid_and_equal(chunk, pair_index, key))
+		{
+			return &chunk.pairs[pair_index].value;
+		}
+
+		if (chunk_size == 1)
+		{
+			return nullptr;
+		}
+
+		/// check collision
+		uint32_t valid_mask = chunk.valid_mask;
+		for (unsigned int try_i = 1;
+		     try_i < chunk_size && valid_mask;
+		     try_i++)
+		{
+			const uint32_t pair_index = ((hash >> total_shift) + try_i) & (chunk_size - 1);
+			if (is_valid_and_equal(chunk, pair_index, key))
+			{
+				return &chunk.pairs[pair_index].value;
+			}
+			valid_mask &= 0xFFFFFFFFu ^ (1u << pair_index);
+		}
+
+		/// not found
+		return nullptr;
+	}
 };
 
 }
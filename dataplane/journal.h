@@ -0,0 +1,142 @@
+#pragma once
+
+#include <inttypes.h>
+#include <memory.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace dataplane
+{
+
+/// dirty blocks of one memory region.
+/// writes are recorded by journal_t::touch() while journal is attached to current thread (see journal_t::scope),
+/// then copy() brings twin region (same layout) up to date by copying only dirty blocks
+class journal_t
+{
+public:
+	constexpr static uint64_t block_size = 256;
+
+	journal_t(const void* base,
+	          const uint64_t size) :
+	        base((const uint8_t*)base),
+	        size(size),
+	        blocks((size + block_size - 1) / block_size / 64 + 1, 0),
+	        dirty_blocks_count(0)
+	{
+	}
+
+	/// attach journal to current thread
+	class scope
+	{
+	public:
+		scope(journal_t& journal) :
+		        prev(current)
+		{
+			current = &journal;
+		}
+
+		~scope()
+		{
+			current = prev;
+		}
+
+	protected:
+		journal_t* prev;
+	};
+
+	/// record write to [pointer, pointer + length), if journal is attached to current thread
+	inline static void touch(const void* pointer,
+	                         const uint64_t length)
+	{
+		if (current)
+		{
+			current->mark(pointer, length);
+		}
+	}
+
+	void mark(const void* pointer,
+	          const uint64_t length)
+	{
+		const uint8_t* from = (const uint8_t*)pointer;
+		if (length == 0 ||
+		    from < base ||
+		    from + length > base + size)
+		{
+			/// not in this region
+			return;
+		}
+
+		const uint64_t block_first = (from - base) / block_size;
+		const uint64_t block_last = (from - base + length - 1) / block_size;
+		for (uint64_t block_i = block_first;
+		     block_i <= block_last;
+		     block_i++)
+		{
+			uint64_t& word = blocks[block_i / 64];
+			const uint64_t bit = ((uint64_t)1) << (block_i % 64);
+			if (!(word & bit))
+			{
+				word |= bit;
+				dirty_blocks_count++;
+			}
+		}
+	}
+
+	/// copy dirty blocks to same offsets of 'to'. returns count of copied bytes
+	uint64_t copy(void* to) const
+	{
+		uint64_t copied = 0;
+
+		uint64_t block_i = 0;
+		const uint64_t blocks_count = (size + block_size - 1) / block_size;
+		while (block_i < blocks_count)
+		{
+			const uint64_t word = blocks[block_i / 64];
+			if (!word &&
+			    !(block_i % 64))
+			{
+				block_i += 64;
+				continue;
+			}
+
+			if (!(word & (((uint64_t)1) << (block_i % 64))))
+			{
+				block_i++;
+				continue;
+			}
+
+			/// merge consecutive dirty blocks to one memcpy
+			uint64_t block_end = block_i + 1;
+			while (block_end < blocks_count &&
+			       (blocks[block_end / 64] & (((uint64_t)1) << (block_end % 64))))
+			{
+				block_end++;
+			}
+
+			const uint64_t offset = block_i * block_size;
+			const uint64_t length = std::min(block_end * block_size, size) - offset;
+			memcpy((uint8_t*)to + offset, base + offset, length);
+			copied += length;
+
+			block_i = block_end;
+		}
+
+		return copied;
+	}
+
+	uint64_t dirty_size() const
+	{
+		return dirty_blocks_count * block_size;
+	}
+
+protected:
+	const uint8_t* base;
+	uint64_t size;
+	std::vector<uint64_t> blocks;
+	uint64_t dirty_blocks_count;
+
+	inline static thread_local journal_t* current = nullptr;
+};
+
+}
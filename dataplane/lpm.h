@@ -3,16 +3,19 @@
 #include <memory.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <rte_byteorder.h>
 #include <rte_common.h>
 #include <rte_ip.h>
+#include <rte_prefetch.h>
 
 #include "common/acl.h"
 #include "common/idp.h"
 #include "common/result.h"
 
 #include "common.h"
+#include "journal.h"
 #include "metadata.h"
 
 namespace dataplane
@@ -24,6 +27,8 @@ template<uint32_t TExtendedSize>
 class lpm4_24bit_8bit_atomic
 {
 public:
+	constexpr static uint32_t extendedChunksSize = TExtendedSize;
+
 	lpm4_24bit_8bit_atomic()
 	{
 		extendedChunksCount = 0;
@@ -80,6 +85,9 @@ public:
 
 	void clear()
 	{
+		journal_t::touch(&rootChunk, sizeof(rootChunk));
+		journal_header();
+
 		memset(&rootChunk.entries[0], 0, sizeof(rootChunk.entries));
 		extendedChunksCount = 0;
 		maxUsedChunkId = 0;
@@ -176,6 +184,17 @@ public:
 		return result;
 	}
 
+	template<typename list_T> ///< @todo: common::idp::limits::response
+	void limits(list_T& list,
+	            const std::string& name,
+	            const std::optional<unsigned int>& socket_id) const
+	{
+		list.emplace_back(name + ".extended_chunks",
+		                  socket_id,
+		                  extendedChunksCount,
+		                  TExtendedSize);
+	}
+
 protected:
 	constexpr static uint8_t flagExtended = 1 << 0;
 	constexpr static uint8_t flagValid = 1 << 1;
@@ -223,12 +242,22 @@ protected:
 	uint32_t maxUsedChunkId;
 	tEntry freeChunkCache;
 
+	/// record writes of chunk allocator state (see journal_t)
+	void journal_header()
+	{
+		journal_t::touch(&extendedChunksCount, sizeof(extendedChunksCount));
+		journal_t::touch(&maxUsedChunkId, sizeof(maxUsedChunkId));
+		journal_t::touch(&freeChunkCache, sizeof(freeChunkCache));
+	}
+
 	bool newExtendedChunk(uint32_t& extendedChunkId)
 	{
 		if (freeChunkCache.flags & flagExtended)
 		{
 			extendedChunkId = freeChunkCache.extendedChunkId;
 			tChunk8& extendedChunk = extendedChunks[extendedChunkId];
+			journal_t::touch(&extendedChunk, sizeof(extendedChunk));
+			journal_header();
 			freeChunkCache.flags = extendedChunk.entries[0].flags;
 			freeChunkCache.extendedChunkId = extendedChunk.entries[0].extendedChunkId;
 			memset(&extendedChunk.entries[0], 0, sizeof(extendedChunk.entries));
@@ -238,9 +267,11 @@ protected:
 		}
 		else if (maxUsedChunkId < TExtendedSize)
 		{
+			journal_header();
 			extendedChunkId = maxUsedChunkId++;
 
 			tChunk8& extendedChunk = extendedChunks[extendedChunkId];
+			journal_t::touch(&extendedChunk, sizeof(extendedChunk));
 			memset(&extendedChunk.entries[0], 0, sizeof(extendedChunk.entries));
 			extendedChunk.entries[0].flags |= flagExtendedChunkOccupied;
 			++extendedChunksCount;
@@ -254,6 +285,9 @@ protected:
 	{
 		tChunk8& extendedChunk = extendedChunks[extendedChunkId];
 
+		journal_t::touch(&extendedChunk.entries[0], sizeof(extendedChunk.entries[0]));
+		journal_header();
+
 		extendedChunk.entries[0].flags = freeChunkCache.flags;
 		extendedChunk.entries[0].extendedChunkId = freeChunkCache.extendedChunkId;
 
@@ -271,6 +305,8 @@ protected:
 		newEntry.flags |= entry.flags & flagExtendedChunkOccupied;
 		newEntry.valueId = value;
 
+		journal_t::touch(&entry, sizeof(entry));
+
 		YADECAP_MEMORY_BARRIER_COMPILE;
 
 		entry.atomic = newEntry.atomic;
@@ -279,6 +315,8 @@ protected:
 	static void updateAllEntries(tChunk8& chunk,
 	                             const tEntry& entry)
 	{
+		journal_t::touch(&chunk.entries[0], sizeof(chunk.entries));
+
 		YADECAP_MEMORY_BARRIER_COMPILE;
 
 		uint8_t flag = chunk.entries[0].flags & flagExtendedChunkOccupied;
@@ -620,202 +658,1095 @@ protected:
 
 //
 
-template<uint32_t TExtendedSize>
-class lpm6_8x16bit_atomic
+/// lpm with 16 bit root and 8 bit levels of bitmap compressed nodes.
+/// node stores only first entry of every run of equal entries and bitmap of run starts,
+/// so entry of byte 'b' is entries[entriesOffset + popcount(bitmap[0..b]) - 1].
+/// node takes one cache line, entries of all nodes are shared pool of power of two sized blocks.
+/// node is never modified in place: new node is built aside and published by atomic store of parent entry.
+/// same semantic as lpm4_24bit_8bit_atomic: insertion order matters
+template<uint32_t TExtendedSize, ///< nodes
+         uint32_t TEntriesSize>
+class lpm_16bit_8bit_compressed
 {
 public:
-	lpm6_8x16bit_atomic()
+	constexpr static uint32_t extendedChunksSize = TExtendedSize;
+	constexpr static uint32_t entriesSize = TEntriesSize;
+
+	lpm_16bit_8bit_compressed()
 	{
-		extendedChunksCount = 0;
-		maxUsedChunkId = 0;
-		freeChunkCache.flags = 0;
+		memset(&rootChunk.entries[0], 0, sizeof(rootChunk.entries));
+		reset();
 	}
 
-	static std::array<uint8_t, 16> createMask(uint8_t ones)
+	void clear()
 	{
-		std::array<uint8_t, 16> maskBuf;
-		for (int i = 0; i < 16; i++)
-		{
-			if (ones >= 8)
-			{
-				maskBuf[i] = 0xFF;
-				ones -= 8;
-				continue;
-			}
+		journal_t::touch(&rootChunk, sizeof(rootChunk));
+		journal_header();
 
-			maskBuf[i] = ~(0xFF >> ones);
-			ones = 0;
-		}
+		memset(&rootChunk.entries[0], 0, sizeof(rootChunk.entries));
+		reset();
+	}
 
-		return maskBuf;
+	struct tStats
+	{
+		uint64_t extendedChunksCount; ///< nodes
+		uint64_t entriesCount;
+	};
+
+	tStats getStats() const
+	{
+		tStats result;
+		memset(&result, 0, sizeof(result));
+		result.extendedChunksCount = extendedChunksCount;
+		result.entriesCount = entriesCount;
+
+		return result;
 	}
 
-	/// Insertion order matters!
-	eResult insert(const std::array<uint8_t, 16>& ipv6Address,
-	               const uint8_t& mask,
-	               const uint32_t& valueId,
-	               bool* needWait = nullptr)
+	template<typename list_T> ///< @todo: common::idp::limits::response
+	void limits(list_T& list,
+	            const std::string& name,
+	            const std::optional<unsigned int>& socket_id) const
 	{
-		if (mask > 128 ||
-		    valueId & 0xFF000000)
+		list.emplace_back(name + ".extended_chunks",
+		                  socket_id,
+		                  extendedChunksCount,
+		                  TExtendedSize);
+		list.emplace_back(name + ".entries",
+		                  socket_id,
+		                  entriesCount,
+		                  TEntriesSize);
+	}
+
+protected:
+	constexpr static uint8_t flagExtended = 1 << 0;
+	constexpr static uint8_t flagValid = 1 << 1;
+
+	constexpr static uint32_t idInvalid = 0xFFFFFFFF;
+	constexpr static unsigned int sizeClassesCount = 9; ///< blocks of 1, 2, 4 .. 256 entries
+
+	union tEntry
+	{
+		struct
 		{
-			YADECAP_LOG_DEBUG("invalid prefix or value\n");
-			return eResult::invalidArguments;
-		}
+			uint8_t flags : 8;
+			union
+			{
+				uint32_t valueId : 24;
+				uint32_t extendedChunkId : 24;
+			} __attribute__((__packed__));
+		} __attribute__((__packed__));
 
-		if (needWait)
+		uint32_t atomic;
+	} __attribute__((__packed__));
+
+	static_assert(sizeof(tEntry) == 4, "invalid size of tEntry");
+
+	struct tChunk16
+	{
+		tEntry entries[256 * 256];
+	} __attribute__((__packed__));
+
+	struct tNode
+	{
+		uint64_t bitmap[4]; ///< bit 'b' is set, if entry 'b' starts new run
+		uint16_t ranks[4]; ///< count of runs started before bitmap[i]
+		uint32_t entriesOffset; ///< next free node, if node is free
+		uint32_t sizeClass;
+	} __rte_aligned(RTE_CACHE_LINE_SIZE);
+
+	static_assert(sizeof(tNode) == RTE_CACHE_LINE_SIZE, "invalid size of tNode");
+
+	/// nodes and entries blocks, replaced by update()
+	struct garbage_t
+	{
+		std::vector<uint32_t> nodes; ///< released after success
+		std::vector<uint32_t> trees; ///< overwritten subtrees, released after success
+		std::vector<uint32_t> allocated; ///< released on failure
+	};
+
+protected:
+	uint32_t extendedChunksCount;
+	uint32_t maxUsedChunkId;
+	uint32_t freeChunkId;
+	uint32_t entriesCount;
+	uint32_t maxUsedEntryId;
+	uint32_t freeEntryIds[sizeClassesCount];
+
+	void reset()
+	{
+		extendedChunksCount = 0;
+		maxUsedChunkId = 0;
+		freeChunkId = idInvalid;
+		entriesCount = 0;
+		maxUsedEntryId = 0;
+		for (auto& freeEntryId : freeEntryIds)
 		{
-			*needWait = false;
+			freeEntryId = idInvalid;
 		}
+	}
 
-		return insertStep(ipv6Address,
-		                  mask,
-		                  valueId,
-		                  needWait,
-		                  0,
-		                  rootChunk);
+	/// record writes of allocator state (see journal_t)
+	void journal_header()
+	{
+		journal_t::touch(&extendedChunksCount, sizeof(extendedChunksCount));
+		journal_t::touch(&maxUsedChunkId, sizeof(maxUsedChunkId));
+		journal_t::touch(&freeChunkId, sizeof(freeChunkId));
+		journal_t::touch(&entriesCount, sizeof(entriesCount));
+		journal_t::touch(&maxUsedEntryId, sizeof(maxUsedEntryId));
+		journal_t::touch(&freeEntryIds[0], sizeof(freeEntryIds));
 	}
 
-	eResult insert(const std::array<uint8_t, 16>& ipv6Address,
-	               const std::array<uint8_t, 16>& mask,
-	               const uint32_t& valueId)
+	/// index of entry of 'byte' in entries
+	inline uint32_t lookupNode(const uint32_t nodeId,
+	                           const uint8_t byte) const
 	{
-		if (valueId & 0xFF000000)
+		const tNode& node = nodes[nodeId];
+		const unsigned int word_i = byte >> 6;
+		const uint64_t bits = node.bitmap[word_i] & ((((uint64_t)2) << (byte & 63)) - 1);
+
+		return node.entriesOffset + node.ranks[word_i] + __builtin_popcountll(bits) - 1;
+	}
+
+	bool newNode(uint32_t& nodeId)
+	{
+		if (freeChunkId != idInvalid)
 		{
-			YADECAP_LOG_DEBUG("invalid value\n");
-			return eResult::invalidArguments;
+			journal_header();
+			nodeId = freeChunkId;
+			freeChunkId = nodes[nodeId].entriesOffset;
+		}
+		else if (maxUsedChunkId < TExtendedSize)
+		{
+			journal_header();
+			nodeId = maxUsedChunkId++;
+		}
+		else
+		{
+			return false;
 		}
 
-		return insertStep(ipv6Address,
-		                  mask,
-		                  valueId,
-		                  0,
-		                  false,
-		                  rootChunk);
+		++extendedChunksCount;
+		return true;
 	}
 
-	eResult remove(const std::array<uint8_t, 16>& ipv6Address,
-	               const uint8_t& mask,
-	               bool* needWait = nullptr)
+	bool newEntries(const uint32_t sizeClass,
+	                uint32_t& entriesOffset)
 	{
-		if (mask > 128)
+		const uint32_t size = ((uint32_t)1) << sizeClass;
+
+		if (freeEntryIds[sizeClass] != idInvalid)
 		{
-			YADECAP_LOG_DEBUG("invalid prefix\n");
-			return eResult::invalidArguments;
+			journal_header();
+			entriesOffset = freeEntryIds[sizeClass];
+			freeEntryIds[sizeClass] = entries[entriesOffset].atomic;
 		}
-
-		if (needWait)
+		else if (maxUsedEntryId + size <= TEntriesSize)
 		{
-			*needWait = false;
+			journal_header();
+			entriesOffset = maxUsedEntryId;
+			maxUsedEntryId += size;
+		}
+		else
+		{
+			return false;
 		}
 
-		return removeStep(ipv6Address,
-		                  mask,
-		                  needWait,
-		                  0,
-		                  rootChunk);
+		entriesCount += size;
+		return true;
 	}
 
-	eResult remove(const std::array<uint8_t, 16>& ipv6Address,
-	               const std::array<uint8_t, 16>& mask)
+	void freeEntries(const uint32_t sizeClass,
+	                 const uint32_t entriesOffset)
 	{
-		return removeStep(ipv6Address, mask, 0, false, rootChunk);
+		tEntry& entry = entries[entriesOffset];
+
+		journal_t::touch(&entry, sizeof(entry));
+		journal_header();
+
+		entry.atomic = freeEntryIds[sizeClass];
+		freeEntryIds[sizeClass] = entriesOffset;
+		entriesCount -= ((uint32_t)1) << sizeClass;
 	}
 
-	void clear()
+	void freeChunk(const uint32_t nodeId)
 	{
-		this->rootChunk = {};
-		extendedChunksCount = 0;
-		maxUsedChunkId = 0;
-		freeChunkCache.flags = 0;
+		tNode& node = nodes[nodeId];
+
+		journal_t::touch(&node.entriesOffset, sizeof(node.entriesOffset));
+		journal_header();
+
+		node.entriesOffset = freeChunkId;
+		freeChunkId = nodeId;
+		--extendedChunksCount;
 	}
 
-	inline void lookup(const ipv6_address_t* ipv6Addresses,
-	                   uint32_t* valueIds,
-	                   const unsigned int& count) const
+	/// node and its entries, without children
+	void freeNode(const uint32_t nodeId)
 	{
-		/// @todo: OPT: le -> be
+		const tNode& node = nodes[nodeId];
 
-		for (unsigned int ipv6Address_i = 0;
-		     ipv6Address_i < count;
-		     ipv6Address_i++)
-		{
-			const ipv6_address_t& ipv6Address = ipv6Addresses[ipv6Address_i];
-			const tChunk* currentChunk = &rootChunk;
+		freeEntries(node.sizeClass, node.entriesOffset);
+		freeChunk(nodeId);
+	}
 
-			valueIds[ipv6Address_i] = lpmValueIdInvalid;
+	void freeTree(const uint32_t nodeId)
+	{
+		const tNode& node = nodes[nodeId];
+		const uint32_t runsCount = node.ranks[3] + __builtin_popcountll(node.bitmap[3]);
 
-			for (unsigned int step = 0;
-			     step < 8;
-			     step++)
+		for (uint32_t run_i = 0;
+		     run_i < runsCount;
+		     run_i++)
+		{
+			const tEntry& entry = entries[node.entriesOffset + run_i];
+			if (entry.flags & flagExtended)
 			{
-				uint16_t entry_i = rte_be_to_cpu_16(*(((uint16_t*)ipv6Address.bytes) + step));
-
-				tEntry entry;
-				entry.atomic = currentChunk->entries[entry_i].atomic;
-
-				if (entry.flags & flagValid)
-				{
-					///                     = entry.valueId;
-					valueIds[ipv6Address_i] = entry.atomic >> 8;
-					break;
-				}
-				else if (entry.flags & flagExtended)
-				{
-					///          = &extendedChunks[entry.extendedChunkId];
-					currentChunk = &extendedChunks[entry.atomic >> 8];
-				}
-				else
-				{
-					break;
-				}
+				freeTree(entry.extendedChunkId);
 			}
 		}
-	}
 
-	constexpr static uint32_t mask_full = 0xFFFFFFFFu;
+		freeNode(nodeId);
+	}
 
-	inline void lookup(const uint32_t mask,
-	                   const ipv6_address_t* ipv6Addresses,
-	                   uint32_t* valueIds,
-	                   const unsigned int& count) const
+	void expand(const tEntry& entry,
+	            tEntry* expanded) const
 	{
-		/// @todo: OPT: le -> be
-
-		if (mask == mask_full)
+		if (!(entry.flags & flagExtended))
 		{
+			for (unsigned int entry_i = 0;
+			     entry_i < 256;
+			     entry_i++)
+			{
+				expanded[entry_i].atomic = entry.atomic;
+			}
+
 			return;
 		}
 
-		for (unsigned int ipv6Address_i = 0;
-		     ipv6Address_i < count;
-		     ipv6Address_i++)
+		const tNode& node = nodes[entry.extendedChunkId];
+
+		uint32_t run_i = 0;
+		tEntry current;
+		current.atomic = 0;
+		for (unsigned int entry_i = 0;
+		     entry_i < 256;
+		     entry_i++)
 		{
-			if (mask & (1u << ipv6Address_i))
+			if ((node.bitmap[entry_i >> 6] >> (entry_i & 63)) & 1)
 			{
-				continue;
+				current.atomic = entries[node.entriesOffset + run_i].atomic;
+				run_i++;
 			}
 
-			const ipv6_address_t& ipv6Address = ipv6Addresses[ipv6Address_i];
-			const tChunk* currentChunk = &rootChunk;
-
-			valueIds[ipv6Address_i] = lpmValueIdInvalid;
+			expanded[entry_i].atomic = current.atomic;
+		}
+	}
 
-			for (unsigned int step = 0;
-			     step < 8;
-			     step++)
+	eResult compress(const tEntry* expanded,
+	                 tEntry& result,
+	                 garbage_t& garbage)
+	{
+		uint32_t runsCount = 1;
+		for (unsigned int entry_i = 1;
+		     entry_i < 256;
+		     entry_i++)
+		{
+			if (expanded[entry_i].atomic != expanded[entry_i - 1].atomic)
 			{
-				uint16_t entry_i = rte_be_to_cpu_16(*(((uint16_t*)ipv6Address.bytes) + step));
+				runsCount++;
+			}
+		}
 
-				tEntry entry;
-				entry.atomic = currentChunk->entries[entry_i].atomic;
+		if (runsCount == 1 &&
+		    !(expanded[0].flags & flagExtended))
+		{
+			/// merge
+			result.atomic = expanded[0].atomic;
+			return eResult::success;
+		}
 
-				if (entry.flags & flagValid)
-				{
-					///                     = entry.valueId;
-					valueIds[ipv6Address_i] = entry.atomic >> 8;
-					break;
-				}
+		uint32_t sizeClass = 0;
+		while ((((uint32_t)1) << sizeClass) < runsCount)
+		{
+			sizeClass++;
+		}
+
+		uint32_t entriesOffset;
+		if (!newEntries(sizeClass, entriesOffset))
+		{
+			YADECAP_LOG_WARNING("lpm is full\n");
+			return eResult::isFull;
+		}
+
+		uint32_t nodeId;
+		if (!newNode(nodeId))
+		{
+			freeEntries(sizeClass, entriesOffset);
+
+			YADECAP_LOG_WARNING("lpm is full\n");
+			return eResult::isFull;
+		}
+
+		tNode& node = nodes[nodeId];
+		journal_t::touch(&node, sizeof(node));
+		journal_t::touch(&entries[entriesOffset], sizeof(tEntry) << sizeClass);
+
+		memset(&node, 0, sizeof(node));
+		node.entriesOffset = entriesOffset;
+		node.sizeClass = sizeClass;
+
+		uint32_t run_i = 0;
+		for (unsigned int entry_i = 0;
+		     entry_i < 256;
+		     entry_i++)
+		{
+			if (entry_i % 64 == 0)
+			{
+				node.ranks[entry_i / 64] = run_i;
+			}
+
+			if (entry_i == 0 ||
+			    expanded[entry_i].atomic != expanded[entry_i - 1].atomic)
+			{
+				node.bitmap[entry_i / 64] |= ((uint64_t)1) << (entry_i % 64);
+				entries[entriesOffset + run_i].atomic = expanded[entry_i].atomic;
+				run_i++;
+			}
+		}
+
+		garbage.allocated.emplace_back(nodeId);
+
+		result.atomic = 0;
+		result.flags = flagExtended;
+		result.extendedChunkId = nodeId;
+		return eResult::success;
+	}
+
+	/// byte of address covering /depth + 8
+	static uint8_t byteOf(const uint32_t& ipAddress,
+	                      const uint8_t depth)
+	{
+		return ipAddress >> (24 - depth);
+	}
+
+	static uint8_t byteOf(const std::array<uint8_t, 16>& ipv6Address,
+	                      const uint8_t depth)
+	{
+		return ipv6Address[depth / 8];
+	}
+
+	/// build new node for 'entry' (covers /depth) with prefix applied
+	template<typename TAddress>
+	eResult updateNode(const tEntry entry,
+	                   const uint8_t depth,
+	                   const TAddress& address,
+	                   const uint8_t& mask,
+	                   const tEntry& newEntry,
+	                   tEntry& result,
+	                   garbage_t& garbage)
+	{
+		tEntry expanded[256];
+		expand(entry, expanded);
+
+		const uint8_t byte = byteOf(address, depth);
+
+		if (mask <= depth + 8)
+		{
+			const unsigned int count = ((unsigned int)1) << (depth + 8 - mask);
+			const unsigned int from = byte & ~(count - 1);
+
+			for (unsigned int entry_i = from;
+			     entry_i < from + count;
+			     entry_i++)
+			{
+				if (expanded[entry_i].flags & flagExtended)
+				{
+					garbage.trees.emplace_back((uint32_t)expanded[entry_i].extendedChunkId);
+				}
+
+				expanded[entry_i].atomic = newEntry.atomic;
+			}
+		}
+		else
+		{
+			eResult eresult = updateNode(expanded[byte],
+			                             depth + 8,
+			                             address,
+			                             mask,
+			                             newEntry,
+			                             expanded[byte],
+			                             garbage);
+			if (eresult != eResult::success)
+			{
+				return eresult;
+			}
+		}
+
+		if (entry.flags & flagExtended)
+		{
+			garbage.nodes.emplace_back((uint32_t)entry.extendedChunkId);
+		}
+
+		return compress(expanded, result, garbage);
+	}
+
+	static void updateEntry(tEntry& entry,
+	                        const tEntry& newEntry)
+	{
+		journal_t::touch(&entry, sizeof(entry));
+
+		YADECAP_MEMORY_BARRIER_COMPILE;
+
+		entry.atomic = newEntry.atomic;
+	}
+
+	template<typename TAddress>
+	eResult update(const TAddress& address,
+	               const uint8_t& mask,
+	               const tEntry& newEntry,
+	               bool* needWait)
+	{
+		if (needWait)
+		{
+			*needWait = false;
+		}
+
+		const uint32_t root_i = (((uint32_t)byteOf(address, 0)) << 8) | byteOf(address, 8);
+
+		if (mask <= 16)
+		{
+			const uint32_t count = ((uint32_t)1) << (16 - mask);
+			const uint32_t from = root_i & ~(count - 1);
+
+			for (uint32_t entry_i = from;
+			     entry_i < from + count;
+			     entry_i++)
+			{
+				const tEntry entry = rootChunk.entries[entry_i];
+
+				updateEntry(rootChunk.entries[entry_i], newEntry);
+
+				if (entry.flags & flagExtended)
+				{
+					freeTree(entry.extendedChunkId);
+
+					if (needWait)
+					{
+						*needWait = true;
+					}
+				}
+			}
+
+			return eResult::success;
+		}
+
+		tEntry& rootEntry = rootChunk.entries[root_i];
+
+		garbage_t garbage;
+		tEntry entry;
+		eResult result = updateNode(rootEntry,
+		                            16,
+		                            address,
+		                            mask,
+		                            newEntry,
+		                            entry,
+		                            garbage);
+		if (result != eResult::success)
+		{
+			for (const auto& nodeId : garbage.allocated)
+			{
+				freeNode(nodeId);
+			}
+
+			return result;
+		}
+
+		updateEntry(rootEntry, entry);
+
+		for (const auto& nodeId : garbage.nodes)
+		{
+			freeNode(nodeId);
+		}
+
+		for (const auto& nodeId : garbage.trees)
+		{
+			freeTree(nodeId);
+		}
+
+		if (needWait &&
+		    (garbage.nodes.size() || garbage.trees.size()))
+		{
+			*needWait = true;
+		}
+
+		return eResult::success;
+	}
+
+protected:
+	tChunk16 rootChunk;
+	tNode nodes[TExtendedSize];
+	tEntry entries[TEntriesSize];
+} __rte_aligned(RTE_CACHE_LINE_SIZE);
+
+/// ipv4 lpm with 16 bit root and two 8 bit levels (dir-16-8-8).
+/// root takes 256 KB instead of 64 MB of lpm4_24bit_8bit_atomic
+template<uint32_t TExtendedSize, ///< nodes
+         uint32_t TEntriesSize>
+class lpm4_16bit_2x8bit_compressed : public lpm_16bit_8bit_compressed<TExtendedSize, TEntriesSize>
+{
+public:
+	eResult insert(const uint32_t& ipAddress,
+	               const uint8_t& mask,
+	               const uint32_t& valueId,
+	               bool* needWait = nullptr)
+	{
+		if (mask > 32 ||
+		    valueId & 0xFF000000)
+		{
+			YADECAP_LOG_DEBUG("invalid prefix or value\n");
+			return eResult::invalidArguments;
+		}
+
+		tEntry entry;
+		entry.atomic = 0;
+		entry.flags = flagValid;
+		entry.valueId = valueId;
+
+		return this->update(ipAddress, mask, entry, needWait);
+	}
+
+	eResult remove(const uint32_t& ipAddress,
+	               const uint8_t& mask,
+	               bool* needWait = nullptr)
+	{
+		if (mask > 32)
+		{
+			YADECAP_LOG_DEBUG("invalid prefix\n");
+			return eResult::invalidArguments;
+		}
+
+		tEntry entry;
+		entry.atomic = 0;
+
+		return this->update(ipAddress, mask, entry, needWait);
+	}
+
+	inline void lookup(const uint32_t* ipAddresses,
+	                   uint32_t* valueIds,
+	                   const unsigned int& count) const
+	{
+		for (unsigned int ipAddress_i = 0;
+		     ipAddress_i < count;
+		     ipAddress_i += CONFIG_YADECAP_MBUFS_BURST_SIZE)
+		{
+			lookupBurst(ipAddresses + ipAddress_i,
+			            valueIds + ipAddress_i,
+			            RTE_MIN(count - ipAddress_i, (unsigned int)CONFIG_YADECAP_MBUFS_BURST_SIZE));
+		}
+	}
+
+	template<unsigned int TOffset>
+	inline void lookup(rte_mbuf** mbufs,
+	                   uint32_t* valueIds,
+	                   const unsigned int& count) const
+	{
+		uint32_t ipAddresses[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+
+		for (unsigned int mbuf_i = 0;
+		     mbuf_i < count;
+		     mbuf_i++)
+		{
+			const rte_mbuf* mbuf = mbufs[mbuf_i];
+			dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+
+			ipAddresses[mbuf_i] = *(rte_pktmbuf_mtod_offset(mbuf, const uint32_t*, metadata->network_headerOffset + TOffset));
+		}
+
+		lookup(ipAddresses, valueIds, count);
+	}
+
+	inline bool lookup(const uint32_t& ipAddress,
+	                   uint32_t* valueId = nullptr) const
+	{
+		uint32_t lvalueId;
+
+		lookup(&ipAddress, &lvalueId, 1);
+
+		if (valueId)
+		{
+			*valueId = lvalueId;
+		}
+
+		if (lvalueId != lpmValueIdInvalid)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+protected:
+	using base_t = lpm_16bit_8bit_compressed<TExtendedSize, TEntriesSize>;
+	using tEntry = typename base_t::tEntry;
+	using base_t::flagExtended;
+	using base_t::flagValid;
+
+	/// each level is done for whole burst before next one, so cache misses of different addresses overlap
+	inline void lookupBurst(const uint32_t* ipAddresses,
+	                        uint32_t* valueIds,
+	                        const unsigned int count) const
+	{
+		uint32_t addresses[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+		tEntry burstEntries[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+		uint32_t entryIds[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+
+		for (unsigned int ipAddress_i = 0;
+		     ipAddress_i < count;
+		     ipAddress_i++)
+		{
+			addresses[ipAddress_i] = rte_be_to_cpu_32(ipAddresses[ipAddress_i]);
+			burstEntries[ipAddress_i].atomic = this->rootChunk.entries[addresses[ipAddress_i] >> 16].atomic;
+
+			if (burstEntries[ipAddress_i].flags & flagExtended)
+			{
+				rte_prefetch0(&this->nodes[burstEntries[ipAddress_i].atomic >> 8]);
+			}
+		}
+
+		for (unsigned int ipAddress_i = 0;
+		     ipAddress_i < count;
+		     ipAddress_i++)
+		{
+			if (burstEntries[ipAddress_i].flags & flagExtended)
+			{
+				///                     = lookupNode(entry.extendedChunkId, ...);
+				entryIds[ipAddress_i] = this->lookupNode(burstEntries[ipAddress_i].atomic >> 8, (addresses[ipAddress_i] >> 8) & 0xFF);
+				rte_prefetch0(&this->entries[entryIds[ipAddress_i]]);
+			}
+		}
+
+		for (unsigned int ipAddress_i = 0;
+		     ipAddress_i < count;
+		     ipAddress_i++)
+		{
+			tEntry entry = burstEntries[ipAddress_i];
+
+			if (entry.flags & flagExtended)
+			{
+				entry.atomic = this->entries[entryIds[ipAddress_i]].atomic;
+
+				if (entry.flags & flagExtended)
+				{
+					/// longer than /24, rare
+					entry.atomic = this->entries[this->lookupNode(entry.atomic >> 8, addresses[ipAddress_i] & 0xFF)].atomic;
+				}
+			}
+
+			if (entry.flags & flagValid)
+			{
+				///                   = entry.valueId;
+				valueIds[ipAddress_i] = entry.atomic >> 8;
+			}
+			else
+			{
+				valueIds[ipAddress_i] = lpmValueIdInvalid;
+			}
+		}
+	}
+};
+
+/// ipv6 lpm with 16 bit root and up to fourteen 8 bit levels.
+/// full view takes tens of megabytes instead of 256 KB per extended chunk of lpm6_8x16bit_atomic
+template<uint32_t TExtendedSize, ///< nodes
+         uint32_t TEntriesSize>
+class lpm6_16bit_14x8bit_compressed : public lpm_16bit_8bit_compressed<TExtendedSize, TEntriesSize>
+{
+public:
+	eResult insert(const std::array<uint8_t, 16>& ipv6Address,
+	               const uint8_t& mask,
+	               const uint32_t& valueId,
+	               bool* needWait = nullptr)
+	{
+		if (mask > 128 ||
+		    valueId & 0xFF000000)
+		{
+			YADECAP_LOG_DEBUG("invalid prefix or value\n");
+			return eResult::invalidArguments;
+		}
+
+		tEntry entry;
+		entry.atomic = 0;
+		entry.flags = flagValid;
+		entry.valueId = valueId;
+
+		return this->update(ipv6Address, mask, entry, needWait);
+	}
+
+	eResult remove(const std::array<uint8_t, 16>& ipv6Address,
+	               const uint8_t& mask,
+	               bool* needWait = nullptr)
+	{
+		if (mask > 128)
+		{
+			YADECAP_LOG_DEBUG("invalid prefix\n");
+			return eResult::invalidArguments;
+		}
+
+		tEntry entry;
+		entry.atomic = 0;
+
+		return this->update(ipv6Address, mask, entry, needWait);
+	}
+
+	inline void lookup(const ipv6_address_t* ipv6Addresses,
+	                   uint32_t* valueIds,
+	                   const unsigned int& count) const
+	{
+		for (unsigned int ipv6Address_i = 0;
+		     ipv6Address_i < count;
+		     ipv6Address_i += CONFIG_YADECAP_MBUFS_BURST_SIZE)
+		{
+			lookupBurst(ipv6Addresses + ipv6Address_i,
+			            valueIds + ipv6Address_i,
+			            RTE_MIN(count - ipv6Address_i, (unsigned int)CONFIG_YADECAP_MBUFS_BURST_SIZE));
+		}
+	}
+
+	template<unsigned int TOffset>
+	inline void lookup(rte_mbuf** mbufs,
+	                   uint32_t* valueIds,
+	                   const unsigned int& count) const
+	{
+		ipv6_address_t ipv6Addresses[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+
+		for (unsigned int mbuf_i = 0;
+		     mbuf_i < count;
+		     mbuf_i++)
+		{
+			const rte_mbuf* mbuf = mbufs[mbuf_i];
+			dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+
+			memcpy(ipv6Addresses[mbuf_i].bytes,
+			       rte_pktmbuf_mtod_offset(mbuf, const void*, metadata->network_headerOffset + TOffset),
+			       16);
+		}
+
+		lookup(ipv6Addresses, valueIds, count);
+	}
+
+	inline bool lookup(const std::array<uint8_t, 16>& ipv6Address,
+	                   uint32_t* valueId = nullptr) const
+	{
+		return lookup(ipv6Address.data(), valueId);
+	}
+
+	inline bool lookup(const uint8_t* ipv6_address,
+	                   uint32_t* value_id = nullptr) const
+	{
+		ipv6_address_t lipv6Address;
+		uint32_t lvalueId;
+
+		memcpy(lipv6Address.bytes, ipv6_address, 16);
+		lookup(&lipv6Address, &lvalueId, 1);
+
+		if (value_id)
+		{
+			*value_id = lvalueId;
+		}
+
+		if (lvalueId != lpmValueIdInvalid)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+protected:
+	using base_t = lpm_16bit_8bit_compressed<TExtendedSize, TEntriesSize>;
+	using tEntry = typename base_t::tEntry;
+	using base_t::flagExtended;
+	using base_t::flagValid;
+
+	/// each level is done for whole burst before next one, so cache misses of different addresses overlap.
+	/// addresses which reached value drop out, so deep levels cost only for long prefixes
+	inline void lookupBurst(const ipv6_address_t* ipv6Addresses,
+	                        uint32_t* valueIds,
+	                        const unsigned int count) const
+	{
+		tEntry burstEntries[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+		uint32_t entryIds[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+		uint8_t walking[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+		unsigned int walkingCount = 0;
+
+		for (unsigned int ipv6Address_i = 0;
+		     ipv6Address_i < count;
+		     ipv6Address_i++)
+		{
+			const uint8_t* bytes = ipv6Addresses[ipv6Address_i].bytes;
+
+			burstEntries[ipv6Address_i].atomic = this->rootChunk.entries[(((uint32_t)bytes[0]) << 8) | bytes[1]].atomic;
+
+			if (burstEntries[ipv6Address_i].flags & flagExtended)
+			{
+				rte_prefetch0(&this->nodes[burstEntries[ipv6Address_i].atomic >> 8]);
+				walking[walkingCount++] = ipv6Address_i;
+			}
+		}
+
+		for (unsigned int byte_i = 2;
+		     walkingCount;
+		     byte_i++)
+		{
+			for (unsigned int walking_i = 0;
+			     walking_i < walkingCount;
+			     walking_i++)
+			{
+				const unsigned int ipv6Address_i = walking[walking_i];
+
+				///                     = lookupNode(entry.extendedChunkId, ...);
+				entryIds[ipv6Address_i] = this->lookupNode(burstEntries[ipv6Address_i].atomic >> 8, ipv6Addresses[ipv6Address_i].bytes[byte_i]);
+				rte_prefetch0(&this->entries[entryIds[ipv6Address_i]]);
+			}
+
+			unsigned int nextWalkingCount = 0;
+			for (unsigned int walking_i = 0;
+			     walking_i < walkingCount;
+			     walking_i++)
+			{
+				const unsigned int ipv6Address_i = walking[walking_i];
+
+				burstEntries[ipv6Address_i].atomic = this->entries[entryIds[ipv6Address_i]].atomic;
+
+				if (burstEntries[ipv6Address_i].flags & flagExtended)
+				{
+					rte_prefetch0(&this->nodes[burstEntries[ipv6Address_i].atomic >> 8]);
+					walking[nextWalkingCount++] = ipv6Address_i;
+				}
+			}
+
+			walkingCount = nextWalkingCount;
+		}
+
+		for (unsigned int ipv6Address_i = 0;
+		     ipv6Address_i < count;
+		     ipv6Address_i++)
+		{
+			if (burstEntries[ipv6Address_i].flags & flagValid)
+			{
+				///                     = entry.valueId;
+				valueIds[ipv6Address_i] = burstEntries[ipv6Address_i].atomic >> 8;
+			}
+			else
+			{
+				valueIds[ipv6Address_i] = lpmValueIdInvalid;
+			}
+		}
+	}
+};
+
+//
+
+template<uint32_t TExtendedSize>
+class lpm6_8x16bit_atomic
+{
+public:
+	lpm6_8x16bit_atomic()
+	{
+		extendedChunksCount = 0;
+		maxUsedChunkId = 0;
+		freeChunkCache.flags = 0;
+	}
+
+	static std::array<uint8_t, 16> createMask(uint8_t ones)
+	{
+		std::array<uint8_t, 16> maskBuf;
+		for (int i = 0; i < 16; i++)
+		{
+			if (ones >= 8)
+			{
+				maskBuf[i] = 0xFF;
+				ones -= 8;
+				continue;
+			}
+
+			maskBuf[i] = ~(0xFF >> ones);
+			ones = 0;
+		}
+
+		return maskBuf;
+	}
+
+	/// Insertion order matters!
+	eResult insert(const std::array<uint8_t, 16>& ipv6Address,
+	               const uint8_t& mask,
+	               const uint32_t& valueId,
+	               bool* needWait = nullptr)
+	{
+		if (mask > 128 ||
+		    valueId & 0xFF000000)
+		{
+			YADECAP_LOG_DEBUG("invalid prefix or value\n");
+			return eResult::invalidArguments;
+		}
+
+		if (needWait)
+		{
+			*needWait = false;
+		}
+
+		return insertStep(ipv6Address,
+		                  mask,
+		                  valueId,
+		                  needWait,
+		                  0,
+		                  rootChunk);
+	}
+
+	eResult insert(const std::array<uint8_t, 16>& ipv6Address,
+	               const std::array<uint8_t, 16>& mask,
+	               const uint32_t& valueId)
+	{
+		if (valueId & 0xFF000000)
+		{
+			YADECAP_LOG_DEBUG("invalid value\n");
+			return eResult::invalidArguments;
+		}
+
+		return insertStep(ipv6Address,
+		                  mask,
+		                  valueId,
+		                  0,
+		                  false,
+		                  rootChunk);
+	}
+
+	eResult remove(const std::array<uint8_t, 16>& ipv6Address,
+	               const uint8_t& mask,
+	               bool* needWait = nullptr)
+	{
+		if (mask > 128)
+		{
+			YADECAP_LOG_DEBUG("invalid prefix\n");
+			return eResult::invalidArguments;
+		}
+
+		if (needWait)
+		{
+			*needWait = false;
+		}
+
+		return removeStep(ipv6Address,
+		                  mask,
+		                  needWait,
+		                  0,
+		                  rootChunk);
+	}
+
+	eResult remove(const std::array<uint8_t, 16>& ipv6Address,
+	               const std::array<uint8_t, 16>& mask)
+	{
+		return removeStep(ipv6Address, mask, 0, false, rootChunk);
+	}
+
+	void clear()
+	{
+		journal_t::touch(&rootChunk, sizeof(rootChunk));
+		journal_header();
+
+		this->rootChunk = {};
+		extendedChunksCount = 0;
+		maxUsedChunkId = 0;
+		freeChunkCache.flags = 0;
+	}
+
+	inline void lookup(const ipv6_address_t* ipv6Addresses,
+	                   uint32_t* valueIds,
+	                   const unsigned int& count) const
+	{
+		/// @todo: OPT: le -> be
+
+		for (unsigned int ipv6Address_i = 0;
+		     ipv6Address_i < count;
+		     ipv6Address_i++)
+		{
+			const ipv6_address_t& ipv6Address = ipv6Addresses[ipv6Address_i];
+			const tChunk* currentChunk = &rootChunk;
+
+			valueIds[ipv6Address_i] = lpmValueIdInvalid;
+
+			for (unsigned int step = 0;
+			     step < 8;
+			     step++)
+			{
+				uint16_t entry_i = rte_be_to_cpu_16(*(((uint16_t*)ipv6Address.bytes) + step));
+
+				tEntry entry;
+				entry.atomic = currentChunk->entries[entry_i].atomic;
+
+				if (entry.flags & flagValid)
+				{
+					///                     = entry.valueId;
+					valueIds[ipv6Address_i] = entry.atomic >> 8;
+					break;
+				}
+				else if (entry.flags & flagExtended)
+				{
+					///          = &extendedChunks[entry.extendedChunkId];
+					currentChunk = &extendedChunks[entry.atomic >> 8];
+				}
+				else
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	constexpr static uint32_t mask_full = 0xFFFFFFFFu;
+
+	inline void lookup(const uint32_t mask,
+	                   const ipv6_address_t* ipv6Addresses,
+	                   uint32_t* valueIds,
+	                   const unsigned int& count) const
+	{
+		/// @todo: OPT: le -> be
+
+		if (mask == mask_full)
+		{
+			return;
+		}
+
+		for (unsigned int ipv6Address_i = 0;
+		     ipv6Address_i < count;
+		     ipv6Address_i++)
+		{
+			if (mask & (1u << ipv6Address_i))
+			{
+				continue;
+			}
+
+			const ipv6_address_t& ipv6Address = ipv6Addresses[ipv6Address_i];
+			const tChunk* currentChunk = &rootChunk;
+
+			valueIds[ipv6Address_i] = lpmValueIdInvalid;
+
+			for (unsigned int step = 0;
+			     step < 8;
+			     step++)
+			{
+				uint16_t entry_i = rte_be_to_cpu_16(*(((uint16_t*)ipv6Address.bytes) + step));
+
+				tEntry entry;
+				entry.atomic = currentChunk->entries[entry_i].atomic;
+
+				if (entry.flags & flagValid)
+				{
+					///                     = entry.valueId;
+					valueIds[ipv6Address_i] = entry.atomic >> 8;
+					break;
+				}
 				else if (entry.flags & flagExtended)
 				{
 					///          = &extendedChunks[entry.extendedChunkId];
@@ -910,6 +1841,17 @@ public:
 		return result;
 	}
 
+	template<typename list_T> ///< @todo: common::idp::limits::response
+	void limits(list_T& list,
+	            const std::string& name,
+	            const std::optional<unsigned int>& socket_id) const
+	{
+		list.emplace_back(name + ".extended_chunks",
+		                  socket_id,
+		                  extendedChunksCount,
+		                  TExtendedSize);
+	}
+
 protected:
 	constexpr static uint8_t flagExtended = 1 << 0;
 	constexpr static uint8_t flagValid = 1 << 1;
@@ -948,12 +1890,22 @@ protected:
 	uint32_t extendedChunksCount;
 	tEntry freeChunkCache;
 
+	/// record writes of chunk allocator state (see journal_t)
+	void journal_header()
+	{
+		journal_t::touch(&extendedChunksCount, sizeof(extendedChunksCount));
+		journal_t::touch(&maxUsedChunkId, sizeof(maxUsedChunkId));
+		journal_t::touch(&freeChunkCache, sizeof(freeChunkCache));
+	}
+
 	bool newExtendedChunk(uint32_t& extendedChunkId, uint16_t ownerMaskHextet)
 	{
 		if (freeChunkCache.flags & flagExtended)
 		{
 			extendedChunkId = freeChunkCache.extendedChunkId;
 			tChunk& extendedChunk = extendedChunks[extendedChunkId];
+			journal_t::touch(&extendedChunk, sizeof(extendedChunk));
+			journal_header();
 			freeChunkCache.flags = extendedChunk.entries[0].flags;
 			freeChunkCache.extendedChunkId = extendedChunk.entries[0].extendedChunkId;
 			memset(&extendedChunk.entries[0], 0, sizeof(extendedChunk.entries));
@@ -964,9 +1916,11 @@ protected:
 		}
 		else if (maxUsedChunkId < TExtendedSize)
 		{
+			journal_header();
 			extendedChunkId = maxUsedChunkId++;
 
 			tChunk& extendedChunk = extendedChunks[extendedChunkId];
+			journal_t::touch(&extendedChunk, sizeof(extendedChunk));
 			memset(&extendedChunk.entries[0], 0, sizeof(extendedChunk.entries));
 			extendedChunk.entries[0].flags |= flagExtendedChunkOccupied;
 			extendedChunk.ownerMaskHextet = ownerMaskHextet;
@@ -995,6 +1949,9 @@ protected:
 			}
 		}
 
+		journal_t::touch(&extendedChunk.entries[0], sizeof(extendedChunk.entries[0]));
+		journal_header();
+
 		extendedChunk.entries[0].flags = freeChunkCache.flags;
 		extendedChunk.entries[0].extendedChunkId = freeChunkCache.extendedChunkId;
 
@@ -1012,6 +1969,8 @@ protected:
 		newEntry.flags |= entry.flags & flagExtendedChunkOccupied;
 		newEntry.valueId = value;
 
+		journal_t::touch(&entry, sizeof(entry));
+
 		YADECAP_MEMORY_BARRIER_COMPILE;
 
 		entry.atomic = newEntry.atomic;
@@ -1020,6 +1979,8 @@ protected:
 	static void updateAllEntries(tChunk& chunk,
 	                             const tEntry& entry)
 	{
+		journal_t::touch(&chunk.entries[0], sizeof(chunk.entries));
+
 		YADECAP_MEMORY_BARRIER_COMPILE;
 
 		uint8_t flag = chunk.entries[0].flags & flagExtendedChunkOccupied;
@@ -22,7 +22,7 @@ struct metadata
 	uint16_t transport_headerOffset;
 	uint16_t transport_flags;
 	uint16_t payload_length;
-	uint32_t hash;
+	uint32_t hash; ///< cached by cWorker::preparePacket()
 	uint32_t flowLabel; ///< @todo: union
 	uint8_t repeat_ttl;
 	uint8_t already_early_decapped;
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/config.h"
+
+#include "type.h"
+
+namespace dataplane::nat64stateful
+{
+
+/// port-block mode: first state of ipv6 source takes block of 'port_block_size' ports of one pool address,
+/// following states of source take ports of its block in turn.
+///
+/// port space of numa is ports 1024-65535 with numa id in low bits: port = (port_index << numa_shift) | numa_id
+class port_space_t
+{
+public:
+	port_space_t(const uint32_t numa_shift,
+	             const uint32_t numa_id,
+	             const uint32_t port_block_size) :
+	        numa_shift(numa_shift),
+	        numa_id(numa_id),
+	        port_index_begin((1024 + (1u << numa_shift) - 1) >> numa_shift),
+	        port_index_end(0x10000 >> numa_shift),
+	        ports_count(std::min(port_block_size, port_index_end - port_index_begin)),
+	        blocks_count((port_index_end - port_index_begin) / ports_count)
+	{
+	}
+
+	/// first port index of block
+	uint32_t block_port_index(const uint32_t block_id) const
+	{
+		return port_index_begin + block_id % blocks_count * ports_count;
+	}
+
+	/// host byte order
+	uint16_t port(const uint32_t port_index) const
+	{
+		return (port_index << numa_shift) | numa_id;
+	}
+
+public:
+	const uint32_t numa_shift;
+	const uint32_t numa_id;
+	const uint32_t port_index_begin;
+	const uint32_t port_index_end;
+	const uint32_t ports_count;
+	const uint32_t blocks_count;
+};
+
+enum class block_lookup_result_t
+{
+	found,
+	inserted,
+	insert_failed
+};
+
+/// looks up block of source, on first state of source takes free block of pool.
+/// 'pool_address(try_i)' returns ipv4 address of pool for try.
+/// on success block_value is locked by block_locker
+template<typename lan_block_ht,
+         typename wan_block_ht,
+         typename pool_address_T>
+inline block_lookup_result_t block_lookup(lan_block_ht* lan_block,
+                                          wan_block_ht* wan_block,
+                                          const globalBase::nat64stateful_lan_block_key& block_key,
+                                          const uint32_t client_hash,
+                                          const port_space_t& space,
+                                          const pool_address_T& pool_address,
+                                          const uint16_t current_time,
+                                          globalBase::nat64stateful_lan_block_value*& block_value,
+                                          typename lan_block_ht::locker_t*& block_locker)
+{
+	const uint32_t block_hash = lan_block->lookup(block_key, block_value, block_locker);
+	if (block_value)
+	{
+		return block_lookup_result_t::found;
+	}
+
+	/// block is taken once, so probes of blocks don't depend on states
+	globalBase::nat64stateful_wan_block_key owner_key;
+	owner_key.nat64stateful_id = block_key.nat64stateful_id;
+	owner_key.nap = 0;
+	owner_key.nap2 = 0;
+
+	globalBase::nat64stateful_wan_block_value owner_value;
+	owner_value.ipv6_source = block_key.ipv6_source;
+
+	bool owner_insert_success = false;
+	for (unsigned int try_i = 0;
+	     try_i < YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES;
+	     try_i++)
+	{
+		owner_key.ipv4_address = pool_address(try_i);
+		owner_key.port_index = space.block_port_index((client_hash >> 16) + try_i);
+
+		globalBase::nat64stateful_wan_block_value* owner_value_lookup;
+		typename wan_block_ht::locker_t* owner_locker;
+		const uint32_t owner_hash = wan_block->lookup(owner_key, owner_value_lookup, owner_locker);
+		if (!owner_value_lookup)
+		{
+			owner_insert_success = wan_block->insert(owner_hash, owner_key, owner_value);
+			owner_locker->unlock();
+			break;
+		}
+		owner_locker->unlock();
+	}
+
+	if (!owner_insert_success)
+	{
+		block_locker->unlock();
+		return block_lookup_result_t::insert_failed;
+	}
+
+	globalBase::nat64stateful_lan_block_value block_value_new;
+	block_value_new.ipv4_address = owner_key.ipv4_address;
+	block_value_new.port_index = owner_key.port_index;
+	block_value_new.ports_count = space.ports_count;
+	block_value_new.cursor = 0;
+	block_value_new.timestamp_last_packet = current_time;
+	block_value_new.states_count = 0;
+
+	const bool insert_success = lan_block->insert(block_hash, block_key, block_value_new);
+	block_locker->unlock();
+
+	if (!insert_success)
+	{
+		wan_block->remove(owner_key);
+		return block_lookup_result_t::insert_failed;
+	}
+
+	/// gc doesn't release block without states till timeout
+	lan_block->lookup(block_key, block_value, block_locker);
+	if (!block_value)
+	{
+		block_locker->unlock();
+		return block_lookup_result_t::insert_failed;
+	}
+
+	return block_lookup_result_t::inserted;
+}
+
+/// takes next free port of block for wan_key: ports of block are taken in turn,
+/// port is shared by states with different destinations.
+/// returns number of try, or YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES if block is full.
+/// on success wan_key is locked by wan_locker
+template<typename wan_ht>
+inline unsigned int block_port(wan_ht* wan_state,
+                               globalBase::nat64stateful_lan_block_value& block_value,
+                               const port_space_t& space,
+                               globalBase::nat64stateful_wan_key& wan_key,
+                               uint32_t& wan_hash,
+                               typename wan_ht::locker_t*& wan_locker)
+{
+	wan_key.ipv4_destination = block_value.ipv4_address;
+	for (unsigned int try_i = 0;
+	     try_i < YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES;
+	     try_i++)
+	{
+		const uint32_t port_index = block_value.port_index + block_value.cursor;
+		block_value.cursor = (block_value.cursor + 1) % block_value.ports_count;
+
+		wan_key.port_destination = rte_cpu_to_be_16(space.port(port_index));
+
+		globalBase::nat64stateful_wan_value* wan_value_lookup;
+		wan_hash = wan_state->lookup(wan_key, wan_value_lookup, wan_locker);
+		if (!wan_value_lookup)
+		{
+			return try_i;
+		}
+		wan_locker->unlock();
+	}
+
+	return YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES;
+}
+
+/// state of port 'port_index' leaves block of its source
+inline void block_state_remove(globalBase::nat64stateful_lan_block_value& block_value,
+                               const ipv4_address_t& ipv4_address,
+                               const uint32_t port_index,
+                               const uint16_t current_time)
+{
+	if (block_value.states_count &&
+	    block_value.ipv4_address == ipv4_address &&
+	    port_index >= block_value.port_index &&
+	    port_index < (uint32_t)block_value.port_index + block_value.ports_count)
+	{
+		block_value.states_count--;
+		block_value.timestamp_last_packet = current_time;
+	}
+}
+
+/// block is released after YANET_CONFIG_NAT64STATEFUL_PORT_BLOCK_TIMEOUT since its last state
+inline bool block_is_expired(const globalBase::nat64stateful_lan_block_value& block_value,
+                             const uint32_t last_seen)
+{
+	return !block_value.states_count &&
+	       last_seen > YANET_CONFIG_NAT64STATEFUL_PORT_BLOCK_TIMEOUT;
+}
+
+inline globalBase::nat64stateful_wan_block_key block_owner_key(const globalBase::nat64stateful_lan_block_key& block_key,
+                                                               const globalBase::nat64stateful_lan_block_value& block_value)
+{
+	globalBase::nat64stateful_wan_block_key owner_key;
+	owner_key.nat64stateful_id = block_key.nat64stateful_id;
+	owner_key.nap = 0;
+	owner_key.ipv4_address = block_value.ipv4_address;
+	owner_key.port_index = block_value.port_index;
+	owner_key.nap2 = 0;
+	return owner_key;
+}
+
+}
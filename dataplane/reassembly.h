@@ -0,0 +1,505 @@
+#pragma once
+
+#include <inttypes.h>
+#include <memory.h>
+
+#include <array>
+#include <vector>
+
+#include <rte_hash_crc.h>
+
+namespace dataplane
+{
+
+/// fixed-capacity table of fragmented packets. memory is allocated only in constructor.
+/// flows are found by open addressing (linear probing, backward shift deletion),
+/// expired by timer wheel with one second granularity.
+/// fragments of flow are kept in intrusive list sorted by range_from
+template<typename TKey,
+         typename TPacket>
+class reassembly_t
+{
+public:
+	constexpr static uint32_t invalid_id = 0xFFFFFFFF;
+	constexpr static uint32_t range_to_last = 0xFFFFFFFF; ///< range_to of last fragment
+	constexpr static uint32_t wheel_size = 256;
+
+	enum class result_e : uint8_t
+	{
+		inserted,
+		collected, ///< all fragments of flow are inserted, call pop()
+		overflow, ///< no free fragments or flows
+		flow_overflow, ///< too many fragments in flow
+		intersect,
+	};
+
+	reassembly_t(const uint32_t size,
+	             const uint32_t packets_per_flow,
+	             const uint32_t timeout_first,
+	             const uint32_t timeout_last) :
+	        packets_per_flow(packets_per_flow),
+	        timeout_first(timeout_first),
+	        timeout_last(timeout_last),
+	        flows(size ? size : 1),
+	        fragments(size ? size : 1),
+	        wheel_time(0),
+	        wheel_started(false),
+	        packets_count(0),
+	        flows_count(0)
+	{
+		uint32_t index_size = 1;
+		while (index_size < 2 * flows.size())
+		{
+			index_size <<= 1;
+		}
+
+		index.resize(index_size, {0, invalid_id});
+		index_mask = index_size - 1;
+
+		for (uint32_t flow_id = 0;
+		     flow_id < flows.size();
+		     flow_id++)
+		{
+			flows[flow_id].wheel_next = flow_id + 1;
+		}
+		flows.back().wheel_next = invalid_id;
+		flows_free = 0;
+
+		for (uint32_t fragment_id = 0;
+		     fragment_id < fragments.size();
+		     fragment_id++)
+		{
+			fragments[fragment_id].next = fragment_id + 1;
+		}
+		fragments.back().next = invalid_id;
+		fragments_free = 0;
+
+		wheel.fill(invalid_id);
+	}
+
+	/// on success packet is owned by table
+	result_e insert(const TKey& key,
+	                const uint32_t range_from,
+	                const uint32_t range_to,
+	                TPacket packet,
+	                const uint32_t current_time,
+	                uint32_t& flow_id)
+	{
+		if (!wheel_started)
+		{
+			wheel_time = current_time;
+			wheel_started = true;
+		}
+
+		const uint32_t hash = rte_hash_crc(&key, sizeof(TKey), 0);
+
+		flow_id = lookup(key, hash);
+		if (flow_id == invalid_id)
+		{
+			if (flows_free == invalid_id ||
+			    fragments_free == invalid_id)
+			{
+				return result_e::overflow;
+			}
+
+			flow_id = flows_free;
+			flow_t& flow = flows[flow_id];
+			flows_free = flow.wheel_next;
+
+			memcpy(&flow.key, &key, sizeof(TKey));
+			flow.hash = hash;
+			flow.time_first = current_time;
+			flow.fragments_head = invalid_id;
+			flow.fragments_tail = invalid_id;
+			flow.fragments_count = 0;
+			flow.wheel_prev = invalid_id;
+			flow.wheel_next = invalid_id;
+			flow.wheel_slot = invalid_id;
+
+			index_insert(hash, flow_id);
+			flows_count++;
+		}
+		else
+		{
+			if (flows[flow_id].fragments_count > packets_per_flow)
+			{
+				return result_e::flow_overflow;
+			}
+
+			if (fragments_free == invalid_id)
+			{
+				return result_e::overflow;
+			}
+		}
+
+		flow_t& flow = flows[flow_id];
+
+		/// find position. list is sorted and has no intersections, so check only neighbors
+		uint32_t prev_id = invalid_id;
+		uint32_t next_id = flow.fragments_head;
+		while (next_id != invalid_id &&
+		       fragments[next_id].range_from < range_from)
+		{
+			prev_id = next_id;
+			next_id = fragments[next_id].next;
+		}
+
+		if ((prev_id != invalid_id && fragments[prev_id].range_to >= range_from) ||
+		    (next_id != invalid_id && fragments[next_id].range_from <= range_to))
+		{
+			return result_e::intersect;
+		}
+
+		const uint32_t fragment_id = fragments_free;
+		fragment_t& fragment = fragments[fragment_id];
+		fragments_free = fragment.next;
+
+		fragment.range_from = range_from;
+		fragment.range_to = range_to;
+		fragment.packet = packet;
+		fragment.next = next_id;
+
+		if (prev_id == invalid_id)
+		{
+			flow.fragments_head = fragment_id;
+		}
+		else
+		{
+			fragments[prev_id].next = fragment_id;
+		}
+
+		if (next_id == invalid_id)
+		{
+			flow.fragments_tail = fragment_id;
+		}
+
+		flow.fragments_count++;
+		packets_count++;
+
+		flow.time_last = current_time;
+		wheel_schedule(flow_id);
+
+		if (is_collected(flow))
+		{
+			return result_e::collected;
+		}
+
+		return result_e::inserted;
+	}
+
+	/// first fragment of flow
+	TPacket first(const uint32_t flow_id) const
+	{
+		return fragments[flows[flow_id].fragments_head].packet;
+	}
+
+	/// last fragment of flow
+	TPacket last(const uint32_t flow_id, uint32_t& range_from) const
+	{
+		const fragment_t& fragment = fragments[flows[flow_id].fragments_tail];
+		range_from = fragment.range_from;
+		return fragment.packet;
+	}
+
+	/// remove flow. callback(packet) is called in order of range_from
+	template<typename TCallback>
+	void pop(const uint32_t flow_id,
+	         const TCallback& callback)
+	{
+		flow_t& flow = flows[flow_id];
+
+		uint32_t fragment_id = flow.fragments_head;
+		while (fragment_id != invalid_id)
+		{
+			fragment_t& fragment = fragments[fragment_id];
+			const uint32_t next_id = fragment.next;
+
+			callback(fragment.packet);
+
+			fragment.next = fragments_free;
+			fragments_free = fragment_id;
+			packets_count--;
+
+			fragment_id = next_id;
+		}
+
+		wheel_unlink(flow_id);
+		index_remove(flow.key, flow.hash);
+
+		flow.wheel_next = flows_free;
+		flows_free = flow_id;
+		flows_count--;
+	}
+
+	/// remove flows with expired timeouts. callback(packet)
+	template<typename TCallback>
+	void expire(const uint32_t current_time,
+	            const TCallback& callback)
+	{
+		if (!wheel_started)
+		{
+			wheel_time = current_time;
+			wheel_started = true;
+		}
+
+		if ((int32_t)(current_time - wheel_time) < 0)
+		{
+			return;
+		}
+
+		uint32_t steps = current_time - wheel_time + 1;
+		if (steps > wheel_size)
+		{
+			steps = wheel_size;
+		}
+
+		for (uint32_t step_i = 0;
+		     step_i < steps;
+		     step_i++)
+		{
+			uint32_t flow_id = wheel[(wheel_time + step_i) % wheel_size];
+			while (flow_id != invalid_id)
+			{
+				const uint32_t next_id = flows[flow_id].wheel_next;
+
+				if ((int32_t)(current_time - deadline(flows[flow_id])) >= 0)
+				{
+					pop(flow_id, callback);
+				}
+
+				flow_id = next_id;
+			}
+		}
+
+		wheel_time = current_time + 1;
+	}
+
+	/// remove all flows. callback(packet)
+	template<typename TCallback>
+	void clear(const TCallback& callback)
+	{
+		for (uint32_t slot = 0;
+		     slot < wheel_size;
+		     slot++)
+		{
+			while (wheel[slot] != invalid_id)
+			{
+				pop(wheel[slot], callback);
+			}
+		}
+	}
+
+	uint32_t get_packets_count() const
+	{
+		return packets_count;
+	}
+
+	uint32_t get_flows_count() const
+	{
+		return flows_count;
+	}
+
+protected:
+	struct flow_t
+	{
+		TKey key;
+		uint32_t hash;
+		uint32_t time_first;
+		uint32_t time_last;
+		uint32_t fragments_head;
+		uint32_t fragments_tail;
+		uint32_t fragments_count;
+		uint32_t wheel_prev;
+		uint32_t wheel_next; ///< also next free flow
+		uint32_t wheel_slot;
+	};
+
+	struct fragment_t
+	{
+		uint32_t range_from;
+		uint32_t range_to;
+		TPacket packet;
+		uint32_t next; ///< also next free fragment
+	};
+
+	struct index_t
+	{
+		uint32_t hash;
+		uint32_t flow_id;
+	};
+
+	inline uint32_t deadline(const flow_t& flow) const
+	{
+		const uint32_t deadline_first = flow.time_first + timeout_first;
+		const uint32_t deadline_last = flow.time_last + timeout_last;
+		return (int32_t)(deadline_first - deadline_last) < 0 ? deadline_first : deadline_last;
+	}
+
+	inline bool is_collected(const flow_t& flow) const
+	{
+		if (fragments[flow.fragments_tail].range_to != range_to_last)
+		{
+			return false;
+		}
+
+		uint32_t next_range_from = 0;
+		uint32_t fragment_id = flow.fragments_head;
+		while (fragment_id != invalid_id)
+		{
+			const fragment_t& fragment = fragments[fragment_id];
+			if (fragment.range_from != next_range_from)
+			{
+				return false;
+			}
+
+			next_range_from = fragment.range_to + 1;
+			fragment_id = fragment.next;
+		}
+
+		return true;
+	}
+
+	inline uint32_t lookup(const TKey& key,
+	                       const uint32_t hash) const
+	{
+		for (uint32_t index_i = hash & index_mask;
+		     index[index_i].flow_id != invalid_id;
+		     index_i = (index_i + 1) & index_mask)
+		{
+			if (index[index_i].hash == hash &&
+			    !memcmp(&flows[index[index_i].flow_id].key, &key, sizeof(TKey)))
+			{
+				return index[index_i].flow_id;
+			}
+		}
+
+		return invalid_id;
+	}
+
+	inline void index_insert(const uint32_t hash,
+	                         const uint32_t flow_id)
+	{
+		uint32_t index_i = hash & index_mask;
+		while (index[index_i].flow_id != invalid_id)
+		{
+			index_i = (index_i + 1) & index_mask;
+		}
+
+		index[index_i] = {hash, flow_id};
+	}
+
+	inline void index_remove(const TKey& key,
+	                         const uint32_t hash)
+	{
+		uint32_t index_i = hash & index_mask;
+		while (index[index_i].hash != hash ||
+		       memcmp(&flows[index[index_i].flow_id].key, &key, sizeof(TKey)))
+		{
+			index_i = (index_i + 1) & index_mask;
+		}
+
+		/// backward shift, no tombstones
+		for (;;)
+		{
+			uint32_t next_i = (index_i + 1) & index_mask;
+			for (;;)
+			{
+				if (index[next_i].flow_id == invalid_id)
+				{
+					index[index_i].flow_id = invalid_id;
+					return;
+				}
+
+				const uint32_t ideal_i = index[next_i].hash & index_mask;
+				if (((next_i - ideal_i) & index_mask) >= ((next_i - index_i) & index_mask))
+				{
+					break;
+				}
+
+				next_i = (next_i + 1) & index_mask;
+			}
+
+			index[index_i] = index[next_i];
+			index_i = next_i;
+		}
+	}
+
+	inline void wheel_unlink(const uint32_t flow_id)
+	{
+		flow_t& flow = flows[flow_id];
+		if (flow.wheel_slot == invalid_id)
+		{
+			return;
+		}
+
+		if (flow.wheel_prev == invalid_id)
+		{
+			wheel[flow.wheel_slot] = flow.wheel_next;
+		}
+		else
+		{
+			flows[flow.wheel_prev].wheel_next = flow.wheel_next;
+		}
+
+		if (flow.wheel_next != invalid_id)
+		{
+			flows[flow.wheel_next].wheel_prev = flow.wheel_prev;
+		}
+
+		flow.wheel_prev = invalid_id;
+		flow.wheel_next = invalid_id;
+		flow.wheel_slot = invalid_id;
+	}
+
+	inline void wheel_schedule(const uint32_t flow_id)
+	{
+		flow_t& flow = flows[flow_id];
+
+		uint32_t time = deadline(flow);
+		if ((int32_t)(time - wheel_time) < 0)
+		{
+			/// already late, expire on next step
+			time = wheel_time;
+		}
+
+		const uint32_t slot = time % wheel_size;
+		if (flow.wheel_slot == slot)
+		{
+			return;
+		}
+
+		wheel_unlink(flow_id);
+
+		flow.wheel_slot = slot;
+		flow.wheel_prev = invalid_id;
+		flow.wheel_next = wheel[slot];
+		if (wheel[slot] != invalid_id)
+		{
+			flows[wheel[slot]].wheel_prev = flow_id;
+		}
+		wheel[slot] = flow_id;
+	}
+
+protected:
+	uint32_t packets_per_flow;
+	uint32_t timeout_first;
+	uint32_t timeout_last;
+
+	std::vector<flow_t> flows;
+	uint32_t flows_free;
+
+	std::vector<fragment_t> fragments;
+	uint32_t fragments_free;
+
+	std::vector<index_t> index;
+	uint32_t index_mask;
+
+	std::array<uint32_t, wheel_size> wheel;
+	uint32_t wheel_time; ///< next second to process
+	bool wheel_started;
+
+	uint32_t packets_count;
+	uint32_t flows_count;
+};
+
+}
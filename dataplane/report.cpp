@@ -273,6 +273,7 @@ nlohmann::json cReport::convertWorker(const cWorker* worker)
 	json["stats"]["fwsync_unicast_egress_drops"] = worker->stats.fwsync_unicast_egress_drops;
 	json["stats"]["fwsync_unicast_egress_packets"] = worker->stats.fwsync_unicast_egress_packets;
 	json["stats"]["fwsync_multicast_egress_imm_packets"] = worker->stats.fwsync_multicast_egress_imm_packets;
+	json["stats"]["fwsync_multicast_egress_imm_frames"] = worker->stats.fwsync_multicast_egress_imm_frames;
 	json["stats"]["fwsync_no_config_drops"] = worker->stats.fwsync_no_config_drops;
 	json["stats"]["acl_ingress_dropPackets"] = worker->stats.acl_ingress_dropPackets;
 	json["stats"]["acl_egress_dropPackets"] = worker->stats.acl_egress_dropPackets;
@@ -386,8 +387,18 @@ nlohmann::json cReport::convertWorkerGC(const worker_gc_t* worker)
 	json["stats"]["fwsync_multicast_egress_drops"] = worker->stats.fwsync_multicast_egress_drops;
 	json["stats"]["fwsync_unicast_egress_packets"] = worker->stats.fwsync_unicast_egress_packets;
 	json["stats"]["fwsync_unicast_egress_drops"] = worker->stats.fwsync_unicast_egress_drops;
+	json["stats"]["fwsync_egress_frame_packets"] = worker->stats.fwsync_egress_frame_packets;
+	json["stats"]["fwsync_egress_frames"] = worker->stats.fwsync_egress_frames;
 	json["stats"]["balancer_state_insert_failed"] = worker->stats.balancer_state_insert_failed;
 	json["stats"]["balancer_state_insert_done"] = worker->stats.balancer_state_insert_done;
+	json["stats"]["nat64stateful_gc_scanned"] = worker->stats.nat64stateful_gc_scanned;
+	json["stats"]["nat64stateful_gc_expired"] = worker->stats.nat64stateful_gc_expired;
+	json["stats"]["nat64stateful_port_blocks_released"] = worker->stats.nat64stateful_port_blocks_released;
+	json["stats"]["balancer_gc_scanned"] = worker->stats.balancer_gc_scanned;
+	json["stats"]["balancer_gc_expired"] = worker->stats.balancer_gc_expired;
+	json["stats"]["acl_gc_scanned"] = worker->stats.acl_gc_scanned;
+	json["stats"]["acl_gc_expired"] = worker->stats.acl_gc_expired;
+	json["nat64stateful_wan_state_expiry"]["size"] = worker->nat64stateful_wan_state_expiry.size();
 
 	/// permanently base
 	json["permanentlyBase"]["globalBaseAtomic"]["pointer"] = pointerToHex(worker->base_permanently.globalBaseAtomic);
@@ -488,16 +499,52 @@ nlohmann::json cReport::convertControlPlane(const cControlPlane* controlPlane)
 		jsonKni["stats"]["obytes"] = stats.obytes;
 		jsonKni["stats"]["odropped"] = stats.odropped;
 
+		const auto& queues_stats = std::get<5>(iter.second);
+		for (tQueueId queue_id = 0;
+		     queue_id < queues_stats.size();
+		     queue_id++)
+		{
+			nlohmann::json jsonQueue;
+
+			jsonQueue["queueId"] = queue_id;
+			if (queue_id == 0)
+			{
+				jsonQueue["ipackets"] = stats.ipackets;
+				jsonQueue["ibytes"] = stats.ibytes;
+				jsonQueue["idropped"] = stats.idropped;
+			}
+			else
+			{
+				for (const auto& [coreId, worker] : dataPlane->workers)
+				{
+					const auto& kernel_interface_queue = worker->kernel_interface_queues[portId];
+					if (kernel_interface_queue.queue_id == queue_id)
+					{
+						jsonQueue["coreId"] = coreId;
+						jsonQueue["ipackets"] = kernel_interface_queue.packets;
+						jsonQueue["ibytes"] = kernel_interface_queue.bytes;
+						jsonQueue["idropped"] = kernel_interface_queue.drops;
+					}
+				}
+			}
+			jsonQueue["opackets"] = queues_stats[queue_id].opackets;
+			jsonQueue["obytes"] = queues_stats[queue_id].obytes;
+
+			jsonKni["queues"].emplace_back(jsonQueue);
+		}
+
 		json["knis"].emplace_back(jsonKni);
 	}
 
-	json["repeat_packets"] = controlPlane->stats.repeat_packets;
-	json["tofarm_packets"] = controlPlane->stats.tofarm_packets;
-	json["farm_packets"] = controlPlane->stats.farm_packets;
-	json["fwsync_multicast_ingress_packets"] = controlPlane->stats.fwsync_multicast_ingress_packets;
-	json["slowworker_drops"] = controlPlane->stats.slowworker_drops;
-	json["slowworker_packets"] = controlPlane->stats.slowworker_packets;
-	json["mempool_is_empty"] = controlPlane->stats.mempool_is_empty;
+	const auto slowworker_stats = controlPlane->get_slow_worker_stats();
+	json["repeat_packets"] = slowworker_stats.repeat_packets;
+	json["tofarm_packets"] = slowworker_stats.tofarm_packets;
+	json["farm_packets"] = slowworker_stats.farm_packets;
+	json["fwsync_multicast_ingress_packets"] = slowworker_stats.fwsync_multicast_ingress_packets;
+	json["fwsync_multicast_ingress_frames"] = slowworker_stats.fwsync_multicast_ingress_frames;
+	json["slowworker_drops"] = slowworker_stats.slowworker_drops;
+	json["slowworker_packets"] = slowworker_stats.slowworker_packets;
+	json["mempool_is_empty"] = slowworker_stats.mempool_is_empty;
 
 	json["dregress"]["bad_decap_transport"] = controlPlane->dregress.stats.bad_decap_transport;
 	json["dregress"]["fragment"] = controlPlane->dregress.stats.fragment;
@@ -513,8 +560,29 @@ nlohmann::json cReport::convertControlPlane(const cControlPlane* controlPlane)
 	json["dregress"]["tcp_ok"] = controlPlane->dregress.stats.tcp_ok;
 	json["dregress"]["tcp_timeout_sessions"] = controlPlane->dregress.stats.tcp_timeout_sessions;
 	json["dregress"]["tcp_unknown_sessions"] = controlPlane->dregress.stats.tcp_unknown_sessions;
+	json["dregress"]["directions_overflow"] = controlPlane->dregress.stats.directions_overflow;
 	json["dregress"]["connections"] = convertHashtable(*controlPlane->dregress.connections);
 
+	{
+		std::lock_guard<std::mutex> guard(controlPlane->update_global_base_stats_mutex);
+
+		const auto convert = [](const cControlPlane::update_global_base_stats_t& stats) {
+			nlohmann::json json;
+			json["count"] = stats.count;
+			json["last_ns"] = stats.last_ns;
+			json["max_ns"] = stats.max_ns;
+			json["total_ns"] = stats.total_ns;
+			return json;
+		};
+
+		json["update_global_base"] = convert(controlPlane->update_global_base_stats);
+		json["update_global_base"]["journal_bytes"] = controlPlane->update_global_base_journal_bytes;
+		for (const auto& [type, stats] : controlPlane->update_global_base_type_stats)
+		{
+			json["update_global_base"]["types"][std::to_string((uint32_t)type)] = convert(stats);
+		}
+	}
+
 	return json;
 }
 
@@ -556,11 +624,15 @@ nlohmann::json cReport::convertGlobalBaseAtomic(const dataplane::globalBase::ato
 	json["pointer"] = pointerToHex(globalBaseAtomic);
 	json["socketId"] = globalBaseAtomic->socketId;
 	json["currentTime"] = globalBaseAtomic->currentTime;
+	json["balancer_weights_size"] = globalBaseAtomic->balancer_weights_size;
+	json["balancer_weights_overflows"] = globalBaseAtomic->balancer_weights_overflows;
 
 	globalBaseAtomic->updater.fw4_state.report(json["fw4_state"]);
 	globalBaseAtomic->updater.fw6_state.report(json["fw6_state"]);
 	globalBaseAtomic->updater.nat64stateful_lan_state.report(json["nat64stateful_lan_state"]);
 	globalBaseAtomic->updater.nat64stateful_wan_state.report(json["nat64stateful_wan_state"]);
+	globalBaseAtomic->updater.nat64stateful_lan_block.report(json["nat64stateful_lan_block"]);
+	globalBaseAtomic->updater.nat64stateful_wan_block.report(json["nat64stateful_wan_block"]);
 
 	return json;
 }
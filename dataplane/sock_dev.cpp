@@ -1,5 +1,6 @@
 #include "sock_dev.h"
 
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -10,6 +11,7 @@
 
 #include <rte_ethdev.h>
 #include <rte_malloc.h>
+#include <rte_spinlock.h>
 #include <rte_version.h>
 
 #if RTE_VERSION >= RTE_VERSION_NUM(20, 11, 0, 0)
@@ -22,6 +24,8 @@
 #include <rte_bus_pci.h>
 #include <rte_pci.h>
 
+#include "common/sock_dev_ring.h"
+
 #define MAX_RX_QUEUES 128
 #define MAX_TX_QUEUES 128
 
@@ -53,8 +57,43 @@ struct sock_internals
 	struct eth_dev_ops dev_ops;
 	struct sock_queue rx_queues[MAX_RX_QUEUES];
 	rte_eth_stats eth_stats;
+
+	/// shared memory mode, see common/sock_dev_ring.h. ring_memory is changed with both locks held
+	rte_spinlock_t ring_rx_lock;
+	rte_spinlock_t ring_tx_lock;
+	uint8_t* ring_memory;
+	uint64_t ring_memory_size;
+	common::sock_dev_ring::ring_view_t ring_rx;
+	common::sock_dev_ring::ring_view_t ring_tx;
+	uint32_t ring_idle_polls; ///< under ring_rx_lock
 };
 
+/// ring_rx_lock and ring_tx_lock must be held
+static void
+sock_dev_ring_unmap(struct sock_internals* internals)
+{
+	if (internals->ring_memory)
+	{
+		munmap(internals->ring_memory, internals->ring_memory_size);
+		internals->ring_memory = NULL;
+		internals->ring_memory_size = 0;
+		internals->ring_rx = common::sock_dev_ring::ring_view_t();
+		internals->ring_tx = common::sock_dev_ring::ring_view_t();
+	}
+}
+
+static void
+sock_dev_ring_release(struct sock_internals* internals)
+{
+	rte_spinlock_lock(&internals->ring_rx_lock);
+	rte_spinlock_lock(&internals->ring_tx_lock);
+
+	sock_dev_ring_unmap(internals);
+
+	rte_spinlock_unlock(&internals->ring_tx_lock);
+	rte_spinlock_unlock(&internals->ring_rx_lock);
+}
+
 static int
 sock_dev_configure(struct rte_eth_dev* dev __rte_unused)
 {
@@ -101,6 +140,7 @@ sock_dev_close(struct rte_eth_dev* dev)
 	struct sock_internals* internals =
 	        (struct sock_internals*)dev->data->dev_private;
 
+	sock_dev_ring_release(internals);
 	close(internals->fd);
 	unlink(internals->sockaddr.sun_path);
 	rte_free(internals);
@@ -126,6 +166,7 @@ sock_dev_close(struct rte_eth_dev* dev)
 	struct sock_internals* internals =
 	        (struct sock_internals*)dev->data->dev_private;
 
+	sock_dev_ring_release(internals);
 	close(internals->fd);
 	unlink(internals->sockaddr.sun_path);
 	rte_free(internals);
@@ -246,6 +287,194 @@ ssize_t readCount(int fd, char* buf, size_t count)
 	return count;
 }
 
+/// creates shared memory rings and passes them to client
+static bool
+sock_dev_ring_create(struct sock_internals* internals,
+                     const common::sock_dev_ring::config_t& config)
+{
+	namespace ring = common::sock_dev_ring;
+
+	if (!ring::is_valid(config))
+	{
+		return false;
+	}
+
+	const uint64_t size = ring::size(config);
+
+	int memory_fd = memfd_create("sock_dev", MFD_CLOEXEC);
+	if (memory_fd < 0)
+	{
+		return false;
+	}
+
+	if (ftruncate(memory_fd, size) < 0)
+	{
+		close(memory_fd);
+		return false;
+	}
+
+	void* pointer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd, 0);
+	if (pointer == MAP_FAILED)
+	{
+		close(memory_fd);
+		return false;
+	}
+
+	uint8_t* memory = (uint8_t*)pointer;
+
+	ring::header_t* header = (ring::header_t*)memory;
+	header->magic = ring::magic;
+	header->version = ring::version;
+	header->slots_count = config.slots_count;
+	header->slot_size = config.slot_size;
+	header->to_dataplane_offset = ring::align(sizeof(ring::header_t));
+	header->from_dataplane_offset = header->to_dataplane_offset + ring::ring_size(config);
+	header->size = size;
+
+	ring::ring_view_t ring_rx;
+	ring::ring_view_t ring_tx;
+	ring_rx.create(memory + header->to_dataplane_offset, config);
+	ring_tx.create(memory + header->from_dataplane_offset, config);
+
+	/// answer: one byte with memfd
+	char byte = 0;
+	struct iovec iov = {&byte, sizeof(byte)};
+
+	union
+	{
+		struct cmsghdr align;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control;
+	memset(&control, 0, sizeof(control));
+
+	struct msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &iov;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &memory_fd, sizeof(memory_fd));
+
+	ssize_t rc = sendmsg(internals->conFd, &message, MSG_NOSIGNAL);
+	close(memory_fd);
+
+	if (rc != sizeof(byte))
+	{
+		munmap(memory, size);
+		return false;
+	}
+
+	sock_dev_ring_release(internals);
+
+	rte_spinlock_lock(&internals->ring_rx_lock);
+	rte_spinlock_lock(&internals->ring_tx_lock);
+
+	internals->ring_memory = memory;
+	internals->ring_memory_size = size;
+	internals->ring_rx = ring_rx;
+	internals->ring_tx = ring_tx;
+	internals->ring_idle_polls = 0;
+
+	rte_spinlock_unlock(&internals->ring_tx_lock);
+	rte_spinlock_unlock(&internals->ring_rx_lock);
+
+	return true;
+}
+
+/// releases rings and closes connection, if client closed it.
+/// ring_rx_lock must be held and rings must be mapped, so connection is closed once
+static void
+sock_dev_ring_check(struct sock_internals* internals)
+{
+	char byte;
+	ssize_t rc = recv(internals->conFd, &byte, sizeof(byte), MSG_PEEK | MSG_DONTWAIT);
+	if (rc > 0 ||
+	    (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)))
+	{
+		return;
+	}
+
+	rte_spinlock_lock(&internals->ring_tx_lock);
+	sock_dev_ring_unmap(internals);
+	rte_spinlock_unlock(&internals->ring_tx_lock);
+
+	close(internals->conFd);
+	internals->conFd = -1;
+}
+
+static uint16_t
+sock_dev_ring_rx(struct sock_queue* sq, struct rte_mbuf** bufs, uint16_t nb_bufs)
+{
+	struct sock_internals* si = sq->internals;
+
+	/// ring has one consumer, other queues skip poll
+	if (!rte_spinlock_trylock(&si->ring_rx_lock))
+	{
+		return 0;
+	}
+
+	if (si->ring_memory == NULL)
+	{
+		rte_spinlock_unlock(&si->ring_rx_lock);
+		return 0;
+	}
+
+	uint32_t count = si->ring_rx.ready(nb_bufs);
+	if (count == 0)
+	{
+		if ((++si->ring_idle_polls & 0x3FF) == 0)
+		{
+			sock_dev_ring_check(si);
+		}
+
+		rte_spinlock_unlock(&si->ring_rx_lock);
+		return 0;
+	}
+
+	if (rte_pktmbuf_alloc_bulk(sq->mb_pool, bufs, count) != 0)
+	{
+		si->eth_stats.rx_nombuf++;
+		rte_spinlock_unlock(&si->ring_rx_lock);
+		return 0;
+	}
+
+	uint16_t rx = 0;
+	for (uint32_t i = 0;
+	     i < count;
+	     i++)
+	{
+		struct rte_mbuf* mbuf = bufs[i];
+		uint32_t length = si->ring_rx.ready_length(i);
+
+		if (length == 0 ||
+		    length > rte_pktmbuf_tailroom(mbuf))
+		{
+			si->eth_stats.ierrors++;
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+
+		rte_memcpy(rte_pktmbuf_mtod(mbuf, void*), si->ring_rx.ready_data(i), length);
+		mbuf->data_len = length;
+		mbuf->pkt_len = length;
+		mbuf->port = si->portId;
+		bufs[rx++] = mbuf;
+
+		si->eth_stats.ipackets++;
+		si->eth_stats.ibytes += length;
+	}
+
+	si->ring_rx.release(count);
+	rte_spinlock_unlock(&si->ring_rx_lock);
+
+	return rx;
+}
+
 static uint16_t
 sock_dev_rx(void* q, struct rte_mbuf** bufs, uint16_t nb_bufs)
 {
@@ -256,6 +485,11 @@ sock_dev_rx(void* q, struct rte_mbuf** bufs, uint16_t nb_bufs)
 
 	struct sock_queue* sq = (struct sock_queue*)q;
 
+	if (sq->internals->ring_memory)
+	{
+		return sock_dev_ring_rx(sq, bufs, nb_bufs);
+	}
+
 	if (sq->internals->conFd < 0)
 	{
 		sq->internals->conFd = accept4(sq->internals->fd, NULL, NULL, SOCK_NONBLOCK);
@@ -282,6 +516,37 @@ sock_dev_rx(void* q, struct rte_mbuf** bufs, uint16_t nb_bufs)
 
 	hdr.data_length = ntohl(hdr.data_length);
 
+	if (hdr.data_length == common::sock_dev_ring::handshake)
+	{
+		/// client switches connection to shared memory rings
+		common::sock_dev_ring::config_t config;
+		do
+		{
+			rc = readCount(sq->internals->conFd, (char*)&config, sizeof(config));
+			if (rc < 0)
+			{
+				sq->internals->conFd = -1; /// Reset the connection
+				return 0;
+			}
+		} while (rc == 0);
+
+		if (!sock_dev_ring_create(sq->internals, config))
+		{
+			sq->internals->eth_stats.ierrors++;
+			close(sq->internals->conFd);
+			sq->internals->conFd = -1; /// Reset the connection
+		}
+
+		return 0;
+	}
+
+	if (hdr.data_length > MAX_PACK_SIZE)
+	{
+		sq->internals->eth_stats.ierrors++;
+		sq->internals->conFd = -1; /// Reset the connection
+		return 0;
+	}
+
 	/// Packet header received, read the packet until reading is done or an error happened
 	do
 	{
@@ -354,6 +619,60 @@ writeIovCount(int fd, struct iovec* iov, size_t count)
 	return 1;
 }
 
+static uint16_t
+sock_dev_ring_tx(struct sock_internals* si, struct rte_mbuf** bufs, uint16_t nb_bufs)
+{
+	/// ring has one producer, transmit queues are serialized
+	rte_spinlock_lock(&si->ring_tx_lock);
+
+	if (si->ring_memory == NULL)
+	{
+		rte_spinlock_unlock(&si->ring_tx_lock);
+		si->eth_stats.oerrors++;
+		return 0;
+	}
+
+	const uint32_t count = si->ring_tx.reserve(nb_bufs);
+	const uint32_t slot_size = si->ring_tx.get_slot_size();
+
+	uint32_t produced = 0;
+	uint16_t i;
+	for (i = 0;
+	     i < nb_bufs && produced < count;
+	     i++)
+	{
+		struct rte_mbuf* mbuf = bufs[i];
+		uint32_t length = rte_pktmbuf_pkt_len(mbuf);
+
+		if (length <= slot_size)
+		{
+			uint8_t* data = si->ring_tx.reserved_data(produced);
+			const void* source = rte_pktmbuf_read(mbuf, 0, length, data);
+			if (source != data)
+			{
+				rte_memcpy(data, source, length);
+			}
+
+			si->ring_tx.set_reserved_length(produced, length);
+			produced++;
+
+			si->eth_stats.opackets++;
+			si->eth_stats.obytes += length;
+		}
+		else /// Packet does not fit, drop it
+		{
+			si->eth_stats.oerrors++;
+		}
+
+		rte_pktmbuf_free(mbuf);
+	}
+
+	si->ring_tx.commit(produced);
+	rte_spinlock_unlock(&si->ring_tx_lock);
+
+	return i;
+}
+
 static uint16_t
 sock_dev_tx(void* q, struct rte_mbuf** bufs, uint16_t nb_bufs)
 {
@@ -363,6 +682,12 @@ sock_dev_tx(void* q, struct rte_mbuf** bufs, uint16_t nb_bufs)
 	}
 
 	struct sock_internals* si = (struct sock_internals*)q;
+
+	if (si->ring_memory)
+	{
+		return sock_dev_ring_tx(si, bufs, nb_bufs);
+	}
+
 	if (si->conFd < 0)
 	{
 		si->eth_stats.oerrors++;
@@ -451,6 +776,10 @@ int sock_dev_create(const char* name, uint8_t numa_node)
 	listen(internals->fd, 1);
 	internals->conFd = -1;
 
+	rte_spinlock_init(&internals->ring_rx_lock);
+	rte_spinlock_init(&internals->ring_tx_lock);
+	internals->ring_memory = NULL;
+
 	struct rte_eth_dev* eth_dev = NULL;
 	eth_dev = rte_eth_dev_allocate(path);
 	if (eth_dev == NULL)
@@ -307,7 +307,8 @@ struct tInterface
 struct nat64stateful_t
 {
 	nat64stateful_t() :
-	        pool_size(0)
+	        pool_size(0),
+	        port_block_size(0)
 	{
 		state_timeout.tcp_syn = YANET_CONFIG_STATE_TIMEOUT_DEFAULT;
 		state_timeout.tcp_ack = YANET_CONFIG_STATE_TIMEOUT_DEFAULT;
@@ -321,6 +322,7 @@ struct nat64stateful_t
 
 	uint32_t pool_start;
 	uint32_t pool_size;
+	uint16_t port_block_size; ///< 0 - port of each state is probed in whole pool
 	tCounterId counter_id;
 	uint8_t ipv4_dscp_flags;
 	struct
@@ -492,6 +494,42 @@ struct nat64stateful_wan_value
 	uint32_t flags;
 };
 
+/// block of ports of one ipv4 address, allocated to ipv6 source.
+///
+/// ports of numa have numa id in low bits, so block is range of port indexes in port space of numa:
+/// port = (port_index << numa_shift) | numa_id
+struct nat64stateful_lan_block_key
+{
+	uint32_t nat64stateful_id : 24;
+	uint8_t nap;
+	ipv6_address_t ipv6_source;
+};
+
+struct nat64stateful_lan_block_value
+{
+	ipv4_address_t ipv4_address;
+	uint16_t port_index; ///< first port of block
+	uint16_t ports_count;
+	uint16_t cursor; ///< next port of block to try
+	uint16_t timestamp_last_packet; ///< of last insert or remove of state
+	uint32_t states_count;
+};
+
+/// owner of block
+struct nat64stateful_wan_block_key
+{
+	uint32_t nat64stateful_id : 24;
+	uint8_t nap;
+	ipv4_address_t ipv4_address;
+	uint16_t port_index;
+	uint16_t nap2;
+};
+
+struct nat64stateful_wan_block_value
+{
+	ipv6_address_t ipv6_source;
+};
+
 static_assert(YANET_CONFIG_NAT64STATEFULS_SIZE <= 0xFFFFFF, "invalid size");
 
 struct nat64stateless_translation_t
@@ -764,6 +802,9 @@ struct fw_state_sync_frame_t
 	}
 };
 
+/// sync packets carry up to this number of frames, to fit into mtu 1500 (ipv6 and udp headers)
+constexpr unsigned int fw_state_sync_frames_per_packet_max = (1500 - 40 - 8) / sizeof(fw_state_sync_frame_t);
+
 struct fw_state_sync_config_t
 {
 	rte_ether_addr ether_address_destination;
@@ -0,0 +1,103 @@
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../dynamic_table.h"
+
+namespace
+{
+
+using table_t = dataplane::dynamic_table<uint32_t>;
+
+struct table_deleter_t
+{
+	void operator()(table_t* table) const
+	{
+		table->~table_t();
+		std::free(table);
+	}
+};
+
+std::unique_ptr<table_t, table_deleter_t> create(const uint32_t size,
+                                                 table_t::updater& updater)
+{
+	auto* table = new (std::malloc(table_t::calculate_sizeof(size))) table_t();
+	updater.update_pointer(table, 0, size);
+	return std::unique_ptr<table_t, table_deleter_t>(table);
+}
+
+TEST(DynamicTable, DenseAndCompressed)
+{
+	table_t::updater dense_updater;
+	table_t::updater compressed_updater;
+	auto dense = create(64, dense_updater);
+	auto compressed = create(64, compressed_updater);
+
+	/// rows 0, 2, 3 are same
+	std::vector<uint32_t> values = {1, 2, 3, 0,
+	                                4, 5, 6, 0,
+	                                1, 2, 3, 0,
+	                                1, 2, 3, 0,
+	                                7, 7, 7, 0};
+	EXPECT_EQ(eResult::success, dense_updater.update(4, {}, values));
+	EXPECT_EQ(20, dense_updater.keys_count);
+	EXPECT_EQ(20, dense_updater.dense_keys_count);
+
+	std::vector<uint32_t> rows = {0, 1, 0, 0, 2};
+	std::vector<uint32_t> compressed_values = {1, 2, 3, 0,
+	                                           4, 5, 6, 0,
+	                                           7, 7, 7, 0};
+	EXPECT_EQ(eResult::success, compressed_updater.update(4, rows, compressed_values));
+	EXPECT_EQ(17, compressed_updater.keys_count);
+	EXPECT_EQ(20, compressed_updater.dense_keys_count);
+
+	uint32_t k1s[YANET_CONFIG_BURST_SIZE];
+	uint32_t k2s[YANET_CONFIG_BURST_SIZE];
+	uint32_t dense_group_ids[YANET_CONFIG_BURST_SIZE];
+	uint32_t compressed_group_ids[YANET_CONFIG_BURST_SIZE];
+
+	unsigned int count = 0;
+	for (uint32_t k1 = 0;
+	     k1 < 5;
+	     k1++)
+	{
+		for (uint32_t k2 = 0;
+		     k2 < 4 && count < YANET_CONFIG_BURST_SIZE;
+		     k2++)
+		{
+			k1s[count] = k1;
+			k2s[count] = k2;
+			count++;
+		}
+	}
+
+	dense->lookup(k1s, k2s, dense_group_ids, count);
+	compressed->lookup(k1s, k2s, compressed_group_ids, count);
+
+	for (unsigned int i = 0;
+	     i < count;
+	     i++)
+	{
+		EXPECT_EQ(values[k1s[i] * 4 + k2s[i]], dense_group_ids[i]);
+		EXPECT_EQ(values[k1s[i] * 4 + k2s[i]], compressed_group_ids[i]);
+		EXPECT_EQ(values[k1s[i] * 4 + k2s[i]], compressed->lookup(k1s[i], k2s[i]));
+	}
+}
+
+TEST(DynamicTable, Invalid)
+{
+	table_t::updater updater;
+	auto table = create(16, updater);
+
+	/// row out of values
+	EXPECT_EQ(eResult::invalidCount, updater.update(4, {0, 2}, {1, 2, 3, 4, 5, 6, 7, 8}));
+
+	/// rows and values don't fit
+	EXPECT_EQ(eResult::invalidCount, updater.update(8, {0, 1}, std::vector<uint32_t>(16)));
+
+	EXPECT_EQ(eResult::success, updater.update(8, {0, 0}, std::vector<uint32_t>(8)));
+}
+
+}
@@ -0,0 +1,105 @@
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../expiry_wheel.h"
+
+namespace
+{
+
+std::vector<uint32_t> expire(dataplane::expiry_wheel_t& wheel,
+                             const uint32_t current_time,
+                             const uint32_t limit = 0xFFFFFFFFu)
+{
+	std::vector<uint32_t> result;
+	wheel.expire(current_time, limit, [&](uint32_t handle) {
+		result.emplace_back(handle);
+	});
+	return result;
+}
+
+TEST(ExpiryWheel, Basic)
+{
+	dataplane::expiry_wheel_t wheel;
+	wheel.reset(16, 1000);
+
+	wheel.schedule(1, 1010);
+	wheel.schedule(2, 1005);
+	wheel.schedule(3, 900); ///< in past: due on next second
+	EXPECT_TRUE(wheel.is_scheduled(1));
+	EXPECT_FALSE(wheel.is_scheduled(4));
+	EXPECT_EQ(3, wheel.size());
+
+	EXPECT_EQ(std::vector<uint32_t>(), expire(wheel, 1000));
+	EXPECT_EQ(std::vector<uint32_t>({3}), expire(wheel, 1001));
+	EXPECT_EQ(std::vector<uint32_t>({2}), expire(wheel, 1009));
+	EXPECT_FALSE(wheel.is_scheduled(2));
+	EXPECT_EQ(std::vector<uint32_t>({1}), expire(wheel, 1010));
+	EXPECT_EQ(0, wheel.size());
+}
+
+TEST(ExpiryWheel, Cascade)
+{
+	dataplane::expiry_wheel_t wheel;
+	wheel.reset(1024, 100);
+
+	/// deadlines of both levels, across many windows of level 0
+	std::map<uint32_t, uint32_t> deadlines;
+	for (uint32_t handle = 0;
+	     handle < 1024;
+	     handle++)
+	{
+		const uint32_t deadline = 101 + (handle * 64) % dataplane::expiry_wheel_t::delay_max;
+		wheel.schedule(handle, deadline);
+		deadlines[handle] = deadline;
+	}
+
+	for (uint32_t time = 100;
+	     time <= 100 + dataplane::expiry_wheel_t::delay_max;
+	     time += 7)
+	{
+		for (const uint32_t handle : expire(wheel, time))
+		{
+			EXPECT_LE(deadlines[handle], time);
+			EXPECT_GT(deadlines[handle] + 7, time);
+			deadlines.erase(handle);
+		}
+	}
+
+	EXPECT_TRUE(deadlines.empty());
+	EXPECT_EQ(0, wheel.size());
+}
+
+TEST(ExpiryWheel, LimitAndReschedule)
+{
+	dataplane::expiry_wheel_t wheel;
+	wheel.reset(8, 0);
+
+	for (uint32_t handle = 0;
+	     handle < 8;
+	     handle++)
+	{
+		wheel.schedule(handle, 10);
+	}
+
+	EXPECT_EQ(3, expire(wheel, 20, 3).size());
+	EXPECT_EQ(5, wheel.size());
+
+	/// alive handles are scheduled again from callback
+	uint32_t count = wheel.expire(20, 100, [&](uint32_t handle) {
+		wheel.schedule(handle, 20 + 300);
+	});
+	EXPECT_EQ(5, count);
+	EXPECT_EQ(5, wheel.size());
+
+	EXPECT_EQ(std::vector<uint32_t>(), expire(wheel, 319));
+	EXPECT_EQ(5, expire(wheel, 320).size());
+
+	/// delay is clamped
+	wheel.schedule(0, 320 + 100000);
+	EXPECT_EQ(std::vector<uint32_t>(), expire(wheel, 320 + dataplane::expiry_wheel_t::delay_max - 1));
+	EXPECT_EQ(std::vector<uint32_t>({0}), expire(wheel, 320 + dataplane::expiry_wheel_t::delay_max));
+}
+
+}
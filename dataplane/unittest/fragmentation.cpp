@@ -0,0 +1,273 @@
+#include <map>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../reassembly.h"
+
+namespace
+{
+
+struct key_t
+{
+	uint32_t source;
+	uint32_t destination;
+	uint32_t packet_id;
+};
+
+using table_t = dataplane::reassembly_t<key_t, uint32_t>;
+using result_e = table_t::result_e;
+
+constexpr uint32_t last = table_t::range_to_last;
+
+key_t make_key(const uint32_t packet_id)
+{
+	return {0x0A000001, 0x0A000002, packet_id};
+}
+
+std::vector<uint32_t> pop(table_t& table,
+                          const uint32_t flow_id)
+{
+	std::vector<uint32_t> result;
+	table.pop(flow_id, [&](uint32_t packet) {
+		result.emplace_back(packet);
+	});
+	return result;
+}
+
+TEST(Reassembly, Collect)
+{
+	table_t table(16, 64, 32, 16);
+
+	uint32_t flow_id;
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 1480, 2959, 2, 0, flow_id));
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 2960, last, 3, 0, flow_id));
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(2), 0, 1479, 10, 0, flow_id));
+	EXPECT_EQ(result_e::collected, table.insert(make_key(1), 0, 1479, 1, 0, flow_id));
+	EXPECT_EQ(4, table.get_packets_count());
+	EXPECT_EQ(2, table.get_flows_count());
+
+	uint32_t range_from;
+	EXPECT_EQ(1, table.first(flow_id));
+	EXPECT_EQ(3, table.last(flow_id, range_from));
+	EXPECT_EQ(2960, range_from);
+
+	EXPECT_EQ(std::vector<uint32_t>({1, 2, 3}), pop(table, flow_id));
+	EXPECT_EQ(1, table.get_packets_count());
+	EXPECT_EQ(1, table.get_flows_count());
+
+	/// same key after pop is new flow
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 0, 1479, 4, 0, flow_id));
+	EXPECT_EQ(2, table.get_flows_count());
+}
+
+TEST(Reassembly, Intersect)
+{
+	table_t table(16, 64, 32, 16);
+
+	uint32_t flow_id;
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 100, 199, 1, 0, flow_id));
+	EXPECT_EQ(result_e::intersect, table.insert(make_key(1), 100, 199, 2, 0, flow_id));
+	EXPECT_EQ(result_e::intersect, table.insert(make_key(1), 0, 100, 2, 0, flow_id));
+	EXPECT_EQ(result_e::intersect, table.insert(make_key(1), 199, 299, 2, 0, flow_id));
+	EXPECT_EQ(result_e::intersect, table.insert(make_key(1), 150, 160, 2, 0, flow_id));
+	EXPECT_EQ(result_e::intersect, table.insert(make_key(1), 0, last, 2, 0, flow_id));
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 200, last, 3, 0, flow_id));
+	EXPECT_EQ(result_e::intersect, table.insert(make_key(1), 300, 399, 2, 0, flow_id));
+	EXPECT_EQ(result_e::collected, table.insert(make_key(1), 0, 99, 4, 0, flow_id));
+	EXPECT_EQ(std::vector<uint32_t>({4, 1, 3}), pop(table, flow_id));
+}
+
+TEST(Reassembly, Overflow)
+{
+	table_t table(4, 2, 32, 16);
+
+	uint32_t flow_id;
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 0, 7, 1, 0, flow_id));
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 8, 15, 2, 0, flow_id));
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 16, 23, 3, 0, flow_id));
+	EXPECT_EQ(result_e::flow_overflow, table.insert(make_key(1), 24, 31, 4, 0, flow_id));
+
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(2), 0, 7, 5, 0, flow_id));
+	EXPECT_EQ(result_e::overflow, table.insert(make_key(3), 0, 7, 6, 0, flow_id));
+	EXPECT_EQ(result_e::overflow, table.insert(make_key(2), 8, 15, 6, 0, flow_id));
+	EXPECT_EQ(4, table.get_packets_count());
+
+	/// packets of expired flows are released
+	std::vector<uint32_t> expired;
+	table.expire(100, [&](uint32_t packet) {
+		expired.emplace_back(packet);
+	});
+	EXPECT_EQ(4, expired.size());
+	EXPECT_EQ(0, table.get_packets_count());
+	EXPECT_EQ(0, table.get_flows_count());
+
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(3), 0, 7, 6, 100, flow_id));
+}
+
+TEST(Reassembly, Timeout)
+{
+	table_t table(16, 64, 32, 16);
+
+	std::vector<uint32_t> expired;
+	const auto callback = [&](uint32_t packet) {
+		expired.emplace_back(packet);
+	};
+
+	uint32_t flow_id;
+	table.expire(1000, callback);
+
+	/// timeout_last
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(1), 0, 7, 1, 1000, flow_id));
+	/// timeout_first: updated every 10 seconds, but expires after 32 seconds from first fragment
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(2), 0, 7, 2, 1000, flow_id));
+
+	for (uint32_t time = 1001; time < 1040; time++)
+	{
+		if (time % 10 == 0)
+		{
+			table.insert(make_key(2), (time - 1000) * 8, (time - 1000) * 8 + 7, 3, time, flow_id);
+		}
+
+		table.expire(time, callback);
+
+		if (time < 1016)
+		{
+			EXPECT_TRUE(expired.empty()) << time;
+		}
+		else if (time < 1032)
+		{
+			EXPECT_EQ(std::vector<uint32_t>({1}), expired) << time;
+		}
+		else
+		{
+			EXPECT_EQ(std::vector<uint32_t>({1, 2, 3, 3, 3}), expired) << time;
+		}
+	}
+
+	/// time jumps over whole wheel
+	EXPECT_EQ(result_e::inserted, table.insert(make_key(3), 0, 7, 4, 1040, flow_id));
+	table.expire(1040 + 10 * table_t::wheel_size, callback);
+	EXPECT_EQ(4, expired.back());
+	EXPECT_EQ(0, table.get_flows_count());
+}
+
+TEST(Reassembly, Random)
+{
+	table_t table(256, 64, 32, 16);
+	std::map<uint32_t, uint32_t> flows; ///< packet_id -> flow_id
+
+	std::mt19937 generator(42);
+	for (uint32_t i = 0; i < 200000; i++)
+	{
+		const uint32_t packet_id = generator() % 512;
+
+		auto it = flows.find(packet_id);
+		if (it != flows.end() &&
+		    generator() % 2)
+		{
+			EXPECT_EQ(1, pop(table, it->second).size());
+			flows.erase(it);
+			continue;
+		}
+
+		uint32_t flow_id;
+		const auto result = table.insert(make_key(packet_id), 8, 15, packet_id, 0, flow_id);
+		if (flows.size() == 256)
+		{
+			EXPECT_EQ(result_e::overflow, result);
+		}
+		else if (it != flows.end())
+		{
+			EXPECT_EQ(result_e::intersect, result);
+			EXPECT_EQ(it->second, flow_id);
+		}
+		else
+		{
+			EXPECT_EQ(result_e::inserted, result);
+			flows[packet_id] = flow_id;
+		}
+
+		EXPECT_EQ(flows.size(), table.get_flows_count());
+	}
+}
+
+/// fragment flood: every fragment opens new flow which never completes
+TEST(Reassembly, FloodNewFlows)
+{
+	constexpr uint32_t size = 1024;
+	constexpr uint32_t count = 64 * 1024;
+
+	table_t table(size, 64, 32, 16);
+
+	uint64_t overflows = 0;
+	uint64_t expired = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t flow_id;
+		if (table.insert(make_key(i), 0, 7, i, i / (count / 64), flow_id) == result_e::overflow)
+		{
+			overflows++;
+		}
+
+		table.expire(i / (count / 64), [&](uint32_t) {
+			expired++;
+		});
+	}
+
+	EXPECT_LE(table.get_flows_count(), size);
+	EXPECT_LT(0, overflows);
+	EXPECT_LT(0, expired);
+	EXPECT_EQ(count, overflows + expired + table.get_packets_count());
+}
+
+/// tiny and overlapping fragments of few flows
+TEST(Reassembly, FloodTinyOverlapping)
+{
+	constexpr uint32_t size = 4096;
+	constexpr uint32_t flows = 16;
+	constexpr uint32_t count = 64 * 1024;
+
+	table_t table(size, 64, 32, 16);
+
+	uint64_t inserted = 0;
+	uint64_t intersects = 0;
+	uint64_t flow_overflows = 0;
+	uint64_t overflows = 0;
+
+	std::mt19937 generator(42);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		/// 8 bytes fragments, every second one overlaps with neighbor
+		const uint32_t range_from = (generator() % 1024) * 8 + (i % 2) * 4;
+
+		uint32_t flow_id;
+		switch (table.insert(make_key(i % flows), range_from, range_from + 7, i, 0, flow_id))
+		{
+			case result_e::inserted:
+				inserted++;
+				break;
+			case result_e::intersect:
+				intersects++;
+				break;
+			case result_e::flow_overflow:
+				flow_overflows++;
+				break;
+			case result_e::overflow:
+				overflows++;
+				break;
+			case result_e::collected:
+				break;
+		}
+	}
+
+	/// every flow is limited by packets_per_flow
+	EXPECT_EQ(flows * 65, inserted);
+	EXPECT_EQ(inserted, table.get_packets_count());
+	EXPECT_EQ(0, overflows);
+	EXPECT_EQ(count, inserted + intersects + flow_overflows + overflows);
+}
+
+}
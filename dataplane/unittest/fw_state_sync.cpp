@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "../fw_state_sync.h"
+
+namespace
+{
+
+struct packet_t
+{
+	unsigned int id;
+};
+
+TEST(FwStateSync, FlushOnFull)
+{
+	dataplane::fw_state_sync_batch_t<packet_t> batch;
+	batch.configure(3, 1000);
+
+	packet_t packet{1};
+	batch.start(&packet, 7, 100);
+	EXPECT_EQ(nullptr, batch.append());
+	EXPECT_EQ(nullptr, batch.append());
+	EXPECT_EQ(&packet, batch.append());
+	EXPECT_EQ(nullptr, batch.get());
+}
+
+TEST(FwStateSync, FlushOnOtherAcl)
+{
+	dataplane::fw_state_sync_batch_t<packet_t> batch;
+	batch.configure(3, 1000);
+
+	packet_t packet{1};
+	batch.start(&packet, 7, 100);
+	EXPECT_EQ(nullptr, batch.append());
+
+	EXPECT_EQ(nullptr, batch.take_other(7));
+	EXPECT_EQ(&packet, batch.get());
+	EXPECT_EQ(&packet, batch.take_other(8));
+	EXPECT_EQ(nullptr, batch.get());
+}
+
+TEST(FwStateSync, FlushOnTimeout)
+{
+	dataplane::fw_state_sync_batch_t<packet_t> batch;
+	batch.configure(8, 1000);
+
+	/// nothing pending
+	EXPECT_EQ(nullptr, batch.take_expired(5000));
+
+	/// partly filled packet waits till timeout since its first frame
+	packet_t packet{1};
+	batch.start(&packet, 7, 100);
+	EXPECT_EQ(nullptr, batch.append());
+	EXPECT_EQ(nullptr, batch.take_expired(100));
+	EXPECT_EQ(nullptr, batch.append());
+	EXPECT_EQ(nullptr, batch.take_expired(1099));
+	EXPECT_EQ(&packet, batch.take_expired(1100));
+	EXPECT_EQ(nullptr, batch.get());
+	EXPECT_EQ(nullptr, batch.take_expired(5000));
+
+	/// timeout of next packet starts from its own first frame
+	packet_t packet_next{2};
+	batch.start(&packet_next, 7, 2000);
+	EXPECT_EQ(nullptr, batch.append());
+	EXPECT_EQ(nullptr, batch.take_expired(2999));
+	EXPECT_EQ(&packet_next, batch.take_expired(3000));
+
+	/// frames count is reset by flush
+	packet_t packet_last{3};
+	batch.start(&packet_last, 7, 4000);
+	for (unsigned int i = 0;
+	     i < 7;
+	     i++)
+	{
+		EXPECT_EQ(nullptr, batch.append());
+	}
+	EXPECT_EQ(&packet_last, batch.append());
+}
+
+TEST(FwStateSync, OneFramePerPacket)
+{
+	dataplane::fw_state_sync_batch_t<packet_t> batch;
+	batch.configure(0, 1000); ///< same as 1
+
+	packet_t packet{1};
+	batch.start(&packet, 7, 100);
+	EXPECT_EQ(&packet, batch.append());
+}
+
+}
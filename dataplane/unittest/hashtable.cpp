@@ -1,3 +1,8 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "../hashtable.h"
@@ -326,6 +331,86 @@ TEST(hashtable_mod_id32, collision)
 	}
 }
 
+TEST(hashtable_mod_id32_dynamic, remove)
+{
+	using ht_t = dataplane::hashtable_mod_id32_dynamic<uint32_t,
+	                                                   16>;
+
+	constexpr uint32_t total_size = 64;
+
+	std::vector<uint64_t> memory(ht_t::calculate_sizeof(total_size) / sizeof(uint64_t) + 1);
+	auto* ht = reinterpret_cast<ht_t*>(memory.data());
+
+	ht_t::updater updater;
+	updater.update_pointer(ht, 0, total_size);
+	updater.clear();
+
+	uint32_t hashes[YANET_CONFIG_BURST_SIZE];
+	uint32_t keys[YANET_CONFIG_BURST_SIZE];
+	uint32_t values[YANET_CONFIG_BURST_SIZE];
+
+	std::vector<std::tuple<uint32_t, uint32_t>> inserted;
+	for (uint32_t i = 0;
+	     i < 48;
+	     i++)
+	{
+		inserted.emplace_back(i, 0x31337 + i);
+	}
+
+	EXPECT_EQ(eResult::success, updater.update(inserted));
+	EXPECT_EQ(48, updater.keys_count);
+	EXPECT_EQ(0, updater.insert_failed);
+
+	std::vector<uint32_t> removed;
+	for (uint32_t i = 0;
+	     i < 48;
+	     i += 3)
+	{
+		removed.emplace_back(i);
+	}
+	removed.emplace_back(1000); ///< not found
+
+	EXPECT_EQ(eResult::success, updater.remove(removed));
+	EXPECT_EQ(32, updater.keys_count);
+
+	for (uint32_t i = 0;
+	     i < 48;
+	     i++)
+	{
+		keys[0] = i;
+		const auto mask = ht->lookup(hashes, keys, values, 1);
+		if (i % 3)
+		{
+			EXPECT_EQ(0xFFFFFFFF, mask);
+			EXPECT_EQ(0x31337 + i, values[0]);
+		}
+		else
+		{
+			EXPECT_EQ(0xFFFFFFFE, mask);
+		}
+	}
+
+	/// delta: update one key, insert removed ones back
+	std::vector<std::tuple<uint32_t, uint32_t>> updated;
+	updated.emplace_back(1, 0x1);
+	for (const auto key : removed)
+	{
+		updated.emplace_back(key, 0x2);
+	}
+
+	EXPECT_EQ(eResult::success, updater.update(updated));
+	EXPECT_EQ(49, updater.keys_count);
+	EXPECT_EQ(1, updater.rewrites);
+
+	keys[0] = 1;
+	EXPECT_EQ(0xFFFFFFFF, ht->lookup(hashes, keys, values, 1));
+	EXPECT_EQ(0x1, values[0]);
+
+	keys[0] = 3;
+	EXPECT_EQ(0xFFFFFFFF, ht->lookup(hashes, keys, values, 1));
+	EXPECT_EQ(0x2, values[0]);
+}
+
 TEST(hashtable_mod_spinlock, basic)
 {
 	dataplane::hashtable_mod_spinlock<ipv6_address_t,
@@ -486,4 +571,278 @@ TEST(hashtable_mod_spinlock, collision)
 	}
 }
 
+TEST(hashtable_mod_spinlock, burst)
+{
+	dataplane::hashtable_mod_spinlock<uint32_t,
+	                                  uint32_t,
+	                                  1024,
+	                                  8>
+	        ht;
+
+	uint32_t hashes[YANET_CONFIG_BURST_SIZE];
+	uint32_t keys[YANET_CONFIG_BURST_SIZE];
+
+	uint32_t* value;
+	dataplane::spinlock_nonrecursive_t* locker;
+
+	for (unsigned int i = 0;
+	     i < YANET_CONFIG_BURST_SIZE;
+	     i++)
+	{
+		keys[i] = 0x31337 + i;
+	}
+
+	ht.prefetch(hashes, keys, YANET_CONFIG_BURST_SIZE);
+
+	for (unsigned int i = 0;
+	     i < YANET_CONFIG_BURST_SIZE;
+	     i++)
+	{
+		EXPECT_EQ(ht.calculate_hash(keys[i]), hashes[i]);
+
+		/// insert only even keys
+		const uint32_t hash = ht.lookup(hashes[i], keys[i], value, locker);
+		EXPECT_EQ(hashes[i], hash);
+		EXPECT_EQ(nullptr, value);
+		if (!(i & 1))
+		{
+			EXPECT_EQ(true, ht.insert(hash, keys[i], i));
+		}
+		locker->unlock();
+	}
+
+	ht.prefetch(hashes, keys, YANET_CONFIG_BURST_SIZE);
+
+	for (unsigned int i = 0;
+	     i < YANET_CONFIG_BURST_SIZE;
+	     i++)
+	{
+		ht.lookup(hashes[i], keys[i], value, locker);
+		if (!(i & 1))
+		{
+			EXPECT_NE(nullptr, value);
+			EXPECT_EQ(i, *value);
+		}
+		else
+		{
+			EXPECT_EQ(nullptr, value);
+		}
+		locker->unlock();
+	}
+}
+
+
+TEST(hashtable_mod_seqlock, optimistic)
+{
+	dataplane::hashtable_mod_spinlock<uint32_t,
+	                                  uint64_t,
+	                                  1024,
+	                                  8,
+	                                  dataplane::seqlock_t>
+	        ht;
+
+	const uint32_t key = 0x31337;
+	const uint32_t hash = ht.calculate_hash(key);
+
+	uint64_t value_copy = 0;
+	uint64_t* value;
+	dataplane::seqlock_t* locker;
+
+	EXPECT_EQ(false, ht.lookup_optimistic(hash, key, value_copy, value));
+	EXPECT_EQ(nullptr, value);
+
+	ht.lookup(hash, key, value, locker);
+	EXPECT_EQ(nullptr, value);
+	EXPECT_EQ(true, ht.insert(hash, key, 12345u));
+	locker->unlock();
+
+	EXPECT_EQ(true, ht.lookup_optimistic(hash, key, value_copy, value));
+	EXPECT_NE(nullptr, value);
+	EXPECT_EQ(12345u, value_copy);
+
+	/// update without lock
+	__atomic_add_fetch(value, 1, __ATOMIC_RELAXED);
+	EXPECT_EQ(true, ht.lookup_optimistic(hash, key, value_copy, value));
+	EXPECT_EQ(12346u, value_copy);
+
+	{
+		uint32_t offset = 0;
+		for (auto iter : ht.range(offset, 1024))
+		{
+			if (iter.is_valid())
+			{
+				iter.lock();
+				iter.unset_valid();
+				iter.unlock();
+			}
+		}
+	}
+
+	EXPECT_EQ(false, ht.lookup_optimistic(hash, key, value_copy, value));
+}
+
+struct pair_value_t
+{
+	uint64_t first;
+	uint64_t second;
+};
+
+/// readers must never see value torn by concurrent writer
+TEST(hashtable_mod_seqlock, consistency)
+{
+	using hashtable_t = dataplane::hashtable_mod_spinlock<uint32_t,
+	                                                      pair_value_t,
+	                                                      64,
+	                                                      8,
+	                                                      dataplane::seqlock_t>;
+	auto ht = std::make_unique<hashtable_t>();
+
+	for (uint32_t key = 0;
+	     key < 16;
+	     key++)
+	{
+		ht->insert_or_update(key, {0, 0});
+	}
+
+	std::atomic<bool> stop = false;
+	std::atomic<uint64_t> torn = 0;
+
+	std::vector<std::thread> readers;
+	for (unsigned int thread_i = 0;
+	     thread_i < 2;
+	     thread_i++)
+	{
+		readers.emplace_back([&]() {
+			uint32_t key = 0;
+			while (!stop)
+			{
+				pair_value_t value_copy;
+				pair_value_t* value;
+				if (ht->lookup_optimistic(ht->calculate_hash(key), key, value_copy, value) &&
+				    value_copy.first != value_copy.second)
+				{
+					torn++;
+				}
+
+				key = (key + 1) % 16;
+			}
+		});
+	}
+
+	for (uint64_t i = 1;
+	     i < 1024 * 1024;
+	     i++)
+	{
+		const uint32_t key = i % 16;
+
+		pair_value_t* value;
+		dataplane::seqlock_t* locker;
+		ht->lookup(key, value, locker);
+		value->first = i;
+		value->second = i;
+		locker->unlock();
+	}
+
+	stop = true;
+	for (auto& thread : readers)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(0, torn);
+}
+
+/// workers hit few hot states and rarely insert new ones. prints ns per lookup for both lockers
+template<typename locker_t>
+double contention_benchmark(const unsigned int threads_count)
+{
+	using hashtable_t = dataplane::hashtable_mod_spinlock<uint32_t,
+	                                                      pair_value_t,
+	                                                      64 * 1024,
+	                                                      16,
+	                                                      locker_t>;
+	auto ht = std::make_unique<hashtable_t>();
+
+	constexpr uint32_t hot_keys = 64;
+	constexpr uint32_t lookups = 4 * 1024 * 1024;
+
+	for (uint32_t key = 0;
+	     key < hot_keys;
+	     key++)
+	{
+		ht->insert_or_update(key, {0, 0});
+	}
+
+	std::atomic<unsigned int> ready = 0;
+	std::atomic<uint64_t> hits = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (unsigned int thread_i = 0;
+	     thread_i < threads_count;
+	     thread_i++)
+	{
+		threads.emplace_back([&, thread_i]() {
+			ready++;
+			while (ready != threads_count)
+			{
+				std::this_thread::yield();
+			}
+
+			uint64_t thread_hits = 0;
+			for (uint32_t i = 0;
+			     i < lookups;
+			     i++)
+			{
+				if (i % 128 == 0)
+				{
+					/// new state
+					ht->insert_or_update(hot_keys + thread_i * lookups + i, {i, i});
+					continue;
+				}
+
+				const uint32_t key = (i * 7 + thread_i) % hot_keys;
+
+				pair_value_t value_copy;
+				pair_value_t* value;
+				if (ht->lookup_optimistic(ht->calculate_hash(key), key, value_copy, value))
+				{
+					/// timestamp
+					if (value_copy.first != i / 1024)
+					{
+						__atomic_store_n(&value->first, i / 1024, __ATOMIC_RELAXED);
+					}
+					thread_hits++;
+				}
+			}
+
+			hits += thread_hits;
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ((uint64_t)threads_count * (lookups - lookups / 128), hits);
+	return (double)duration / lookups;
+}
+
+TEST(HashtableContentionBenchmark, ReadMostly)
+{
+	const unsigned int threads_count = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+
+	const double spinlock_ns = contention_benchmark<dataplane::spinlock_nonrecursive_t>(threads_count);
+	const double seqlock_ns = contention_benchmark<dataplane::seqlock_t>(threads_count);
+
+	printf("state table contention, %u threads: spinlock %.1f ns/lookup, seqlock %.1f ns/lookup\n",
+	       threads_count,
+	       spinlock_ns,
+	       seqlock_ns);
+}
+
 }
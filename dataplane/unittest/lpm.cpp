@@ -1,7 +1,9 @@
 //! In this LPM insertion order matters!
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <random>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -16,6 +18,8 @@ template<uint32_t TExtendedSize>
 class lpm6_8x16bit_atomic : public dataplane::lpm6_8x16bit_atomic<TExtendedSize>
 {
 public:
+	constexpr static bool compressed = false;
+
 	void print() const
 	{
 		auto envPtr = std::getenv("YANET_TEST_DEBUG");
@@ -183,9 +187,83 @@ private:
 	}
 };
 
-TEST(LPM, Lookup)
+/// gapped masks are not supported: insert and remove with mask address take contiguous masks only
+template<uint32_t TExtendedSize,
+         uint32_t TEntriesSize>
+class lpm6_16bit_14x8bit_compressed : public dataplane::lpm6_16bit_14x8bit_compressed<TExtendedSize, TEntriesSize>
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+public:
+	using lpm_t = dataplane::lpm6_16bit_14x8bit_compressed<TExtendedSize, TEntriesSize>;
+	using lpm_t::insert;
+	using lpm_t::remove;
+
+	constexpr static bool compressed = true;
+
+	eResult insert(const std::array<uint8_t, 16>& ipv6Address,
+	               const std::array<uint8_t, 16>& mask,
+	               const uint32_t& valueId)
+	{
+		return lpm_t::insert(ipv6Address, mask_length(mask), valueId);
+	}
+
+	eResult remove(const std::array<uint8_t, 16>& ipv6Address,
+	               const std::array<uint8_t, 16>& mask)
+	{
+		return lpm_t::remove(ipv6Address, mask_length(mask));
+	}
+
+	void print() const
+	{
+	}
+
+protected:
+	/// invalid length for gapped mask
+	static uint8_t mask_length(const std::array<uint8_t, 16>& mask)
+	{
+		uint8_t length = 0;
+		while (length < 128 &&
+		       (mask[length / 8] & (0x80 >> (length % 8))))
+		{
+			length++;
+		}
+
+		for (unsigned int bit_i = length; bit_i < 128; bit_i++)
+		{
+			if (mask[bit_i / 8] & (0x80 >> (bit_i % 8)))
+			{
+				return 0xFF;
+			}
+		}
+
+		return length;
+	}
+};
+
+template<typename T>
+class LPM : public ::testing::Test
+{
+};
+
+using lpm6_types = ::testing::Types<lpm6_8x16bit_atomic<512>,
+                                    lpm6_16bit_14x8bit_compressed<64 * 1024, 1024 * 1024>>;
+TYPED_TEST_SUITE(LPM, lpm6_types);
+
+/// lpm6_8x16bit_atomic takes extended chunk per 16 bits of prefix, compressed lpm takes node per 8 bits
+template<typename lpm_T>
+uint64_t extended_chunks(const uint64_t atomic_count,
+                         const uint64_t compressed_count)
+{
+	return lpm_T::compressed ? compressed_count : atomic_count;
+}
+
+std::array<uint8_t, 16> ipv6(const std::string& string)
+{
+	return common::ipv6_address_t(string);
+}
+
+TYPED_TEST(LPM, Lookup)
+{
+	auto t = std::make_unique<TypeParam>();
 
 	uint32_t valueId{0};
 	EXPECT_FALSE(t->lookup(common::ipv6_address_t("2222:777:aabc:1234::1"), &valueId));
@@ -198,13 +276,15 @@ TEST(LPM, Lookup)
 	EXPECT_EQ(4299, valueId);
 	EXPECT_TRUE(t->lookup(common::ipv6_address_t("2222:777:aabc:1234:ffff:ffff:ffff:ffff"), &valueId));
 	EXPECT_EQ(4299, valueId);
+	EXPECT_FALSE(t->lookup(common::ipv6_address_t("2222:777:aabc:1235::"), &valueId));
+	EXPECT_FALSE(t->lookup(common::ipv6_address_t("2222:777:aabc:1233:ffff:ffff:ffff:ffff"), &valueId));
 
 	t->print();
 }
 
-TEST(LPM, LookupUnalignedBitMask)
+TYPED_TEST(LPM, LookupUnalignedBitMask)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+	auto t = std::make_unique<TypeParam>();
 
 	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), 69, 4299));
 
@@ -221,9 +301,9 @@ TEST(LPM, LookupUnalignedBitMask)
 	t->print();
 }
 
-TEST(LPM, LookupOverlapped)
+TYPED_TEST(LPM, LookupOverlapped)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+	auto t = std::make_unique<TypeParam>();
 
 	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), 64, 4299));
 	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234:4800::"), 69, 589));
@@ -245,9 +325,9 @@ TEST(LPM, LookupOverlapped)
 	t->print();
 }
 
-TEST(LPM, LookupOverlappedSimple)
+TYPED_TEST(LPM, LookupOverlappedSimple)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+	auto t = std::make_unique<TypeParam>();
 
 	const std::vector<std::tuple<std::string, uint8_t, uint32_t>> entries{
 	        {"::", 0, 1},
@@ -269,9 +349,9 @@ TEST(LPM, LookupOverlappedSimple)
 	t->print();
 }
 
-TEST(LPM, LookupExtMask)
+TYPED_TEST(LPM, LookupExtMask)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+	auto t = std::make_unique<TypeParam>();
 
 	uint32_t valueId{0};
 	EXPECT_FALSE(t->lookup(common::ipv6_address_t("2222:777:aabc:1234::1"), &valueId));
@@ -288,9 +368,9 @@ TEST(LPM, LookupExtMask)
 	t->print();
 }
 
-TEST(LPM, LookupUnalignedBitExtMask)
+TYPED_TEST(LPM, LookupUnalignedBitExtMask)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+	auto t = std::make_unique<TypeParam>();
 
 	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), common::ipv6_address_t("ffff:ffff:ffff:ffff:f800::"), 4299));
 
@@ -307,9 +387,9 @@ TEST(LPM, LookupUnalignedBitExtMask)
 	t->print();
 }
 
-TEST(LPM, LookupOverlappedExt)
+TYPED_TEST(LPM, LookupOverlappedExt)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
+	auto t = std::make_unique<TypeParam>();
 
 	const std::vector<std::tuple<std::string, std::string, uint32_t>> entries{
 	        {"2222:777:aabc:1234::", "ffff:ffff:ffff:ffff::", 4299},
@@ -340,6 +420,310 @@ TEST(LPM, LookupOverlappedExt)
 	t->print();
 }
 
+TYPED_TEST(LPM, LookupMerge)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	for (int i = 65535; i >= 1; i--)
+	{
+		std::array<uint8_t, 16> addr{0x11, 0x11, 0x22, 0x22, uint8_t(i / 256), uint8_t(i % 256), 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(addr), common::ipv6_address_t("ffff:ffff:ffff::"), 1000));
+	}
+
+	EXPECT_EQ(extended_chunks<TypeParam>(2, 4), t->getStats().extendedChunksCount);
+
+	std::array<uint8_t, 16> addr{0x11, 0x11, 0x22, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(addr), common::ipv6_address_t("ffff:ffff:ffff::"), 1000));
+	EXPECT_EQ(extended_chunks<TypeParam>(1, 2), t->getStats().extendedChunksCount);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, LookupCruelRealWorld)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	std::ifstream stream("networks.txt");
+	std::string line;
+	int counter = 1000000; // Easier to match by eyes.
+	std::vector<std::tuple<std::string, std::string, uint32_t>> entries;
+	while (std::getline(stream, line))
+	{
+		auto pos = line.find('/');
+		auto addr = line.substr(0, pos);
+		auto mask = line.substr(pos + 1);
+		if (pos == std::string::npos)
+		{
+			mask = "128";
+		}
+
+		auto isNumber = !mask.empty() && std::all_of(mask.begin(), mask.end(), ::isdigit);
+		if (isNumber)
+		{
+			// Nevermind. The easiest way to convert ones set to proper IPv6 address.
+			mask = common::ipv6_address_t(dataplane::lpm6_8x16bit_atomic<1>::createMask(std::stoi(mask, nullptr, 10))).toString();
+		}
+		entries.emplace_back(addr, mask, counter++);
+	}
+
+	for (auto [net, mask, value] : entries)
+	{
+		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(net), common::ipv6_address_t(mask), value))
+		        << "Failed to insert " << value;
+	}
+
+	t->print();
+}
+
+TYPED_TEST(LPM, RemoveOne)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), 64, 4299));
+	EXPECT_EQ(extended_chunks<TypeParam>(3, 6), t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("2222:777:aabc:1234::"), 64));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, RemoveNotSame)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("::"), 0, 4299));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("::1"), 128));
+	EXPECT_EQ(extended_chunks<TypeParam>(7, 14), t->getStats().extendedChunksCount);
+
+	uint32_t valueId{0};
+	EXPECT_FALSE(t->lookup(common::ipv6_address_t("::1"), &valueId));
+	EXPECT_TRUE(t->lookup(common::ipv6_address_t("::2"), &valueId));
+	EXPECT_EQ(4299, valueId);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, RemoveNet)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222::"), 32, 100));
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222:3333::"), 48, 101));
+	EXPECT_EQ(extended_chunks<TypeParam>(2, 4), t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("1111:2222::"), 32));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, RemoveNetCovered)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv6("1111:2222::"), 32, 100));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("1111:2222:3333::"), 48, 101));
+
+	/// remove clears range, covering prefix is not restored
+	EXPECT_EQ(eResult::success, t->remove(ipv6("1111:2222:3333::"), 48));
+
+	uint32_t valueId{0};
+	EXPECT_FALSE(t->lookup(ipv6("1111:2222:3333::1"), &valueId));
+	EXPECT_TRUE(t->lookup(ipv6("1111:2222:3334::1"), &valueId));
+	EXPECT_EQ(100, valueId);
+
+	EXPECT_EQ(eResult::success, t->remove(ipv6("1111:2222::"), 32));
+	EXPECT_FALSE(t->lookup(ipv6("1111:2222:3334::1"), &valueId));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+}
+
+TYPED_TEST(LPM, RemoveOneWithMask)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), common::ipv6_address_t("ffff:ffff:ffff:ffff::"), 4299));
+	EXPECT_EQ(extended_chunks<TypeParam>(3, 6), t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("2222:777:aabc:1234::"), common::ipv6_address_t("ffff:ffff:ffff:ffff::")));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, RemoveNotSameWithMask)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("::"), common::ipv6_address_t("::"), 4299));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("::1"), common::ipv6_address_t("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")));
+	EXPECT_EQ(extended_chunks<TypeParam>(7, 14), t->getStats().extendedChunksCount);
+
+	uint32_t valueId{0};
+	EXPECT_FALSE(t->lookup(common::ipv6_address_t("::1"), &valueId));
+	EXPECT_TRUE(t->lookup(common::ipv6_address_t("::2"), &valueId));
+	EXPECT_EQ(4299, valueId);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, RemoveNetWithMask)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222::"), common::ipv6_address_t("ffff:ffff::"), 100));
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222:3333::"), common::ipv6_address_t("ffff:ffff:ffff::"), 101));
+	EXPECT_EQ(extended_chunks<TypeParam>(2, 4), t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("1111:2222::"), common::ipv6_address_t("ffff:ffff::")));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	t->print();
+}
+
+TYPED_TEST(LPM, Journal)
+{
+	auto t = std::make_unique<TypeParam>();
+	auto stale = std::make_unique<TypeParam>();
+
+	for (auto* lpm : {t.get(), stale.get()})
+	{
+		EXPECT_EQ(eResult::success, lpm->insert(common::ipv6_address_t("2222:777::"), 32, 1001));
+		EXPECT_EQ(eResult::success, lpm->insert(common::ipv6_address_t("2222:777:aabc:1234::"), 64, 1002));
+	}
+
+	dataplane::journal_t journal(t.get(), sizeof(*t));
+	{
+		dataplane::journal_t::scope scope(journal);
+
+		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:1a::a1"), 128, 1003));
+		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("3333::"), 16, 1004));
+		EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("2222:777:aabc:1234::"), 64));
+	}
+
+	EXPECT_LT(journal.dirty_size(), sizeof(*t));
+	journal.copy(stale.get());
+
+	EXPECT_EQ(t->getStats().extendedChunksCount, stale->getStats().extendedChunksCount);
+
+	for (const auto& address : {"2222:777::1", "2222:777:1a::a1", "2222:777:aabc:1234::1", "3333::1", "4444::1"})
+	{
+		uint32_t valueId{0};
+		uint32_t staleValueId{0};
+		EXPECT_EQ(t->lookup(common::ipv6_address_t(address), &valueId),
+		          stale->lookup(common::ipv6_address_t(address), &staleValueId));
+		EXPECT_EQ(valueId, staleValueId);
+	}
+
+	uint32_t valueId{0};
+	EXPECT_TRUE(stale->lookup(common::ipv6_address_t("2222:777:1a::a1"), &valueId));
+	EXPECT_EQ(1003, valueId);
+	/// remove clears range, covering prefix is not restored
+	EXPECT_FALSE(stale->lookup(common::ipv6_address_t("2222:777:aabc:1234::1"), &valueId));
+	EXPECT_TRUE(stale->lookup(common::ipv6_address_t("2222:777:aabc:1235::1"), &valueId));
+	EXPECT_EQ(1001, valueId);
+
+	/// stale copy stays consistent for further updates
+	EXPECT_EQ(eResult::success, stale->insert(common::ipv6_address_t("2222:777:1b::"), 48, 1005));
+	EXPECT_TRUE(stale->lookup(common::ipv6_address_t("2222:777:1b::1"), &valueId));
+	EXPECT_EQ(1005, valueId);
+}
+
+TYPED_TEST(LPM, LookupInsertionOrder)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv6("::"), 0, 1));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8::"), 29, 2));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8:1200::"), 40, 3));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8:1234::"), 47, 4));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8:1234::1"), 128, 5));
+
+	uint32_t valueId{0};
+	EXPECT_TRUE(t->lookup(ipv6("3000::1"), &valueId));
+	EXPECT_EQ(1, valueId);
+	EXPECT_TRUE(t->lookup(ipv6("2001:dbf:ffff::1"), &valueId));
+	EXPECT_EQ(2, valueId);
+	EXPECT_TRUE(t->lookup(ipv6("2001:db8:12ff::1"), &valueId));
+	EXPECT_EQ(3, valueId);
+	EXPECT_TRUE(t->lookup(ipv6("2001:db8:1235:ffff::1"), &valueId));
+	EXPECT_EQ(4, valueId);
+	EXPECT_TRUE(t->lookup(ipv6("2001:db8:1234::1"), &valueId));
+	EXPECT_EQ(5, valueId);
+	EXPECT_TRUE(t->lookup(ipv6("2001:db8:1234::2"), &valueId));
+	EXPECT_EQ(4, valueId);
+
+	/// insertion order matters: shorter prefix overwrites longer ones
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8::"), 32, 6));
+	EXPECT_TRUE(t->lookup(ipv6("2001:db8:1234::1"), &valueId));
+	EXPECT_EQ(6, valueId);
+	EXPECT_TRUE(t->lookup(ipv6("2001:db9::1"), &valueId));
+	EXPECT_EQ(2, valueId);
+}
+
+TYPED_TEST(LPM, LookupBatch)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8::"), 32, 1));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8:1::"), 48, 2));
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8:1:2:3:4:5:6"), 128, 3));
+
+	/// more than one burst, addresses finish walk at different levels
+	std::vector<ipv6_address_t> ipv6Addresses;
+	std::vector<uint32_t> expectValueIds;
+	for (unsigned int i = 0; i < 3 * CONFIG_YADECAP_MBUFS_BURST_SIZE + 5; i++)
+	{
+		switch (i % 4)
+		{
+			case 0:
+				ipv6Addresses.emplace_back(ipv6_address_t::convert(common::ipv6_address_t("2001:db8:ffff::1")));
+				expectValueIds.emplace_back(1);
+				break;
+			case 1:
+				ipv6Addresses.emplace_back(ipv6_address_t::convert(common::ipv6_address_t("2001:db8:1::1")));
+				expectValueIds.emplace_back(2);
+				break;
+			case 2:
+				ipv6Addresses.emplace_back(ipv6_address_t::convert(common::ipv6_address_t("2001:db8:1:2:3:4:5:6")));
+				expectValueIds.emplace_back(3);
+				break;
+			default:
+				ipv6Addresses.emplace_back(ipv6_address_t::convert(common::ipv6_address_t("2001:db9::1")));
+				expectValueIds.emplace_back(dataplane::lpmValueIdInvalid);
+				break;
+		}
+	}
+
+	std::vector<uint32_t> valueIds(ipv6Addresses.size());
+	t->lookup(ipv6Addresses.data(), valueIds.data(), ipv6Addresses.size());
+	EXPECT_EQ(expectValueIds, valueIds);
+}
+
+TYPED_TEST(LPM, Limits)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv6("2001:db8:1::"), 48, 1));
+
+	common::idp::limits::response limits;
+	t->limits(limits, "route.v6.lpm", 0);
+	ASSERT_LE(1, limits.size());
+
+	const auto& [name, socket_id, current, maximum] = limits[0];
+	EXPECT_EQ("route.v6.lpm.extended_chunks", name);
+	EXPECT_EQ(0, socket_id);
+	EXPECT_EQ(t->getStats().extendedChunksCount, current);
+	EXPECT_LT(0, current);
+	EXPECT_LT(current, maximum);
+}
+
+/// gapped masks (project id) are supported by lpm6_8x16bit_atomic only
+
 TEST(LPM, LookupProjectIDExtMask)
 {
 	auto t = std::make_unique<lpm6_8x16bit_atomic<128>>();
@@ -622,157 +1006,36 @@ TEST(LPM, LookupSummary)
 	t->print();
 }
 
-TEST(LPM, LookupMerge)
+TEST(LPM, LookupSummaryWithClear)
 {
 	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
 
-	for (int i = 65535; i >= 1; i--)
+	const std::vector<std::tuple<std::string, std::string, uint32_t>> entries{
+	        {"::", "::", 1001},
+	        {"1111:2222::", "ffff:ffff::", 1002},
+	        {"3333:4444:5555::", "ffff:ffff:ffff::", 1003},
+	        {"3333:4444:5555:0:aaaa:bbbb::", "ffff:ffff:ffff:0:ffff:ffff::", 1004},
+	        {"3333:4444:5555:6666::", "ffff:ffff:ffff:ffff::", 1005},
+	        {"3333:4444:5555:6666:aaaa:bbbb::", "ffff:ffff:ffff:ffff:ffff:ffff::", 1006},
+	};
+
+	for (auto [net, mask, value] : entries)
 	{
-		std::array<uint8_t, 16> addr{0x11, 0x11, 0x22, 0x22, uint8_t(i / 256), uint8_t(i % 256), 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(addr), common::ipv6_address_t("ffff:ffff:ffff::"), 1000));
+		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(net), common::ipv6_address_t(mask), value));
 	}
 
-	EXPECT_EQ(2, t->getStats().extendedChunksCount);
-
-	std::array<uint8_t, 16> addr{0x11, 0x11, 0x22, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(addr), common::ipv6_address_t("ffff:ffff:ffff::"), 1000));
-	EXPECT_EQ(1, t->getStats().extendedChunksCount);
+	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("::"), common::ipv6_address_t("::")));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
 
 	t->print();
 }
 
-TEST(LPM, LookupCruelRealWorld)
+TEST(LPM, RemoveGappedNetwork)
 {
-	auto t = std::make_unique<lpm6_8x16bit_atomic<512>>();
+	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
 
-	std::ifstream stream("networks.txt");
-	std::string line;
-	int counter = 1000000; // Easier to match by eyes.
-	std::vector<std::tuple<std::string, std::string, uint32_t>> entries;
-	while (std::getline(stream, line))
-	{
-		auto pos = line.find('/');
-		auto addr = line.substr(0, pos);
-		auto mask = line.substr(pos + 1);
-		if (pos == std::string::npos)
-		{
-			mask = "128";
-		}
-
-		auto isNumber = !mask.empty() && std::all_of(mask.begin(), mask.end(), ::isdigit);
-		if (isNumber)
-		{
-			// Nevermind. The easiest way to convert ones set to proper IPv6 address.
-			mask = common::ipv6_address_t(t->createMask(std::stoi(mask, nullptr, 10))).toString();
-		}
-		entries.emplace_back(addr, mask, counter++);
-	}
-
-	for (auto [net, mask, value] : entries)
-	{
-		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(net), common::ipv6_address_t(mask), value))
-		        << "Failed to insert " << value;
-	}
-
-	t->print();
-}
-
-TEST(LPM, RemoveOne)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), 64, 4299));
-	EXPECT_EQ(3, t->getStats().extendedChunksCount);
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("2222:777:aabc:1234::"), 64));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	t->print();
-}
-
-TEST(LPM, RemoveNotSame)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("::"), 0, 4299));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("::1"), 128));
-	EXPECT_EQ(7, t->getStats().extendedChunksCount);
-
-	uint32_t valueId{0};
-	EXPECT_FALSE(t->lookup(common::ipv6_address_t("::1"), &valueId));
-	EXPECT_TRUE(t->lookup(common::ipv6_address_t("::2"), &valueId));
-	EXPECT_EQ(4299, valueId);
-
-	t->print();
-}
-
-TEST(LPM, RemoveNet)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222::"), 32, 100));
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222:3333::"), 48, 101));
-	EXPECT_EQ(2, t->getStats().extendedChunksCount);
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("1111:2222::"), 32));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	t->print();
-}
-
-TEST(LPM, RemoveOneWithMask)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("2222:777:aabc:1234::"), common::ipv6_address_t("ffff:ffff:ffff:ffff::"), 4299));
-	EXPECT_EQ(3, t->getStats().extendedChunksCount);
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("2222:777:aabc:1234::"), common::ipv6_address_t("ffff:ffff:ffff:ffff::")));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	t->print();
-}
-
-TEST(LPM, RemoveNotSameWithMask)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("::"), common::ipv6_address_t("::"), 4299));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("::1"), common::ipv6_address_t("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")));
-	EXPECT_EQ(7, t->getStats().extendedChunksCount);
-
-	uint32_t valueId{0};
-	EXPECT_FALSE(t->lookup(common::ipv6_address_t("::1"), &valueId));
-	EXPECT_TRUE(t->lookup(common::ipv6_address_t("::2"), &valueId));
-	EXPECT_EQ(4299, valueId);
-
-	t->print();
-}
-
-TEST(LPM, RemoveNetWithMask)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222::"), common::ipv6_address_t("ffff:ffff::"), 100));
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("1111:2222:3333::"), common::ipv6_address_t("ffff:ffff:ffff::"), 101));
-	EXPECT_EQ(2, t->getStats().extendedChunksCount);
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("1111:2222::"), common::ipv6_address_t("ffff:ffff::")));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	t->print();
-}
-
-TEST(LPM, RemoveGappedNetwork)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("::"), common::ipv6_address_t("::"), 4299));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+	EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t("::"), common::ipv6_address_t("::"), 4299));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
 
 	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("1111:2222:0:0:aaaa:bbbb::"), common::ipv6_address_t("ffff:ffff:0:0:ffff:ffff:0:0")));
 	EXPECT_EQ(5, t->getStats().extendedChunksCount);
@@ -786,30 +1049,6 @@ TEST(LPM, RemoveGappedNetwork)
 	t->print();
 }
 
-TEST(LPM, LookupSummaryWithClear)
-{
-	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
-
-	const std::vector<std::tuple<std::string, std::string, uint32_t>> entries{
-	        {"::", "::", 1001},
-	        {"1111:2222::", "ffff:ffff::", 1002},
-	        {"3333:4444:5555::", "ffff:ffff:ffff::", 1003},
-	        {"3333:4444:5555:0:aaaa:bbbb::", "ffff:ffff:ffff:0:ffff:ffff::", 1004},
-	        {"3333:4444:5555:6666::", "ffff:ffff:ffff:ffff::", 1005},
-	        {"3333:4444:5555:6666:aaaa:bbbb::", "ffff:ffff:ffff:ffff:ffff:ffff::", 1006},
-	};
-
-	for (auto [net, mask, value] : entries)
-	{
-		EXPECT_EQ(eResult::success, t->insert(common::ipv6_address_t(net), common::ipv6_address_t(mask), value));
-	}
-
-	EXPECT_EQ(eResult::success, t->remove(common::ipv6_address_t("::"), common::ipv6_address_t("::")));
-	EXPECT_EQ(0, t->getStats().extendedChunksCount);
-
-	t->print();
-}
-
 TEST(LPM, InsertCorruption)
 {
 	auto t = std::make_unique<lpm6_8x16bit_atomic<64>>();
@@ -887,4 +1126,418 @@ TEST(LPM, InsertCorruption)
 	t->print();
 }
 
+/// random inserts and removes give same lookups as plain list of updates
+TEST(LPM, Random)
+{
+	auto compressed = std::make_unique<dataplane::lpm6_16bit_14x8bit_compressed<64 * 1024, 1024 * 1024>>();
+
+	struct update_t
+	{
+		std::array<uint8_t, 16> address;
+		uint8_t mask;
+		uint32_t valueId;
+	};
+
+	std::vector<update_t> updates;
+
+	const auto covers = [](const update_t& update, const std::array<uint8_t, 16>& address) {
+		for (unsigned int bit_i = 0;
+		     bit_i < update.mask;
+		     bit_i++)
+		{
+			const uint8_t bit = 0x80 >> (bit_i % 8);
+			if ((update.address[bit_i / 8] & bit) != (address[bit_i / 8] & bit))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	const auto reference = [&](const std::array<uint8_t, 16>& address) {
+		for (auto it = updates.rbegin(); it != updates.rend(); ++it)
+		{
+			if (covers(*it, address))
+			{
+				return it->valueId;
+			}
+		}
+
+		return dataplane::lpmValueIdInvalid;
+	};
+
+	std::mt19937 generator(42);
+
+	/// dense subnet, so updates hit same nodes
+	const auto random_address = [&]() {
+		std::array<uint8_t, 16> address;
+		for (auto& byte : address)
+		{
+			byte = generator() % 4;
+		}
+
+		address[0] = 0x20;
+		address[1] = 0x01;
+		if (generator() % 4 == 0)
+		{
+			address[1] = generator();
+			address[2] = generator();
+		}
+
+		return address;
+	};
+
+	std::vector<ipv6_address_t> addresses;
+	for (unsigned int i = 0; i < 4000; i++)
+	{
+		update_t update;
+		update.address = random_address();
+		update.mask = (generator() % 8) ? 16 + generator() % 113 : generator() % 17;
+		update.valueId = (generator() % 4) ? generator() % 8 : dataplane::lpmValueIdInvalid;
+
+		for (unsigned int bit_i = update.mask; bit_i < 128; bit_i++)
+		{
+			update.address[bit_i / 8] &= ~(0x80 >> (bit_i % 8));
+		}
+
+		if (update.valueId != dataplane::lpmValueIdInvalid)
+		{
+			ASSERT_EQ(eResult::success, compressed->insert(update.address, update.mask, update.valueId));
+		}
+		else
+		{
+			ASSERT_EQ(eResult::success, compressed->remove(update.address, update.mask));
+		}
+
+		updates.emplace_back(update);
+
+		addresses.emplace_back();
+		memcpy(addresses.back().bytes, update.address.data(), 16);
+		addresses.emplace_back();
+		const auto address = random_address();
+		memcpy(addresses.back().bytes, address.data(), 16);
+
+		if (i % 500 == 0 ||
+		    i == 3999)
+		{
+			std::vector<uint32_t> values(addresses.size());
+			compressed->lookup(addresses.data(), values.data(), addresses.size());
+
+			for (unsigned int address_i = 0;
+			     address_i < addresses.size();
+			     address_i++)
+			{
+				std::array<uint8_t, 16> address;
+				memcpy(address.data(), addresses[address_i].bytes, 16);
+				ASSERT_EQ(reference(address), values[address_i]) << i << " " << common::ipv6_address_t(address).toString();
+			}
+		}
+	}
+
+	/// all freed nodes and entries return to allocator
+	compressed->remove(ipv6("::"), 0);
+	EXPECT_EQ(0, compressed->getStats().extendedChunksCount);
+	EXPECT_EQ(0, compressed->getStats().entriesCount);
+}
+
+/// ipv4
+
+template<typename T>
+class LPM4 : public ::testing::Test
+{
+};
+
+using lpm4_types = ::testing::Types<dataplane::lpm4_24bit_8bit_atomic<64>,
+                                    dataplane::lpm4_16bit_2x8bit_compressed<1024, 64 * 1024>>;
+TYPED_TEST_SUITE(LPM4, lpm4_types);
+
+uint32_t ipv4(const std::string& string)
+{
+	return common::ipv4_address_t(string);
+}
+
+template<typename lpm_T>
+bool lookup4(const lpm_T& lpm,
+             const std::string& string,
+             uint32_t* valueId)
+{
+	return lpm.lookup(rte_cpu_to_be_32(ipv4(string)), valueId);
+}
+
+TYPED_TEST(LPM4, Lookup)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	uint32_t valueId{0};
+	EXPECT_FALSE(lookup4(*t, "10.0.0.1", &valueId));
+	EXPECT_EQ(dataplane::lpmValueIdInvalid, valueId);
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.0.0.0"), 8, 4299));
+
+	EXPECT_TRUE(lookup4(*t, "10.0.0.0", &valueId));
+	EXPECT_EQ(4299, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.255.255.255", &valueId));
+	EXPECT_EQ(4299, valueId);
+	EXPECT_FALSE(lookup4(*t, "11.0.0.0", &valueId));
+	EXPECT_FALSE(lookup4(*t, "9.255.255.255", &valueId));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+}
+
+TYPED_TEST(LPM4, LookupUnalignedBitMask)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.8.0.0"), 13, 1));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.9.8.0"), 21, 2));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.9.9.32"), 27, 3));
+
+	uint32_t valueId{0};
+	EXPECT_FALSE(lookup4(*t, "10.7.255.255", &valueId));
+	EXPECT_TRUE(lookup4(*t, "10.8.0.0", &valueId));
+	EXPECT_EQ(1, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.15.255.255", &valueId));
+	EXPECT_EQ(1, valueId);
+	EXPECT_FALSE(lookup4(*t, "10.16.0.0", &valueId));
+
+	EXPECT_TRUE(lookup4(*t, "10.9.7.255", &valueId));
+	EXPECT_EQ(1, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.9.8.0", &valueId));
+	EXPECT_EQ(2, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.9.15.255", &valueId));
+	EXPECT_EQ(2, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.9.16.0", &valueId));
+	EXPECT_EQ(1, valueId);
+
+	EXPECT_TRUE(lookup4(*t, "10.9.9.31", &valueId));
+	EXPECT_EQ(2, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.9.9.32", &valueId));
+	EXPECT_EQ(3, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.9.9.63", &valueId));
+	EXPECT_EQ(3, valueId);
+	EXPECT_TRUE(lookup4(*t, "10.9.9.64", &valueId));
+	EXPECT_EQ(2, valueId);
+}
+
+TYPED_TEST(LPM4, LookupOverlapped)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("0.0.0.0"), 0, 1));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("192.168.0.0"), 16, 2));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("192.168.1.0"), 24, 3));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("192.168.1.1"), 32, 4));
+
+	uint32_t valueId{0};
+	EXPECT_TRUE(lookup4(*t, "1.1.1.1", &valueId));
+	EXPECT_EQ(1, valueId);
+	EXPECT_TRUE(lookup4(*t, "192.168.0.1", &valueId));
+	EXPECT_EQ(2, valueId);
+	EXPECT_TRUE(lookup4(*t, "192.168.1.0", &valueId));
+	EXPECT_EQ(3, valueId);
+	EXPECT_TRUE(lookup4(*t, "192.168.1.1", &valueId));
+	EXPECT_EQ(4, valueId);
+	EXPECT_TRUE(lookup4(*t, "192.168.1.2", &valueId));
+	EXPECT_EQ(3, valueId);
+	EXPECT_TRUE(lookup4(*t, "192.168.2.1", &valueId));
+	EXPECT_EQ(2, valueId);
+
+	/// insertion order matters: shorter prefix overwrites longer ones
+	EXPECT_EQ(eResult::success, t->insert(ipv4("192.168.0.0"), 16, 5));
+	EXPECT_TRUE(lookup4(*t, "192.168.1.1", &valueId));
+	EXPECT_EQ(5, valueId);
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+}
+
+TYPED_TEST(LPM4, LookupBatch)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.0.0.0"), 8, 1));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.1.2.0"), 24, 2));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("10.1.2.128"), 25, 3));
+
+	const uint32_t ipAddresses[] = {rte_cpu_to_be_32(ipv4("10.0.0.1")),
+	                                rte_cpu_to_be_32(ipv4("10.1.2.1")),
+	                                rte_cpu_to_be_32(ipv4("10.1.2.129")),
+	                                rte_cpu_to_be_32(ipv4("11.0.0.1"))};
+	uint32_t valueIds[4];
+	t->lookup(ipAddresses, valueIds, 4);
+
+	EXPECT_EQ(1, valueIds[0]);
+	EXPECT_EQ(2, valueIds[1]);
+	EXPECT_EQ(3, valueIds[2]);
+	EXPECT_EQ(dataplane::lpmValueIdInvalid, valueIds[3]);
+}
+
+TYPED_TEST(LPM4, RemoveNotSame)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("0.0.0.0"), 0, 4299));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+
+	EXPECT_EQ(eResult::success, t->remove(ipv4("1.2.3.4"), 32));
+	EXPECT_LT(0, t->getStats().extendedChunksCount);
+
+	uint32_t valueId{0};
+	EXPECT_FALSE(lookup4(*t, "1.2.3.4", &valueId));
+	EXPECT_TRUE(lookup4(*t, "1.2.3.5", &valueId));
+	EXPECT_EQ(4299, valueId);
+	EXPECT_TRUE(lookup4(*t, "1.2.4.4", &valueId));
+	EXPECT_EQ(4299, valueId);
+
+	EXPECT_EQ(eResult::success, t->remove(ipv4("0.0.0.0"), 0));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+	EXPECT_FALSE(lookup4(*t, "1.2.3.5", &valueId));
+}
+
+TYPED_TEST(LPM4, RemoveNet)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("172.16.0.0"), 16, 100));
+	EXPECT_EQ(eResult::success, t->insert(ipv4("172.16.1.16"), 28, 101));
+	EXPECT_LT(0, t->getStats().extendedChunksCount);
+
+	/// remove clears range, covering prefix is not restored
+	EXPECT_EQ(eResult::success, t->remove(ipv4("172.16.1.16"), 28));
+	uint32_t valueId{0};
+	EXPECT_FALSE(lookup4(*t, "172.16.1.17", &valueId));
+	EXPECT_TRUE(lookup4(*t, "172.16.1.32", &valueId));
+	EXPECT_EQ(100, valueId);
+
+	EXPECT_EQ(eResult::success, t->remove(ipv4("172.16.0.0"), 16));
+	EXPECT_EQ(0, t->getStats().extendedChunksCount);
+	EXPECT_FALSE(lookup4(*t, "172.16.1.17", &valueId));
+}
+
+TYPED_TEST(LPM4, Merge)
+{
+	auto t = std::make_unique<TypeParam>();
+	auto merged = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::success, merged->insert(ipv4("1.1.1.0"), 24, 7));
+
+	EXPECT_EQ(eResult::success, t->insert(ipv4("1.1.1.0"), 25, 7));
+	EXPECT_LT(merged->getStats().extendedChunksCount, t->getStats().extendedChunksCount);
+	EXPECT_EQ(eResult::success, t->insert(ipv4("1.1.1.128"), 25, 7));
+	EXPECT_EQ(merged->getStats().extendedChunksCount, t->getStats().extendedChunksCount);
+
+	uint32_t valueId{0};
+	EXPECT_TRUE(lookup4(*t, "1.1.1.255", &valueId));
+	EXPECT_EQ(7, valueId);
+}
+
+TYPED_TEST(LPM4, InvalidArguments)
+{
+	auto t = std::make_unique<TypeParam>();
+
+	EXPECT_EQ(eResult::invalidArguments, t->insert(ipv4("1.1.1.0"), 33, 1));
+	EXPECT_EQ(eResult::invalidArguments, t->insert(ipv4("1.1.1.0"), 24, 0x01000000));
+	EXPECT_EQ(eResult::invalidArguments, t->remove(ipv4("1.1.1.0"), 33));
+}
+
+TYPED_TEST(LPM4, Journal)
+{
+	auto t = std::make_unique<TypeParam>();
+	auto stale = std::make_unique<TypeParam>();
+
+	for (auto* lpm : {t.get(), stale.get()})
+	{
+		EXPECT_EQ(eResult::success, lpm->insert(ipv4("10.0.0.0"), 8, 1001));
+		EXPECT_EQ(eResult::success, lpm->insert(ipv4("10.1.0.0"), 24, 1002));
+	}
+
+	dataplane::journal_t journal(t.get(), sizeof(*t));
+	{
+		dataplane::journal_t::scope scope(journal);
+
+		EXPECT_EQ(eResult::success, t->insert(ipv4("10.2.3.4"), 32, 1003));
+		EXPECT_EQ(eResult::success, t->insert(ipv4("20.0.0.0"), 16, 1004));
+		EXPECT_EQ(eResult::success, t->remove(ipv4("10.1.0.0"), 24));
+	}
+
+	EXPECT_LT(journal.dirty_size(), sizeof(*t));
+	journal.copy(stale.get());
+
+	EXPECT_EQ(t->getStats().extendedChunksCount, stale->getStats().extendedChunksCount);
+
+	for (const auto& address : {"10.0.0.1", "10.1.0.1", "10.2.3.4", "10.2.3.5", "20.0.0.1", "30.0.0.1"})
+	{
+		uint32_t valueId{0};
+		uint32_t staleValueId{0};
+		EXPECT_EQ(lookup4(*t, address, &valueId), lookup4(*stale, address, &staleValueId));
+		EXPECT_EQ(valueId, staleValueId);
+	}
+
+	uint32_t valueId{0};
+	EXPECT_TRUE(lookup4(*stale, "10.2.3.4", &valueId));
+	EXPECT_EQ(1003, valueId);
+	EXPECT_FALSE(lookup4(*stale, "10.1.0.1", &valueId));
+	EXPECT_TRUE(lookup4(*stale, "10.1.1.1", &valueId));
+	EXPECT_EQ(1001, valueId);
+
+	/// stale copy stays consistent for further updates
+	EXPECT_EQ(eResult::success, stale->insert(ipv4("10.2.3.0"), 28, 1005));
+	EXPECT_TRUE(lookup4(*stale, "10.2.3.4", &valueId));
+	EXPECT_EQ(1005, valueId);
+}
+
+/// random inserts and removes give same lookups in both ipv4 lpms
+TEST(LPM4, Random)
+{
+	using atomic_t = dataplane::lpm4_24bit_8bit_atomic<4096>;
+	using compressed_t = dataplane::lpm4_16bit_2x8bit_compressed<16 * 1024, 1024 * 1024>;
+
+	auto atomic = std::make_unique<atomic_t>();
+	auto compressed = std::make_unique<compressed_t>();
+
+	std::mt19937 generator(42);
+	std::vector<uint32_t> addresses;
+
+	/// dense subnet, so updates hit same nodes
+	const auto random_address = [&]() {
+		return (generator() % 2) ? (0x0A000000 | (generator() & 0x0003FFFF)) : generator();
+	};
+
+	for (unsigned int i = 0; i < 20000; i++)
+	{
+		const uint8_t mask = (generator() % 8) ? 17 + generator() % 16 : 8 + generator() % 9;
+		const uint32_t ipAddress = random_address() & (mask ? (0xFFFFFFFFu << (32 - mask)) : 0);
+
+		if (generator() % 4)
+		{
+			const uint32_t valueId = generator() % 8;
+			ASSERT_EQ(eResult::success, atomic->insert(ipAddress, mask, valueId));
+			ASSERT_EQ(eResult::success, compressed->insert(ipAddress, mask, valueId));
+		}
+		else
+		{
+			ASSERT_EQ(eResult::success, atomic->remove(ipAddress, mask));
+			ASSERT_EQ(eResult::success, compressed->remove(ipAddress, mask));
+		}
+
+		addresses.emplace_back(rte_cpu_to_be_32(ipAddress));
+		addresses.emplace_back(rte_cpu_to_be_32(ipAddress - 1));
+		addresses.emplace_back(rte_cpu_to_be_32(random_address()));
+
+		if (i % 1000 == 0 ||
+		    i == 19999)
+		{
+			std::vector<uint32_t> atomic_values(addresses.size());
+			std::vector<uint32_t> compressed_values(addresses.size());
+			atomic->lookup(addresses.data(), atomic_values.data(), addresses.size());
+			compressed->lookup(addresses.data(), compressed_values.data(), addresses.size());
+			ASSERT_EQ(atomic_values, compressed_values) << i;
+		}
+	}
+
+	/// all freed nodes and entries return to allocator
+	atomic->clear();
+	compressed->remove(0, 0);
+	EXPECT_EQ(0, compressed->getStats().extendedChunksCount);
+	EXPECT_EQ(0, compressed->getStats().entriesCount);
+}
+
 } // namespace
@@ -0,0 +1,235 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../hashtable.h"
+#include "../nat64stateful.h"
+
+namespace
+{
+
+using namespace dataplane::nat64stateful;
+using namespace dataplane::globalBase;
+
+using lan_block_ht = dataplane::hashtable_mod_spinlock_dynamic<nat64stateful_lan_block_key, nat64stateful_lan_block_value, 16>;
+using wan_block_ht = dataplane::hashtable_mod_spinlock_dynamic<nat64stateful_wan_block_key, nat64stateful_wan_block_value, 16>;
+using wan_ht = dataplane::hashtable_mod_spinlock_dynamic<nat64stateful_wan_key, nat64stateful_wan_value, 16>;
+
+template<typename hashtable_T>
+class table_t
+{
+public:
+	table_t(const uint32_t total_size) :
+	        memory(hashtable_T::calculate_sizeof(total_size) / sizeof(uint64_t) + 1)
+	{
+		hashtable = new (memory.data()) hashtable_T();
+		updater.update_pointer(hashtable, 0, total_size);
+	}
+
+	hashtable_T* operator->()
+	{
+		return hashtable;
+	}
+
+	std::vector<uint64_t> memory;
+	hashtable_T* hashtable;
+	typename hashtable_T::updater updater;
+};
+
+class nat64stateful_port_block : public ::testing::Test
+{
+protected:
+	nat64stateful_port_block() :
+	        lan_block(1024),
+	        wan_block(1024),
+	        wan_state(1024),
+	        space(1, 1, 8) ///< two numa, numa 1
+	{
+		block_key.nat64stateful_id = 1;
+		block_key.nap = 0;
+		block_key.ipv6_source = ipv6_address_t::convert(common::ipv6_address_t("2000::1"));
+	}
+
+	block_lookup_result_t lookup(const uint32_t client_hash,
+	                             nat64stateful_lan_block_value*& block_value)
+	{
+		lan_block_ht::locker_t* block_locker;
+		const auto result = block_lookup(lan_block.hashtable,
+		                                 wan_block.hashtable,
+		                                 block_key,
+		                                 client_hash,
+		                                 space,
+		                                 [](const unsigned int try_i) {
+			                                 return ipv4_address_t::convert(common::ipv4_address_t(0x0A000000 + try_i));
+		                                 },
+		                                 100,
+		                                 block_value,
+		                                 block_locker);
+		if (result != block_lookup_result_t::insert_failed)
+		{
+			block_locker->unlock();
+		}
+		return result;
+	}
+
+	/// takes port of block and inserts state, as worker does
+	unsigned int insert_state(nat64stateful_lan_block_value& block_value,
+	                          nat64stateful_wan_key& wan_key)
+	{
+		memset(&wan_key, 0, sizeof(wan_key));
+		wan_key.nat64stateful_id = 1;
+		wan_key.proto = IPPROTO_UDP;
+		wan_key.ipv4_source = ipv4_address_t::convert(common::ipv4_address_t("8.8.8.8"));
+		wan_key.port_source = rte_cpu_to_be_16(53);
+
+		uint32_t wan_hash;
+		wan_ht::locker_t* wan_locker;
+		const unsigned int try_i = block_port(wan_state.hashtable, block_value, space, wan_key, wan_hash, wan_locker);
+		if (try_i == YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES)
+		{
+			return try_i;
+		}
+
+		nat64stateful_wan_value wan_value;
+		memset(&wan_value, 0, sizeof(wan_value));
+		EXPECT_TRUE(wan_state->insert(wan_hash, wan_key, wan_value));
+		wan_locker->unlock();
+
+		block_value.states_count++;
+		return try_i;
+	}
+
+	table_t<lan_block_ht> lan_block;
+	table_t<wan_block_ht> wan_block;
+	table_t<wan_ht> wan_state;
+	port_space_t space;
+	nat64stateful_lan_block_key block_key;
+};
+
+TEST_F(nat64stateful_port_block, space)
+{
+	/// port index 512 of numa 1 is port 1025
+	EXPECT_EQ(512, space.port_index_begin);
+	EXPECT_EQ(0x8000, space.port_index_end);
+	EXPECT_EQ(8, space.ports_count);
+	EXPECT_EQ(1025, space.port(space.block_port_index(0)));
+	EXPECT_EQ(space.port_index_begin + 8, space.block_port_index(1));
+	EXPECT_EQ(space.block_port_index(0), space.block_port_index(space.blocks_count));
+
+	/// block is never larger than port space
+	port_space_t space_large(0, 0, 0x10000);
+	EXPECT_EQ(0x10000 - 1024, space_large.ports_count);
+	EXPECT_EQ(1, space_large.blocks_count);
+}
+
+TEST_F(nat64stateful_port_block, first_use)
+{
+	nat64stateful_lan_block_value* block_value = nullptr;
+	EXPECT_EQ(block_lookup_result_t::inserted, lookup(0x00030000, block_value));
+	ASSERT_NE(nullptr, block_value);
+	EXPECT_EQ(ipv4_address_t::convert(common::ipv4_address_t("10.0.0.0")), block_value->ipv4_address);
+	EXPECT_EQ(space.block_port_index(3), block_value->port_index);
+	EXPECT_EQ(8, block_value->ports_count);
+	EXPECT_EQ(0, block_value->states_count);
+	EXPECT_EQ(100, block_value->timestamp_last_packet);
+
+	/// owner of block
+	nat64stateful_wan_block_value* owner_value;
+	wan_block_ht::locker_t* owner_locker;
+	wan_block->lookup(block_owner_key(block_key, *block_value), owner_value, owner_locker);
+	ASSERT_NE(nullptr, owner_value);
+	EXPECT_EQ(block_key.ipv6_source, owner_value->ipv6_source);
+	owner_locker->unlock();
+
+	/// following states of source use same block
+	nat64stateful_lan_block_value* block_value_next = nullptr;
+	EXPECT_EQ(block_lookup_result_t::found, lookup(0x00030000, block_value_next));
+	EXPECT_EQ(block_value, block_value_next);
+
+	/// block of other source is taken from next probe
+	block_key.ipv6_source = ipv6_address_t::convert(common::ipv6_address_t("2000::2"));
+	EXPECT_EQ(block_lookup_result_t::inserted, lookup(0x00030000, block_value_next));
+	EXPECT_EQ(ipv4_address_t::convert(common::ipv4_address_t("10.0.0.1")), block_value_next->ipv4_address);
+	EXPECT_EQ(space.block_port_index(4), block_value_next->port_index);
+}
+
+TEST_F(nat64stateful_port_block, ports_in_turn)
+{
+	nat64stateful_lan_block_value* block_value = nullptr;
+	ASSERT_EQ(block_lookup_result_t::inserted, lookup(0, block_value));
+
+	for (unsigned int i = 0;
+	     i < 8;
+	     i++)
+	{
+		nat64stateful_wan_key wan_key;
+		EXPECT_EQ(0, insert_state(*block_value, wan_key));
+		EXPECT_EQ(block_value->ipv4_address, wan_key.ipv4_destination);
+		EXPECT_EQ(space.port(block_value->port_index + i), rte_be_to_cpu_16(wan_key.port_destination));
+		EXPECT_EQ(1, rte_be_to_cpu_16(wan_key.port_destination) & 1); ///< numa id
+	}
+
+	EXPECT_EQ(8, block_value->states_count);
+	EXPECT_EQ(0, block_value->cursor);
+}
+
+TEST_F(nat64stateful_port_block, is_full)
+{
+	nat64stateful_lan_block_value* block_value = nullptr;
+	ASSERT_EQ(block_lookup_result_t::inserted, lookup(0, block_value));
+
+	std::vector<nat64stateful_wan_key> wan_keys(8);
+	for (auto& wan_key : wan_keys)
+	{
+		EXPECT_GT(YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES, insert_state(*block_value, wan_key));
+	}
+
+	nat64stateful_wan_key wan_key;
+	EXPECT_EQ(YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES, insert_state(*block_value, wan_key));
+
+	/// port of removed state is taken again
+	wan_state->remove(wan_keys[5]);
+	EXPECT_EQ(5, insert_state(*block_value, wan_key));
+	EXPECT_EQ(wan_keys[5].port_destination, wan_key.port_destination);
+}
+
+TEST_F(nat64stateful_port_block, release)
+{
+	nat64stateful_lan_block_value* block_value = nullptr;
+	ASSERT_EQ(block_lookup_result_t::inserted, lookup(0, block_value));
+
+	nat64stateful_wan_key wan_keys[2];
+	insert_state(*block_value, wan_keys[0]);
+	insert_state(*block_value, wan_keys[1]);
+
+	/// block with states is never released
+	EXPECT_FALSE(block_is_expired(*block_value, YANET_CONFIG_NAT64STATEFUL_PORT_BLOCK_TIMEOUT + 1));
+
+	/// state of other address or out of block doesn't leave block
+	block_state_remove(*block_value, ipv4_address_t::convert(common::ipv4_address_t("10.0.0.9")), block_value->port_index, 200);
+	block_state_remove(*block_value, block_value->ipv4_address, block_value->port_index + 8, 200);
+	EXPECT_EQ(2, block_value->states_count);
+
+	for (const auto& wan_key : wan_keys)
+	{
+		block_state_remove(*block_value,
+		                   wan_key.ipv4_destination,
+		                   rte_be_to_cpu_16(wan_key.port_destination) >> space.numa_shift,
+		                   200);
+	}
+	EXPECT_EQ(0, block_value->states_count);
+	EXPECT_EQ(200, block_value->timestamp_last_packet);
+
+	/// block without states is released only after timeout
+	EXPECT_FALSE(block_is_expired(*block_value, 0));
+	EXPECT_FALSE(block_is_expired(*block_value, YANET_CONFIG_NAT64STATEFUL_PORT_BLOCK_TIMEOUT));
+	EXPECT_TRUE(block_is_expired(*block_value, YANET_CONFIG_NAT64STATEFUL_PORT_BLOCK_TIMEOUT + 1));
+
+	/// count doesn't underflow
+	block_state_remove(*block_value, wan_keys[0].ipv4_destination, rte_be_to_cpu_16(wan_keys[0].port_destination) >> space.numa_shift, 300);
+	EXPECT_EQ(0, block_value->states_count);
+	EXPECT_EQ(200, block_value->timestamp_last_packet);
+}
+
+}
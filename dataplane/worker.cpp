@@ -1,6 +1,7 @@
 #include <string>
 #include <thread>
 
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_ether.h>
@@ -17,6 +18,7 @@
 #include "dataplane.h"
 #include "icmp.h"
 #include "metadata.h"
+#include "nat64stateful.h"
 #include "prepare.h"
 #include "worker.h"
 
@@ -37,10 +39,12 @@ cWorker::cWorker(cDataPlane* dataPlane) :
         ring_lowPriority(nullptr),
         ring_toFreePackets(nullptr),
         ring_log(nullptr),
+        counters(nullptr),
+        aclCounters(nullptr),
         packetsToSWNPRemainder(dataPlane->config.SWNormalPriorityRateLimitPerWorker)
 {
 	memset(bursts, 0, sizeof(bursts));
-	memset(counters, 0, sizeof(counters));
+	memset(kernel_interface_queues, 0, sizeof(kernel_interface_queues));
 }
 
 cWorker::~cWorker()
@@ -167,6 +171,11 @@ eResult cWorker::init(const tCoreId& coreId,
 		return eResult::invalidCoreId;
 	}
 
+	fw_state_sync_batch.configure(RTE_MAX(1u,
+	                                      RTE_MIN((unsigned int)dataPlane->getConfigValue(eConfigType::fw_state_sync_frames_per_packet),
+	                                              dataplane::globalBase::fw_state_sync_frames_per_packet_max)),
+	                              rte_get_tsc_hz() / 1000000 * dataPlane->getConfigValue(eConfigType::fw_state_sync_flush_timeout));
+
 	return eResult::success;
 }
 
@@ -307,6 +316,7 @@ void cWorker::fillStatsNamesToAddrsTable(std::unordered_map<std::string, uint64_
 	table["fwsync_multicast_egress_drops"] = &stats.fwsync_multicast_egress_drops;
 	table["fwsync_multicast_egress_packets"] = &stats.fwsync_multicast_egress_packets;
 	table["fwsync_multicast_egress_imm_packets"] = &stats.fwsync_multicast_egress_imm_packets;
+	table["fwsync_multicast_egress_imm_frames"] = &stats.fwsync_multicast_egress_imm_frames;
 	table["fwsync_no_config_drops"] = &stats.fwsync_no_config_drops;
 	table["fwsync_unicast_egress_drops"] = &stats.fwsync_unicast_egress_drops;
 	table["fwsync_unicast_egress_packets"] = &stats.fwsync_unicast_egress_packets;
@@ -377,7 +387,19 @@ YANET_NEVER_INLINE void cWorker::mainThread()
 		     worker_port_i++)
 		{
 			toFreePackets_handle();
+
+#ifdef YANET_CONFIG_WORKER_PROFILE
+			const uint64_t profile_tsc = rte_rdtsc();
 			physicalPort_ingress_handle(worker_port_i);
+			if (logicalPort_ingress_stack.mbufsCount)
+			{
+				profile.update(worker::stage_e::physicalPort_ingress_handle,
+				               logicalPort_ingress_stack.mbufsCount,
+				               rte_rdtsc() - profile_tsc);
+			}
+#else
+			physicalPort_ingress_handle(worker_port_i);
+#endif
 
 			if (unlikely(logicalPort_ingress_stack.mbufsCount == 0))
 			{
@@ -387,6 +409,8 @@ YANET_NEVER_INLINE void cWorker::mainThread()
 			handlePackets();
 		}
 
+		acl_state_emit_flush_expired();
+
 		iteration++;
 	}
 }
@@ -447,7 +471,7 @@ inline void cWorker::calcHash(rte_mbuf* mbuf)
 	}
 }
 
-void cWorker::preparePacket(rte_mbuf* mbuf)
+inline void cWorker::prepareHeaders(rte_mbuf* mbuf)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
@@ -504,15 +528,42 @@ void cWorker::preparePacket(rte_mbuf* mbuf)
 	}
 }
 
+void cWorker::preparePacket(rte_mbuf* mbuf)
+{
+	prepareHeaders(mbuf);
+	calcHash(mbuf);
+}
+
+/// call stage handler. when built with YANET_CONFIG_WORKER_PROFILE, account its cycles and packets
+#ifdef YANET_CONFIG_WORKER_PROFILE
+#define YANET_WORKER_STAGE(stage, packets_count)                                                            \
+	do                                                                                                  \
+	{                                                                                                   \
+		const uint64_t profile_packets = (packets_count);                                           \
+		if (profile_packets)                                                                        \
+		{                                                                                           \
+			const uint64_t profile_tsc = rte_rdtsc();                                           \
+			stage();                                                                            \
+			profile.update(worker::stage_e::stage, profile_packets, rte_rdtsc() - profile_tsc); \
+		}                                                                                           \
+		else                                                                                        \
+		{                                                                                           \
+			stage();                                                                            \
+		}                                                                                           \
+	} while (0)
+#else
+#define YANET_WORKER_STAGE(stage, packets_count) stage()
+#endif
+
 inline void cWorker::handlePackets()
 {
 	const auto& base = bases[localBaseId & 1];
 	const auto& globalbase = *base.globalBase;
 
-	logicalPort_ingress_handle();
+	YANET_WORKER_STAGE(logicalPort_ingress_handle, logicalPort_ingress_stack.mbufsCount);
 
-	acl_ingress_handle4();
-	acl_ingress_handle6();
+	YANET_WORKER_STAGE(acl_ingress_handle4, acl_ingress_stack4.mbufsCount);
+	YANET_WORKER_STAGE(acl_ingress_handle6, acl_ingress_stack6.mbufsCount);
 
 	if (globalbase.early_decap_enabled)
 	{
@@ -520,62 +571,63 @@ inline void cWorker::handlePackets()
 		{
 			acl_ingress_stack4 = after_early_decap_stack4;
 			after_early_decap_stack4.clear();
-			acl_ingress_handle4();
+			YANET_WORKER_STAGE(acl_ingress_handle4, acl_ingress_stack4.mbufsCount);
 		}
 
 		if (after_early_decap_stack6.mbufsCount > 0)
 		{
 			acl_ingress_stack6 = after_early_decap_stack6;
 			after_early_decap_stack6.clear();
-			acl_ingress_handle6();
+			YANET_WORKER_STAGE(acl_ingress_handle6, acl_ingress_stack6.mbufsCount);
 		}
 	}
 
 	if (globalbase.tun64_enabled)
 	{
-		tun64_ipv4_handle();
-		tun64_ipv6_handle();
+		YANET_WORKER_STAGE(tun64_ipv4_handle, tun64_stack4.mbufsCount);
+		YANET_WORKER_STAGE(tun64_ipv6_handle, tun64_stack6.mbufsCount);
 	}
 
 	if (globalbase.decap_enabled)
 	{
-		decap_handle();
+		YANET_WORKER_STAGE(decap_handle, decap_stack.mbufsCount);
 	}
 
 	if (globalbase.nat64stateful_enabled)
 	{
-		nat64stateful_lan_handle();
-		nat64stateful_wan_handle();
+		YANET_WORKER_STAGE(nat64stateful_lan_handle, nat64stateful_lan_stack.mbufsCount);
+		YANET_WORKER_STAGE(nat64stateful_wan_handle, nat64stateful_wan_stack.mbufsCount);
 	}
 
 	if (globalbase.nat64stateless_enabled)
 	{
-		nat64stateless_ingress_handle();
-		nat64stateless_egress_handle();
+		YANET_WORKER_STAGE(nat64stateless_ingress_handle, nat64stateless_ingress_stack.mbufsCount);
+		YANET_WORKER_STAGE(nat64stateless_egress_handle, nat64stateless_egress_stack.mbufsCount);
 	}
 
 	if (globalbase.balancer_enabled)
 	{
-		balancer_handle();
+		YANET_WORKER_STAGE(balancer_handle, balancer_stack.mbufsCount);
 
-		balancer_icmp_reply_handle(); // balancer replies instead of real (when client pings VS)
-		balancer_icmp_forward_handle(); // forward icmp message to other balancers (if not sent to one of this balancer's reals)
+		YANET_WORKER_STAGE(balancer_icmp_reply_handle, balancer_icmp_reply_stack.mbufsCount); // balancer replies instead of real (when client pings VS)
+		YANET_WORKER_STAGE(balancer_icmp_forward_handle, balancer_icmp_forward_stack.mbufsCount); // forward icmp message to other balancers (if not sent to one of this balancer's reals)
 	}
 
-	route_handle4();
-	route_handle6();
-	route_tunnel_handle4();
-	route_tunnel_handle6();
+	YANET_WORKER_STAGE(route_handle4, route_stack4.mbufsCount);
+	YANET_WORKER_STAGE(route_handle6, route_stack6.mbufsCount);
+	YANET_WORKER_STAGE(route_tunnel_handle4, route_tunnel_stack4.mbufsCount);
+	YANET_WORKER_STAGE(route_tunnel_handle6, route_tunnel_stack6.mbufsCount);
 
 	if (globalbase.acl_egress_enabled)
 	{
-		acl_egress_handle4();
-		acl_egress_handle6();
+		YANET_WORKER_STAGE(acl_egress_handle4, acl_egress_stack4.mbufsCount);
+		YANET_WORKER_STAGE(acl_egress_handle6, acl_egress_stack6.mbufsCount);
 	}
 
-	logicalPort_egress_handle();
-	controlPlane_handle();
-	physicalPort_egress_handle();
+	YANET_WORKER_STAGE(logicalPort_egress_handle, logicalPort_egress_stack.mbufsCount);
+	YANET_WORKER_STAGE(controlPlane_handle, controlPlane_stack.mbufsCount);
+	YANET_WORKER_STAGE(kernel_interface_handle, kernel_interface_stack_count());
+	YANET_WORKER_STAGE(physicalPort_egress_handle, physicalPort_stack_count());
 }
 
 static_assert(CONFIG_YADECAP_PORTS_SIZE == 8, "(vlanId << 3) | metadata->fromPortId");
@@ -589,15 +641,29 @@ inline void cWorker::physicalPort_ingress_handle(const unsigned int& worker_port
 	                                   logicalPort_ingress_stack.mbufs,
 	                                   CONFIG_YADECAP_MBUFS_BURST_SIZE);
 
-	/// init metadata
+	const tPortId fromPortId = basePermanently.workerPorts[worker_port_i].inPortId;
+
+	for (unsigned int mbuf_i = 0;
+	     mbuf_i < rxSize && mbuf_i < YANET_CONFIG_PREFETCH_OFFSET;
+	     mbuf_i++)
+	{
+		rte_prefetch0(rte_pktmbuf_mtod(logicalPort_ingress_stack.mbufs[mbuf_i], void*));
+	}
+
+	/// init metadata and parse headers
 	for (unsigned int mbuf_i = 0;
 	     mbuf_i < rxSize;
 	     mbuf_i++)
 	{
+		if (mbuf_i + YANET_CONFIG_PREFETCH_OFFSET < rxSize)
+		{
+			rte_prefetch0(rte_pktmbuf_mtod(logicalPort_ingress_stack.mbufs[mbuf_i + YANET_CONFIG_PREFETCH_OFFSET], void*));
+		}
+
 		rte_mbuf* mbuf = logicalPort_ingress_stack.mbufs[mbuf_i];
 		dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-		metadata->fromPortId = basePermanently.workerPorts[worker_port_i].inPortId;
+		metadata->fromPortId = fromPortId;
 		metadata->repeat_ttl = YANET_CONFIG_REPEAT_TTL;
 		metadata->flowLabel = 0;
 		metadata->already_early_decapped = 0;
@@ -617,10 +683,26 @@ inline void cWorker::physicalPort_ingress_handle(const unsigned int& worker_port
 		}
 		metadata->in_logicalport_id = metadata->flow.data.logicalPortId;
 
-		preparePacket(mbuf);
+		prepareHeaders(mbuf);
+	}
+
+	/// hash whole burst in separate pass: crc of different packets are independent and overlap in pipeline.
+	/// later stages use cached metadata->hash
+	for (unsigned int mbuf_i = 0;
+	     mbuf_i < rxSize;
+	     mbuf_i++)
+	{
+		calcHash(logicalPort_ingress_stack.mbufs[mbuf_i]);
+	}
 
-		if (basePermanently.globalBaseAtomic->physicalPort_flags[metadata->fromPortId] & YANET_PHYSICALPORT_FLAG_IN_DUMP)
+	if (basePermanently.globalBaseAtomic->physicalPort_flags[fromPortId] & YANET_PHYSICALPORT_FLAG_IN_DUMP)
+	{
+		for (unsigned int mbuf_i = 0;
+		     mbuf_i < rxSize;
+		     mbuf_i++)
 		{
+			rte_mbuf* mbuf = logicalPort_ingress_stack.mbufs[mbuf_i];
+
 			if (!rte_ring_full(ring_lowPriority))
 			{
 				rte_mbuf* mbuf_clone = rte_pktmbuf_alloc(mempool);
@@ -637,7 +719,7 @@ inline void cWorker::physicalPort_ingress_handle(const unsigned int& worker_port
 
 					YADECAP_METADATA(mbuf_clone)->flow.type = common::globalBase::eFlowType::slowWorker_dump;
 					YADECAP_METADATA(mbuf_clone)->flow.data.dump.type = common::globalBase::dump_type_e::physicalPort_ingress;
-					YADECAP_METADATA(mbuf_clone)->flow.data.dump.id = metadata->fromPortId;
+					YADECAP_METADATA(mbuf_clone)->flow.data.dump.id = fromPortId;
 					slowWorker_entry_lowPriority(mbuf_clone);
 				}
 			}
@@ -679,6 +761,20 @@ inline void cWorker::physicalPort_egress_handle()
 	}
 }
 
+#ifdef YANET_CONFIG_WORKER_PROFILE
+inline unsigned int cWorker::physicalPort_stack_count() const
+{
+	unsigned int count = 0;
+	for (tPortId portId = 0;
+	     portId < basePermanently.ports_count;
+	     portId++)
+	{
+		count += physicalPort_stack[portId].mbufsCount;
+	}
+	return count;
+}
+#endif
+
 inline void cWorker::logicalPort_ingress_handle()
 {
 	const auto& base = bases[localBaseId & 1];
@@ -962,6 +1058,7 @@ inline void cWorker::acl_ingress_handle4()
 {
 	const auto& base = bases[localBaseId & 1];
 	const auto& acl = base.globalBase->acl;
+	auto* fw4_state = basePermanently.globalBaseAtomic->fw4_state;
 
 	if (unlikely(acl_ingress_stack4.mbufsCount == 0))
 	{
@@ -1077,6 +1174,30 @@ inline void cWorker::acl_ingress_handle4()
 	                        value_acl.totals,
 	                        acl_ingress_stack4.mbufsCount);
 
+	/// prefetch states for packets dropped by rules, they may still be allowed by keepstate
+	for (unsigned int mbuf_i = 0;
+	     mbuf_i < acl_ingress_stack4.mbufsCount;
+	     mbuf_i++)
+	{
+		rte_mbuf* mbuf = acl_ingress_stack4.mbufs[mbuf_i];
+
+		auto& total_value = value_acl.totals[mbuf_i];
+		if (total_value & 0x80000000u)
+		{
+			total_value = 0; ///< default
+		}
+
+		if (acl.values[total_value].flow.type == common::globalBase::eFlowType::drop &&
+		    (mask & (1u << mbuf_i)))
+		{
+			auto& state_key = key_acl.fw4_states[mbuf_i];
+			acl_state_key(mbuf, state_key);
+
+			hashes[mbuf_i] = fw4_state->calculate_hash(state_key);
+			fw4_state->prefetch(hashes[mbuf_i]);
+		}
+	}
+
 	for (unsigned int mbuf_i = 0;
 	     mbuf_i < acl_ingress_stack4.mbufsCount;
 	     mbuf_i++)
@@ -1091,18 +1212,12 @@ inline void cWorker::acl_ingress_handle4()
 			continue;
 		}
 
-		auto total_value = value_acl.totals[mbuf_i];
-		if (total_value & 0x80000000u)
-		{
-			total_value = 0; ///< default
-		}
-
-		const auto& value = acl.values[total_value];
+		const auto& value = acl.values[value_acl.totals[mbuf_i]];
 
 		if (value.flow.type == common::globalBase::eFlowType::drop)
 		{
 			// Try to match against stateful dynamic rules. If so - a packet will be handled.
-			if (acl_try_keepstate(mbuf))
+			if (acl_try_keepstate(mbuf, hashes[mbuf_i], key_acl.fw4_states[mbuf_i]))
 			{
 				continue;
 			}
@@ -1146,6 +1261,7 @@ inline void cWorker::acl_ingress_handle6()
 {
 	const auto& base = bases[localBaseId & 1];
 	const auto& acl = base.globalBase->acl;
+	auto* fw6_state = basePermanently.globalBaseAtomic->fw6_state;
 
 	if (unlikely(acl_ingress_stack6.mbufsCount == 0))
 	{
@@ -1268,6 +1384,30 @@ inline void cWorker::acl_ingress_handle6()
 	                        value_acl.totals,
 	                        acl_ingress_stack6.mbufsCount);
 
+	/// prefetch states for packets dropped by rules, they may still be allowed by keepstate
+	for (unsigned int mbuf_i = 0;
+	     mbuf_i < acl_ingress_stack6.mbufsCount;
+	     mbuf_i++)
+	{
+		rte_mbuf* mbuf = acl_ingress_stack6.mbufs[mbuf_i];
+
+		auto& total_value = value_acl.totals[mbuf_i];
+		if (total_value & 0x80000000u)
+		{
+			total_value = 0; ///< default
+		}
+
+		if (acl.values[total_value].flow.type == common::globalBase::eFlowType::drop &&
+		    (mask & (1u << mbuf_i)))
+		{
+			auto& state_key = key_acl.fw6_states[mbuf_i];
+			acl_state_key(mbuf, state_key);
+
+			hashes[mbuf_i] = fw6_state->calculate_hash(state_key);
+			fw6_state->prefetch(hashes[mbuf_i]);
+		}
+	}
+
 	for (unsigned int mbuf_i = 0;
 	     mbuf_i < acl_ingress_stack6.mbufsCount;
 	     mbuf_i++)
@@ -1282,18 +1422,12 @@ inline void cWorker::acl_ingress_handle6()
 			continue;
 		}
 
-		auto total_value = value_acl.totals[mbuf_i];
-		if (total_value & 0x80000000u)
-		{
-			total_value = 0; ///< default
-		}
-
-		const auto& value = acl.values[total_value];
+		const auto& value = acl.values[value_acl.totals[mbuf_i]];
 
 		if (value.flow.type == common::globalBase::eFlowType::drop)
 		{
 			// Try to match against stateful dynamic rules. If so - a packet will be handled.
-			if (acl_try_keepstate(mbuf))
+			if (acl_try_keepstate(mbuf, hashes[mbuf_i], key_acl.fw6_states[mbuf_i]))
 			{
 				continue;
 			}
@@ -1820,8 +1954,6 @@ inline void cWorker::route_handle4()
 		rte_ipv4_hdr* ipv4Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv4_hdr*, metadata->network_headerOffset);
 
 		route_ipv4_keys[mbuf_i] = ipv4Header->dst_addr;
-
-		calcHash(mbuf);
 	}
 
 	base.globalBase->route_lpm4.lookup(route_ipv4_keys, route_ipv4_values, route_stack4.mbufsCount);
@@ -1919,8 +2051,6 @@ inline void cWorker::route_handle6()
 		rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
 
 		rte_memcpy(route_ipv6_keys[mbuf_i].bytes, ipv6Header->dst_addr, 16);
-
-		calcHash(mbuf);
 	}
 
 	base.globalBase->route_lpm6.lookup(route_ipv6_keys, route_ipv6_values, route_stack6.mbufsCount);
@@ -2103,7 +2233,6 @@ inline void cWorker::route_tunnel_handle4()
 
 		route_ipv4_keys[mbuf_i] = ipv4Header->dst_addr;
 
-		calcHash(mbuf);
 		metadata->hash = rte_hash_crc(&metadata->flowLabel, 4, metadata->hash);
 	}
 
@@ -2209,7 +2338,6 @@ inline void cWorker::route_tunnel_handle6()
 
 		rte_memcpy(route_ipv6_keys[mbuf_i].bytes, ipv6Header->dst_addr, 16);
 
-		calcHash(mbuf);
 		metadata->hash = rte_hash_crc(&metadata->flowLabel, 4, metadata->hash);
 	}
 
@@ -2476,6 +2604,67 @@ inline void cWorker::nat64stateful_lan_entry(rte_mbuf* mbuf)
 	nat64stateful_lan_stack.insert(mbuf);
 }
 
+inline bool cWorker::nat64stateful_lan_block_port(const dataplane::globalBase::nat64stateful_t& nat64stateful,
+                                                  const dataplane::globalBase::nat64stateful_lan_key& key,
+                                                  const uint32_t client_hash,
+                                                  dataplane::globalBase::nat64stateful_wan_key& wan_key,
+                                                  uint32_t& wan_hash,
+                                                  dataplane::globalBase::nat64stateful::wan_ht::locker_t*& wan_locker,
+                                                  dataplane::globalBase::nat64stateful_lan_block_value*& block_value,
+                                                  dataplane::globalBase::nat64stateful::lan_block_ht::locker_t*& block_locker)
+{
+	const auto& base = bases[localBaseId & 1];
+
+	const dataplane::nat64stateful::port_space_t space(__builtin_popcount(rte_be_to_cpu_16(basePermanently.nat64stateful_numa_reverse_mask)),
+	                                                   rte_be_to_cpu_16(basePermanently.nat64stateful_numa_id),
+	                                                   nat64stateful.port_block_size);
+
+	dataplane::globalBase::nat64stateful_lan_block_key block_key;
+	block_key.nat64stateful_id = key.nat64stateful_id;
+	block_key.nap = 0;
+	block_key.ipv6_source = key.ipv6_source;
+
+	auto pool_address = [&](const unsigned int try_i) {
+		return base.globalBase->nat64stateful_pool[nat64stateful.pool_start + (client_hash + try_i) % nat64stateful.pool_size];
+	};
+
+	const auto block_result = dataplane::nat64stateful::block_lookup(basePermanently.globalBaseAtomic->nat64stateful_lan_block,
+	                                                                 basePermanently.globalBaseAtomic->nat64stateful_wan_block,
+	                                                                 block_key,
+	                                                                 client_hash,
+	                                                                 space,
+	                                                                 pool_address,
+	                                                                 basePermanently.globalBaseAtomic->currentTime,
+	                                                                 block_value,
+	                                                                 block_locker);
+	if (block_result == dataplane::nat64stateful::block_lookup_result_t::insert_failed)
+	{
+		counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::port_block_insert_failed]++;
+		return false;
+	}
+	else if (block_result == dataplane::nat64stateful::block_lookup_result_t::inserted)
+	{
+		counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::port_block_insert_success]++;
+	}
+
+	const unsigned int try_i = dataplane::nat64stateful::block_port(basePermanently.globalBaseAtomic->nat64stateful_wan_state,
+	                                                                *block_value,
+	                                                                space,
+	                                                                wan_key,
+	                                                                wan_hash,
+	                                                                wan_locker);
+	if (try_i == YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES)
+	{
+		block_locker->unlock();
+		counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::port_block_is_full]++;
+		return false;
+	}
+
+	/// success. block stays locked till insert of state
+	counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::tries_array_start + try_i]++;
+	return true;
+}
+
 inline void cWorker::nat64stateful_lan_handle()
 {
 	const auto& base = bases[localBaseId & 1];
@@ -2531,6 +2720,10 @@ inline void cWorker::nat64stateful_lan_handle()
 		}
 	}
 
+	nat64stateful_lan_state->prefetch(hashes,
+	                                  nat64stateful_lan_keys,
+	                                  nat64stateful_lan_stack.mbufsCount);
+
 	dataplane::globalBase::nat64stateful_lan_value value;
 	for (unsigned int mbuf_i = 0;
 	     mbuf_i < nat64stateful_lan_stack.mbufsCount;
@@ -2544,166 +2737,196 @@ inline void cWorker::nat64stateful_lan_handle()
 		const auto& nat64stateful = base.globalBase->nat64statefuls[metadata->flow.data.nat64stateful_id];
 
 		dataplane::globalBase::nat64stateful_lan_value* value_lookup;
-		dataplane::spinlock_nonrecursive_t* locker;
-		const uint32_t hash = nat64stateful_lan_state->lookup(key, value_lookup, locker);
-		if (value_lookup)
+		if (nat64stateful_lan_state->lookup_optimistic(hashes[mbuf_i], key, value, value_lookup) &&
+		    nat64stateful_flags(mbuf, value.flags) == value.flags)
 		{
-			if (metadata->transport_headerType == IPPROTO_TCP)
+			/// tcp flags are not changed: only timestamp is updated, without lock
+			const uint16_t timestamp = basePermanently.globalBaseAtomic->currentTime;
+			if (value.timestamp_last_packet != timestamp)
 			{
-				rte_tcp_hdr* tcp_header = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
-				if (tcp_header->tcp_flags & TCP_SYN_FLAG)
-				{
-					value_lookup->flags = tcp_header->tcp_flags;
-				}
-				else
-				{
-					value_lookup->flags |= tcp_header->tcp_flags;
-				}
+				__atomic_store_n(&value_lookup->timestamp_last_packet, timestamp, __ATOMIC_RELAXED);
+				value.timestamp_last_packet = timestamp;
 			}
-
-			value_lookup->timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
-			value = *value_lookup;
-			locker->unlock();
 		}
 		else
 		{
-			locker->unlock();
-
-			if (!nat64stateful.pool_size)
-			{
-				counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::pool_is_empty]++;
-				drop(mbuf);
-				continue;
-			}
-
-			uint32_t client_hash = nat64stateful_hash(key.ipv6_source);
-
-			uint16_t port_step = rte_cpu_to_be_16((client_hash >> 17) / YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES);
-			if ((port_step & 0x00F8) == 0) ///< 0-1023. @todo: config
+			dataplane::globalBase::nat64stateful::lan_ht::locker_t* locker;
+			const uint32_t hash = nat64stateful_lan_state->lookup(hashes[mbuf_i], key, value_lookup, locker);
+			if (value_lookup)
 			{
-				port_step += 0x0004; ///< + 1024
+				value_lookup->flags = nat64stateful_flags(mbuf, value_lookup->flags);
+				value_lookup->timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
+				value = *value_lookup;
+				locker->unlock();
 			}
-
-			dataplane::globalBase::nat64stateful_wan_key wan_key;
-			wan_key.nat64stateful_id = key.nat64stateful_id;
-			wan_key.proto = key.proto;
-			wan_key.ipv4_source.address = *(uint32_t*)&key.ipv6_destination.bytes[12]; ///< @todo [12] -> [any]
-			wan_key.ipv4_destination = base.globalBase->nat64stateful_pool[nat64stateful.pool_start + client_hash % nat64stateful.pool_size];
-			wan_key.port_source = key.port_destination;
-			wan_key.port_destination = key.port_source;
-
-			uint32_t wan_hash;
-			dataplane::globalBase::nat64stateful_wan_value* wan_value_lookup;
-			dataplane::spinlock_nonrecursive_t* wan_locker;
-			for (unsigned int try_i = 0;
-			     try_i < YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES;
-			     try_i++)
+			else
 			{
-				wan_key.port_destination &= basePermanently.nat64stateful_numa_mask;
-				wan_key.port_destination ^= basePermanently.nat64stateful_numa_id;
+				locker->unlock();
 
-				if ((wan_key.port_destination & 0x00F8) == 0) ///< 0-1023. @todo: config
+				if (!nat64stateful.pool_size)
 				{
-					wan_key.port_destination += 0x0004; ///< + 1024
+					counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::pool_is_empty]++;
+					drop(mbuf);
+					continue;
 				}
 
-				wan_hash = nat64stateful_wan_state->lookup(wan_key, wan_value_lookup, wan_locker);
-				if (!wan_value_lookup)
+				uint32_t client_hash = nat64stateful_hash(key.ipv6_source);
+
+				dataplane::globalBase::nat64stateful_wan_key wan_key;
+				wan_key.nat64stateful_id = key.nat64stateful_id;
+				wan_key.proto = key.proto;
+				wan_key.ipv4_source.address = *(uint32_t*)&key.ipv6_destination.bytes[12]; ///< @todo [12] -> [any]
+				wan_key.port_source = key.port_destination;
+
+				uint32_t wan_hash;
+				dataplane::globalBase::nat64stateful_wan_value* wan_value_lookup;
+				dataplane::globalBase::nat64stateful::wan_ht::locker_t* wan_locker;
+				dataplane::globalBase::nat64stateful_lan_block_value* block_value_lookup = nullptr;
+				dataplane::globalBase::nat64stateful::lan_block_ht::locker_t* block_locker = nullptr;
+				if (nat64stateful.port_block_size)
 				{
-					/// success
-					counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::tries_array_start + try_i]++;
-					break;
+					if (!nat64stateful_lan_block_port(nat64stateful,
+					                                  key,
+					                                  client_hash,
+					                                  wan_key,
+					                                  wan_hash,
+					                                  wan_locker,
+					                                  block_value_lookup,
+					                                  block_locker))
+					{
+						drop(mbuf);
+						continue;
+					}
 				}
-				wan_locker->unlock();
+				else
+				{
+					uint16_t port_step = rte_cpu_to_be_16((client_hash >> 17) / YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES);
+					if ((port_step & 0x00F8) == 0) ///< 0-1023. @todo: config
+					{
+						port_step += 0x0004; ///< + 1024
+					}
 
-				wan_key.port_destination += port_step;
-			}
+					wan_key.ipv4_destination = base.globalBase->nat64stateful_pool[nat64stateful.pool_start + client_hash % nat64stateful.pool_size];
+					wan_key.port_destination = key.port_source;
 
-			if (wan_value_lookup)
-			{
-				/// unluck. state not created
+					for (unsigned int try_i = 0;
+					     try_i < YANET_CONFIG_NAT64STATEFUL_INSERT_TRIES;
+					     try_i++)
+					{
+						wan_key.port_destination &= basePermanently.nat64stateful_numa_mask;
+						wan_key.port_destination ^= basePermanently.nat64stateful_numa_id;
+
+						if ((wan_key.port_destination & 0x00F8) == 0) ///< 0-1023. @todo: config
+						{
+							wan_key.port_destination += 0x0004; ///< + 1024
+						}
+
+						wan_hash = nat64stateful_wan_state->lookup(wan_key, wan_value_lookup, wan_locker);
+						if (!wan_value_lookup)
+						{
+							/// success
+							counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::tries_array_start + try_i]++;
+							break;
+						}
+						wan_locker->unlock();
+
+						wan_key.port_destination += port_step;
+					}
 
-				counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::tries_failed]++;
-				drop(mbuf);
-				continue;
-			}
+					if (wan_value_lookup)
+					{
+						/// unluck. state not created
 
-			{
-				dataplane::globalBase::nat64stateful_wan_value wan_value;
-				memcpy(wan_value.ipv6_source.bytes, key.ipv6_destination.bytes, 12);
-				wan_value.port_destination = key.port_source;
-				wan_value.timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime - YANET_CONFIG_STATE_TIMEOUT_MAX;
-				wan_value.ipv6_destination = key.ipv6_source;
-				wan_value.flags = 0;
+						counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::tries_failed]++;
+						drop(mbuf);
+						continue;
+					}
+				}
 
-				bool insert_success = nat64stateful_wan_state->insert(wan_hash, wan_key, wan_value);
-				wan_locker->unlock();
+				{
+					dataplane::globalBase::nat64stateful_wan_value wan_value;
+					memcpy(wan_value.ipv6_source.bytes, key.ipv6_destination.bytes, 12);
+					wan_value.port_destination = key.port_source;
+					wan_value.timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime - YANET_CONFIG_STATE_TIMEOUT_MAX;
+					wan_value.ipv6_destination = key.ipv6_source;
+					wan_value.flags = 0;
 
-				counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::wan_state_insert + (tCounterId)insert_success]++;
+					bool insert_success = nat64stateful_wan_state->insert(wan_hash, wan_key, wan_value);
+					wan_locker->unlock();
 
-				if (!insert_success)
-				{
-					drop(mbuf);
-					continue;
-				}
+					if (block_locker)
+					{
+						block_value_lookup->states_count += (uint32_t)insert_success;
+						block_value_lookup->timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
+						block_locker->unlock();
+					}
 
-				/// @todo: create cross-numa state over slowworker?
-				for (unsigned int numa_i = 0;
-				     numa_i < YANET_CONFIG_NUMA_SIZE;
-				     numa_i++)
-				{
-					auto* globalbase_atomic = basePermanently.globalBaseAtomics[numa_i];
-					if (globalbase_atomic == basePermanently.globalBaseAtomic)
+					counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::wan_state_insert + (tCounterId)insert_success]++;
+
+					if (!insert_success)
 					{
+						drop(mbuf);
 						continue;
 					}
-					else if (globalbase_atomic == nullptr)
+
+					/// @todo: create cross-numa state over slowworker?
+					for (unsigned int numa_i = 0;
+					     numa_i < YANET_CONFIG_NUMA_SIZE;
+					     numa_i++)
 					{
-						break;
+						auto* globalbase_atomic = basePermanently.globalBaseAtomics[numa_i];
+						if (globalbase_atomic == basePermanently.globalBaseAtomic)
+						{
+							continue;
+						}
+						else if (globalbase_atomic == nullptr)
+						{
+							break;
+						}
+
+						bool insert_success = globalbase_atomic->nat64stateful_wan_state->insert_or_update(wan_key, wan_value);
+						counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::wan_state_cross_numa_insert + (tCounterId)insert_success]++;
 					}
-
-					bool insert_success = globalbase_atomic->nat64stateful_wan_state->insert_or_update(wan_key, wan_value);
-					counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::wan_state_cross_numa_insert + (tCounterId)insert_success]++;
 				}
-			}
-
-			{
-				value.ipv4_source = wan_key.ipv4_destination;
-				value.port_source = wan_key.port_destination;
-				value.timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
-				value.flags = 0;
 
-				if (metadata->transport_headerType == IPPROTO_TCP)
 				{
-					rte_tcp_hdr* tcp_header = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
-					value.flags = tcp_header->tcp_flags;
-				}
+					value.ipv4_source = wan_key.ipv4_destination;
+					value.port_source = wan_key.port_destination;
+					value.timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
+					value.flags = 0;
 
-				locker->lock();
+					if (metadata->transport_headerType == IPPROTO_TCP)
+					{
+						rte_tcp_hdr* tcp_header = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
+						value.flags = tcp_header->tcp_flags;
+					}
 
-				bool insert_success = nat64stateful_lan_state->insert(hash, key, value);
-				locker->unlock();
+					locker->lock();
 
-				counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::lan_state_insert + (tCounterId)insert_success]++;
+					bool insert_success = nat64stateful_lan_state->insert(hash, key, value);
+					locker->unlock();
 
-				/// @todo: create cross-numa state over slowworker?
-				value.timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime - YANET_CONFIG_STATE_TIMEOUT_MAX;
-				for (unsigned int numa_i = 0;
-				     numa_i < YANET_CONFIG_NUMA_SIZE;
-				     numa_i++)
-				{
-					auto* globalbase_atomic = basePermanently.globalBaseAtomics[numa_i];
-					if (globalbase_atomic == basePermanently.globalBaseAtomic)
-					{
-						continue;
-					}
-					else if (globalbase_atomic == nullptr)
+					counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::lan_state_insert + (tCounterId)insert_success]++;
+
+					/// @todo: create cross-numa state over slowworker?
+					value.timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime - YANET_CONFIG_STATE_TIMEOUT_MAX;
+					for (unsigned int numa_i = 0;
+					     numa_i < YANET_CONFIG_NUMA_SIZE;
+					     numa_i++)
 					{
-						break;
+						auto* globalbase_atomic = basePermanently.globalBaseAtomics[numa_i];
+						if (globalbase_atomic == basePermanently.globalBaseAtomic)
+						{
+							continue;
+						}
+						else if (globalbase_atomic == nullptr)
+						{
+							break;
+						}
+
+						bool insert_success = globalbase_atomic->nat64stateful_lan_state->insert_or_update(key, value);
+						counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::lan_state_cross_numa_insert + (tCounterId)insert_success]++;
 					}
-
-					bool insert_success = globalbase_atomic->nat64stateful_lan_state->insert_or_update(key, value);
-					counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::lan_state_cross_numa_insert + (tCounterId)insert_success]++;
 				}
 			}
 		}
@@ -2925,6 +3148,10 @@ inline void cWorker::nat64stateful_wan_handle()
 		}
 	}
 
+	nat64stateful_wan_state->prefetch(hashes,
+	                                  nat64stateful_wan_keys,
+	                                  nat64stateful_wan_stack.mbufsCount);
+
 	dataplane::globalBase::nat64stateful_wan_value value;
 	for (unsigned int mbuf_i = 0;
 	     mbuf_i < nat64stateful_wan_stack.mbufsCount;
@@ -2938,33 +3165,35 @@ inline void cWorker::nat64stateful_wan_handle()
 		const auto& nat64stateful = base.globalBase->nat64statefuls[metadata->flow.data.nat64stateful_id];
 
 		dataplane::globalBase::nat64stateful_wan_value* value_lookup;
-		dataplane::spinlock_nonrecursive_t* locker;
-		nat64stateful_wan_state->lookup(key, value_lookup, locker);
-		if (!value_lookup)
-		{
-			locker->unlock();
-
-			counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::wan_state_not_found]++;
-			drop(mbuf);
-			continue;
-		}
-
-		if (metadata->transport_headerType == IPPROTO_TCP)
+		if (nat64stateful_wan_state->lookup_optimistic(hashes[mbuf_i], key, value, value_lookup) &&
+		    nat64stateful_flags(mbuf, value.flags) == value.flags)
 		{
-			rte_tcp_hdr* tcp_header = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
-			if (tcp_header->tcp_flags & TCP_SYN_FLAG)
+			/// tcp flags are not changed: only timestamp is updated, without lock
+			const uint16_t timestamp = basePermanently.globalBaseAtomic->currentTime;
+			if (value.timestamp_last_packet != timestamp)
 			{
-				value_lookup->flags = tcp_header->tcp_flags;
+				__atomic_store_n(&value_lookup->timestamp_last_packet, timestamp, __ATOMIC_RELAXED);
+				value.timestamp_last_packet = timestamp;
 			}
-			else
+		}
+		else
+		{
+			dataplane::globalBase::nat64stateful::wan_ht::locker_t* locker;
+			nat64stateful_wan_state->lookup(hashes[mbuf_i], key, value_lookup, locker);
+			if (!value_lookup)
 			{
-				value_lookup->flags |= tcp_header->tcp_flags;
+				locker->unlock();
+
+				counters[nat64stateful.counter_id + (tCounterId)nat64stateful::module_counter::wan_state_not_found]++;
+				drop(mbuf);
+				continue;
 			}
-		}
 
-		value_lookup->timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
-		value = *value_lookup;
-		locker->unlock();
+			value_lookup->flags = nat64stateful_flags(mbuf, value_lookup->flags);
+			value_lookup->timestamp_last_packet = basePermanently.globalBaseAtomic->currentTime;
+			value = *value_lookup;
+			locker->unlock();
+		}
 
 		nat64stateful_wan_translation(mbuf, value);
 
@@ -3065,6 +3294,25 @@ inline void cWorker::nat64stateful_wan_flow(rte_mbuf* mbuf,
 	}
 }
 
+inline uint32_t cWorker::nat64stateful_flags(rte_mbuf* mbuf,
+                                             const uint32_t flags)
+{
+	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+
+	if (metadata->transport_headerType != IPPROTO_TCP)
+	{
+		return flags;
+	}
+
+	rte_tcp_hdr* tcp_header = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
+	if (tcp_header->tcp_flags & TCP_SYN_FLAG)
+	{
+		return tcp_header->tcp_flags;
+	}
+
+	return flags | tcp_header->tcp_flags;
+}
+
 inline void cWorker::nat64stateless_ingress_entry_checked(rte_mbuf* mbuf)
 {
 	nat64stateless_ingress_stack.insert(mbuf);
@@ -3636,7 +3884,6 @@ inline void cWorker::balancer_handle()
 		rte_mbuf* mbuf = balancer_stack.mbufs[mbuf_i];
 		dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 
-		calcHash(mbuf);
 		metadata->hash = rte_hash_crc(&metadata->flowLabel, 4, metadata->hash);
 
 		auto& key = balancer_keys[mbuf_i];
@@ -3712,6 +3959,10 @@ inline void cWorker::balancer_handle()
 		}
 	}
 
+	basePermanently.globalBaseAtomic->balancer_state.prefetch(hashes,
+	                                                          balancer_keys,
+	                                                          balancer_stack.mbufsCount);
+
 	for (unsigned int mbuf_i = 0;
 	     mbuf_i < balancer_stack.mbufsCount;
 	     mbuf_i++)
@@ -3733,9 +3984,29 @@ inline void cWorker::balancer_handle()
 
 		/// @todo: BALANCER TCP SYN
 
+		dataplane::globalBase::balancer_state_value_t value_copy;
 		dataplane::globalBase::balancer_state_value_t* value;
-		dataplane::spinlock_nonrecursive_t* locker;
-		const uint32_t hash = basePermanently.globalBaseAtomic->balancer_state.lookup(key, value, locker);
+		if (basePermanently.globalBaseAtomic->balancer_state.lookup_optimistic(hashes[mbuf_i], key, value_copy, value) &&
+		    (base.globalBase->balancer_real_states[value_copy.real_unordered_id].flags & YANET_BALANCER_FLAG_ENABLED))
+		{
+			/// real is enabled: only timestamp is updated, without lock
+			const uint16_t timestamp = basePermanently.globalBaseAtomic->currentTime;
+			if (value_copy.timestamp_last_packet != timestamp)
+			{
+				__atomic_store_n(&value->timestamp_last_packet, timestamp, __ATOMIC_RELAXED);
+			}
+
+			const auto& real_unordered = base.globalBase->balancer_reals[value_copy.real_unordered_id];
+			balancer_tunnel(mbuf, service, real_unordered, real_unordered.counter_id);
+
+			counters[(service.atomic1 >> 8) + (tCounterId)balancer::service_counter::packets]++;
+			counters[(service.atomic1 >> 8) + (tCounterId)balancer::service_counter::bytes] += mbuf->pkt_len;
+			balancer_flow(mbuf, balancer.flow);
+			continue;
+		}
+
+		dataplane::globalBase::balancer_state_ht::locker_t* locker;
+		const uint32_t hash = basePermanently.globalBaseAtomic->balancer_state.lookup(hashes[mbuf_i], key, value, locker);
 		bool rescheduleReal = false;
 		if (value)
 		{
@@ -4104,6 +4375,9 @@ inline void cWorker::balancer_icmp_reply_handle()
 			ipv4Header->src_addr = ipv4Header->dst_addr;
 			ipv4Header->dst_addr = tmp_for_swap;
 
+			/// addresses are swapped, cached hash is invalid
+			calcHash(mbuf);
+
 			// it is a reply, ttl starts anew, route_handle() will decrease it and modify checksum accordingly
 			ipv4Header->time_to_live = 65;
 
@@ -4132,6 +4406,9 @@ inline void cWorker::balancer_icmp_reply_handle()
 			memcpy(ipv6Header->src_addr, ipv6Header->dst_addr, sizeof(ipv6Header->src_addr));
 			memcpy(ipv6Header->dst_addr, tmp_for_swap, sizeof(tmp_for_swap));
 
+			/// addresses are swapped, cached hash is invalid
+			calcHash(mbuf);
+
 			ipv6Header->hop_limits = 65; // it is a reply, hop_limits start anew
 
 			uint16_t icmpv6_checksum = ~icmpv6Header->checksum;
@@ -4332,7 +4609,7 @@ inline void cWorker::balancer_icmp_forward_handle()
 		const auto& service = base.globalBase->balancer_services[service_id];
 
 		dataplane::globalBase::balancer_state_value_t* value;
-		dataplane::spinlock_nonrecursive_t* locker;
+		dataplane::globalBase::balancer_state_ht::locker_t* locker;
 		basePermanently.globalBaseAtomic->balancer_state.lookup(key, value, locker);
 
 		if (value)
@@ -4384,98 +4661,110 @@ inline void cWorker::balancer_icmp_forward_handle()
 	balancer_icmp_forward_stack.clear();
 }
 
-inline bool cWorker::acl_try_keepstate(rte_mbuf* mbuf)
+inline void cWorker::acl_state_key(rte_mbuf* mbuf,
+                                  dataplane::globalBase::fw4_state_key_t& key)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+	rte_ipv4_hdr* ipv4Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv4_hdr*, metadata->network_headerOffset);
 
-	if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
-	{
-		rte_ipv4_hdr* ipv4Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv4_hdr*, metadata->network_headerOffset);
-
-		dataplane::globalBase::fw4_state_key_t key;
-		key.proto = metadata->transport_headerType;
-		key.__nap = 0;
-		key.src_addr.address = ipv4Header->src_addr;
-		key.dst_addr.address = ipv4Header->dst_addr;
-
-		if (metadata->transport_headerType == IPPROTO_TCP)
-		{
-			rte_tcp_hdr* tcpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
-
-			key.src_port = rte_be_to_cpu_16(tcpHeader->src_port);
-			key.dst_port = rte_be_to_cpu_16(tcpHeader->dst_port);
-		}
-		else if (metadata->transport_headerType == IPPROTO_UDP)
-		{
-			rte_udp_hdr* udpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_udp_hdr*, metadata->transport_headerOffset);
+	key.proto = metadata->transport_headerType;
+	key.__nap = 0;
+	key.src_addr.address = ipv4Header->src_addr;
+	key.dst_addr.address = ipv4Header->dst_addr;
 
-			key.src_port = rte_be_to_cpu_16(udpHeader->src_port);
-			key.dst_port = rte_be_to_cpu_16(udpHeader->dst_port);
-		}
-		else // todo: sctp, ddcp, udp-lite
-		{
-			key.src_port = 0;
-			key.dst_port = 0;
-		}
+	if (metadata->transport_headerType == IPPROTO_TCP)
+	{
+		rte_tcp_hdr* tcpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
 
-		dataplane::globalBase::fw_state_value_t* value;
-		dataplane::spinlock_nonrecursive_t* locker;
-		basePermanently.globalBaseAtomic->fw4_state->lookup(key, value, locker);
+		key.src_port = rte_be_to_cpu_16(tcpHeader->src_port);
+		key.dst_port = rte_be_to_cpu_16(tcpHeader->dst_port);
+	}
+	else if (metadata->transport_headerType == IPPROTO_UDP)
+	{
+		rte_udp_hdr* udpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_udp_hdr*, metadata->transport_headerOffset);
 
-		return acl_try_keepstate(mbuf, value, locker);
+		key.src_port = rte_be_to_cpu_16(udpHeader->src_port);
+		key.dst_port = rte_be_to_cpu_16(udpHeader->dst_port);
 	}
-	else if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6))
+	else // todo: sctp, ddcp, udp-lite
 	{
-		rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
+		key.src_port = 0;
+		key.dst_port = 0;
+	}
+}
 
-		dataplane::globalBase::fw6_state_key_t key;
-		key.proto = metadata->transport_headerType;
-		key.__nap = 0;
-		rte_memcpy(key.src_addr.bytes, ipv6Header->src_addr, 16);
-		rte_memcpy(key.dst_addr.bytes, ipv6Header->dst_addr, 16);
+inline void cWorker::acl_state_key(rte_mbuf* mbuf,
+                                  dataplane::globalBase::fw6_state_key_t& key)
+{
+	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+	rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
 
-		if (metadata->transport_headerType == IPPROTO_TCP)
-		{
-			rte_tcp_hdr* tcpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
+	key.proto = metadata->transport_headerType;
+	key.__nap = 0;
+	rte_memcpy(key.src_addr.bytes, ipv6Header->src_addr, 16);
+	rte_memcpy(key.dst_addr.bytes, ipv6Header->dst_addr, 16);
 
-			key.src_port = rte_be_to_cpu_16(tcpHeader->src_port);
-			key.dst_port = rte_be_to_cpu_16(tcpHeader->dst_port);
-		}
-		else if (metadata->transport_headerType == IPPROTO_UDP)
-		{
-			rte_udp_hdr* udpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_udp_hdr*, metadata->transport_headerOffset);
+	if (metadata->transport_headerType == IPPROTO_TCP)
+	{
+		rte_tcp_hdr* tcpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
 
-			key.src_port = rte_be_to_cpu_16(udpHeader->src_port);
-			key.dst_port = rte_be_to_cpu_16(udpHeader->dst_port);
-		}
-		else // todo: sctp, ddcp, udp-lite
-		{
-			key.src_port = 0;
-			key.dst_port = 0;
-		}
+		key.src_port = rte_be_to_cpu_16(tcpHeader->src_port);
+		key.dst_port = rte_be_to_cpu_16(tcpHeader->dst_port);
+	}
+	else if (metadata->transport_headerType == IPPROTO_UDP)
+	{
+		rte_udp_hdr* udpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_udp_hdr*, metadata->transport_headerOffset);
 
-		dataplane::globalBase::fw_state_value_t* value;
-		dataplane::spinlock_nonrecursive_t* locker;
-		basePermanently.globalBaseAtomic->fw6_state->lookup(key, value, locker);
+		key.src_port = rte_be_to_cpu_16(udpHeader->src_port);
+		key.dst_port = rte_be_to_cpu_16(udpHeader->dst_port);
+	}
+	else // todo: sctp, ddcp, udp-lite
+	{
+		key.src_port = 0;
+		key.dst_port = 0;
+	}
+}
 
-		return acl_try_keepstate(mbuf, value, locker);
+inline bool cWorker::acl_try_keepstate(rte_mbuf* mbuf,
+                                       const uint32_t hash,
+                                       const dataplane::globalBase::fw4_state_key_t& key)
+{
+	common::globalBase::tFlow flow;
+	if (!acl_keepstate_hit(mbuf, basePermanently.globalBaseAtomic->fw4_state, hash, key, flow))
+	{
+		// No record found, the caller should continue as usual.
+		return false;
 	}
 
-	return false;
+	// Handle the packet according its flow.
+	acl_ingress_flow(mbuf, flow);
+	return true;
 }
 
 inline bool cWorker::acl_try_keepstate(rte_mbuf* mbuf,
-                                       dataplane::globalBase::fw_state_value_t* value,
-                                       dataplane::spinlock_nonrecursive_t* locker)
+                                       const uint32_t hash,
+                                       const dataplane::globalBase::fw6_state_key_t& key)
 {
-	// Checking both value and locker for non-being-nullptr seems redundant.
-	if (value == nullptr)
+	common::globalBase::tFlow flow;
+	if (!acl_keepstate_hit(mbuf, basePermanently.globalBaseAtomic->fw6_state, hash, key, flow))
 	{
 		// No record found, the caller should continue as usual.
-		locker->unlock();
 		return false;
 	}
 
+	// Handle the packet according its flow.
+	acl_ingress_flow(mbuf, flow);
+	return true;
+}
+
+template<typename state_ht_t,
+         typename key_t>
+inline bool cWorker::acl_keepstate_hit(rte_mbuf* mbuf,
+                                       state_ht_t* state_ht,
+                                       const uint32_t hash,
+                                       const key_t& key,
+                                       common::globalBase::tFlow& flow)
+{
 	uint8_t flags = 0;
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 	if (metadata->transport_headerType == IPPROTO_TCP)
@@ -4484,16 +4773,45 @@ inline bool cWorker::acl_try_keepstate(rte_mbuf* mbuf,
 		flags = common::fwstate::from_tcp_flags(tcpHeader->tcp_flags);
 	}
 
+	const uint32_t current_time = basePermanently.globalBaseAtomic->currentTime;
+
+	dataplane::globalBase::fw_state_value_t value_copy;
+	dataplane::globalBase::fw_state_value_t* value;
+	if (!state_ht->lookup_optimistic(hash, key, value_copy, value))
+	{
+		return false;
+	}
+
+	if ((value_copy.tcp.dst_flags | flags) == value_copy.tcp.dst_flags)
+	{
+		/// tcp flags are already known: update counters without lock
+		flow = value_copy.flow;
+		if (value_copy.last_seen != current_time)
+		{
+			__atomic_store_n(&value->last_seen, current_time, __ATOMIC_RELAXED);
+		}
+		__atomic_add_fetch(&value->packets_since_last_sync, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&value->packets_backward, 1, __ATOMIC_RELAXED);
+		return true;
+	}
+
+	typename state_ht_t::locker_t* locker;
+	state_ht->lookup(hash, key, value, locker);
+	if (value == nullptr)
+	{
+		/// removed after optimistic lookup
+		locker->unlock();
+		return false;
+	}
+
 	// Copy the flow to prevent concurrent usage. In the other thread there can be garbage collector active.
-	common::globalBase::tFlow flow = value->flow;
-	value->last_seen = basePermanently.globalBaseAtomic->currentTime;
+	flow = value->flow;
+	value->last_seen = current_time;
 	value->packets_since_last_sync++;
 	value->packets_backward++;
 	value->tcp.dst_flags |= flags;
 	locker->unlock();
 
-	// Handle the packet according its flow.
-	acl_ingress_flow(mbuf, flow);
 	return true;
 }
 
@@ -4563,7 +4881,7 @@ inline void cWorker::acl_create_keepstate(rte_mbuf* mbuf, tAclId aclId, const co
 			}
 
 			dataplane::globalBase::fw_state_value_t* lookup_value;
-			dataplane::spinlock_nonrecursive_t* locker;
+			dataplane::globalBase::acl::ipv4_states_ht::locker_t* locker;
 			const uint32_t hash = atomic->fw4_state->lookup(key, lookup_value, locker);
 			if (lookup_value)
 			{
@@ -4660,7 +4978,7 @@ inline void cWorker::acl_create_keepstate(rte_mbuf* mbuf, tAclId aclId, const co
 			}
 
 			dataplane::globalBase::fw_state_value_t* lookup_value;
-			dataplane::spinlock_nonrecursive_t* locker;
+			dataplane::globalBase::acl::ipv6_states_ht::locker_t* locker;
 			const uint32_t hash = atomic->fw6_state->lookup(key, lookup_value, locker);
 			if (lookup_value)
 			{
@@ -4699,32 +5017,68 @@ inline void cWorker::acl_create_keepstate(rte_mbuf* mbuf, tAclId aclId, const co
 
 inline void cWorker::acl_state_emit(tAclId aclId, const dataplane::globalBase::fw_state_sync_frame_t& frame)
 {
-	rte_mbuf* mbuf = rte_pktmbuf_alloc(mempool);
-	if (mbuf == nullptr)
+	constexpr uint16_t payload_offset = sizeof(rte_ether_hdr) + sizeof(rte_vlan_hdr) + sizeof(rte_ipv6_hdr) + sizeof(rte_udp_hdr);
+
+	if (rte_mbuf* mbuf = fw_state_sync_batch.take_other(aclId))
 	{
-		stats.fwsync_multicast_egress_drops++;
-		return;
+		acl_state_emit_flush(mbuf);
 	}
 
-	/// @todo: init metadata
+	if (fw_state_sync_batch.get() == nullptr)
+	{
+		rte_mbuf* mbuf = rte_pktmbuf_alloc(mempool);
+		if (mbuf == nullptr)
+		{
+			stats.fwsync_multicast_egress_drops++;
+			return;
+		}
 
-	constexpr uint16_t payload_offset = sizeof(rte_ether_hdr) + sizeof(rte_vlan_hdr) + sizeof(rte_ipv6_hdr) + sizeof(rte_udp_hdr);
-	rte_pktmbuf_append(mbuf, payload_offset + sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+		/// @todo: init metadata
 
-	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
-	metadata->flow.data.aclId = aclId;
+		rte_pktmbuf_append(mbuf, payload_offset);
 
-	// We're only filling the payload here.
-	// Other headers will be set in the slow worker before emitting.
-	void* payload = rte_pktmbuf_mtod_offset(mbuf, void*, payload_offset);
+		dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
+		metadata->flow.data.aclId = aclId;
+
+		// We're only filling the payload here.
+		// Other headers will be set in the slow worker before emitting.
+		metadata->flow.type = common::globalBase::eFlowType::slowWorker_fw_sync;
+
+		fw_state_sync_batch.start(mbuf, aclId, rte_get_tsc_cycles());
+	}
+
+	void* payload = rte_pktmbuf_append(fw_state_sync_batch.get(), sizeof(dataplane::globalBase::fw_state_sync_frame_t));
 	rte_memcpy(payload, (void*)&frame, sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+	stats.fwsync_multicast_egress_imm_frames++;
+
+	if (rte_mbuf* mbuf = fw_state_sync_batch.append())
+	{
+		acl_state_emit_flush(mbuf);
+	}
+}
 
+inline void cWorker::acl_state_emit_flush(rte_mbuf* mbuf)
+{
 	// Push packet to the ring through stack.
-	metadata->flow.type = common::globalBase::eFlowType::slowWorker_fw_sync;
 	controlPlane_stack.insert(mbuf);
 	stats.fwsync_multicast_egress_imm_packets++;
 }
 
+/// called on each iteration of worker and of slow worker
+inline void cWorker::acl_state_emit_flush_expired()
+{
+	if (likely(fw_state_sync_batch.get() == nullptr))
+	{
+		return;
+	}
+
+	if (rte_mbuf* mbuf = fw_state_sync_batch.take_expired(rte_get_tsc_cycles()))
+	{
+		acl_state_emit_flush(mbuf);
+		controlPlane_handle();
+	}
+}
+
 inline void cWorker::acl_egress_entry(rte_mbuf* mbuf, tAclId aclId)
 {
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
@@ -5221,11 +5575,18 @@ inline bool cWorker::acl_egress_try_keepstate(rte_mbuf* mbuf)
 			key.dst_port = 0;
 		}
 
-		dataplane::globalBase::fw_state_value_t* value;
-		dataplane::spinlock_nonrecursive_t* locker;
-		basePermanently.globalBaseAtomic->fw4_state->lookup(key, value, locker);
+		auto* fw4_state = basePermanently.globalBaseAtomic->fw4_state;
+
+		common::globalBase::tFlow flow;
+		if (!acl_keepstate_hit(mbuf, fw4_state, fw4_state->calculate_hash(key), key, flow))
+		{
+			// No record found, the caller should continue as usual.
+			return false;
+		}
 
-		return acl_egress_try_keepstate(mbuf, value, locker);
+		// Handle the packet according its flow.
+		acl_egress_flow(mbuf, flow);
+		return true;
 	}
 	else if (metadata->network_headerType == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6))
 	{
@@ -5257,47 +5618,21 @@ inline bool cWorker::acl_egress_try_keepstate(rte_mbuf* mbuf)
 			key.dst_port = 0;
 		}
 
-		dataplane::globalBase::fw_state_value_t* value;
-		dataplane::spinlock_nonrecursive_t* locker;
-		basePermanently.globalBaseAtomic->fw6_state->lookup(key, value, locker);
-
-		return acl_egress_try_keepstate(mbuf, value, locker);
-	}
-
-	return false;
-}
+		auto* fw6_state = basePermanently.globalBaseAtomic->fw6_state;
 
-inline bool cWorker::acl_egress_try_keepstate(rte_mbuf* mbuf,
-                                              dataplane::globalBase::fw_state_value_t* value,
-                                              dataplane::spinlock_nonrecursive_t* locker)
-{
-	// Checking both value and locker for non-being-nullptr seems redundant.
-	if (value == nullptr)
-	{
-		// No record found, the caller should continue as usual.
-		locker->unlock();
-		return false;
-	}
+		common::globalBase::tFlow flow;
+		if (!acl_keepstate_hit(mbuf, fw6_state, fw6_state->calculate_hash(key), key, flow))
+		{
+			// No record found, the caller should continue as usual.
+			return false;
+		}
 
-	uint8_t flags = 0;
-	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
-	if (metadata->transport_headerType == IPPROTO_TCP)
-	{
-		rte_tcp_hdr* tcpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_tcp_hdr*, metadata->transport_headerOffset);
-		flags = common::fwstate::from_tcp_flags(tcpHeader->tcp_flags);
+		// Handle the packet according its flow.
+		acl_egress_flow(mbuf, flow);
+		return true;
 	}
 
-	// Copy the flow to prevent concurrent usage. In the other thread there can be garbage collector active.
-	common::globalBase::tFlow flow = value->flow;
-	value->last_seen = basePermanently.globalBaseAtomic->currentTime;
-	value->packets_since_last_sync++;
-	value->packets_backward++;
-	value->tcp.dst_flags |= flags;
-	locker->unlock();
-
-	// Handle the packet according its flow.
-	acl_egress_flow(mbuf, flow);
-	return true;
+	return false;
 }
 
 inline void cWorker::acl_egress_flow(rte_mbuf* mbuf, const common::globalBase::tFlow& flow)
@@ -5354,7 +5689,6 @@ inline void cWorker::dregress_entry(rte_mbuf* mbuf)
 
 	/// @todo: opt
 	preparePacket(mbuf);
-	calcHash(mbuf);
 
 	slowWorker_entry_normalPriority(mbuf, common::globalBase::eFlowType::slowWorker_dregress);
 }
@@ -5364,6 +5698,17 @@ inline void cWorker::controlPlane(rte_mbuf* mbuf)
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 	metadata->flow.type = common::globalBase::eFlowType::slowWorker_kni;
 
+#ifndef CONFIG_YADECAP_AUTOTEST
+	/// multicast may be fw state sync, it is checked by slow worker
+	generic_rte_ether_hdr* ethernetHeader = rte_pktmbuf_mtod(mbuf, generic_rte_ether_hdr*);
+	if (kernel_interface_queues[metadata->fromPortId].queue_id &&
+	    !(ethernetHeader->dst_addr.addr_bytes[0] & 1))
+	{
+		kernel_interface_stack[metadata->fromPortId].insert(mbuf);
+		return;
+	}
+#endif
+
 	controlPlane_stack.insert(mbuf);
 }
 
@@ -5392,6 +5737,65 @@ inline void cWorker::controlPlane_handle()
 	controlPlane_stack.clear();
 }
 
+inline void cWorker::kernel_interface_handle()
+{
+	for (tPortId portId = 0;
+	     portId < basePermanently.ports_count;
+	     portId++)
+	{
+		auto& stack = kernel_interface_stack[portId];
+		if (likely(stack.mbufsCount == 0))
+		{
+			continue;
+		}
+
+		auto& queue = kernel_interface_queues[portId];
+
+		uint64_t bytes = 0;
+		for (unsigned int mbuf_i = 0;
+		     mbuf_i < stack.mbufsCount;
+		     mbuf_i++)
+		{
+			bytes += rte_pktmbuf_pkt_len(stack.mbufs[mbuf_i]);
+		}
+
+		/// sent mbufs are freed by virtio tx cleanup on this core, so worker mempool stays single producer
+		uint16_t txSize = rte_eth_tx_burst(queue.kernel_port_id,
+		                                   queue.queue_id,
+		                                   stack.mbufs,
+		                                   stack.mbufsCount);
+
+		queue.packets += txSize;
+		queue.drops += stack.mbufsCount - txSize;
+
+		for (;
+		     txSize < stack.mbufsCount;
+		     txSize++)
+		{
+			bytes -= rte_pktmbuf_pkt_len(stack.mbufs[txSize]);
+			rte_pktmbuf_free(stack.mbufs[txSize]);
+		}
+
+		queue.bytes += bytes;
+
+		stack.clear();
+	}
+}
+
+#ifdef YANET_CONFIG_WORKER_PROFILE
+inline unsigned int cWorker::kernel_interface_stack_count() const
+{
+	unsigned int count = 0;
+	for (tPortId portId = 0;
+	     portId < basePermanently.ports_count;
+	     portId++)
+	{
+		count += kernel_interface_stack[portId].mbufsCount;
+	}
+	return count;
+}
+#endif
+
 inline void cWorker::drop(rte_mbuf* mbuf)
 {
 	stats.dropPackets++;
@@ -5513,6 +5917,9 @@ YANET_NEVER_INLINE void cWorker::slowWorkerHandlePackets()
 
 YANET_NEVER_INLINE void cWorker::slowWorkerAfterHandlePackets()
 {
+	/// slow worker creates states too (slowWorkerFlow() -> acl_ingress_entry())
+	acl_state_emit_flush_expired();
+
 	iteration++;
 }
 
@@ -5522,6 +5929,9 @@ YANET_NEVER_INLINE void cWorker::slowWorkerFlow(rte_mbuf* mbuf,
 	dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 	metadata->flow = flow;
 
+	/// packets from controlplane may be generated or rewritten without preparePacket()
+	calcHash(mbuf);
+
 	if (flow.type == common::globalBase::eFlowType::acl_ingress)
 	{
 		acl_ingress_entry(mbuf);
@@ -13,6 +13,7 @@
 
 #include "base.h"
 #include "common.h"
+#include "fw_state_sync.h"
 #include "globalbase.h"
 #include "samples.h"
 #include "sharedmemory.h"
@@ -54,6 +55,135 @@ public:
 	rte_mbuf* mbufs[TSize];
 };
 
+/// tx queue of multi-queue kernel interface, owned by one worker (see cControlPlane::init_kernel_interfaces()).
+/// queue 0 is transmitted by slow worker, so queue_id 0 means packets to kernel go through ring_normalPriority
+struct kernel_interface_queue_t
+{
+	tPortId kernel_port_id;
+	tQueueId queue_id;
+
+	uint64_t packets;
+	uint64_t bytes;
+	uint64_t drops;
+};
+
+/// pipeline stages of cWorker::handlePackets(), named after their handlers
+enum class stage_e : uint32_t
+{
+	physicalPort_ingress_handle,
+	logicalPort_ingress_handle,
+	acl_ingress_handle4,
+	acl_ingress_handle6,
+	tun64_ipv4_handle,
+	tun64_ipv6_handle,
+	decap_handle,
+	nat64stateful_lan_handle,
+	nat64stateful_wan_handle,
+	nat64stateless_ingress_handle,
+	nat64stateless_egress_handle,
+	balancer_handle,
+	balancer_icmp_reply_handle,
+	balancer_icmp_forward_handle,
+	route_handle4,
+	route_handle6,
+	route_tunnel_handle4,
+	route_tunnel_handle6,
+	acl_egress_handle4,
+	acl_egress_handle6,
+	logicalPort_egress_handle,
+	controlPlane_handle,
+	kernel_interface_handle,
+	physicalPort_egress_handle,
+	size
+};
+
+constexpr inline const char* stage_to_string(const stage_e stage)
+{
+	switch (stage)
+	{
+		case stage_e::physicalPort_ingress_handle:
+			return "physicalPort_ingress_handle";
+		case stage_e::logicalPort_ingress_handle:
+			return "logicalPort_ingress_handle";
+		case stage_e::acl_ingress_handle4:
+			return "acl_ingress_handle4";
+		case stage_e::acl_ingress_handle6:
+			return "acl_ingress_handle6";
+		case stage_e::tun64_ipv4_handle:
+			return "tun64_ipv4_handle";
+		case stage_e::tun64_ipv6_handle:
+			return "tun64_ipv6_handle";
+		case stage_e::decap_handle:
+			return "decap_handle";
+		case stage_e::nat64stateful_lan_handle:
+			return "nat64stateful_lan_handle";
+		case stage_e::nat64stateful_wan_handle:
+			return "nat64stateful_wan_handle";
+		case stage_e::nat64stateless_ingress_handle:
+			return "nat64stateless_ingress_handle";
+		case stage_e::nat64stateless_egress_handle:
+			return "nat64stateless_egress_handle";
+		case stage_e::balancer_handle:
+			return "balancer_handle";
+		case stage_e::balancer_icmp_reply_handle:
+			return "balancer_icmp_reply_handle";
+		case stage_e::balancer_icmp_forward_handle:
+			return "balancer_icmp_forward_handle";
+		case stage_e::route_handle4:
+			return "route_handle4";
+		case stage_e::route_handle6:
+			return "route_handle6";
+		case stage_e::route_tunnel_handle4:
+			return "route_tunnel_handle4";
+		case stage_e::route_tunnel_handle6:
+			return "route_tunnel_handle6";
+		case stage_e::acl_egress_handle4:
+			return "acl_egress_handle4";
+		case stage_e::acl_egress_handle6:
+			return "acl_egress_handle6";
+		case stage_e::logicalPort_egress_handle:
+			return "logicalPort_egress_handle";
+		case stage_e::controlPlane_handle:
+			return "controlPlane_handle";
+		case stage_e::kernel_interface_handle:
+			return "kernel_interface_handle";
+		case stage_e::physicalPort_egress_handle:
+			return "physicalPort_egress_handle";
+		case stage_e::size:
+			break;
+	}
+
+	return "unknown";
+}
+
+/// tsc cycles, invocations and packets of each pipeline stage.
+/// filled only when built with YANET_CONFIG_WORKER_PROFILE (meson option 'worker_profile').
+/// stage is accounted only when it has packets to handle
+class profile_t
+{
+public:
+	profile_t()
+	{
+		memset(cycles, 0, sizeof(cycles));
+		memset(invocations, 0, sizeof(invocations));
+		memset(packets, 0, sizeof(packets));
+	}
+
+	inline void update(const stage_e stage,
+	                   const uint64_t packets_count,
+	                   const uint64_t cycles_count)
+	{
+		cycles[(uint32_t)stage] += cycles_count;
+		invocations[(uint32_t)stage]++;
+		packets[(uint32_t)stage] += packets_count;
+	}
+
+public:
+	uint64_t cycles[(uint32_t)stage_e::size];
+	uint64_t invocations[(uint32_t)stage_e::size];
+	uint64_t packets[(uint32_t)stage_e::size];
+};
+
 }
 
 class cWorker
@@ -74,6 +204,9 @@ protected:
 	YANET_NEVER_INLINE void mainThread();
 
 	inline void calcHash(rte_mbuf* mbuf);
+	inline void prepareHeaders(rte_mbuf* mbuf);
+
+	/// parse headers and cache hash in metadata. must be called again after headers are rewritten
 	void preparePacket(rte_mbuf* mbuf); ///< @todo: inline
 
 	inline void handlePackets();
@@ -81,6 +214,9 @@ protected:
 	inline void physicalPort_ingress_handle(const unsigned int& worker_port_i);
 
 	inline void physicalPort_egress_handle();
+#ifdef YANET_CONFIG_WORKER_PROFILE
+	inline unsigned int physicalPort_stack_count() const;
+#endif
 
 	inline void logicalPort_ingress_handle();
 	inline void logicalPort_ingress_flow(rte_mbuf* mbuf, const common::globalBase::tFlow& flow);
@@ -121,6 +257,7 @@ protected:
 	/// nat64stateful lan (ipv6)
 	inline void nat64stateful_lan_entry(rte_mbuf* mbuf);
 	inline void nat64stateful_lan_handle();
+	inline bool nat64stateful_lan_block_port(const dataplane::globalBase::nat64stateful_t& nat64stateful, const dataplane::globalBase::nat64stateful_lan_key& key, const uint32_t client_hash, dataplane::globalBase::nat64stateful_wan_key& wan_key, uint32_t& wan_hash, dataplane::globalBase::nat64stateful::wan_ht::locker_t*& wan_locker, dataplane::globalBase::nat64stateful_lan_block_value*& block_value, dataplane::globalBase::nat64stateful::lan_block_ht::locker_t*& block_locker);
 	inline void nat64stateful_lan_translation(rte_mbuf* mbuf, const dataplane::globalBase::nat64stateful_lan_value& value);
 	inline void nat64stateful_lan_flow(rte_mbuf* mbuf, const common::globalBase::tFlow& flow);
 
@@ -129,6 +266,7 @@ protected:
 	inline void nat64stateful_wan_handle();
 	inline void nat64stateful_wan_translation(rte_mbuf* mbuf, const dataplane::globalBase::nat64stateful_wan_value& value);
 	inline void nat64stateful_wan_flow(rte_mbuf* mbuf, const common::globalBase::tFlow& flow);
+	inline uint32_t nat64stateful_flags(rte_mbuf* mbuf, const uint32_t flags); ///< tcp flags of state after packet
 
 	/// nat64stateless lan (ipv6)
 	inline void nat64stateless_ingress_entry_checked(rte_mbuf* mbuf);
@@ -160,12 +298,17 @@ protected:
 	inline void balancer_ipv4_source(rte_ipv4_hdr* header, const ipv4_address_t& balancer, const dataplane::globalBase::balancer_service_t& service);
 
 	/// fw state
-	inline bool acl_try_keepstate(rte_mbuf* mbuf);
-	inline bool acl_try_keepstate(rte_mbuf* mbuf, dataplane::globalBase::fw_state_value_t* value, dataplane::spinlock_nonrecursive_t* locker);
+	inline void acl_state_key(rte_mbuf* mbuf, dataplane::globalBase::fw4_state_key_t& key);
+	inline void acl_state_key(rte_mbuf* mbuf, dataplane::globalBase::fw6_state_key_t& key);
+	inline bool acl_try_keepstate(rte_mbuf* mbuf, const uint32_t hash, const dataplane::globalBase::fw4_state_key_t& key);
+	inline bool acl_try_keepstate(rte_mbuf* mbuf, const uint32_t hash, const dataplane::globalBase::fw6_state_key_t& key);
 	inline bool acl_egress_try_keepstate(rte_mbuf* mbuf);
-	inline bool acl_egress_try_keepstate(rte_mbuf* mbuf, dataplane::globalBase::fw_state_value_t* value, dataplane::spinlock_nonrecursive_t* locker);
+	template<typename state_ht_t, typename key_t>
+	inline bool acl_keepstate_hit(rte_mbuf* mbuf, state_ht_t* state_ht, const uint32_t hash, const key_t& key, common::globalBase::tFlow& flow);
 	inline void acl_create_keepstate(rte_mbuf* mbuf, tAclId aclId, const common::globalBase::tFlow& flow);
 	inline void acl_state_emit(tAclId aclId, const dataplane::globalBase::fw_state_sync_frame_t& frame);
+	inline void acl_state_emit_flush(rte_mbuf* mbuf);
+	inline void acl_state_emit_flush_expired();
 
 	inline void acl_egress_entry(rte_mbuf* mbuf, tAclId aclId);
 	inline void acl_egress_handle4();
@@ -177,6 +320,10 @@ protected:
 
 	inline void controlPlane(rte_mbuf* mbuf);
 	inline void controlPlane_handle();
+	inline void kernel_interface_handle();
+#ifdef YANET_CONFIG_WORKER_PROFILE
+	inline unsigned int kernel_interface_stack_count() const;
+#endif
 
 	inline void drop(rte_mbuf* mbuf);
 
@@ -244,6 +391,8 @@ protected:
 			ipv6_address_t ipv6_destinations[CONFIG_YADECAP_MBUFS_BURST_SIZE];
 			common::acl::transport_key_t transports[CONFIG_YADECAP_MBUFS_BURST_SIZE];
 			common::acl::total_key_t totals[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+			dataplane::globalBase::fw4_state_key_t fw4_states[CONFIG_YADECAP_MBUFS_BURST_SIZE];
+			dataplane::globalBase::fw6_state_key_t fw6_states[CONFIG_YADECAP_MBUFS_BURST_SIZE];
 		} key_acl;
 	};
 
@@ -289,6 +438,7 @@ protected:
 	worker::tStack<> acl_egress_stack4;
 	worker::tStack<> acl_egress_stack6;
 	worker::tStack<128> controlPlane_stack; ///< to_linux + ingress_state + egress_state + nap
+	worker::tStack<> kernel_interface_stack[CONFIG_YADECAP_PORTS_SIZE]; ///< to_linux over owned queues of kernel_interface_queues
 
 	worker::tStack<> after_early_decap_stack4;
 	worker::tStack<> after_early_decap_stack6;
@@ -303,13 +453,20 @@ protected:
 
 	common::worker::stats::common stats;
 	common::worker::stats::port statsPorts[CONFIG_YADECAP_PORTS_SIZE];
+	worker::kernel_interface_queue_t kernel_interface_queues[CONFIG_YADECAP_PORTS_SIZE];
 	uint64_t bursts[CONFIG_YADECAP_MBUFS_BURST_SIZE + 1];
-	uint64_t counters[YANET_CONFIG_COUNTERS_SIZE];
-	uint64_t aclCounters[YANET_CONFIG_ACL_COUNTERS_SIZE];
+#ifdef YANET_CONFIG_WORKER_PROFILE
+	worker::profile_t profile;
+#endif
+	uint64_t* counters; ///< [YANET_CONFIG_COUNTERS_SIZE], in shared memory, see common/shared_counters.h
+	uint64_t* aclCounters; ///< [YANET_CONFIG_ACL_COUNTERS_SIZE], in shared memory
 
 	// will decrease with each new packet sent to slow worker, replenishes each N mseconds
 	int32_t packetsToSWNPRemainder;
 
+	/// fw state sync frames are collected to one packet, until it is full or flush timeout is expired
+	dataplane::fw_state_sync_batch_t<rte_mbuf> fw_state_sync_batch;
+
 	cSharedMemory dumpRings[YANET_CONFIG_SHARED_RINGS_NUMBER];
 
 	samples::Sampler sampler;
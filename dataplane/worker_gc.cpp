@@ -5,6 +5,7 @@
 
 #include "controlplane.h"
 #include "dataplane.h"
+#include "nat64stateful.h"
 #include "worker.h"
 #include "worker_gc.h"
 
@@ -19,7 +20,8 @@ worker_gc_t::worker_gc_t(cDataPlane* dataplane) :
         local_base_id(0),
         ring_to_slowworker(nullptr),
         ring_to_free_mbuf(nullptr),
-        callback_id(0)
+        callback_id(0),
+        nat64stateful_wan_state_expiry_hashtable(nullptr)
 {
 	memset(counters, 0, sizeof(counters));
 }
@@ -63,6 +65,9 @@ eResult worker_gc_t::init(const tCoreId& core_id,
 
 	gc_step = dataplane->getConfigValue(eConfigType::gc_step);
 	sample_gc_step = dataplane->getConfigValue(eConfigType::sample_gc_step);
+	fw_state_sync_frames_per_packet = RTE_MAX(1u,
+	                                          RTE_MIN((unsigned int)dataplane->getConfigValue(eConfigType::fw_state_sync_frames_per_packet),
+	                                                  dataplane::globalBase::fw_state_sync_frames_per_packet_max));
 
 	mempool = rte_mempool_create(("wgc" + std::to_string(core_id)).data(),
 	                             CONFIG_YADECAP_MBUFS_COUNT + 3 * CONFIG_YADECAP_PORTS_SIZE * CONFIG_YADECAP_MBUFS_BURST_SIZE,
@@ -161,6 +166,8 @@ void worker_gc_t::limits(common::idp::limits::response& response) const
 
 	globalbase_atomic->updater.nat64stateful_lan_state.limits(response, "nat64stateful.lan.state.ht");
 	globalbase_atomic->updater.nat64stateful_wan_state.limits(response, "nat64stateful.wan.state.ht");
+	globalbase_atomic->updater.nat64stateful_lan_block.limits(response, "nat64stateful.lan.block.ht");
+	globalbase_atomic->updater.nat64stateful_wan_block.limits(response, "nat64stateful.wan.block.ht");
 	globalbase_atomic->updater.fw4_state.limits(response, "acl.state.v4.ht");
 	globalbase_atomic->updater.fw6_state.limits(response, "acl.state.v6.ht");
 }
@@ -175,9 +182,18 @@ void worker_gc_t::fillStatsNamesToAddrsTable(std::unordered_map<std::string, uin
 	table["fwsync_multicast_egress_drops"] = &stats.fwsync_multicast_egress_drops;
 	table["fwsync_unicast_egress_packets"] = &stats.fwsync_unicast_egress_packets;
 	table["fwsync_unicast_egress_drops"] = &stats.fwsync_unicast_egress_drops;
+	table["fwsync_egress_frame_packets"] = &stats.fwsync_egress_frame_packets;
+	table["fwsync_egress_frames"] = &stats.fwsync_egress_frames;
 	table["drop_samples"] = &stats.drop_samples;
 	table["balancer_state_insert_failed"] = &stats.balancer_state_insert_failed;
 	table["balancer_state_insert_done"] = &stats.balancer_state_insert_done;
+	table["nat64stateful_gc_scanned"] = &stats.nat64stateful_gc_scanned;
+	table["nat64stateful_gc_expired"] = &stats.nat64stateful_gc_expired;
+	table["nat64stateful_port_blocks_released"] = &stats.nat64stateful_port_blocks_released;
+	table["balancer_gc_scanned"] = &stats.balancer_gc_scanned;
+	table["balancer_gc_expired"] = &stats.balancer_gc_expired;
+	table["acl_gc_scanned"] = &stats.acl_gc_scanned;
+	table["acl_gc_expired"] = &stats.acl_gc_expired;
 }
 
 YANET_INLINE_NEVER void worker_gc_t::thread()
@@ -209,149 +225,245 @@ void worker_gc_t::handle()
 
 void worker_gc_t::handle_nat64stateful_gc()
 {
-	const auto& base = bases[local_base_id & 1];
 	auto* globalbase_atomic = base_permanently.globalBaseAtomic;
+	auto* wan_state = globalbase_atomic->nat64stateful_wan_state;
+
+	if (nat64stateful_wan_state_expiry_hashtable != wan_state ||
+	    nat64stateful_wan_state_expiry.handles_size() != globalbase_atomic->updater.nat64stateful_wan_state.get_total_size())
+	{
+		/// hashtable is reallocated
+		nat64stateful_wan_state_expiry_hashtable = wan_state;
+		nat64stateful_wan_state_expiry.reset(globalbase_atomic->updater.nat64stateful_wan_state.get_total_size(), current_time);
+	}
+
+	/// states are checked, when they are due
+	nat64stateful_wan_state_expiry.expire(current_time, gc_step, [&](uint32_t handle) {
+		dataplane::globalBase::nat64stateful::wan_ht::iterator_t iter(wan_state, handle);
+		nat64stateful_gc_state(iter);
+	});
 
+	/// new states are found by walk, which reads keys of unknown states only
 	for (auto iter : globalbase_atomic->updater.nat64stateful_wan_state.gc(nat64stateful_wan_state_gc.offset, gc_step))
 	{
-		iter.lock();
 		if (!iter.is_valid())
 		{
-			iter.unlock();
 			continue;
 		}
 
-		correct_timestamp(iter.value()->timestamp_last_packet);
-		auto flags = iter.value()->flags;
-		auto wan_key = *iter.key();
-		auto wan_value = *iter.value();
-		iter.unlock();
-
 		nat64stateful_wan_state_gc.valid_keys++;
 
-		if ((wan_key.port_destination & base_permanently.nat64stateful_numa_reverse_mask) != base_permanently.nat64stateful_numa_id)
+		if (nat64stateful_wan_state_expiry.is_scheduled(iter.get_index()))
+		{
+			continue;
+		}
+
+		/// read without lock, nat64stateful_gc_state() checks it again
+		if ((iter.key()->port_destination & base_permanently.nat64stateful_numa_reverse_mask) != base_permanently.nat64stateful_numa_id)
 		{
 			/// this state created on another numa
 			continue;
 		}
 
-		uint16_t last_seen = calc_last_seen(wan_value.timestamp_last_packet);
+		nat64stateful_gc_state(iter);
+	}
 
-		const auto& nat64stateful = base.globalBase->nat64statefuls[wan_key.nat64stateful_id];
+	if (nat64stateful_wan_state_gc.offset == 0)
+	{
+		nat64stateful_wan_state_gc.iterations++;
+	}
 
-		/// check other wan tables
-		for (unsigned int numa_i = 0;
-		     numa_i < YANET_CONFIG_NUMA_SIZE;
-		     numa_i++)
+	/// for calc stats only
+	for (auto iter : globalbase_atomic->updater.nat64stateful_lan_state.gc(nat64stateful_lan_state_gc.offset, gc_step))
+	{
+		if (iter.is_valid())
 		{
-			auto* globalbase_atomic = base_permanently.globalBaseAtomics[numa_i];
-			if (globalbase_atomic == base_permanently.globalBaseAtomic)
-			{
-				continue;
-			}
-			else if (globalbase_atomic == nullptr)
-			{
-				break;
-			}
-
-			dataplane::globalBase::nat64stateful_wan_value* wan_value_lookup;
-			dataplane::spinlock_nonrecursive_t* wan_locker;
-			globalbase_atomic->nat64stateful_wan_state->lookup(wan_key, wan_value_lookup, wan_locker);
-			if (wan_value_lookup)
-			{
-				correct_timestamp(wan_value_lookup->timestamp_last_packet);
-				last_seen = RTE_MIN(last_seen, calc_last_seen(wan_value_lookup->timestamp_last_packet));
-				flags |= wan_value_lookup->flags;
-			}
-			wan_locker->unlock();
+			nat64stateful_lan_state_gc.valid_keys++;
 		}
+	}
+
+	if (nat64stateful_lan_state_gc.offset == 0)
+	{
+		nat64stateful_lan_state_gc.iterations++;
+	}
 
-		dataplane::globalBase::nat64stateful_lan_key lan_key;
-		lan_key.nat64stateful_id = wan_key.nat64stateful_id;
-		lan_key.proto = wan_key.proto;
-		lan_key.ipv6_source = wan_value.ipv6_destination;
-		lan_key.ipv6_destination = wan_value.ipv6_source;
-		lan_key.ipv6_destination.mapped_ipv4_address = wan_key.ipv4_source;
-		lan_key.port_source = wan_value.port_destination;
-		lan_key.port_destination = wan_key.port_source;
-
-		/// check lan tables
-		for (unsigned int numa_i = 0;
-		     numa_i < YANET_CONFIG_NUMA_SIZE;
-		     numa_i++)
+	/// block is released after timeout since its last state
+	for (auto iter : globalbase_atomic->updater.nat64stateful_lan_block.gc(nat64stateful_lan_block_gc.offset, gc_step))
+	{
+		iter.lock();
+		if (!iter.is_valid())
 		{
-			auto* globalbase_atomic = base_permanently.globalBaseAtomics[numa_i];
-			if (globalbase_atomic == nullptr)
-			{
-				break;
-			}
+			iter.unlock();
+			continue;
+		}
 
-			dataplane::globalBase::nat64stateful_lan_value* lan_value_lookup;
-			dataplane::spinlock_nonrecursive_t* lan_locker;
-			globalbase_atomic->nat64stateful_lan_state->lookup(lan_key, lan_value_lookup, lan_locker);
-			if (lan_value_lookup)
-			{
-				correct_timestamp(lan_value_lookup->timestamp_last_packet);
-				last_seen = RTE_MIN(last_seen, calc_last_seen(lan_value_lookup->timestamp_last_packet));
-				flags |= lan_value_lookup->flags;
-			}
-			lan_locker->unlock();
+		nat64stateful_lan_block_gc.valid_keys++;
+
+		correct_timestamp(iter.value()->timestamp_last_packet);
+		if (!dataplane::nat64stateful::block_is_expired(*iter.value(),
+		                                                calc_last_seen(iter.value()->timestamp_last_packet)))
+		{
+			iter.unlock();
+			continue;
 		}
 
-		uint16_t timeout = nat64stateful.state_timeout.other;
-		if (wan_key.proto == IPPROTO_TCP)
+		const auto owner_key = dataplane::nat64stateful::block_owner_key(*iter.key(), *iter.value());
+
+		iter.unset_valid();
+		iter.unlock();
+
+		globalbase_atomic->nat64stateful_wan_block->remove(owner_key);
+		stats.nat64stateful_port_blocks_released++;
+	}
+
+	if (nat64stateful_lan_block_gc.offset == 0)
+	{
+		nat64stateful_lan_block_gc.iterations++;
+	}
+
+	/// for calc stats only
+	for (auto iter : globalbase_atomic->updater.nat64stateful_wan_block.gc(nat64stateful_wan_block_gc.offset, gc_step))
+	{
+		if (iter.is_valid())
 		{
-			if (flags & (TCP_FIN_FLAG | TCP_RST_FLAG))
-			{
-				timeout = nat64stateful.state_timeout.tcp_fin;
-			}
-			else if (flags & TCP_ACK_FLAG)
-			{
-				timeout = nat64stateful.state_timeout.tcp_ack;
-			}
-			else
-			{
-				timeout = nat64stateful.state_timeout.tcp_syn;
-			}
+			nat64stateful_wan_block_gc.valid_keys++;
 		}
-		else if (wan_key.proto == IPPROTO_UDP)
+	}
+
+	if (nat64stateful_wan_block_gc.offset == 0)
+	{
+		nat64stateful_wan_block_gc.iterations++;
+	}
+}
+
+void worker_gc_t::nat64stateful_gc_state(dataplane::globalBase::nat64stateful::wan_ht::iterator_t& iter)
+{
+	const auto& base = bases[local_base_id & 1];
+
+	iter.lock();
+	if (!iter.is_valid())
+	{
+		iter.unlock();
+		return;
+	}
+
+	correct_timestamp(iter.value()->timestamp_last_packet);
+	auto flags = iter.value()->flags;
+	auto wan_key = *iter.key();
+	auto wan_value = *iter.value();
+	iter.unlock();
+
+	stats.nat64stateful_gc_scanned++;
+
+	if ((wan_key.port_destination & base_permanently.nat64stateful_numa_reverse_mask) != base_permanently.nat64stateful_numa_id)
+	{
+		/// this state created on another numa
+		return;
+	}
+
+	uint16_t last_seen = calc_last_seen(wan_value.timestamp_last_packet);
+
+	const auto& nat64stateful = base.globalBase->nat64statefuls[wan_key.nat64stateful_id];
+
+	/// check other wan tables
+	for (unsigned int numa_i = 0;
+	     numa_i < YANET_CONFIG_NUMA_SIZE;
+	     numa_i++)
+	{
+		auto* globalbase_atomic = base_permanently.globalBaseAtomics[numa_i];
+		if (globalbase_atomic == base_permanently.globalBaseAtomic)
 		{
-			timeout = nat64stateful.state_timeout.udp;
+			continue;
 		}
-		else if (wan_key.proto == IPPROTO_ICMPV6)
+		else if (globalbase_atomic == nullptr)
 		{
-			timeout = nat64stateful.state_timeout.icmp;
+			break;
 		}
 
-		if (last_seen > timeout)
+		dataplane::globalBase::nat64stateful_wan_value* wan_value_lookup;
+		dataplane::globalBase::nat64stateful::wan_ht::locker_t* wan_locker;
+		globalbase_atomic->nat64stateful_wan_state->lookup(wan_key, wan_value_lookup, wan_locker);
+		if (wan_value_lookup)
 		{
-			nat64stateful_remove_state(lan_key, wan_key);
+			correct_timestamp(wan_value_lookup->timestamp_last_packet);
+			last_seen = RTE_MIN(last_seen, calc_last_seen(wan_value_lookup->timestamp_last_packet));
+			flags |= wan_value_lookup->flags;
 		}
+		wan_locker->unlock();
 	}
 
-	if (nat64stateful_wan_state_gc.offset == 0)
+	dataplane::globalBase::nat64stateful_lan_key lan_key;
+	lan_key.nat64stateful_id = wan_key.nat64stateful_id;
+	lan_key.proto = wan_key.proto;
+	lan_key.ipv6_source = wan_value.ipv6_destination;
+	lan_key.ipv6_destination = wan_value.ipv6_source;
+	lan_key.ipv6_destination.mapped_ipv4_address = wan_key.ipv4_source;
+	lan_key.port_source = wan_value.port_destination;
+	lan_key.port_destination = wan_key.port_source;
+
+	/// check lan tables
+	for (unsigned int numa_i = 0;
+	     numa_i < YANET_CONFIG_NUMA_SIZE;
+	     numa_i++)
 	{
-		nat64stateful_wan_state_gc.iterations++;
+		auto* globalbase_atomic = base_permanently.globalBaseAtomics[numa_i];
+		if (globalbase_atomic == nullptr)
+		{
+			break;
+		}
+
+		dataplane::globalBase::nat64stateful_lan_value* lan_value_lookup;
+		dataplane::globalBase::nat64stateful::lan_ht::locker_t* lan_locker;
+		globalbase_atomic->nat64stateful_lan_state->lookup(lan_key, lan_value_lookup, lan_locker);
+		if (lan_value_lookup)
+		{
+			correct_timestamp(lan_value_lookup->timestamp_last_packet);
+			last_seen = RTE_MIN(last_seen, calc_last_seen(lan_value_lookup->timestamp_last_packet));
+			flags |= lan_value_lookup->flags;
+		}
+		lan_locker->unlock();
 	}
 
-	/// for calc stats only
-	for (auto iter : globalbase_atomic->updater.nat64stateful_lan_state.gc(nat64stateful_lan_state_gc.offset, gc_step))
+	uint16_t timeout = nat64stateful.state_timeout.other;
+	uint16_t delay_max = timeout;
+	if (wan_key.proto == IPPROTO_TCP)
 	{
-		iter.lock();
-		if (!iter.is_valid())
+		/// worker may set FIN or RST after state is scheduled, and shorten its timeout.
+		/// state is checked again not later than the smallest of tcp timeouts
+		delay_max = RTE_MIN(nat64stateful.state_timeout.tcp_syn,
+		                    RTE_MIN(nat64stateful.state_timeout.tcp_ack,
+		                            nat64stateful.state_timeout.tcp_fin));
+
+		if (flags & (TCP_FIN_FLAG | TCP_RST_FLAG))
 		{
-			iter.unlock();
-			continue;
+			timeout = nat64stateful.state_timeout.tcp_fin;
 		}
-		iter.unlock();
-
-		nat64stateful_lan_state_gc.valid_keys++;
+		else if (flags & TCP_ACK_FLAG)
+		{
+			timeout = nat64stateful.state_timeout.tcp_ack;
+		}
+		else
+		{
+			timeout = nat64stateful.state_timeout.tcp_syn;
+		}
+	}
+	else if (wan_key.proto == IPPROTO_UDP)
+	{
+		timeout = nat64stateful.state_timeout.udp;
+	}
+	else if (wan_key.proto == IPPROTO_ICMPV6)
+	{
+		timeout = nat64stateful.state_timeout.icmp;
 	}
 
-	if (nat64stateful_lan_state_gc.offset == 0)
+	if (last_seen > timeout)
 	{
-		nat64stateful_lan_state_gc.iterations++;
+		stats.nat64stateful_gc_expired++;
+		nat64stateful_remove_state(lan_key, wan_key);
+		return;
 	}
+
+	/// state is local, so only this gc removes it and pair keeps its index till then
+	nat64stateful_wan_state_expiry.schedule(iter.get_index(), current_time + RTE_MIN((uint32_t)(timeout - last_seen), (uint32_t)delay_max) + 1);
 }
 
 void worker_gc_t::handle_balancer_gc()
@@ -372,6 +484,7 @@ void worker_gc_t::handle_balancer_gc()
 			iter.unlock();
 
 			globalbase_atomic->balancer_state_gc.valid_keys++;
+			stats.balancer_gc_scanned++;
 
 			/// balancer service connections
 			{
@@ -446,7 +559,7 @@ void worker_gc_t::handle_balancer_gc()
 					bool updated = false;
 
 					dataplane::globalBase::balancer_state_value_t* ht_value;
-					dataplane::spinlock_nonrecursive_t* locker;
+					dataplane::globalBase::balancer_state_ht::locker_t* locker;
 					uint32_t old_real_id;
 
 					uint32_t hash = globalbase_atomic_other->balancer_state.lookup(*iter.key(), ht_value, locker);
@@ -495,6 +608,7 @@ void worker_gc_t::handle_balancer_gc()
 				const auto& real_from_base = base.globalBase->balancer_reals[iter.value()->real_unordered_id];
 				++counters[real_from_base.counter_id + (tCounterId)balancer::gc_real_counter::sessions_destroyed];
 				iter.unset_valid();
+				stats.balancer_gc_expired++;
 			}
 			iter.unlock();
 		}
@@ -526,6 +640,7 @@ void worker_gc_t::handle_acl_gc()
 			iter.unlock();
 
 			fw4_state_gc.valid_keys++;
+			stats.acl_gc_scanned++;
 
 			common::idp::getFWState::key_t fw_key(std::uint8_t(key.proto), {rte_be_to_cpu_32(key.src_addr.address)}, {rte_be_to_cpu_32(key.dst_addr.address)}, key.src_port, key.dst_port);
 			fw_state_insert_stack.emplace_back(
@@ -542,6 +657,7 @@ void worker_gc_t::handle_acl_gc()
 				if (current_time - value.last_seen >= globalbase_atomic->fw_state_config.tcp_timeout)
 				{
 					fw_state_remove_stack.emplace_back(fw_key);
+					stats.acl_gc_expired++;
 
 					iter.lock();
 					iter.unset_valid();
@@ -569,6 +685,7 @@ void worker_gc_t::handle_acl_gc()
 				if (current_time - value.last_seen >= globalbase_atomic->fw_state_config.udp_timeout)
 				{
 					fw_state_remove_stack.emplace_back(fw_key);
+					stats.acl_gc_expired++;
 
 					iter.lock();
 					iter.unset_valid();
@@ -594,6 +711,7 @@ void worker_gc_t::handle_acl_gc()
 				if (current_time - value.last_seen >= globalbase_atomic->fw_state_config.other_protocols_timeout)
 				{
 					fw_state_remove_stack.emplace_back(fw_key);
+					stats.acl_gc_expired++;
 
 					iter.lock();
 					iter.unset_valid();
@@ -634,6 +752,7 @@ void worker_gc_t::handle_acl_gc()
 			iter.unlock();
 
 			fw6_state_gc.valid_keys++;
+			stats.acl_gc_scanned++;
 
 			common::idp::getFWState::key_t fw_key(std::uint8_t(key.proto), {key.src_addr.bytes}, {key.dst_addr.bytes}, key.src_port, key.dst_port);
 			fw_state_insert_stack.emplace_back(
@@ -650,6 +769,7 @@ void worker_gc_t::handle_acl_gc()
 				if (current_time - value.last_seen >= globalbase_atomic->fw_state_config.tcp_timeout)
 				{
 					fw_state_remove_stack.emplace_back(fw_key);
+					stats.acl_gc_expired++;
 
 					iter.lock();
 					iter.unset_valid();
@@ -677,6 +797,7 @@ void worker_gc_t::handle_acl_gc()
 				if (current_time - value.last_seen >= globalbase_atomic->fw_state_config.udp_timeout)
 				{
 					fw_state_remove_stack.emplace_back(fw_key);
+					stats.acl_gc_expired++;
 
 					iter.lock();
 					iter.unset_valid();
@@ -702,6 +823,7 @@ void worker_gc_t::handle_acl_gc()
 				if (current_time - value.last_seen >= globalbase_atomic->fw_state_config.other_protocols_timeout)
 				{
 					fw_state_remove_stack.emplace_back(fw_key);
+					stats.acl_gc_expired++;
 
 					iter.lock();
 					iter.unset_valid();
@@ -763,18 +885,36 @@ void worker_gc_t::handle_acl_sync()
 
 		/// @todo: init metadata
 
-		const auto& [frame, aclId] = fw_state_sync_events.front();
+		const tAclId aclId = std::get<1>(fw_state_sync_events.front());
 
 		constexpr uint16_t payload_offset = sizeof(rte_ether_hdr) + sizeof(rte_vlan_hdr) + sizeof(rte_ipv6_hdr) + sizeof(rte_udp_hdr);
-		rte_pktmbuf_append(mbuf, payload_offset + sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+		rte_pktmbuf_append(mbuf, payload_offset);
 
 		dataplane::metadata* metadata = YADECAP_METADATA(mbuf);
 		metadata->flow.data.aclId = aclId;
 
-		// We're only filling the payload here.
-		// Other headers will be set in the slow worker before emitting.
-		void* payload = rte_pktmbuf_mtod_offset(mbuf, void*, payload_offset);
-		memcpy(payload, (void*)&frame, sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+		// Consecutive frames of the same acl are sent in one packet.
+		unsigned int frames_count = 0;
+		while (!fw_state_sync_events.empty() &&
+		       frames_count < fw_state_sync_frames_per_packet)
+		{
+			const auto& [frame, frame_acl_id] = fw_state_sync_events.front();
+			if (frame_acl_id != aclId)
+			{
+				break;
+			}
+
+			void* payload = rte_pktmbuf_append(mbuf, sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+			memcpy(payload, (void*)&frame, sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+
+			fw_state_sync_events.pop();
+			frames_count++;
+		}
+
+		const uint16_t frames_size = frames_count * sizeof(dataplane::globalBase::fw_state_sync_frame_t);
+
+		stats.fwsync_egress_frame_packets++;
+		stats.fwsync_egress_frames += frames_count;
 
 		{
 			const auto& fw_state_config = base.globalBase->fw_state_sync_configs[metadata->flow.data.aclId];
@@ -793,7 +933,7 @@ void worker_gc_t::handle_acl_sync()
 
 			rte_ipv6_hdr* ipv6Header = rte_pktmbuf_mtod_offset(mbuf, rte_ipv6_hdr*, metadata->network_headerOffset);
 			ipv6Header->vtc_flow = rte_cpu_to_be_32(0x6 << 28);
-			ipv6Header->payload_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+			ipv6Header->payload_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + frames_size);
 			ipv6Header->proto = IPPROTO_UDP;
 			ipv6Header->hop_limits = 64;
 			memcpy(ipv6Header->src_addr, fw_state_config.ipv6_address_source.bytes, 16);
@@ -802,7 +942,7 @@ void worker_gc_t::handle_acl_sync()
 			rte_udp_hdr* udpHeader = rte_pktmbuf_mtod_offset(mbuf, rte_udp_hdr*, metadata->network_headerOffset + sizeof(rte_ipv6_hdr));
 			udpHeader->src_port = fw_state_config.port_multicast; // IPFW reuses the same port for both src and dst.
 			udpHeader->dst_port = fw_state_config.port_multicast;
-			udpHeader->dgram_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + sizeof(dataplane::globalBase::fw_state_sync_frame_t));
+			udpHeader->dgram_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + frames_size);
 			udpHeader->dgram_cksum = 0;
 			udpHeader->dgram_cksum = rte_ipv6_udptcp_cksum(ipv6Header, udpHeader);
 
@@ -872,8 +1012,6 @@ void worker_gc_t::handle_acl_sync()
 		}
 
 		rte_pktmbuf_free(mbuf);
-
-		fw_state_sync_events.pop();
 	}
 }
 
@@ -980,6 +1118,28 @@ void worker_gc_t::nat64stateful_remove_state(const dataplane::globalBase::nat64s
 		globalbase_atomic->nat64stateful_lan_state->remove(lan_key);
 		globalbase_atomic->nat64stateful_wan_state->remove(wan_key); ///< must be deleted last!
 	}
+
+	/// state leaves port block of its source
+	{
+		auto* globalbase_atomic = base_permanently.globalBaseAtomic;
+
+		dataplane::globalBase::nat64stateful_lan_block_key block_key;
+		block_key.nat64stateful_id = lan_key.nat64stateful_id;
+		block_key.nap = 0;
+		block_key.ipv6_source = lan_key.ipv6_source;
+
+		const uint32_t numa_shift = __builtin_popcount(rte_be_to_cpu_16(base_permanently.nat64stateful_numa_reverse_mask));
+		const uint32_t port_index = rte_be_to_cpu_16(wan_key.port_destination) >> numa_shift;
+
+		dataplane::globalBase::nat64stateful_lan_block_value* block_value;
+		dataplane::globalBase::nat64stateful::lan_block_ht::locker_t* block_locker;
+		globalbase_atomic->nat64stateful_lan_block->lookup(block_key, block_value, block_locker);
+		if (block_value)
+		{
+			dataplane::nat64stateful::block_state_remove(*block_value, wan_key.ipv4_destination, port_index, current_time);
+		}
+		block_locker->unlock();
+	}
 }
 
 void worker_gc_t::send_to_slowworker(rte_mbuf* mbuf,
@@ -1119,7 +1279,7 @@ void worker_gc_t::nat64stateful_state(const common::idp::nat64stateful_state::re
 				}
 
 				dataplane::globalBase::nat64stateful_wan_value* wan_value_lookup;
-				dataplane::spinlock_nonrecursive_t* wan_locker;
+				dataplane::globalBase::nat64stateful::wan_ht::locker_t* wan_locker;
 				globalbase_atomic->nat64stateful_wan_state->lookup(wan_key, wan_value_lookup, wan_locker);
 				if (wan_value_lookup)
 				{
@@ -1150,7 +1310,7 @@ void worker_gc_t::nat64stateful_state(const common::idp::nat64stateful_state::re
 				}
 
 				dataplane::globalBase::nat64stateful_lan_value* lan_value_lookup;
-				dataplane::spinlock_nonrecursive_t* lan_locker;
+				dataplane::globalBase::nat64stateful::lan_ht::locker_t* lan_locker;
 				globalbase_atomic->nat64stateful_lan_state->lookup(lan_key, lan_value_lookup, lan_locker);
 				if (lan_value_lookup)
 				{
@@ -6,6 +6,7 @@
 
 #include "base.h"
 #include "common.h"
+#include "expiry_wheel.h"
 #include "globalbase.h"
 #include "samples.h"
 
@@ -43,6 +44,7 @@ protected:
 	void correct_timestamp(uint16_t& timestamp, const uint16_t last_seen_max = YANET_CONFIG_STATE_TIMEOUT_MAX);
 	uint16_t calc_last_seen(const uint16_t timestamp);
 
+	void nat64stateful_gc_state(dataplane::globalBase::nat64stateful::wan_ht::iterator_t& iter);
 	void nat64stateful_remove_state(const dataplane::globalBase::nat64stateful_lan_key& lan_key, const dataplane::globalBase::nat64stateful_wan_key& wan_key);
 
 	void send_to_slowworker(rte_mbuf* mbuf, const common::globalBase::eFlowType& flow_type);
@@ -100,8 +102,13 @@ public:
 	uint32_t current_time;
 	dataplane::hashtable_gc_t nat64stateful_lan_state_gc;
 	dataplane::hashtable_gc_t nat64stateful_wan_state_gc;
+	dataplane::hashtable_gc_t nat64stateful_lan_block_gc;
+	dataplane::hashtable_gc_t nat64stateful_wan_block_gc;
+	dataplane::expiry_wheel_t nat64stateful_wan_state_expiry; ///< local states of nat64stateful_wan_state_expiry_hashtable
+	dataplane::globalBase::nat64stateful::wan_ht* nat64stateful_wan_state_expiry_hashtable;
 	dataplane::hashtable_gc_t fw4_state_gc;
 	dataplane::hashtable_gc_t fw6_state_gc;
 	uint32_t gc_step;
 	uint32_t sample_gc_step;
+	uint32_t fw_state_sync_frames_per_packet;
 };
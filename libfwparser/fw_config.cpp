@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <iterator>
 #include <limits>
 #include <netdb.h>
+#include <sstream>
 #include <stdexcept>
 
 #include "libfwparser/fw_parser.h"
@@ -25,6 +27,7 @@ fw_config_t::fw_config_t(int step)
 	m_ruleid_last = 0;
 	m_ruleno_last = 0;
 	m_ruleno_step = value;
+	m_sources_hash = 0xCBF29CE484222325ull ^ value;
 
 	m_curr_entity = entity_type::NONE;
 	m_curr_rule = std::make_shared<rule_t>();
@@ -124,13 +127,18 @@ bool fw_config_t::open(const std::string& file, bool nested)
 		}
 		filename = parent + filename;
 	}
-	auto fstrm = std::make_shared<std::ifstream>(filename, std::ios::in);
-	if (!fstrm->is_open())
+	std::ifstream fstrm(filename, std::ios::in);
+	if (!fstrm.is_open())
 	{
 		throw std::runtime_error("failed to open config: " + filename);
 	}
 
-	setup_lexer(filename, fstrm, nested);
+	// read whole file to take it into account in sources hash
+	std::string content((std::istreambuf_iterator<char>(fstrm)),
+	                    std::istreambuf_iterator<char>());
+	hash_source(filename, content);
+
+	setup_lexer(filename, std::make_shared<std::istringstream>(std::move(content)), nested);
 	return (true);
 }
 
@@ -178,11 +186,30 @@ bool fw_config_t::schedule_file(const std::string& file)
 
 bool fw_config_t::schedule_string(const std::string& str)
 {
+	hash_source("<CMDLINE>", str);
+
 	auto istrm = std::make_shared<std::istringstream>(str);
 	setup_lexer("<CMDLINE>", istrm, false);
 	return true;
 }
 
+void fw_config_t::hash_source(const std::string& name, const std::string& content)
+{
+	// FNV-1a over name and content of each source in order of opening
+	auto hash_bytes = [this](const char* data, size_t size) {
+		for (size_t i = 0; i < size; i++)
+		{
+			m_sources_hash ^= (uint8_t)data[i];
+			m_sources_hash *= 0x100000001B3ull;
+		}
+	};
+
+	const uint64_t size = content.size();
+	hash_bytes(name.data(), name.size() + 1);
+	hash_bytes(reinterpret_cast<const char*>(&size), sizeof(size));
+	hash_bytes(content.data(), content.size());
+}
+
 bool fw_config_t::schedule_stdin(void)
 {
 	istream_ptr_t istrm;
@@ -504,6 +504,13 @@ public:
 		return m_labels;
 	}
 
+	// hash of names and contents of all scheduled and included sources.
+	// complete after parse(), stdin is not taken into account
+	uint64_t sources_hash() const
+	{
+		return m_sources_hash;
+	}
+
 private:
 	void setup_lexer(const std::string& name, istream_ptr_t isrm, bool nested);
 	// parser's context
@@ -549,12 +556,14 @@ private:
 protected:
 	bool open(const std::string& file, bool nested = true);
 	bool close();
+	void hash_source(const std::string& name, const std::string& content);
 
 	fw_lexer_t m_lexer;
 	int m_debug; // debug level
 	unsigned int m_ruleid_last;
 	unsigned int m_ruleno_last;
 	unsigned int m_ruleno_step;
+	uint64_t m_sources_hash;
 	std::vector<fw_config_history_t> m_history; // history of opened files
 	// lexer cursor location, current filename and its number in m_history
 	std::stack<location> m_location;